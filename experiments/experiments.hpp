@@ -39,6 +39,7 @@
 #include <string>
 #include <tuple>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 #include <fmt/color.h>
@@ -240,11 +241,17 @@ public:
     return true;
   }
 
+  /* compares two datasets (by default the last two), counts differences in
+   * `track_columns`, and flags values in the columns of `regression_tolerances`
+   * that increased by more than the given relative tolerance (the number of
+   * flagged values is returned by `num_regressions`) */
   bool compare( std::string const& old_version = {},
                 std::string const& current_version = {},
                 std::vector<std::string> const& track_columns = {},
-                std::ostream& os = std::cout )
+                std::ostream& os = std::cout,
+                std::unordered_map<std::string, double> const& regression_tolerances = {} )
   {
+    num_regressions_ = 0u;
     if ( data_.size() < 2u )
     {
       fmt::print( "[w] dataset contains less than two entry sets\n" );
@@ -282,8 +289,9 @@ public:
         }
       }
 
-      /* track differences */
+      /* track differences and regressions */
       std::unordered_map<std::string, uint32_t> differences;
+      std::vector<std::string> regressions;
       for ( auto const& column : track_columns )
       {
         differences[column] = 0u;
@@ -326,6 +334,18 @@ public:
               {
                 it_diff->second++;
               }
+
+              auto const& value_old = row[column_names_[i]];
+              auto const& value_cur = row[column_names_[i] + "'"];
+              if ( const auto it_tol = regression_tolerances.find( column_names_[i] ); it_tol != regression_tolerances.end() && value_old.is_number() && value_cur.is_number() )
+              {
+                auto const v_old = value_old.template get<double>();
+                auto const v_cur = value_cur.template get<double>();
+                if ( v_cur > v_old * ( 1.0 + it_tol->second ) )
+                {
+                  regressions.push_back( fmt::format( "[w] regression in column '{}' for {}: {:.2f} -> {:.2f} ({:+.1f}%)\n", column_names_[i], row[column_names_[0]].is_string() ? row[column_names_[0]].template get<std::string>() : row[column_names_[0]].dump(), v_old, v_cur, v_old > 0.0 ? 100.0 * ( v_cur - v_old ) / v_old : 100.0 ) );
+                }
+              }
             }
           }
         }
@@ -341,6 +361,12 @@ public:
           os << fmt::format( "[i] {} differences in column '{}'\n", v, k );
         }
       }
+
+      for ( auto const& r : regressions )
+      {
+        os << r;
+      }
+      num_regressions_ = static_cast<uint32_t>( regressions.size() );
     }
     catch ( ... )
     {
@@ -351,6 +377,12 @@ public:
     return true;
   }
 
+  /* number of regressions found by the last call to `compare` */
+  uint32_t num_regressions() const
+  {
+    return num_regressions_;
+  }
+
 private:
   std::string name_;
   std::string filename_;
@@ -358,6 +390,7 @@ private:
   std::vector<std::tuple<ColumnTypes...>> rows_;
 
   nlohmann::json data_;
+  uint32_t num_regressions_{0u};
 };
 
 // clang-format off
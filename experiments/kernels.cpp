@@ -0,0 +1,190 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2019  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Throughput of core kernels on the bundled benchmarks.
+ *
+ * For every benchmark and kernel, the driver records the run-time per node
+ * (best of several repetitions), the peak resident set size, and the number
+ * of heap allocations per node.  Results are stored per git revision and
+ * compared to the previous revision; the program returns a non-zero exit
+ * code if a kernel became slower, needs more memory, or allocates more
+ * often than the tolerance allows.
+ *
+ * usage: kernels [repetitions] [time tolerance]
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+#include <kitty/partial_truth_table.hpp>
+#include <lorina/aiger.hpp>
+#include <mockturtle/algorithms/cleanup.hpp>
+#include <mockturtle/algorithms/cut_enumeration.hpp>
+#include <mockturtle/algorithms/simulation.hpp>
+#include <mockturtle/io/aiger_reader.hpp>
+#include <mockturtle/networks/aig.hpp>
+#include <mockturtle/utils/memory.hpp>
+#include <mockturtle/views/topo_view.hpp>
+
+#include <experiments.hpp>
+
+/* count heap allocations of the whole program */
+static std::atomic<uint64_t> num_allocations{0u};
+
+void* operator new( std::size_t size )
+{
+  ++num_allocations;
+  if ( void* p = std::malloc( size ? size : 1u ) )
+  {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+#if defined( __GNUC__ ) && !defined( __clang__ ) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete( void* p ) noexcept
+{
+  std::free( p );
+}
+
+void operator delete( void* p, std::size_t ) noexcept
+{
+  ::operator delete( p );
+}
+
+namespace
+{
+
+struct measurement
+{
+  double ns_per_node;
+  double rss;
+  double allocs_per_node;
+};
+
+/* runs `fn` `repetitions` times and keeps the fastest run */
+measurement measure( uint32_t num_nodes, uint32_t repetitions, std::function<void()> const& fn )
+{
+  measurement m{std::numeric_limits<double>::max(), 0.0, 0.0};
+  for ( auto r = 0u; r < repetitions; ++r )
+  {
+    mockturtle::reset_peak_rss();
+    auto const allocs_before = num_allocations.load();
+    auto const begin = std::chrono::steady_clock::now();
+    fn();
+    auto const end = std::chrono::steady_clock::now();
+    auto const allocs = num_allocations.load() - allocs_before;
+
+    auto const ns = std::chrono::duration<double, std::nano>( end - begin ).count();
+    m.ns_per_node = std::min( m.ns_per_node, ns / num_nodes );
+    m.rss = std::max( m.rss, mockturtle::peak_rss() / 1048576.0 );
+    m.allocs_per_node = static_cast<double>( allocs ) / num_nodes;
+  }
+  return m;
+}
+
+} // namespace
+
+int main( int argc, char** argv )
+{
+  using namespace experiments;
+  using namespace mockturtle;
+
+  uint32_t const repetitions = argc > 1 ? static_cast<uint32_t>( std::atoi( argv[1] ) ) : 3u;
+  double const time_tolerance = argc > 2 ? std::atof( argv[2] ) : 0.1;
+
+  experiment<std::string, uint32_t, double, double, double> exp( "kernels", "benchmark/kernel", "nodes", "ns/node", "peak RSS", "allocs/node" );
+
+  for ( auto const& benchmark : epfl_benchmarks() )
+  {
+    fmt::print( "[i] processing {}\n", benchmark );
+
+    aig_network aig;
+    lorina::read_aiger( benchmark_path( benchmark ), aiger_reader( aig ) );
+    auto const num_nodes = aig.size();
+
+    auto const run = [&]( std::string const& kernel, std::function<void()> const& fn ) {
+      auto const m = measure( num_nodes, repetitions, fn );
+      exp( benchmark + "/" + kernel, num_nodes, m.ns_per_node, m.rss, m.allocs_per_node );
+    };
+
+    /* parse and construct with structural hashing */
+    run( "read_aiger", [&]() {
+      aig_network ntk;
+      lorina::read_aiger( benchmark_path( benchmark ), aiger_reader( ntk ) );
+    } );
+
+    /* structural hashing lookups: recreate every gate, all lookups hit */
+    run( "strash", [&]() {
+      aig.foreach_gate( [&]( auto const& n ) {
+        std::array<aig_network::signal, 2u> fanins;
+        aig.foreach_fanin( n, [&]( auto const& f, auto i ) { fanins[i] = f; } );
+        aig.create_and( fanins[0], fanins[1] );
+      } );
+    } );
+
+    run( "topo_view", [&]() {
+      topo_view topo{aig};
+      uint64_t sum{0u};
+      topo.foreach_node( [&]( auto const& n ) { sum += n; } );
+      if ( sum == 0u )
+      {
+        fmt::print( "[w] empty network\n" );
+      }
+    } );
+
+    partial_simulator const sim( aig.num_pis(), 1024u );
+    run( "simulate_nodes", [&]() {
+      simulate_nodes<kitty::partial_truth_table>( aig, sim );
+    } );
+
+    run( "cut_enumeration", [&]() {
+      cut_enumeration_params ps;
+      ps.cut_size = 4u;
+      cut_enumeration( aig, ps );
+    } );
+
+    run( "cleanup_dangling", [&]() {
+      cleanup_dangling( aig );
+    } );
+  }
+
+  exp.save();
+  exp.table();
+
+  exp.compare( {}, {}, {}, std::cout, {{"ns/node", time_tolerance}, {"peak RSS", 0.1}, {"allocs/node", 0.01}} );
+  return exp.num_regressions() == 0u ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,677 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2019  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file aig_rewrite.hpp
+  \brief DAG-aware in-place rewriting of AIGs
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <fmt/format.h>
+#include <kitty/detail/mscfix.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+
+#include "../networks/aig.hpp"
+#include "../traits.hpp"
+#include "../utils/progress_bar.hpp"
+#include "../utils/stopwatch.hpp"
+#include "../views/fanout_view.hpp"
+#include "detail/npn4_table.hpp"
+#include "detail/rewriting_library.hpp"
+#include "node_resynthesis/xag_npn.hpp"
+
+namespace mockturtle
+{
+
+/*! \brief Parameters for aig_rewrite.
+ *
+ * The data structure `aig_rewrite_params` holds configurable parameters with
+ * default arguments for `aig_rewrite`.
+ */
+struct aig_rewrite_params
+{
+  /*! \brief Maximum number of 4-input cuts per node. */
+  uint32_t cut_limit{8u};
+
+  /*! \brief Minimum number of leaves of a candidate cut. */
+  uint32_t min_cand_cut_size{3u};
+
+  /*! \brief Allow zero-gain substitutions. */
+  bool allow_zero_gain{false};
+
+  /*! \brief Show progress. */
+  bool progress{false};
+
+  /*! \brief Be verbose. */
+  bool verbose{false};
+};
+
+/*! \brief Statistics for aig_rewrite.
+ *
+ * The data structure `aig_rewrite_stats` provides data collected by running
+ * `aig_rewrite`.
+ */
+struct aig_rewrite_stats
+{
+  /*! \brief Total runtime. */
+  stopwatch<>::duration time_total{0};
+
+  /*! \brief Accumulated runtime for cut enumeration. */
+  stopwatch<>::duration time_cuts{0};
+
+  /*! \brief Accumulated runtime for evaluating candidates. */
+  stopwatch<>::duration time_eval{0};
+
+  /*! \brief Number of rewritten nodes. */
+  uint32_t num_rewrites{0u};
+
+  /*! \brief Estimated reduction of AND gates. */
+  uint32_t estimated_gain{0u};
+
+  void report() const
+  {
+    fmt::print( "[i] total time      = {:>5.2f} secs\n", to_seconds( time_total ) );
+    fmt::print( "[i] cut enum. time  = {:>5.2f} secs\n", to_seconds( time_cuts ) );
+    fmt::print( "[i] evaluation time = {:>5.2f} secs\n", to_seconds( time_eval ) );
+    fmt::print( "[i] rewrites        = {:>5}\n", num_rewrites );
+    fmt::print( "[i] est. gain       = {:>5}\n", estimated_gain );
+  }
+};
+
+namespace detail
+{
+
+/* Structures of the AIG database of `xag_npn_resynthesis` for the
+ * representatives of all 4-input NPN classes.
+ *
+ * Each structure is stored as a number of gates, followed by two fanin
+ * literals per gate and the output literal.  Literals are `2 * id +
+ * complement`, where id 0 is the constant, ids 1 to 4 are the inputs of the
+ * representative, and the following ids are the gates.  The library is built
+ * once per process on first use.
+ */
+class aig_rewrite_library
+{
+public:
+  static aig_rewrite_library const& instance()
+  {
+    static const aig_rewrite_library library;
+    return library;
+  }
+
+  /* calls `fn( gates, num_gates, output )` for each structure of a class */
+  template<class Fn>
+  void foreach_structure( uint32_t class_index, Fn&& fn ) const
+  {
+    auto const* p = _data.data() + _offsets[class_index];
+    auto const* end = _data.data() + _offsets[class_index + 1u];
+    while ( p != end )
+    {
+      const uint32_t num_gates = p[0];
+      fn( p + 1, num_gates, p[1u + 2u * num_gates] );
+      p += 2u + 2u * num_gates;
+    }
+  }
+
+  uint32_t num_structures() const
+  {
+    return _num_structures;
+  }
+
+private:
+  aig_rewrite_library()
+  {
+    xag_npn_resynthesis<aig_network, aig_network> resyn;
+    rewriting_library<aig_network> library( 4u );
+    auto const& npn = npn4_table::instance();
+
+    for ( auto c = 0u; c < npn.num_classes(); ++c )
+    {
+      _offsets.push_back( static_cast<uint32_t>( _data.size() ) );
+
+      kitty::dynamic_truth_table function( 4u );
+      *function.begin() = *npn.class_representative( c ).cbegin();
+      library.foreach_candidate( library.lookup( function, resyn ), [&]( auto const& cand ) {
+        assert( 2u * ( 5u + library.num_gates( cand ) ) <= 0xffu );
+        _data.push_back( static_cast<uint8_t>( library.num_gates( cand ) ) );
+        const auto output = library.foreach_gate( cand, [&]( auto const& gate, uint32_t const* fanins, uint32_t num_fanins ) {
+          (void)gate;
+          assert( num_fanins == 2u );
+          (void)num_fanins;
+          _data.push_back( static_cast<uint8_t>( fanins[0] ) );
+          _data.push_back( static_cast<uint8_t>( fanins[1] ) );
+        } );
+        _data.push_back( static_cast<uint8_t>( output ) );
+        ++_num_structures;
+        return true;
+      } );
+    }
+    _offsets.push_back( static_cast<uint32_t>( _data.size() ) );
+  }
+
+  std::vector<uint32_t> _offsets;
+  std::vector<uint8_t> _data;
+  uint32_t _num_structures{0u};
+};
+
+/* 4-input cut with its function over the leaves, where leaf i is variable i */
+struct aig_rewrite_cut
+{
+  std::array<uint32_t, 4u> leaves;
+  uint64_t signature;
+  uint16_t function;
+  uint8_t size;
+};
+
+/* swaps variables i < j in a 4-input truth table */
+inline uint16_t swap_vars16( uint16_t tt, uint32_t i, uint32_t j )
+{
+  static constexpr uint16_t vars[] = {0xaaaa, 0xcccc, 0xf0f0, 0xff00};
+  const uint16_t up = vars[i] & ~vars[j];
+  const uint16_t down = ~vars[i] & vars[j];
+  const auto shift = ( 1u << j ) - ( 1u << i );
+  return static_cast<uint16_t>( ( tt & ~( up | down ) ) | ( ( tt & up ) << shift ) | ( ( tt & down ) >> shift ) );
+}
+
+template<class Ntk>
+class aig_rewrite_impl
+{
+public:
+  aig_rewrite_impl( Ntk& ntk, aig_rewrite_params const& ps, aig_rewrite_stats& st )
+      : ntk( ntk ),
+        ps( ps ),
+        st( st ),
+        library( aig_rewrite_library::instance() ),
+        npn( npn4_table::instance() ),
+        stride( ps.cut_limit + 1u )
+  {
+  }
+
+  void run()
+  {
+    stopwatch t( st.time_total );
+
+    const auto size = ntk.size();
+    progress_bar pbar{size, "aig_rewrite |{0}| node = {1:>4} / " + std::to_string( size ) + "   est. gain = {2:>5}", ps.progress};
+
+    for ( auto i = 1u; i < size; ++i )
+    {
+      const auto n = ntk.index_to_node( i );
+      if ( ntk.is_ci( n ) || ntk.is_dead( n ) || ntk.fanout_size( n ) == 0u )
+      {
+        continue;
+      }
+      pbar( i, i, st.estimated_gain );
+
+      call_with_stopwatch( st.time_cuts, [&]() { compute_cuts( n ); } );
+      call_with_stopwatch( st.time_eval, [&]() { rewrite( n ); } );
+    }
+  }
+
+private:
+  /* evaluates all cuts of `n` and replaces it by the best structure */
+  void rewrite( node<Ntk> const& n )
+  {
+    int32_t best_gain{-1};
+    aig_rewrite_cut const* best_cut{nullptr};
+    uint8_t const* best_gates{nullptr};
+    uint32_t best_num_gates{0u};
+    uint32_t best_output{0u};
+    npn4_config best_config{};
+
+    auto const* cuts = &_cuts[stride * ntk.node_to_index( n )];
+    for ( auto c = 0u; c < _num_cuts[ntk.node_to_index( n )]; ++c )
+    {
+      auto const& cut = cuts[c];
+      if ( cut.size < ps.min_cand_cut_size || cut.size == 1u )
+      {
+        continue;
+      }
+
+      /* cuts computed before earlier substitutions may contain removed nodes */
+      if ( std::any_of( cut.leaves.begin(), cut.leaves.begin() + cut.size, [&]( auto leaf ) { return ntk.is_dead( ntk.index_to_node( leaf ) ); } ) )
+      {
+        continue;
+      }
+
+      /* dereference the MFFC of n bounded by the leaves */
+      for ( auto j = 0u; j < cut.size; ++j )
+      {
+        ntk.incr_fanout_size( ntk.index_to_node( cut.leaves[j] ) );
+      }
+      const int32_t mffc = recursive_deref( n );
+
+      const auto config = npn.config( cut.function );
+      set_inputs( cut, config );
+      library.foreach_structure( npn.class_index( cut.function ), [&]( uint8_t const* gates, uint32_t num_gates, uint32_t output ) {
+        const auto limit = ps.allow_zero_gain ? mffc : mffc - 1;
+        const auto cost = evaluate( n, gates, num_gates, output, limit );
+        if ( cost < 0 )
+        {
+          return;
+        }
+
+        const auto gain = mffc - cost;
+        if ( ( gain > 0 || ( ps.allow_zero_gain && gain == 0 ) ) && gain > best_gain )
+        {
+          best_gain = gain;
+          best_cut = &cut;
+          best_gates = gates;
+          best_num_gates = num_gates;
+          best_output = output;
+          best_config = config;
+        }
+      } );
+
+      recursive_ref( n );
+      for ( auto j = 0u; j < cut.size; ++j )
+      {
+        ntk.decr_fanout_size( ntk.index_to_node( cut.leaves[j] ) );
+      }
+    }
+
+    if ( best_gain == -1 )
+    {
+      return;
+    }
+
+    /* the copy of the cut may be overwritten when cuts of new nodes are computed */
+    const auto cut = *best_cut;
+    set_inputs( cut, best_config );
+    for ( auto j = 0u; j < best_num_gates; ++j )
+    {
+      _signals[5u + j] = ntk.create_and( literal_to_signal( best_gates[2u * j] ), literal_to_signal( best_gates[2u * j + 1u] ) );
+    }
+    const auto f = literal_to_signal( best_output ) ^ ( ( best_config.phase >> 4u ) & 1u );
+    if ( ntk.get_node( f ) == n )
+    {
+      return;
+    }
+
+    ++st.num_rewrites;
+    st.estimated_gain += best_gain;
+    ntk.substitute_node( n, f );
+  }
+
+  /* returns the number of new gates of a structure, or -1 if the structure
+   * contains n or needs more than `limit` new gates */
+  int32_t evaluate( node<Ntk> const& n, uint8_t const* gates, uint32_t num_gates, uint32_t output, int32_t limit )
+  {
+    int32_t cost{0};
+    ntk.incr_trav_id();
+    for ( auto j = 0u; j < num_gates; ++j )
+    {
+      const auto a = gates[2u * j];
+      const auto b = gates[2u * j + 1u];
+      _virtual[5u + j] = true;
+      if ( !_virtual[a >> 1u] && !_virtual[b >> 1u] )
+      {
+        if ( const auto f = ntk.has_and( literal_to_signal( a ), literal_to_signal( b ) ) )
+        {
+          const auto g = ntk.get_node( *f );
+          if ( g == n )
+          {
+            return -1;
+          }
+          if ( !ntk.is_constant( g ) && !ntk.is_ci( g ) && ntk.fanout_size( g ) == 0u && ntk.visited( g ) != ntk.trav_id() )
+          {
+            /* the gate exists but is in the MFFC */
+            ntk.set_visited( g, ntk.trav_id() );
+            ++cost;
+          }
+          _signals[5u + j] = *f;
+          _virtual[5u + j] = false;
+          continue;
+        }
+      }
+      if ( ++cost > limit )
+      {
+        return -1;
+      }
+    }
+    if ( cost > limit || ( !_virtual[output >> 1u] && ntk.get_node( literal_to_signal( output ) ) == n ) )
+    {
+      return -1;
+    }
+    return cost;
+  }
+
+  /* maps the inputs of the representative to the leaves of a cut */
+  void set_inputs( aig_rewrite_cut const& cut, npn4_config const& config )
+  {
+    _signals[0] = ntk.get_constant( false );
+    _virtual[0] = false;
+    for ( auto i = 0u; i < 4u; ++i )
+    {
+      const auto leaf = config.perm[i];
+      const auto s = leaf < cut.size ? ntk.make_signal( ntk.index_to_node( cut.leaves[leaf] ) ) : ntk.get_constant( false );
+      _signals[1u + i] = s ^ ( ( config.phase >> leaf ) & 1u );
+      _virtual[1u + i] = false;
+    }
+  }
+
+  signal<Ntk> literal_to_signal( uint32_t lit ) const
+  {
+    return _signals[lit >> 1u] ^ ( lit & 1u );
+  }
+
+  uint32_t recursive_deref( node<Ntk> const& n )
+  {
+    uint32_t value{1u};
+    ntk.foreach_fanin( n, [&]( auto const& s ) {
+      const auto g = ntk.get_node( s );
+      if ( !ntk.is_ci( g ) && !ntk.is_constant( g ) && ntk.decr_fanout_size( g ) == 0u )
+      {
+        value += recursive_deref( g );
+      }
+    } );
+    return value;
+  }
+
+  uint32_t recursive_ref( node<Ntk> const& n )
+  {
+    uint32_t value{1u};
+    ntk.foreach_fanin( n, [&]( auto const& s ) {
+      const auto g = ntk.get_node( s );
+      if ( !ntk.is_ci( g ) && !ntk.is_constant( g ) && ntk.incr_fanout_size( g ) == 0u )
+      {
+        value += recursive_ref( g );
+      }
+    } );
+    return value;
+  }
+
+  /* computes the cuts of `n` from the cuts of its fanins, which are computed if necessary */
+  void compute_cuts( node<Ntk> const& n )
+  {
+    const auto index = ntk.node_to_index( n );
+    if ( _num_cuts.size() <= index )
+    {
+      _num_cuts.resize( ntk.size(), 0u );
+      _cuts.resize( stride * ntk.size() );
+    }
+    if ( _num_cuts[index] != 0u )
+    {
+      return;
+    }
+
+    if ( ntk.is_constant( n ) )
+    {
+      _cuts[stride * index] = {{}, 0u, 0x0000, 0u};
+      _num_cuts[index] = 1u;
+      return;
+    }
+    if ( ntk.is_ci( n ) )
+    {
+      add_trivial_cut( index, 0u );
+      _num_cuts[index] = 1u;
+      return;
+    }
+
+    std::array<signal<Ntk>, 2u> fanins;
+    ntk.foreach_fanin( n, [&]( auto const& s, auto i ) {
+      fanins[i] = s;
+    } );
+    compute_cuts( ntk.get_node( fanins[0] ) );
+    compute_cuts( ntk.get_node( fanins[1] ) );
+
+    const auto i0 = ntk.node_to_index( ntk.get_node( fanins[0] ) );
+    const auto i1 = ntk.node_to_index( ntk.get_node( fanins[1] ) );
+    auto* set = &_cuts[stride * index];
+    uint32_t num_cuts{0u};
+
+    for ( auto c0 = 0u; c0 < _num_cuts[i0]; ++c0 )
+    {
+      for ( auto c1 = 0u; c1 < _num_cuts[i1]; ++c1 )
+      {
+        auto const& cut0 = _cuts[stride * i0 + c0];
+        auto const& cut1 = _cuts[stride * i1 + c1];
+
+        aig_rewrite_cut cut;
+        if ( !merge( cut0, cut1, cut ) )
+        {
+          continue;
+        }
+
+        const uint16_t tt0 = expand( cut0, cut ) ^ ( ntk.is_complemented( fanins[0] ) ? 0xffff : 0x0000 );
+        const uint16_t tt1 = expand( cut1, cut ) ^ ( ntk.is_complemented( fanins[1] ) ? 0xffff : 0x0000 );
+        cut.function = tt0 & tt1;
+
+        insert( set, num_cuts, cut );
+      }
+    }
+
+    add_trivial_cut( index, num_cuts );
+    _num_cuts[index] = num_cuts + 1u;
+  }
+
+  void add_trivial_cut( uint32_t index, uint32_t position )
+  {
+    auto& cut = _cuts[stride * index + position];
+    cut.leaves[0] = index;
+    cut.signature = uint64_t( 1u ) << ( index % 64u );
+    cut.function = 0xaaaa;
+    cut.size = 1u;
+  }
+
+  /* merges the leaves of two cuts, returns false if there are more than 4 */
+  static bool merge( aig_rewrite_cut const& cut0, aig_rewrite_cut const& cut1, aig_rewrite_cut& cut )
+  {
+    auto const sign = cut0.signature | cut1.signature;
+    if ( uint32_t( __builtin_popcount( static_cast<uint32_t>( sign & 0xffffffff ) ) ) + uint32_t( __builtin_popcount( static_cast<uint32_t>( sign >> 32 ) ) ) > 4u )
+    {
+      return false;
+    }
+
+    auto i = 0u, j = 0u, k = 0u;
+    while ( i < cut0.size || j < cut1.size )
+    {
+      if ( k == 4u )
+      {
+        return false;
+      }
+      if ( j == cut1.size || ( i < cut0.size && cut0.leaves[i] < cut1.leaves[j] ) )
+      {
+        cut.leaves[k++] = cut0.leaves[i++];
+      }
+      else if ( i == cut0.size || cut1.leaves[j] < cut0.leaves[i] )
+      {
+        cut.leaves[k++] = cut1.leaves[j++];
+      }
+      else
+      {
+        cut.leaves[k++] = cut0.leaves[i++];
+        ++j;
+      }
+    }
+    cut.size = static_cast<uint8_t>( k );
+    cut.signature = cut0.signature | cut1.signature;
+    return true;
+  }
+
+  /* expresses the function of `sub` over the leaves of `cut` */
+  static uint16_t expand( aig_rewrite_cut const& sub, aig_rewrite_cut const& cut )
+  {
+    std::array<uint32_t, 4u> pos{};
+    for ( auto j = 0u, k = 0u; j < sub.size; ++j )
+    {
+      while ( cut.leaves[k] != sub.leaves[j] )
+      {
+        ++k;
+      }
+      pos[j] = k;
+    }
+
+    /* move variables from the highest one down, such that the target variable is always unused */
+    auto tt = sub.function;
+    for ( auto j = sub.size; j-- > 0u; )
+    {
+      if ( pos[j] != j )
+      {
+        tt = swap_vars16( tt, j, pos[j] );
+      }
+    }
+    return tt;
+  }
+
+  static bool is_subset( aig_rewrite_cut const& sub, aig_rewrite_cut const& cut )
+  {
+    if ( sub.size > cut.size || ( sub.signature & cut.signature ) != sub.signature )
+    {
+      return false;
+    }
+    return std::includes( cut.leaves.begin(), cut.leaves.begin() + cut.size, sub.leaves.begin(), sub.leaves.begin() + sub.size );
+  }
+
+  /* inserts a cut unless it is dominated, removes the cuts it dominates, and
+   * prefers smaller cuts when the set is full */
+  void insert( aig_rewrite_cut* set, uint32_t& num_cuts, aig_rewrite_cut const& cut ) const
+  {
+    for ( auto i = 0u; i < num_cuts; ++i )
+    {
+      if ( is_subset( set[i], cut ) )
+      {
+        return;
+      }
+    }
+
+    auto k = 0u;
+    for ( auto i = 0u; i < num_cuts; ++i )
+    {
+      if ( !is_subset( cut, set[i] ) )
+      {
+        set[k++] = set[i];
+      }
+    }
+    num_cuts = k;
+
+    if ( num_cuts < ps.cut_limit )
+    {
+      set[num_cuts++] = cut;
+      return;
+    }
+
+    auto largest = std::max_element( set, set + num_cuts, []( auto const& a, auto const& b ) { return a.size < b.size; } );
+    if ( largest->size > cut.size )
+    {
+      *largest = cut;
+    }
+  }
+
+private:
+  Ntk& ntk;
+  aig_rewrite_params const& ps;
+  aig_rewrite_stats& st;
+
+  aig_rewrite_library const& library;
+  npn4_table const& npn;
+
+  uint32_t stride;
+  std::vector<aig_rewrite_cut> _cuts;
+  std::vector<uint8_t> _num_cuts;
+
+  std::array<signal<Ntk>, 256u> _signals;
+  std::array<bool, 256u> _virtual{};
+};
+
+} /* namespace detail */
+
+/*! \brief DAG-aware in-place rewriting of AIGs.
+ *
+ * This algorithm is a fast variant of `cut_rewriting` for AIGs, in the style
+ * of the `rewrite` command in ABC.  The nodes are visited in topological
+ * order, and for each node all 4-input cuts are enumerated with their
+ * functions as 16-bit truth tables.  The function of each cut is mapped to
+ * its NPN class with a precomputed table, and all structures of the AIG
+ * database of `xag_npn_resynthesis` for that class are evaluated against the
+ * MFFC of the node by looking up their gates in the structural hash table,
+ * without creating them.  The best structure replaces the node immediately,
+ * so that later nodes are rewritten in the updated network.
+ *
+ * Only the structures that replace a node are added to the network, and the
+ * replaced nodes are removed.  Since new gates are appended, the node indices
+ * are no longer in topological order afterwards.  Call `cleanup_dangling` to
+ * remove dead nodes and to restore the order.
+ *
+ * **Required network functions:**
+ * - `has_and`
+ * - `create_and`
+ * - `substitute_node`
+ * - `incr_fanout_size`
+ * - `decr_fanout_size`
+ * - `is_dead`
+ *
+ * \param ntk AIG (will be modified)
+ * \param ps Rewriting params
+ * \param pst Rewriting statistics
+ */
+template<class Ntk>
+void aig_rewrite( Ntk& ntk, aig_rewrite_params const& ps = {}, aig_rewrite_stats* pst = nullptr )
+{
+  static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
+  static_assert( std::is_same_v<typename Ntk::base_type, aig_network>, "Ntk is not an AIG" );
+  static_assert( has_has_and_v<Ntk>, "Ntk does not implement the has_and method" );
+  static_assert( has_create_and_v<Ntk>, "Ntk does not implement the create_and method" );
+  static_assert( has_substitute_node_v<Ntk>, "Ntk does not implement the substitute_node method" );
+  static_assert( has_incr_fanout_size_v<Ntk>, "Ntk does not implement the incr_fanout_size method" );
+  static_assert( has_decr_fanout_size_v<Ntk>, "Ntk does not implement the decr_fanout_size method" );
+
+  aig_rewrite_stats st;
+
+  /* the fanout view registers event handlers, which are removed afterwards */
+  auto& events = ntk.events();
+  const auto num_on_add = events.on_add.size();
+  const auto num_on_modified = events.on_modified.size();
+  const auto num_on_delete = events.on_delete.size();
+  {
+    fanout_view<Ntk> ntk_fo{ntk};
+    detail::aig_rewrite_impl<fanout_view<Ntk>> p( ntk_fo, ps, st );
+    p.run();
+  }
+  events.on_add.resize( num_on_add );
+  events.on_modified.resize( num_on_modified );
+  events.on_delete.resize( num_on_delete );
+
+  if ( ps.verbose )
+  {
+    st.report();
+  }
+
+  if ( pst )
+  {
+    *pst = st;
+  }
+}
+
+} /* namespace mockturtle */
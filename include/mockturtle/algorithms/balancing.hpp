@@ -32,21 +32,25 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 #include <functional>
 #include <limits>
 #include <memory>
 #include <optional>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include <fmt/format.h>
 #include <kitty/dynamic_truth_table.hpp>
+#include <kitty/operations.hpp>
 
 #include "../utils/cost_functions.hpp"
 #include "../utils/node_map.hpp"
 #include "../utils/progress_bar.hpp"
 #include "../utils/stopwatch.hpp"
+#include "../utils/thread_pool.hpp"
 #include "../views/depth_view.hpp"
 #include "../views/topo_view.hpp"
 #include "cleanup.hpp"
@@ -65,6 +69,18 @@ struct balancing_params
   /*! \brief Optimize only on critical path. */
   bool only_on_critical_path{false};
 
+  /*! \brief Number of threads (0 = default number of threads).
+   *
+   * When this parameter is not 1, the nodes of each level are rebalanced in
+   * parallel, each thread calling (its own copy of) the rebalancing function
+   * on a scratch network.  The best candidate of each node is then copied
+   * into the result in topological order, so the result does not depend on
+   * the number of threads.  The rebalancing function must be safe to call
+   * concurrently on different networks and must not depend on the network
+   * it creates the candidate in beyond the given arrival times.
+   */
+  uint32_t num_threads{1u};
+
   /*! \brief Show progress. */
   bool progress{false};
 
@@ -130,6 +146,18 @@ struct balancing_impl
   }
 
   Ntk run()
+  {
+    /* functions of small cuts are stored inline in the cuts */
+    if ( ps_.cut_enumeration_ps.cut_size <= 6u )
+    {
+      return run( [this]() { return fast_cut_enumeration<Ntk, 6, true>( ntk_, ps_.cut_enumeration_ps, &st_.cut_enumeration_st ); } );
+    }
+    return run( [this]() { return cut_enumeration<Ntk, true>( ntk_, ps_.cut_enumeration_ps, &st_.cut_enumeration_st ); } );
+  }
+
+private:
+  template<class EnumerateCutsFn>
+  Ntk run( EnumerateCutsFn&& enumerate_cuts )
   {
     Ntk dest;
     node_map<arrival_time_pair<Ntk>, Ntk> old_to_new( ntk_ );
@@ -150,33 +178,133 @@ struct balancing_impl
       depth_ntk = std::make_shared<depth_view<Ntk, CostFn>>( ntk_ );
     }
 
-    stopwatch<> t( st_.time_total );
-    const auto cuts = cut_enumeration<Ntk, true>( ntk_, ps_.cut_enumeration_ps, &st_.cut_enumeration_st );
+    stopwatch<> t( st_.time_total, "balancing" );
+    const auto cuts = enumerate_cuts();
 
-    uint32_t current_level{};
-    const auto size = ntk_.size();
-    progress_bar pbar{ntk_.size(), "balancing |{0}| node = {1:>4} / " + std::to_string( size ) + "   current level = {2}", ps_.progress};
-    topo_view<Ntk>{ntk_}.foreach_node( [&]( auto const& n, auto index ) {
-      pbar( index, index, current_level );
+    if ( ps_.num_threads != 1u )
+    {
+      run_parallel( dest, cuts, old_to_new, depth_ntk.get() );
+    }
+    else
+    {
+      uint32_t current_level{};
+      const auto size = ntk_.size();
+      progress_bar pbar{ntk_.size(), "balancing |{0}| node = {1:>4} / " + std::to_string( size ) + "   current level = {2}", ps_.progress};
+      topo_view<Ntk>{ntk_}.foreach_node( [&]( auto const& n, auto index ) {
+        pbar( index, index, current_level );
+
+        if ( ntk_.is_constant( n ) || ntk_.is_pi( n ) )
+        {
+          return;
+        }
+
+        if ( ps_.only_on_critical_path && !depth_ntk->is_on_critical_path( n ) )
+        {
+          std::vector<signal<Ntk>> children;
+          ntk_.foreach_fanin( n, [&]( auto const& f ) {
+            const auto f_best = old_to_new[f].f;
+            children.push_back( ntk_.is_complemented( f ) ? dest.create_not( f_best ) : f_best );
+          });
+          old_to_new[n] = {dest.clone_node( ntk_, n, children ), depth_ntk->level( n )};
+          return;
+        }
+
+        arrival_time_pair<Ntk> best{{}, std::numeric_limits<uint32_t>::max()};
+        uint32_t best_size{};
+        for ( auto& cut : cuts.cuts( ntk_.node_to_index( n ) ) )
+        {
+          if ( cut->size() == 1u || kitty::is_const0( cuts.truth_table( *cut ) ) )
+          {
+            continue;
+          }
+
+          std::vector<arrival_time_pair<Ntk>> arrival_times( cut->size() );
+          std::transform( cut->begin(), cut->end(), arrival_times.begin(), [&]( auto leaf ) { return old_to_new[ntk_.index_to_node( leaf )]; });
 
-      if ( ntk_.is_constant( n ) || ntk_.is_pi( n ) )
+          rebalancing_fn_( dest, cut_function( cuts, *cut ), arrival_times, best.level, best_size, [&]( arrival_time_pair<Ntk> const& cand, uint32_t cand_size ) {
+            if ( cand.level < best.level || ( cand.level == best.level && cand_size < best_size ) )
+            {
+              best = cand;
+              best_size = cand_size;
+            }
+          });
+        }
+        old_to_new[n] = best;
+        current_level = std::max( current_level, best.level );
+      } );
+    }
+
+    ntk_.foreach_po( [&]( auto const& f ) {
+      const auto s = old_to_new[f].f;
+      dest.create_po( ntk_.is_complemented( f ) ? dest.create_not( s ) : s );
+    } );
+
+    return cleanup_dangling( dest );
+  }
+
+private:
+  struct balancing_candidate
+  {
+    arrival_time_pair<Ntk> best{{}, std::numeric_limits<uint32_t>::max()};
+    uint32_t best_size{};
+    std::vector<uint64_t> leaves;
+    uint32_t worker{};
+  };
+
+  /* each thread creates candidates in its own network, whose first PIs are the cut leaves */
+  struct balancing_worker
+  {
+    explicit balancing_worker( uint32_t num_leaves, rebalancing_function_t<Ntk> const& fn )
+        : rebalancing_fn( fn )
+    {
+      for ( auto i = 0u; i < num_leaves; ++i )
       {
-        return;
+        leaves.push_back( scratch.create_pi() );
       }
+    }
+
+    Ntk scratch;
+    std::vector<signal<Ntk>> leaves;
+    rebalancing_function_t<Ntk> rebalancing_fn;
+  };
+
+  /* functions of small cuts have 6 variables and are shrunk to the cut size */
+  template<class Cuts>
+  static kitty::dynamic_truth_table cut_function( Cuts const& cuts, typename Cuts::cut_t const& cut )
+  {
+    if constexpr ( std::is_same_v<typename Cuts::truth_table_t, kitty::dynamic_truth_table> )
+    {
+      return cuts.truth_table( cut );
+    }
+    else
+    {
+      kitty::dynamic_truth_table tt( cut.size() );
+      kitty::shrink_to_inplace( tt, cuts.truth_table( cut ) );
+      return tt;
+    }
+  }
+
+  template<class Cuts>
+  void run_parallel( Ntk& dest, Cuts const& cuts, node_map<arrival_time_pair<Ntk>, Ntk>& old_to_new, depth_view<Ntk, CostFn> const* depth_ntk )
+  {
+    auto const levels = levelize( ntk_ );
+    uint32_t const num_threads = resolve_num_threads( ps_.num_threads );
+    uint32_t current_level{};
+    uint32_t done{};
+    progress_bar pbar{static_cast<uint32_t>( ntk_.size() ), "balancing |{0}| node = {1:>4} / " + std::to_string( ntk_.size() ) + "   current level = {2}", ps_.progress};
 
+    std::vector<balancing_candidate> candidates( levels.empty() ? 0u : levels.front().size() );
+    per_thread<balancing_worker> workers( num_threads, [&]() { return std::make_unique<balancing_worker>( ps_.cut_enumeration_ps.cut_size, rebalancing_fn_ ); } );
+
+    const auto rebalance_node = [&]( node<Ntk> const& n, uint64_t i, uint32_t t ) {
       if ( ps_.only_on_critical_path && !depth_ntk->is_on_critical_path( n ) )
       {
-        std::vector<signal<Ntk>> children;
-        ntk_.foreach_fanin( n, [&]( auto const& f ) {
-          const auto f_best = old_to_new[f].f;
-          children.push_back( ntk_.is_complemented( f ) ? dest.create_not( f_best ) : f_best );
-        });
-        old_to_new[n] = {dest.clone_node( ntk_, n, children ), depth_ntk->level( n )};
         return;
       }
 
-      arrival_time_pair<Ntk> best{{}, std::numeric_limits<uint32_t>::max()};
-      uint32_t best_size{};
+      auto& w = workers[t];
+      auto& cand = candidates[i];
+      cand.worker = t;
       for ( auto& cut : cuts.cuts( ntk_.node_to_index( n ) ) )
       {
         if ( cut->size() == 1u || kitty::is_const0( cuts.truth_table( *cut ) ) )
@@ -184,27 +312,99 @@ struct balancing_impl
           continue;
         }
 
-        std::vector<arrival_time_pair<Ntk>> arrival_times( cut->size() );
-        std::transform( cut->begin(), cut->end(), arrival_times.begin(), [&]( auto leaf ) { return old_to_new[ntk_.index_to_node( leaf )]; });
+        std::vector<arrival_time_pair<Ntk>> arrival_times;
+        for ( auto leaf : *cut )
+        {
+          arrival_times.push_back( {w.leaves[arrival_times.size()], old_to_new[ntk_.index_to_node( leaf )].level} );
+        }
 
-        rebalancing_fn_( dest, cuts.truth_table( *cut ), arrival_times, best.level, best_size, [&]( arrival_time_pair<Ntk> const& cand, uint32_t cand_size ) {
-          if ( cand.level < best.level || ( cand.level == best.level && cand_size < best_size ) )
+        w.rebalancing_fn( w.scratch, cut_function( cuts, *cut ), arrival_times, cand.best.level, cand.best_size, [&]( arrival_time_pair<Ntk> const& c, uint32_t c_size ) {
+          if ( c.level < cand.best.level || ( c.level == cand.best.level && c_size < cand.best_size ) )
           {
-            best = cand;
-            best_size = cand_size;
+            cand.best = c;
+            cand.best_size = c_size;
+            cand.leaves.assign( cut->begin(), cut->end() );
           }
-        });
+        } );
       }
-      old_to_new[n] = best;
-      current_level = std::max( current_level, best.level );
-    } );
+    };
 
-    ntk_.foreach_po( [&]( auto const& f ) {
-      const auto s = old_to_new[f].f;
-      dest.create_po( ntk_.is_complemented( f ) ? dest.create_not( s ) : s );
-    } );
+    const auto replay_level = [&]( uint32_t l ) {
+      auto const& nodes = levels[l];
+      pbar( done, done, current_level );
+      done += static_cast<uint32_t>( nodes.size() );
 
-    return cleanup_dangling( dest );
+      /* replay the best candidates in topological order */
+      for ( auto i = 0u; i < nodes.size(); ++i )
+      {
+        auto const& n = nodes[i];
+        if ( ps_.only_on_critical_path && !depth_ntk->is_on_critical_path( n ) )
+        {
+          std::vector<signal<Ntk>> children;
+          ntk_.foreach_fanin( n, [&]( auto const& f ) {
+            const auto f_best = old_to_new[f].f;
+            children.push_back( ntk_.is_complemented( f ) ? dest.create_not( f_best ) : f_best );
+          } );
+          old_to_new[n] = {dest.clone_node( ntk_, n, children ), depth_ntk->level( n )};
+          continue;
+        }
+
+        auto const& cand = candidates[i];
+        if ( cand.leaves.empty() )
+        {
+          old_to_new[n] = cand.best;
+          continue;
+        }
+
+        std::vector<signal<Ntk>> children;
+        for ( auto leaf : cand.leaves )
+        {
+          children.push_back( old_to_new[ntk_.index_to_node( leaf )].f );
+        }
+        std::unordered_map<node<Ntk>, signal<Ntk>> copies;
+        old_to_new[n] = {copy_candidate( dest, workers[cand.worker], cand.best.f, children, copies ), cand.best.level};
+        current_level = std::max( current_level, cand.best.level );
+      }
+
+      /* reset the scratch networks and candidates for the next level */
+      workers.clear();
+      candidates.assign( l + 1u < levels.size() ? levels[l + 1u].size() : 0u, balancing_candidate{} );
+    };
+
+    wavefront( levels, rebalance_node, replay_level, num_threads );
+  }
+
+  /* copies the cone of `f` from a scratch network into `dest`, on top of `children` */
+  signal<Ntk> copy_candidate( Ntk& dest, balancing_worker const& w, signal<Ntk> const& f, std::vector<signal<Ntk>> const& children, std::unordered_map<node<Ntk>, signal<Ntk>>& copies ) const
+  {
+    auto const& scratch = w.scratch;
+    auto const n = scratch.get_node( f );
+
+    signal<Ntk> s;
+    if ( scratch.is_constant( n ) )
+    {
+      s = dest.get_constant( scratch.constant_value( n ) );
+    }
+    else if ( scratch.is_pi( n ) )
+    {
+      /* the scratch PIs are created right after the constants */
+      s = children[scratch.node_to_index( n ) - scratch.node_to_index( scratch.get_node( w.leaves.front() ) )];
+    }
+    else if ( auto it = copies.find( n ); it != copies.end() )
+    {
+      s = it->second;
+    }
+    else
+    {
+      std::vector<signal<Ntk>> fanins;
+      scratch.foreach_fanin( n, [&]( auto const& fi ) {
+        fanins.push_back( copy_candidate( dest, w, fi, children, copies ) );
+      } );
+      s = dest.clone_node( scratch, n, fanins );
+      copies.emplace( n, s );
+    }
+
+    return scratch.is_complemented( f ) ? dest.create_not( s ) : s;
   }
 
 private:
@@ -34,16 +34,15 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <memory>
 #include <queue>
 #include <tuple>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include <kitty/cube.hpp>
 #include <kitty/dynamic_truth_table.hpp>
 #include <kitty/esop.hpp>
-#include <kitty/hash.hpp>
 #include <kitty/operations.hpp>
 #include <kitty/spp.hpp>
 
@@ -206,25 +205,23 @@ private:
   std::vector<kitty::cube> create_sop_form( kitty::dynamic_truth_table const& func ) const
   {
     stopwatch<> t( time_sop );
-    if ( auto it = sop_hash_.find( func ); it != sop_hash_.end() )
-    {
-      sop_cache_hits++;
-      return it->second;
-    }
-    else
-    {
-      sop_cache_misses++;
-      return sop_hash_[func] = mockturtle::exorcism( func ); // TODO generalize
-    }
+    bool computed{false};
+    auto cover = covers->get( func, [&]( kitty::dynamic_truth_table const& f ) {
+      computed = true;
+      return mockturtle::exorcism( f ); // TODO generalize
+    } );
+    ++( computed ? sop_cache_misses : sop_cache_hits );
+    return cover;
   }
 
-private:
-  mutable std::unordered_map<kitty::dynamic_truth_table, std::vector<kitty::cube>, kitty::hash<kitty::dynamic_truth_table>> sop_hash_;
-
 public:
   bool spp_optimization{false};
   bool mux_optimization{false};
 
+public:
+  /*! \brief Covers of cut functions, shared by all copies of this function. */
+  std::shared_ptr<cover_cache> covers = std::make_shared<cover_cache>();
+
 public:
   mutable uint32_t sop_cache_hits{};
   mutable uint32_t sop_cache_misses{};
@@ -34,16 +34,15 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <memory>
 #include <queue>
 #include <tuple>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include <kitty/cube.hpp>
 #include <kitty/dynamic_truth_table.hpp>
 #include <kitty/isop.hpp>
-#include <kitty/hash.hpp>
 #include <kitty/operations.hpp>
 
 #include "../../traits.hpp"
@@ -126,20 +125,18 @@ private:
   std::vector<kitty::cube> create_sop_form( kitty::dynamic_truth_table const& func ) const
   {
     stopwatch<> t( time_sop );
-    if ( auto it = sop_hash_.find( func ); it != sop_hash_.end() )
-    {
-      sop_cache_hits++;
-      return it->second;
-    }
-    else
-    {
-      sop_cache_misses++;
-      return sop_hash_[func] = kitty::isop( func ); // TODO generalize
-    }
+    bool computed{false};
+    auto cover = covers->get( func, [&]( kitty::dynamic_truth_table const& f ) {
+      computed = true;
+      return kitty::isop( f ); // TODO generalize
+    } );
+    ++( computed ? sop_cache_misses : sop_cache_hits );
+    return cover;
   }
 
-private:
-  mutable std::unordered_map<kitty::dynamic_truth_table, std::vector<kitty::cube>, kitty::hash<kitty::dynamic_truth_table>> sop_hash_;
+public:
+  /*! \brief Covers of cut functions, shared by all copies of this function. */
+  std::shared_ptr<cover_cache> covers = std::make_shared<cover_cache>();
 
 public:
   mutable uint32_t sop_cache_hits{};
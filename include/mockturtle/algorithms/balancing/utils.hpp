@@ -32,7 +32,18 @@
 
 #pragma once
 
+#include <cstdint>
+#include <mutex>
 #include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <kitty/cube.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/hash.hpp>
+#include <kitty/npn.hpp>
+#include <kitty/operators.hpp>
 
 #include "../../traits.hpp"
 
@@ -51,4 +62,158 @@ struct arrival_time_compare
 template<class Ntk>
 using arrival_time_queue = std::priority_queue<arrival_time_pair<Ntk>, std::vector<arrival_time_pair<Ntk>>, arrival_time_compare<Ntk>>;
 
+/*! \brief Memo table for covers of cut functions.
+ *
+ * Stores the SOP or ESOP covers that rebalancing functions derive for cut
+ * functions.  A cover is first looked up by the function itself.  If it is
+ * not found, the function is canonized using flip-swap NPN canonization and
+ * the cover is looked up by the class representative; only if this fails as
+ * well, the cover is computed, and it is computed for the representative.
+ * The cover of the representative is mapped to the cover of the function by
+ * applying the input permutation and input negations of the canonization to
+ * the cubes.  Since the cover of a function does not determine a cover of
+ * its complement, the representative is complemented if the canonization
+ * negates the output.
+ *
+ * Rebalancing functions share the cache among all their copies, i.e., all
+ * calls in a balancing run and in subsequent runs with the same rebalancing
+ * function.  The cache is thread-safe; covers are computed without holding
+ * its lock, such that two threads may compute the same cover.
+ */
+class cover_cache
+{
+public:
+  /*! \brief Returns the cover of a function.
+   *
+   * The function `compute` is called to compute the cover of a function that
+   * is not in the cache.
+   */
+  template<class Fn>
+  std::vector<kitty::cube> get( kitty::dynamic_truth_table const& func, Fn&& compute )
+  {
+    /* the lock is released while canonizing and computing covers */
+    std::unique_lock<std::mutex> lock( _mutex );
+    if ( const auto it = _covers.find( func ); it != _covers.end() )
+    {
+      ++_hits;
+      return it->second;
+    }
+
+    if ( !_use_classes )
+    {
+      ++_misses;
+      lock.unlock();
+      auto cover = compute( func );
+      lock.lock();
+      return _covers.emplace( func, cover ).first->second;
+    }
+    lock.unlock();
+
+    const auto [repr, phase, perm] = kitty::flip_swap_npn_canonization( func );
+    const auto num_vars = func.num_vars();
+    const auto key = ( ( phase >> num_vars ) & 1 ) ? ~repr : repr;
+
+    lock.lock();
+    auto it = _class_covers.find( key );
+    if ( it == _class_covers.end() )
+    {
+      ++_misses;
+      lock.unlock();
+      auto class_cover = compute( key );
+      lock.lock();
+      it = _class_covers.emplace( key, class_cover ).first;
+    }
+    else
+    {
+      ++_class_hits;
+    }
+    auto cover = it->second;
+    lock.unlock();
+
+    /* same transformations as in kitty::create_from_npn_config */
+    auto p = perm;
+    for ( auto i = 0u; i < num_vars; ++i )
+    {
+      if ( p[i] == i )
+      {
+        continue;
+      }
+
+      auto k = i;
+      while ( p[k] != i )
+      {
+        ++k;
+      }
+
+      for ( auto& cube : cover )
+      {
+        swap_variables( cube, i, k );
+      }
+      std::swap( p[i], p[k] );
+    }
+
+    for ( auto& cube : cover )
+    {
+      cube._bits ^= phase & cube._mask & ( ( 1u << num_vars ) - 1u );
+    }
+
+    lock.lock();
+    _covers.emplace( func, cover );
+    return cover;
+  }
+
+  /*! \brief Enables or disables the lookup by NPN class (enabled by default). */
+  void set_use_classes( bool use_classes )
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    _use_classes = use_classes;
+  }
+
+  /*! \brief Removes all covers. */
+  void clear()
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    _covers.clear();
+    _class_covers.clear();
+  }
+
+  /*! \brief Number of functions found in the cache. */
+  uint32_t hits() const { return _hits; }
+
+  /*! \brief Number of functions whose cover was derived from the cover of their class representative. */
+  uint32_t class_hits() const { return _class_hits; }
+
+  /*! \brief Number of computed covers. */
+  uint32_t misses() const { return _misses; }
+
+  /*! \brief Number of functions in the cache. */
+  uint32_t size() const { return static_cast<uint32_t>( _covers.size() ); }
+
+  /*! \brief Number of class representatives in the cache. */
+  uint32_t num_classes() const { return static_cast<uint32_t>( _class_covers.size() ); }
+
+private:
+  static void swap_variables( kitty::cube& cube, uint32_t i, uint32_t k )
+  {
+    const auto swap_bits = []( uint32_t w, uint32_t i, uint32_t k ) {
+      const auto d = ( ( w >> i ) ^ ( w >> k ) ) & 1u;
+      return w ^ ( ( d << i ) | ( d << k ) );
+    };
+    cube._bits = swap_bits( cube._bits, i, k );
+    cube._mask = swap_bits( cube._mask, i, k );
+  }
+
+private:
+  using cover_map_t = std::unordered_map<kitty::dynamic_truth_table, std::vector<kitty::cube>, kitty::hash<kitty::dynamic_truth_table>>;
+
+  cover_map_t _covers;
+  cover_map_t _class_covers;
+  bool _use_classes{true};
+  std::mutex _mutex;
+
+  uint32_t _hits{};
+  uint32_t _class_hits{};
+  uint32_t _misses{};
+};
+
 } // namespace mockturtle
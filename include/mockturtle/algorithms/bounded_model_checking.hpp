@@ -0,0 +1,489 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2019  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file bounded_model_checking.hpp
+  \brief Bounded model checking of sequential networks
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <vector>
+
+#include <bill/sat/interface/common.hpp>
+#include <fmt/format.h>
+#include <kitty/bit_operations.hpp>
+
+#include "../traits.hpp"
+#include "../utils/node_map.hpp"
+#include "../utils/stopwatch.hpp"
+#include "../views/cnf_view.hpp"
+#include "../views/topo_view.hpp"
+#include "sequential_simulation.hpp"
+
+namespace mockturtle
+{
+
+/*! \brief Parameters for bounded_model_checking.
+ *
+ * The data structure `bounded_model_checking_params` holds configurable
+ * parameters with default arguments for `bounded_model_checking`.
+ */
+struct bounded_model_checking_params
+{
+  /*! \brief Number of time frames (cycles) to check. */
+  uint32_t num_frames{10u};
+
+  /*! \brief Conflict limit for each SAT call (0 means no limit). */
+  uint32_t conflict_limit{0u};
+
+  /*! \brief Try to falsify properties with random simulation first. */
+  bool simulation_filter{true};
+
+  /*! \brief Number of 64-bit words (traces / 64) for the simulation filter. */
+  uint32_t num_sim_words{4u};
+
+  /*! \brief Seed for the simulation filter. */
+  uint64_t random_seed{1u};
+
+  /*! \brief Be verbose. */
+  bool verbose{false};
+};
+
+/*! \brief Statistics for bounded_model_checking. */
+struct bounded_model_checking_stats
+{
+  /*! \brief Total runtime. */
+  stopwatch<>::duration time_total{0};
+
+  /*! \brief Runtime of the simulation filter. */
+  stopwatch<>::duration time_sim{0};
+
+  /*! \brief Runtime of SAT solving. */
+  stopwatch<>::duration time_sat{0};
+
+  /*! \brief Number of unrolled time frames. */
+  uint32_t num_frames{0u};
+
+  /*! \brief Number of properties falsified by simulation. */
+  uint32_t num_sim_falsified{0u};
+
+  /*! \brief Number of SAT calls. */
+  uint32_t num_sat_calls{0u};
+
+  /*! \brief Number of variables in the solver. */
+  uint32_t num_vars{0u};
+
+  /*! \brief Number of clauses in the solver. */
+  uint32_t num_clauses{0u};
+
+  void report() const
+  {
+    std::cout << fmt::format( "[i] frames          = {:>8}\n", num_frames );
+    std::cout << fmt::format( "[i] falsified (sim) = {:>8}\n", num_sim_falsified );
+    std::cout << fmt::format( "[i] SAT calls       = {:>8}\n", num_sat_calls );
+    std::cout << fmt::format( "[i] vars / clauses  = {:>8} / {}\n", num_vars, num_clauses );
+    std::cout << fmt::format( "[i] simulation time = {:>5.2f} secs\n", to_seconds( time_sim ) );
+    std::cout << fmt::format( "[i] SAT time        = {:>5.2f} secs\n", to_seconds( time_sat ) );
+    std::cout << fmt::format( "[i] total time      = {:>5.2f} secs\n", to_seconds( time_total ) );
+  }
+};
+
+/*! \brief Outcome of checking a property. */
+enum class bmc_status
+{
+  /*! \brief The property fails within the bound (a counter-example exists). */
+  falsified,
+  /*! \brief The property holds in all frames up to the bound. */
+  holds,
+  /*! \brief The conflict limit was reached. */
+  unknown
+};
+
+/*! \brief Result of bounded model checking for one property. */
+struct bmc_result
+{
+  bmc_status status{bmc_status::unknown};
+
+  /*! \brief Frame of the failure (falsified), number of checked frames (holds),
+   * or frame in which the conflict limit was reached (unknown). */
+  uint32_t depth{0u};
+
+  /*! \brief Counter-example: values of the primary inputs in frames `0` to `depth`. */
+  std::vector<std::vector<bool>> inputs;
+
+  /*! \brief Counter-example: initial values of all registers. */
+  std::vector<bool> initial_state;
+};
+
+namespace detail
+{
+
+template<class Ntk>
+class bounded_model_checking_impl
+{
+public:
+  using node = typename Ntk::node;
+  using signal = typename Ntk::signal;
+  using solver_view = cnf_view<Ntk>;
+
+  bounded_model_checking_impl( Ntk const& ntk, bounded_model_checking_params const& ps, bounded_model_checking_stats& st )
+      : ntk_( ntk ),
+        ps_( ps ),
+        st_( st ),
+        results_( ntk.num_pos() )
+  {
+    for ( auto& r : results_ )
+    {
+      r.status = bmc_status::holds;
+      r.depth = ps.num_frames;
+    }
+    ntk_.foreach_ro( [&]( auto const& ) { ++num_registers_; } );
+  }
+
+  std::vector<bmc_result> run()
+  {
+    stopwatch t( st_.time_total );
+
+    uint32_t open = ntk_.num_pos();
+    if ( ps_.simulation_filter && ps_.num_frames > 0u )
+    {
+      stopwatch t_sim( st_.time_sim );
+      open -= simulate();
+    }
+
+    if ( open > 0u )
+    {
+      unroll_and_solve();
+    }
+
+    st_.num_vars = solver_.num_vars();
+    st_.num_clauses = solver_.num_clauses();
+    return results_;
+  }
+
+private:
+  /* random simulation; returns the number of falsified properties */
+  uint32_t simulate()
+  {
+    auto const num_words = ps_.num_sim_words;
+    sequential_simulator<Ntk> sim( ntk_, num_words, ps_.random_seed );
+    random_stimuli stimuli( ps_.random_seed + 1u );
+
+    std::vector<std::vector<uint64_t>> pi_words( ps_.num_frames, std::vector<uint64_t>( static_cast<std::size_t>( ntk_.num_pis() ) * num_words ) );
+    std::vector<uint64_t> initial( static_cast<std::size_t>( num_registers_ ) * num_words );
+    std::vector<uint64_t> po_words;
+
+    uint32_t falsified{0u};
+    for ( auto k = 0u; k < ps_.num_frames && falsified < ntk_.num_pos(); ++k )
+    {
+      stimuli( k, num_words, pi_words[k] );
+      sim.step( pi_words[k] );
+      if ( k == 0u )
+      {
+        ntk_.foreach_ro( [&]( auto const& n, auto i ) {
+          std::copy_n( sim.values( n ), num_words, initial.begin() + i * num_words );
+        } );
+      }
+
+      sim.output_values( po_words );
+      for ( auto i = 0u; i < ntk_.num_pos(); ++i )
+      {
+        if ( results_[i].status == bmc_status::falsified )
+        {
+          continue;
+        }
+        for ( auto w = 0u; w < num_words; ++w )
+        {
+          if ( auto const bits = po_words[i * num_words + w]; bits != 0u )
+          {
+            auto const bit = kitty::find_first_bit_in_word( bits );
+            auto const value = [&]( uint64_t const* words ) {
+              return ( ( words[w] >> bit ) & 1u ) != 0u;
+            };
+
+            auto& r = results_[i];
+            r.status = bmc_status::falsified;
+            r.depth = k;
+            r.inputs.resize( k + 1u, std::vector<bool>( ntk_.num_pis() ) );
+            for ( auto j = 0u; j <= k; ++j )
+            {
+              for ( auto p = 0u; p < ntk_.num_pis(); ++p )
+              {
+                r.inputs[j][p] = value( pi_words[j].data() + p * num_words );
+              }
+            }
+            r.initial_state.resize( num_registers_ );
+            for ( auto p = 0u; p < num_registers_; ++p )
+            {
+              r.initial_state[p] = value( initial.data() + p * num_words );
+            }
+
+            ++falsified;
+            ++st_.num_sim_falsified;
+            break;
+          }
+        }
+      }
+    }
+    return falsified;
+  }
+
+  /* time-frame expansion into one incremental solver; returns the number of
+   * properties that are decided (falsified or unknown) */
+  uint32_t unroll_and_solve()
+  {
+    /* gates in topological order, shared by all frames */
+    std::vector<node> gates;
+    topo_view<Ntk>{ntk_}.foreach_gate( [&]( auto const& n ) { gates.push_back( n ); } );
+
+    /* register values at the beginning of the current frame */
+    std::vector<signal> state( num_registers_ );
+    for ( auto i = 0u; i < num_registers_; ++i )
+    {
+      auto const r = ntk_.latch_reset( i );
+      state[i] = r == 0 ? solver_.get_constant( false ) : ( r == 1 ? solver_.get_constant( true ) : solver_.create_pi() );
+      initial_.push_back( state[i] );
+    }
+
+    std::vector<bool> open( ntk_.num_pos() );
+    uint32_t num_open{0u};
+    for ( auto i = 0u; i < ntk_.num_pos(); ++i )
+    {
+      open[i] = results_[i].status != bmc_status::falsified;
+      num_open += open[i] ? 1u : 0u;
+    }
+
+    uint32_t decided{0u};
+    node_map<signal, Ntk> old_to_new( ntk_ );
+    std::vector<signal> children;
+    for ( auto k = 0u; k < ps_.num_frames && num_open > 0u; ++k )
+    {
+      ++st_.num_frames;
+
+      old_to_new[ntk_.get_constant( false )] = solver_.get_constant( false );
+      if ( ntk_.get_node( ntk_.get_constant( true ) ) != ntk_.get_node( ntk_.get_constant( false ) ) )
+      {
+        old_to_new[ntk_.get_constant( true )] = solver_.get_constant( true );
+      }
+      auto& frame_inputs = inputs_.emplace_back();
+      ntk_.foreach_pi( [&]( auto const& n ) {
+        old_to_new[n] = solver_.create_pi();
+        frame_inputs.push_back( old_to_new[n] );
+      } );
+      ntk_.foreach_ro( [&]( auto const& n, auto i ) {
+        old_to_new[n] = state[i];
+      } );
+
+      for ( auto const& n : gates )
+      {
+        children.clear();
+        ntk_.foreach_fanin( n, [&]( auto const& f ) {
+          children.push_back( ntk_.is_complemented( f ) ? solver_.create_not( old_to_new[f] ) : old_to_new[f] );
+        } );
+        old_to_new[n] = solver_.clone_node( ntk_, n, children );
+      }
+
+      auto const mapped = [&]( signal const& f ) {
+        return ntk_.is_complemented( f ) ? solver_.create_not( old_to_new[f] ) : old_to_new[f];
+      };
+
+      /* check properties in this frame, each under its own assumption */
+      ntk_.foreach_po( [&]( auto const& f, auto i ) {
+        if ( !open[i] )
+        {
+          return;
+        }
+
+        auto const bad = mapped( f );
+        if ( solver_.get_node( bad ) == solver_.get_node( solver_.get_constant( false ) ) )
+        {
+          if ( solver_.constant_value( solver_.get_node( bad ) ) != solver_.is_complemented( bad ) )
+          {
+            /* no model is needed, since the output is 1 for all inputs */
+            falsify( i, k, false );
+            open[i] = false;
+            --num_open;
+            ++decided;
+          }
+          return;
+        }
+
+        ++st_.num_sat_calls;
+        std::optional<bool> sat;
+        {
+          stopwatch t_sat( st_.time_sat );
+          sat = solver_.solve( {solver_.lit( bad )}, ps_.conflict_limit );
+        }
+
+        if ( !sat )
+        {
+          results_[i].status = bmc_status::unknown;
+          results_[i].depth = k;
+        }
+        else if ( *sat )
+        {
+          falsify( i, k );
+        }
+        else
+        {
+          /* property holds in this frame; the unit clause helps later frames */
+          solver_.add_clause( bill::result::clause_type{~solver_.lit( bad )} );
+          return;
+        }
+        open[i] = false;
+        --num_open;
+        ++decided;
+      } );
+
+      ntk_.foreach_ri( [&]( auto const& f, auto i ) {
+        state[i] = mapped( f );
+      } );
+    }
+
+    if ( ps_.verbose )
+    {
+      fmt::print( "[i] unrolled {} frames, {} variables, {} clauses\n", st_.num_frames, solver_.num_vars(), solver_.num_clauses() );
+    }
+
+    return decided;
+  }
+
+  /* extracts the counter-example from the last model, or uses arbitrary
+   * values for the inputs if `from_model` is false */
+  void falsify( uint32_t index, uint32_t k, bool from_model = true )
+  {
+    auto& r = results_[index];
+    r.status = bmc_status::falsified;
+    r.depth = k;
+
+    auto const value = [&]( signal const& f ) {
+      auto const n = solver_.get_node( f );
+      if ( solver_.is_constant( n ) )
+      {
+        return solver_.constant_value( n ) != solver_.is_complemented( f );
+      }
+      return from_model && solver_.model_value( f );
+    };
+
+    r.inputs.clear();
+    for ( auto j = 0u; j <= k; ++j )
+    {
+      auto& values = r.inputs.emplace_back();
+      for ( auto const& f : inputs_[j] )
+      {
+        values.push_back( value( f ) );
+      }
+    }
+    r.initial_state.clear();
+    for ( auto const& f : initial_ )
+    {
+      r.initial_state.push_back( value( f ) );
+    }
+  }
+
+private:
+  Ntk const& ntk_;
+  bounded_model_checking_params const& ps_;
+  bounded_model_checking_stats& st_;
+
+  solver_view solver_;
+  uint32_t num_registers_{0u};
+  std::vector<std::vector<signal>> inputs_;
+  std::vector<signal> initial_;
+  std::vector<bmc_result> results_;
+};
+
+} // namespace detail
+
+/*! \brief Bounded model checking.
+ *
+ * Each primary output of the sequential network `ntk` is treated as a
+ * property that signals a bad state: the property fails, if the output can
+ * be 1 in one of the first `ps.num_frames` cycles, starting from the reset
+ * values of the registers (registers without a defined reset value may start
+ * with any value).
+ *
+ * The network is unrolled frame by frame into a single `cnf_view`, i.e., the
+ * Tseitin clauses of earlier frames are kept and the solver is used
+ * incrementally.  Properties are checked one at a time by assuming their
+ * output literal in the current frame; once a property holds in a frame, the
+ * negation of its output is added as a unit clause.  If
+ * `ps.simulation_filter` is true, random sequential simulation is used first
+ * to falsify easy properties without calling the SAT solver.
+ *
+ * The function returns one result per primary output, which includes a
+ * counter-example for falsified properties.
+ *
+ * **Required network functions:**
+ * - `num_pis`
+ * - `num_pos`
+ * - `foreach_pi`
+ * - `foreach_po`
+ * - `foreach_ro`
+ * - `foreach_ri`
+ * - `foreach_fanin`
+ * - `latch_reset`
+ * - `clone_node`
+ * - `compute` for `kitty::static_truth_table<6u>` (for the simulation filter)
+ *
+ * \param ntk Sequential network
+ * \param ps Parameters
+ * \param pst Statistics
+ */
+template<class Ntk>
+std::vector<bmc_result> bounded_model_checking( Ntk const& ntk, bounded_model_checking_params const& ps = {}, bounded_model_checking_stats* pst = nullptr )
+{
+  static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
+  static_assert( has_num_pis_v<Ntk>, "Ntk does not implement the num_pis method" );
+  static_assert( has_num_pos_v<Ntk>, "Ntk does not implement the num_pos method" );
+  static_assert( has_foreach_pi_v<Ntk>, "Ntk does not implement the foreach_pi method" );
+  static_assert( has_foreach_po_v<Ntk>, "Ntk does not implement the foreach_po method" );
+  static_assert( has_foreach_ro_v<Ntk>, "Ntk does not implement the foreach_ro method" );
+  static_assert( has_foreach_ri_v<Ntk>, "Ntk does not implement the foreach_ri method" );
+  static_assert( has_foreach_fanin_v<Ntk>, "Ntk does not implement the foreach_fanin method" );
+  static_assert( has_clone_node_v<Ntk>, "Ntk does not implement the clone_node method" );
+
+  bounded_model_checking_stats st;
+  detail::bounded_model_checking_impl<Ntk> impl( ntk, ps, st );
+  auto const result = impl.run();
+
+  if ( ps.verbose )
+  {
+    st.report();
+  }
+  if ( pst )
+  {
+    *pst = st;
+  }
+
+  return result;
+}
+
+} // namespace mockturtle
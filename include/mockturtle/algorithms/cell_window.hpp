@@ -78,6 +78,24 @@ public:
     _gates.reserve( _max_gates );
   }
 
+  /* copies the current window, but not the visited windows; the cell
+   * references are shared with `other` */
+  cell_window_storage( cell_window_storage const& other, bool )
+      : _nodes( other._nodes ),
+        _gates( other._gates ),
+        _leaves( other._leaves ),
+        _roots( other._roots ),
+        _window_mask( other._window_mask ),
+        _cell_refs( other._cell_refs ),
+        _cell_parents( other._cell_parents ),
+        _index_to_node( other._index_to_node ),
+        _node_to_index( other._node_to_index ),
+        _num_constants( other._num_constants ),
+        _max_gates( other._max_gates ),
+        _has_mapping( other._has_mapping )
+  {
+  }
+
   spp::sparse_hash_set<node<Ntk>> _nodes;   /* cell roots in current window */
   spp::sparse_hash_set<node<Ntk>> _gates;   /* gates in current window */
   spp::sparse_hash_set<node<Ntk>> _leaves;  /* leaves of current window */
@@ -168,6 +186,29 @@ public:
     return _storage->_window_hash.insert( _storage->_window_mask ).second;
   }
 
+  /*! \brief Allows the current window to be computed again.
+   *
+   * Removes the current window from the set of visited windows, such that
+   * the next call to `compute_window_for` for the same window returns true.
+   */
+  void forget_window()
+  {
+    _storage->_window_hash.erase( _storage->_window_mask );
+  }
+
+  /*! \brief Returns a copy of the current window.
+   *
+   * The copy is not affected by later calls to `compute_window_for` on this
+   * window, and can be used to change the mapping of the current window
+   * later.  The copy itself must not compute windows.
+   */
+  cell_window snapshot() const
+  {
+    cell_window copy( *this );
+    copy._storage = std::make_shared<detail::cell_window_storage<Ntk>>( *_storage, true );
+    return copy;
+  }
+
   uint32_t num_pis() const
   {
     return _storage->_leaves.size();
@@ -178,6 +219,16 @@ public:
     return _storage->_roots.size();
   }
 
+  uint32_t num_cis() const
+  {
+    return num_pis();
+  }
+
+  uint32_t num_cos() const
+  {
+    return num_pos();
+  }
+
   uint32_t num_gates() const
   {
     return _storage->_gates.size();
@@ -248,6 +299,18 @@ public:
     detail::foreach_element( _storage->_roots.begin(), _storage->_roots.end(), fn );
   }
 
+  template<typename Fn>
+  void foreach_ci( Fn&& fn ) const
+  {
+    foreach_pi( fn );
+  }
+
+  template<typename Fn>
+  void foreach_co( Fn&& fn ) const
+  {
+    foreach_po( fn );
+  }
+
   template<typename Fn>
   void foreach_gate( Fn&& fn ) const
   {
@@ -33,12 +33,19 @@
 #pragma once
 
 #include "../utils/node_map.hpp"
+#include "../utils/profiler.hpp"
 #include "cnf.hpp"
+#include <fmt/format.h>
 #include <bill/sat/interface/abc_bsat2.hpp>
 #include <bill/sat/interface/common.hpp>
 #include <bill/sat/interface/glucose.hpp>
 #include <bill/sat/interface/z3.hpp>
 
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
 namespace mockturtle
 {
 
@@ -57,6 +64,62 @@ struct validator_params
   uint32_t random_seed{0};
 };
 
+struct validator_stats
+{
+  /*! \brief Number of SAT solver calls. */
+  uint32_t num_solve{0};
+
+  /*! \brief Number of satisfiable calls (counter-example found). */
+  uint32_t num_sat{0};
+
+  /*! \brief Number of unsatisfiable calls (validated). */
+  uint32_t num_unsat{0};
+
+  /*! \brief Number of calls aborted by the conflict limit. */
+  uint32_t num_timeout{0};
+
+  /*! \brief Number of solver restarts, after which all nodes are encoded again. */
+  uint32_t num_restarts{0};
+
+  /*! \brief Number of times the CNF encoding of a node was requested. */
+  uint64_t num_lookups{0};
+
+  /*! \brief Number of requests answered by an existing encoding. */
+  uint64_t num_hits{0};
+
+  /*! \brief Number of clauses retired by their activation literal. */
+  uint64_t num_retired_clauses{0};
+
+  /*! \brief Fraction of node encodings that were reused. */
+  double hit_rate() const
+  {
+    return num_lookups == 0u ? 0.0 : static_cast<double>( num_hits ) / num_lookups;
+  }
+
+  validator_stats& operator+=( validator_stats const& other )
+  {
+    num_solve += other.num_solve;
+    num_sat += other.num_sat;
+    num_unsat += other.num_unsat;
+    num_timeout += other.num_timeout;
+    num_restarts += other.num_restarts;
+    num_lookups += other.num_lookups;
+    num_hits += other.num_hits;
+    num_retired_clauses += other.num_retired_clauses;
+    return *this;
+  }
+
+  void report() const
+  {
+    // clang-format off
+    fmt::print( "[i] #solve    = {:>8d} (SAT: {}, UNSAT: {}, timeout: {})\n", num_solve, num_sat, num_unsat, num_timeout );
+    fmt::print( "[i] #restarts = {:>8d}\n", num_restarts );
+    fmt::print( "[i] CNF reuse = {:>8.2f}% ({} of {} node lookups)\n", hit_rate() * 100.0, num_hits, num_lookups );
+    fmt::print( "[i] #retired  = {:>8d} clauses\n", num_retired_clauses );
+    // clang-format on
+  }
+};
+
 template<class Ntk, bill::solvers Solver = bill::solvers::glucose_41, bool use_pushpop = false, bool randomize = false, bool use_odc = false>
 class circuit_validator
 {
@@ -141,30 +204,18 @@ public:
   /*! \brief Validate functional equivalence of signals `f` and `d`. */
   std::optional<bool> validate( signal const& f, signal const& d )
   {
-    if ( !literals.has( d ) )
-    {
-      construct( ntk.get_node( d ) );
-    }
+    encode( ntk.get_node( d ) );
     auto const res = validate( ntk.get_node( f ), lit_not_cond( literals[d], ntk.is_complemented( f ) ^ ntk.is_complemented( d ) ) );
-    if ( solver.num_clauses() > ps.max_clauses && num_invoke >= MIN_NUM_INVOKE )
-    {
-      restart();
-    }
+    check_restart();
     return res;
   }
 
   /*! \brief Validate functional equivalence of node `root` and signal `d`. */
   std::optional<bool> validate( node const& root, signal const& d )
   {
-    if ( !literals.has( d ) )
-    {
-      construct( ntk.get_node( d ) );
-    }
+    encode( ntk.get_node( d ) );
     auto const res = validate( root, lit_not_cond( literals[d], ntk.is_complemented( d ) ) );
-    if ( solver.num_clauses() > ps.max_clauses && num_invoke >= MIN_NUM_INVOKE )
-    {
-      restart();
-    }
+    check_restart();
     return res;
   }
 
@@ -198,43 +249,40 @@ public:
   template<class iterator_type>
   std::optional<bool> validate( node const& root, iterator_type divs_begin, iterator_type divs_end, std::vector<gate> const& circuit, bool output_negation = false )
   {
-    if ( !literals.has( root ) )
-    {
-      construct( root );
-    }
+    encode( root );
 
     std::vector<bill::lit_type> lits;
     while ( divs_begin != divs_end )
     {
-      if ( !literals.has( *divs_begin ) )
-      {
-        construct( *divs_begin );
-      }
+      encode( *divs_begin );
       lits.emplace_back( literals[*divs_begin] );
       divs_begin++;
     }
 
+    /* without push/pop, the clauses of the circuit are guarded by an activation literal */
+    std::optional<bill::lit_type> activation;
     if constexpr ( use_pushpop )
     {
       push();
     }
+    else
+    {
+      activation = bill::lit_type( solver.add_variable(), bill::lit_type::polarities::positive );
+    }
 
     for ( auto g : circuit )
     {
-      lits.emplace_back( add_tmp_gate( lits, g ) );
+      lits.emplace_back( add_tmp_gate( lits, g, activation ) );
     }
 
-    auto const res = validate( root, lit_not_cond( lits.back(), output_negation ) );
+    auto const res = validate( root, lit_not_cond( lits.back(), output_negation ), activation );
 
     if constexpr ( use_pushpop )
     {
       pop();
     }
 
-    if ( solver.num_clauses() > ps.max_clauses && num_invoke >= MIN_NUM_INVOKE )
-    {
-      restart();
-    }
+    check_restart();
 
     return res;
   }
@@ -248,10 +296,7 @@ public:
   /*! \brief Validate whether node `root` is a constant of `value`. */
   std::optional<bool> validate( node const& root, bool value )
   {
-    if ( !literals.has( root ) )
-    {
-      construct( root );
-    }
+    encode( root );
 
     std::optional<bool> res;
     if constexpr ( use_odc )
@@ -278,10 +323,7 @@ public:
       res = solve( {lit_not_cond( literals[root], value )} );
     }
 
-    if ( solver.num_clauses() > ps.max_clauses && num_invoke >= MIN_NUM_INVOKE )
-    {
-      restart();
-    }
+    check_restart();
     return res;
   }
 
@@ -306,10 +348,7 @@ public:
   template<bool enabled = use_pushpop, typename = std::enable_if_t<enabled>>
   std::vector<std::vector<bool>> generate_pattern( node const& root, bool value, std::vector<std::vector<bool>> const& block_patterns = {}, uint32_t num_patterns = 1u )
   {
-    if ( !literals.has( root ) )
-    {
-      construct( root );
-    }
+    encode( root );
 
     push();
 
@@ -345,10 +384,7 @@ public:
     }
 
     pop();
-    if ( solver.num_clauses() > ps.max_clauses && num_invoke >= MIN_NUM_INVOKE )
-    {
-      restart();
-    }
+    check_restart();
     return generated;
   }
 
@@ -362,10 +398,28 @@ public:
     restart();
   }
 
+  /*! \brief Returns statistics accumulated over the lifetime of the validator. */
+  validator_stats const& stats() const
+  {
+    return st;
+  }
+
 private:
+  /* restart when too many clauses are alive; retired clauses do not count */
+  void check_restart()
+  {
+    if ( live_clauses > ps.max_clauses && num_invoke >= MIN_NUM_INVOKE )
+    {
+      ++st.num_restarts;
+      restart();
+    }
+  }
+
   void restart()
   {
     num_invoke = 0u;
+    live_clauses = 0u;
+    guarded_clauses = 0u;
     solver.restart();
     if constexpr ( randomize )
     {
@@ -386,7 +440,19 @@ private:
     } );
 
     solver.add_variables( ntk.num_pis() + 1 );
-    solver.add_clause( {~literals[ntk.get_constant( false )]} );
+    add_clause( {~literals[ntk.get_constant( false )]} );
+  }
+
+  /* makes sure that `n` is encoded in the solver */
+  void encode( node const& n )
+  {
+    ++st.num_lookups;
+    if ( literals.has( n ) )
+    {
+      ++st.num_hits;
+      return;
+    }
+    construct( n );
   }
 
   void construct( node const& n )
@@ -402,10 +468,7 @@ private:
 
     std::vector<bill::lit_type> child_lits;
     ntk.foreach_fanin( n, [&]( auto const& f ) {
-      if ( !literals.has( f ) )
-      {
-        construct( ntk.get_node( f ) );
-      }
+      encode( ntk.get_node( f ) );
       child_lits.push_back( lit_not_cond( literals[f], ntk.is_complemented( f ) ) );
     } );
     bill::lit_type node_lit = literals[n] = bill::lit_type( solver.add_variable(), bill::lit_type::polarities::positive );
@@ -413,25 +476,25 @@ private:
     if ( ntk.is_and( n ) )
     {
       detail::on_and<add_clause_fn_t>( node_lit, child_lits[0], child_lits[1], [&]( auto const& clause ) {
-        solver.add_clause( clause );
+        add_clause( clause );
       } );
     }
     else if ( ntk.is_xor( n ) )
     {
       detail::on_xor<add_clause_fn_t>( node_lit, child_lits[0], child_lits[1], [&]( auto const& clause ) {
-        solver.add_clause( clause );
+        add_clause( clause );
       } );
     }
     else if ( ntk.is_xor3( n ) )
     {
       detail::on_xor3<add_clause_fn_t>( node_lit, child_lits[0], child_lits[1], child_lits[2], [&]( auto const& clause ) {
-        solver.add_clause( clause );
+        add_clause( clause );
       } );
     }
     else if ( ntk.is_maj( n ) )
     {
       detail::on_maj<add_clause_fn_t>( node_lit, child_lits[0], child_lits[1], child_lits[2], [&]( auto const& clause ) {
-        solver.add_clause( clause );
+        add_clause( clause );
       } );
     }
   }
@@ -439,6 +502,7 @@ private:
   void push()
   {
     solver.push();
+    pushed_clauses = live_clauses;
     between_push_pop = true;
     tmp.clear();
   }
@@ -446,6 +510,7 @@ private:
   void pop()
   {
     solver.pop();
+    live_clauses = pushed_clauses;
     for ( auto& n : tmp )
     {
       literals.erase( n );
@@ -453,49 +518,74 @@ private:
     between_push_pop = false;
   }
 
-  bill::lit_type add_clauses_for_2input_gate( bill::lit_type a, bill::lit_type b, std::optional<bill::lit_type> c = std::nullopt, gate_type type = AND )
+  /* adds a clause that counts towards the clause limit */
+  void add_clause( std::vector<bill::lit_type> const& clause )
+  {
+    solver.add_clause( clause );
+    ++live_clauses;
+  }
+
+  /* returns a function that adds a clause, optionally guarded by an activation literal */
+  add_clause_fn_t clause_adder( std::optional<bill::lit_type> const& activation )
+  {
+    if ( activation )
+    {
+      return [this, act = *activation]( auto const& clause ) {
+        auto guarded = clause;
+        guarded.emplace_back( act );
+        add_clause( guarded );
+        ++guarded_clauses;
+      };
+    }
+    return [this]( auto const& clause ) {
+      add_clause( clause );
+    };
+  }
+
+  /* permanently satisfies all clauses guarded by `activation` */
+  void retire( bill::lit_type const& activation )
+  {
+    solver.add_clause( activation );
+    live_clauses -= guarded_clauses;
+    st.num_retired_clauses += guarded_clauses;
+    guarded_clauses = 0u;
+  }
+
+  bill::lit_type add_clauses_for_2input_gate( bill::lit_type a, bill::lit_type b, std::optional<bill::lit_type> c = std::nullopt, gate_type type = AND, std::optional<bill::lit_type> const& activation = std::nullopt )
   {
     assert( type == AND || type == XOR );
 
     auto nlit = c ? *c : bill::lit_type( solver.add_variable(), bill::lit_type::polarities::positive );
     if ( type == AND )
     {
-      detail::on_and<add_clause_fn_t>( nlit, a, b, [&]( auto const& clause ) {
-        solver.add_clause( clause );
-      } );
+      detail::on_and<add_clause_fn_t>( nlit, a, b, clause_adder( activation ) );
     }
     else if ( type == XOR )
     {
-      detail::on_xor<add_clause_fn_t>( nlit, a, b, [&]( auto const& clause ) {
-        solver.add_clause( clause );
-      } );
+      detail::on_xor<add_clause_fn_t>( nlit, a, b, clause_adder( activation ) );
     }
 
     return nlit;
   }
 
-  bill::lit_type add_clauses_for_3input_gate( bill::lit_type a, bill::lit_type b, bill::lit_type c, std::optional<bill::lit_type> d = std::nullopt, gate_type type = MAJ )
+  bill::lit_type add_clauses_for_3input_gate( bill::lit_type a, bill::lit_type b, bill::lit_type c, std::optional<bill::lit_type> d = std::nullopt, gate_type type = MAJ, std::optional<bill::lit_type> const& activation = std::nullopt )
   {
     assert( type == MAJ || type == XOR );
 
     auto nlit = d ? *d : bill::lit_type( solver.add_variable(), bill::lit_type::polarities::positive );
     if ( type == MAJ )
     {
-      detail::on_maj<add_clause_fn_t>( nlit, a, b, c, [&]( auto const& clause ) {
-        solver.add_clause( clause );
-      } );
+      detail::on_maj<add_clause_fn_t>( nlit, a, b, c, clause_adder( activation ) );
     }
     else if ( type == XOR )
     {
-      detail::on_xor3<add_clause_fn_t>( nlit, a, b, c, [&]( auto const& clause ) {
-        solver.add_clause( clause );
-      } );
+      detail::on_xor3<add_clause_fn_t>( nlit, a, b, c, clause_adder( activation ) );
     }
 
     return nlit;
   }
 
-  bill::lit_type add_tmp_gate( std::vector<bill::lit_type> const& lits, gate const& g )
+  bill::lit_type add_tmp_gate( std::vector<bill::lit_type> const& lits, gate const& g, std::optional<bill::lit_type> const& activation = std::nullopt )
   {
     /* currently supports AND2, XOR2, XOR3, MAJ3 */
     assert( g.fanins.size() == 2u || g.fanins.size() == 3u );
@@ -504,24 +594,27 @@ private:
     {
       assert( g.fanins[0].index < lits.size() );
       assert( g.fanins[1].index < lits.size() );
-      return add_clauses_for_2input_gate( lit_not_cond( lits[g.fanins[0].index], g.fanins[0].inverted ), lit_not_cond( lits[g.fanins[1].index], g.fanins[1].inverted ), std::nullopt, g.type );
+      return add_clauses_for_2input_gate( lit_not_cond( lits[g.fanins[0].index], g.fanins[0].inverted ), lit_not_cond( lits[g.fanins[1].index], g.fanins[1].inverted ), std::nullopt, g.type, activation );
     }
     else
     {
       assert( g.fanins[0].index < lits.size() );
       assert( g.fanins[1].index < lits.size() );
       assert( g.fanins[2].index < lits.size() );
-      return add_clauses_for_3input_gate( lit_not_cond( lits[g.fanins[0].index], g.fanins[0].inverted ), lit_not_cond( lits[g.fanins[1].index], g.fanins[1].inverted ), lit_not_cond( lits[g.fanins[2].index], g.fanins[2].inverted ), std::nullopt, g.type );
+      return add_clauses_for_3input_gate( lit_not_cond( lits[g.fanins[0].index], g.fanins[0].inverted ), lit_not_cond( lits[g.fanins[1].index], g.fanins[1].inverted ), lit_not_cond( lits[g.fanins[2].index], g.fanins[2].inverted ), std::nullopt, g.type, activation );
     }
   }
 
   std::optional<bool> solve( std::vector<bill::lit_type> assumptions )
   {
     ++num_invoke;
+    ++st.num_solve;
+    profile_counter( "sat_calls" );
     auto const res = solver.solve( assumptions, ps.conflict_limit );
 
     if ( res == bill::result::states::satisfiable )
     {
+      ++st.num_sat;
       auto model = solver.get_model().model();
       for ( auto i = 0u; i < ntk.num_pis(); ++i )
       {
@@ -531,17 +624,17 @@ private:
     }
     else if ( res == bill::result::states::unsatisfiable )
     {
+      ++st.num_unsat;
       return true;
     }
+    ++st.num_timeout;
     return std::nullopt; /* timeout or something wrong */
   }
 
-  std::optional<bool> validate( node const& root, bill::lit_type const& lit )
+  /* `activation` guards clauses that are only needed for this call; if given, it is also used for the miter */
+  std::optional<bool> validate( node const& root, bill::lit_type const& lit, std::optional<bill::lit_type> const& activation = std::nullopt )
   {
-    if ( !literals.has( root ) )
-    {
-      construct( root );
-    }
+    encode( root );
 
     std::optional<bool> res;
     if constexpr ( use_odc )
@@ -552,7 +645,15 @@ private:
         {
           push();
         }
-        res = solve( {build_odc_window( root, lit )} );
+        if ( activation )
+        {
+          res = solve( {build_odc_window( root, lit ), ~( *activation )} );
+          retire( *activation );
+        }
+        else
+        {
+          res = solve( {build_odc_window( root, lit )} );
+        }
         if constexpr ( use_pushpop )
         {
           pop();
@@ -560,20 +661,38 @@ private:
       }
       else
       {
-        auto nlit = bill::lit_type( solver.add_variable(), bill::lit_type::polarities::positive );
-        solver.add_clause( {literals[root], lit, nlit} );
-        solver.add_clause( {~( literals[root] ), ~lit, nlit} );
-        res = solve( {~nlit} );
+        res = solve_miter( literals[root], lit, activation );
       }
     }
     else
     {
+      res = solve_miter( literals[root], lit, activation );
+    }
+
+    return res;
+  }
+
+  /* checks whether `a` and `b` can differ; the miter clauses are retired afterwards */
+  std::optional<bool> solve_miter( bill::lit_type const& a, bill::lit_type const& b, std::optional<bill::lit_type> activation )
+  {
+    if ( between_push_pop )
+    {
+      /* the clauses are removed by `pop` anyway */
       auto nlit = bill::lit_type( solver.add_variable(), bill::lit_type::polarities::positive );
-      solver.add_clause( {literals[root], lit, nlit} );
-      solver.add_clause( {~( literals[root] ), ~lit, nlit} );
-      res = solve( {~nlit} );
+      add_clause( {a, b, nlit} );
+      add_clause( {~a, ~b, nlit} );
+      return solve( {~nlit} );
     }
 
+    if ( !activation )
+    {
+      activation = bill::lit_type( solver.add_variable(), bill::lit_type::polarities::positive );
+    }
+    auto const add = clause_adder( activation );
+    add( {a, b} );
+    add( {~a, ~b} );
+    auto const res = solve( {~( *activation )} );
+    retire( *activation );
     return res;
   }
 
@@ -584,7 +703,7 @@ private:
     ntk.foreach_pi( [&]( auto const& n, auto i ) {
       clause.emplace_back( lit_not_cond( literals[n] , pattern[i] ) );
     } );
-    solver.add_clause( clause );
+    add_clause( clause );
   }
 
 private:
@@ -613,7 +732,7 @@ private:
     assert( miter.size() > 0 && "max fanout depth < odc_levels (-1 is infinity) and there is no PO in TFO cone" );
     auto nlit2 = bill::lit_type( solver.add_variable(), bill::lit_type::polarities::positive );
     miter.emplace_back( nlit2 );
-    solver.add_clause( miter );
+    add_clause( miter );
     return ~nlit2;
   }
 
@@ -627,10 +746,7 @@ private:
 
       std::vector<bill::lit_type> l_fi;
       ntk.foreach_fanin( fo, [&]( auto const& fi ) {
-        if ( !literals.has( fi ) )
-        {
-          construct( ntk.get_node( fi ) );
-        }
+        encode( ntk.get_node( fi ) );
         l_fi.emplace_back( lit_not_cond( lits.has( ntk.get_node( fi ) ) ? lits[fi] : literals[fi], ntk.is_complemented( fi ) ) );
       } );
       if ( l_fi.size() == 2u )
@@ -661,10 +777,7 @@ private:
         return true; /* skip */
       ntk.set_visited( fo, ntk.trav_id() );
 
-      if ( !literals.has( fo ) )
-      {
-        construct( fo );
-      }
+      encode( fo );
 
       lits[fo] = bill::lit_type( solver.add_variable(), bill::lit_type::polarities::positive );
 
@@ -697,6 +810,15 @@ private:
   static const uint32_t MIN_NUM_INVOKE = 20u;
   uint32_t num_invoke;
 
+  /* clauses that are not satisfied by a retired activation literal (counted
+     here, since solvers differ in whether they drop satisfied clauses), and
+     clauses guarded by the current activation literal */
+  uint32_t live_clauses{0u};
+  uint32_t pushed_clauses{0u};
+  uint32_t guarded_clauses{0u};
+
+  validator_stats st;
+
   bool between_push_pop = false;
   std::vector<node> tmp;
 
@@ -704,4 +826,119 @@ public:
   std::vector<bool> cex;
 };
 
+/*! \brief Pool of circuit validators sharing one network.
+ *
+ * Validators are handed out by `acquire` and returned to the pool when the
+ * lease goes out of scope.  A returned validator keeps its solver and the
+ * CNF encoding of all nodes constructed so far, such that the next client
+ * only pays for the nodes that are not encoded yet.  Acquiring and
+ * releasing validators is thread-safe; each validator is used by at most
+ * one thread at a time.
+ *
+ * The pool must not be moved while validators are leased, as all
+ * validators refer to its parameters.
+ */
+template<class Validator>
+class validator_pool
+{
+public:
+  using validator_t = Validator;
+
+  class lease
+  {
+  public:
+    lease( validator_pool& pool, std::unique_ptr<Validator> v )
+        : pool( &pool ), v( std::move( v ) )
+    {
+    }
+
+    lease( lease&& other ) = default;
+    lease& operator=( lease&& other ) = delete;
+
+    ~lease()
+    {
+      if ( v )
+      {
+        pool->release( std::move( v ) );
+      }
+    }
+
+    Validator& operator*() const { return *v; }
+    Validator* operator->() const { return v.get(); }
+
+  private:
+    validator_pool* pool;
+    std::unique_ptr<Validator> v;
+  };
+
+  template<class Ntk>
+  explicit validator_pool( Ntk const& ntk, validator_params const& ps = {} )
+      : ps( ps ), make( [&ntk, this]() { return std::make_unique<Validator>( ntk, this->ps ); } )
+  {
+  }
+
+  validator_pool( validator_pool const& ) = delete;
+  validator_pool& operator=( validator_pool const& ) = delete;
+
+  /*! \brief Returns an idle validator, or creates a new one. */
+  lease acquire()
+  {
+    {
+      std::lock_guard<std::mutex> lock( mutex );
+      if ( !idle.empty() )
+      {
+        auto v = std::move( idle.back() );
+        idle.pop_back();
+        return lease( *this, std::move( v ) );
+      }
+      ++num_created;
+    }
+    return lease( *this, make() );
+  }
+
+  /*! \brief Restarts all idle validators after the network was modified. */
+  void update()
+  {
+    std::lock_guard<std::mutex> lock( mutex );
+    for ( auto& v : idle )
+    {
+      v->update();
+    }
+  }
+
+  /*! \brief Number of validators created so far. */
+  uint32_t size() const
+  {
+    std::lock_guard<std::mutex> lock( mutex );
+    return num_created;
+  }
+
+  /*! \brief Accumulated statistics of all idle validators. */
+  validator_stats stats() const
+  {
+    std::lock_guard<std::mutex> lock( mutex );
+    validator_stats st;
+    for ( auto const& v : idle )
+    {
+      st += v->stats();
+    }
+    return st;
+  }
+
+private:
+  void release( std::unique_ptr<Validator> v )
+  {
+    std::lock_guard<std::mutex> lock( mutex );
+    idle.emplace_back( std::move( v ) );
+  }
+
+private:
+  validator_params const ps;
+  std::function<std::unique_ptr<Validator>()> make;
+
+  mutable std::mutex mutex;
+  std::vector<std::unique_ptr<Validator>> idle;
+  uint32_t num_created{0u};
+};
+
 } /* namespace mockturtle */
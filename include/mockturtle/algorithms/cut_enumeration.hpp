@@ -41,6 +41,8 @@
 
 #include <kitty/constructors.hpp>
 #include <kitty/dynamic_truth_table.hpp>
+#include <kitty/operations.hpp>
+#include <kitty/static_truth_table.hpp>
 
 #include <fmt/format.h>
 
@@ -116,14 +118,39 @@ struct cut_data<false, T>
 template<bool ComputeTruth, typename T>
 using cut_type = cut<max_cut_size, cut_data<ComputeTruth, T>>;
 
+template<uint32_t NumVars, bool ComputeTruth, typename T = empty_cut_data>
+struct fast_cut_data;
+
+template<uint32_t NumVars, typename T>
+struct fast_cut_data<NumVars, true, T>
+{
+  kitty::static_truth_table<NumVars> func;
+  T data;
+};
+
+template<uint32_t NumVars, typename T>
+struct fast_cut_data<NumVars, false, T>
+{
+  T data;
+};
+
+template<uint32_t NumVars, bool ComputeTruth, typename T>
+using fast_cut_type = cut<NumVars, fast_cut_data<NumVars, ComputeTruth, T>>;
+
 /* forward declarations */
 /*! \cond PRIVATE */
 template<typename Ntk, bool ComputeTruth, typename CutData>
 struct network_cuts;
 
+template<typename Ntk, uint32_t NumVars, bool ComputeTruth, typename CutData>
+struct fast_network_cuts;
+
 template<typename Ntk, bool ComputeTruth = false, typename CutData = empty_cut_data>
 network_cuts<Ntk, ComputeTruth, CutData> cut_enumeration( Ntk const& ntk, cut_enumeration_params const& ps = {}, cut_enumeration_stats * pst = nullptr );
 
+template<typename Ntk, uint32_t NumVars, bool ComputeTruth = false, typename CutData = empty_cut_data>
+fast_network_cuts<Ntk, NumVars, ComputeTruth, CutData> fast_cut_enumeration( Ntk const& ntk, cut_enumeration_params const& ps = {}, cut_enumeration_stats * pst = nullptr );
+
 /* function to update a cut */
 template<typename CutData>
 struct cut_enumeration_update_cut
@@ -140,7 +167,7 @@ struct cut_enumeration_update_cut
 
 namespace detail
 {
-template<typename Ntk, bool ComputeTruth, typename CutData>
+template<typename Ntk, bool ComputeTruth, typename CutData, typename NetworkCuts = network_cuts<Ntk, ComputeTruth, CutData>>
 class cut_enumeration_impl;
 }
 /*! \endcond */
@@ -161,6 +188,7 @@ public:
   static constexpr uint32_t max_cut_num = 26;
   using cut_t = cut_type<ComputeTruth, CutData>;
   using cut_set_t = cut_set<cut_t, max_cut_num>;
+  using truth_table_t = kitty::dynamic_truth_table;
   static constexpr bool compute_truth = ComputeTruth;
 
 private:
@@ -240,7 +268,7 @@ public:
   }
 
 private:
-  template<typename _Ntk, bool _ComputeTruth, typename _CutData>
+  template<typename _Ntk, bool _ComputeTruth, typename _CutData, typename _NetworkCuts>
   friend class detail::cut_enumeration_impl;
 
   template<typename _Ntk, bool _ComputeTruth, typename _CutData>
@@ -279,18 +307,116 @@ private:
   std::size_t _total_cuts{};
 };
 
+/*! \brief Cut database for a network with small cuts.
+ *
+ * The function `fast_cut_enumeration` returns an instance of type
+ * `fast_network_cuts`, which has the same interface as `network_cuts`.  Cuts
+ * have at most `NumVars` leaves, and their functions are stored inline in
+ * each cut as a static truth table instead of in a truth table cache.
+ */
+template<typename Ntk, uint32_t NumVars, bool ComputeTruth, typename CutData>
+struct fast_network_cuts
+{
+public:
+  static constexpr uint32_t max_cut_num = 26;
+  using cut_t = fast_cut_type<NumVars, ComputeTruth, CutData>;
+  using cut_set_t = cut_set<cut_t, max_cut_num>;
+  using truth_table_t = kitty::static_truth_table<NumVars>;
+  static constexpr bool compute_truth = ComputeTruth;
+
+private:
+  explicit fast_network_cuts( uint32_t size ) : _cuts( size )
+  {
+  }
+
+public:
+  /*! \brief Returns the cut set of a node */
+  cut_set_t& cuts( uint32_t node_index ) { return _cuts[node_index]; }
+
+  /*! \brief Returns the cut set of a node */
+  cut_set_t const& cuts( uint32_t node_index ) const { return _cuts[node_index]; }
+
+  /*! \brief Returns the truth table of a cut
+   *
+   * The truth table has `NumVars` variables, of which only the first
+   * `cut.size()` ones are in the support.
+   */
+  template<bool enabled = ComputeTruth, typename = std::enable_if_t<std::is_same_v<Ntk, Ntk> && enabled>>
+  auto const& truth_table( cut_t const& cut ) const
+  {
+    return cut->func;
+  }
+
+  /*! \brief Returns the total number of tuples that were tried to be merged */
+  auto total_tuples() const
+  {
+    return _total_tuples;
+  }
+
+  /*! \brief Returns the total number of cuts in the database. */
+  auto total_cuts() const
+  {
+    return _total_cuts;
+  }
+
+  /*! \brief Returns the number of nodes for which cuts are computed */
+  auto nodes_size() const
+  {
+    return _cuts.size();
+  }
+
+private:
+  template<typename _Ntk, bool _ComputeTruth, typename _CutData, typename _NetworkCuts>
+  friend class detail::cut_enumeration_impl;
+
+  template<typename _Ntk, uint32_t _NumVars, bool _ComputeTruth, typename _CutData>
+  friend fast_network_cuts<_Ntk, _NumVars, _ComputeTruth, _CutData> fast_cut_enumeration( _Ntk const& ntk, cut_enumeration_params const& ps, cut_enumeration_stats * pst );
+
+private:
+  void add_zero_cut( uint32_t index )
+  {
+    auto& cut = _cuts[index].add_cut( &index, &index ); /* fake iterator for emptyness */
+
+    if constexpr ( ComputeTruth )
+    {
+      kitty::clear( cut->func );
+    }
+  }
+
+  void add_unit_cut( uint32_t index )
+  {
+    auto& cut = _cuts[index].add_cut( &index, &index + 1 );
+
+    if constexpr ( ComputeTruth )
+    {
+      kitty::create_nth_var( cut->func, 0u );
+    }
+  }
+
+private:
+  /* compressed representation of cuts */
+  std::vector<cut_set_t> _cuts;
+
+  /* statistics */
+  uint32_t _total_tuples{};
+  std::size_t _total_cuts{};
+};
+
 /*! \cond PRIVATE */
 namespace detail
 {
 
-template<typename Ntk, bool ComputeTruth, typename CutData>
+template<typename Ntk, bool ComputeTruth, typename CutData, typename NetworkCuts>
 class cut_enumeration_impl
 {
 public:
-  using cut_t = typename network_cuts<Ntk, ComputeTruth, CutData>::cut_t;
-  using cut_set_t = typename network_cuts<Ntk, ComputeTruth, CutData>::cut_set_t;
+  using cut_t = typename NetworkCuts::cut_t;
+  using cut_set_t = typename NetworkCuts::cut_set_t;
+
+  /* functions are stored inline in the cuts of `fast_network_cuts` */
+  static constexpr bool static_truth_tables = !std::is_same_v<NetworkCuts, network_cuts<Ntk, ComputeTruth, CutData>>;
 
-  explicit cut_enumeration_impl( Ntk const& ntk, cut_enumeration_params const& ps, cut_enumeration_stats& st, network_cuts<Ntk, ComputeTruth, CutData>& cuts )
+  explicit cut_enumeration_impl( Ntk const& ntk, cut_enumeration_params const& ps, cut_enumeration_stats& st, NetworkCuts& cuts )
       : ntk( ntk ),
         ps( ps ),
         st( st ),
@@ -301,7 +427,7 @@ public:
 public:
   void run()
   {
-    stopwatch t( st.time_total );
+    stopwatch t( st.time_total, "cut_enumeration" );
 
     ntk.foreach_node( [this]( auto node ) {
       const auto index = ntk.node_to_index( node );
@@ -334,10 +460,22 @@ public:
   }
 
 private:
-  uint32_t compute_truth_table( uint32_t index, std::vector<cut_t const*> const& vcuts, cut_t& res )
+  void compute_truth_table( uint32_t index, std::vector<cut_t const*> const& vcuts, cut_t& res )
   {
     stopwatch t( st.time_truth_table );
 
+    if constexpr ( static_truth_tables )
+    {
+      res->func = compute_static_truth_table( index, vcuts, res );
+    }
+    else
+    {
+      res->func_id = compute_dynamic_truth_table( index, vcuts, res );
+    }
+  }
+
+  uint32_t compute_dynamic_truth_table( uint32_t index, std::vector<cut_t const*> const& vcuts, cut_t& res )
+  {
     std::vector<kitty::dynamic_truth_table> tt( vcuts.size() );
     auto i = 0;
     for ( auto const& cut : vcuts )
@@ -373,6 +511,47 @@ private:
     return cuts._truth_tables.insert( tt_res );
   }
 
+  /* expands the functions of the fanin cuts to the leaves of `res` by swapping
+   * variables in place, which uses precomputed masks for up to 6 variables */
+  auto compute_static_truth_table( uint32_t index, std::vector<cut_t const*> const& vcuts, cut_t& res )
+  {
+    static_tts.resize( vcuts.size() );
+    auto i = 0u;
+    for ( auto const& cut : vcuts )
+    {
+      auto& tt = static_tts[i++];
+      tt = ( *cut )->func;
+
+      std::array<uint8_t, max_cut_size> support;
+      auto itp = res.begin();
+      auto j = 0u;
+      for ( auto leaf : *cut )
+      {
+        itp = std::find( itp, res.end(), leaf );
+        support[j++] = static_cast<uint8_t>( std::distance( res.begin(), itp ) );
+      }
+      while ( j-- > 0u )
+      {
+        kitty::swap_inplace( tt, static_cast<uint8_t>( j ), support[j] );
+      }
+    }
+
+    auto tt_res = ntk.compute( ntk.index_to_node( index ), static_tts.begin(), static_tts.end() );
+
+    if ( ps.minimize_truth_table )
+    {
+      const auto support = kitty::min_base_inplace( tt_res );
+      if ( support.size() != res.size() )
+      {
+        std::array<uint32_t, max_cut_size> leaves;
+        std::transform( support.begin(), support.end(), leaves.begin(), [&]( auto v ) { return *( res.begin() + v ); } );
+        res.set_leaves( leaves.begin(), leaves.begin() + support.size() );
+      }
+    }
+
+    return tt_res;
+  }
+
   void merge_cuts2( uint32_t index )
   {
     const auto fanin = 2;
@@ -409,7 +588,7 @@ private:
         {
           vcuts[0] = c1;
           vcuts[1] = c2;
-          new_cut->func_id = compute_truth_table( index, vcuts, new_cut );
+          compute_truth_table( index, vcuts, new_cut );
         }
 
         cut_enumeration_update_cut<CutData>::apply( new_cut, cuts, ntk, index );
@@ -482,7 +661,7 @@ private:
 
         if constexpr ( ComputeTruth )
         {
-          new_cut->func_id = compute_truth_table( index, vcuts, new_cut );
+          compute_truth_table( index, vcuts, new_cut );
         }
 
         cut_enumeration_update_cut<CutData>::apply( new_cut, cuts, ntk, ntk.index_to_node( index ) );
@@ -502,7 +681,7 @@ private:
 
         if constexpr ( ComputeTruth )
         {
-          new_cut->func_id = compute_truth_table( index, {cut}, new_cut );
+          compute_truth_table( index, {cut}, new_cut );
         }
 
         cut_enumeration_update_cut<CutData>::apply( new_cut, cuts, ntk, ntk.index_to_node( index ) );
@@ -523,9 +702,10 @@ private:
   Ntk const& ntk;
   cut_enumeration_params const& ps;
   cut_enumeration_stats& st;
-  network_cuts<Ntk, ComputeTruth, CutData>& cuts;
+  NetworkCuts& cuts;
 
   std::array<cut_set_t*, Ntk::max_fanin_size + 1> lcuts;
+  std::vector<typename NetworkCuts::truth_table_t> static_tts;
 };
 } /* namespace detail */
 /*! \endcond */
@@ -606,6 +786,61 @@ network_cuts<Ntk, ComputeTruth, CutData> cut_enumeration( Ntk const& ntk, cut_en
   return res;
 }
 
+/*! \brief Cut enumeration for small cuts.
+ *
+ * This function implements the same algorithm as `cut_enumeration`, and
+ * computes the same cuts, but for cuts with at most `NumVars` leaves, where
+ * `NumVars` is at most 6 and must not be smaller than the `cut_size`
+ * parameter.  If `ComputeTruth` is true, the function of each cut is stored
+ * inline in the cut as a `kitty::static_truth_table<NumVars>`, and the
+ * functions of the fanin cuts are expanded to the leaves of the new cut by
+ * swapping variables with precomputed masks.  This avoids the dynamic memory
+ * allocations and the hashing of the truth table cache in `cut_enumeration`,
+ * which dominate the truth table computation for small cuts.
+ *
+ * **Required network functions:**
+ * - `is_constant`
+ * - `is_pi`
+ * - `size`
+ * - `get_node`
+ * - `node_to_index`
+ * - `foreach_node`
+ * - `foreach_fanin`
+ * - `compute` for `kitty::static_truth_table<NumVars>` (if `ComputeTruth` is true)
+ */
+template<typename Ntk, uint32_t NumVars, bool ComputeTruth, typename CutData>
+fast_network_cuts<Ntk, NumVars, ComputeTruth, CutData> fast_cut_enumeration( Ntk const& ntk, cut_enumeration_params const& ps, cut_enumeration_stats * pst )
+{
+  static_assert( NumVars <= 6u, "NumVars must be at most 6" );
+  static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
+  static_assert( has_is_constant_v<Ntk>, "Ntk does not implement the is_constant method" );
+  static_assert( has_is_pi_v<Ntk>, "Ntk does not implement the is_pi method" );
+  static_assert( has_size_v<Ntk>, "Ntk does not implement the size method" );
+  static_assert( has_get_node_v<Ntk>, "Ntk does not implement the get_node method" );
+  static_assert( has_foreach_node_v<Ntk>, "Ntk does not implement the foreach_node method" );
+  static_assert( has_foreach_fanin_v<Ntk>, "Ntk does not implement the foreach_fanin method" );
+  static_assert( has_node_to_index_v<Ntk>, "Ntk does not implement the node_to_index method" );
+  static_assert( !ComputeTruth || has_compute_v<Ntk, kitty::static_truth_table<NumVars>>, "Ntk does not implement the compute method for kitty::static_truth_table" );
+
+  assert( ps.cut_size <= NumVars );
+
+  cut_enumeration_stats st;
+  fast_network_cuts<Ntk, NumVars, ComputeTruth, CutData> res( ntk.size() );
+  detail::cut_enumeration_impl<Ntk, ComputeTruth, CutData, fast_network_cuts<Ntk, NumVars, ComputeTruth, CutData>> p( ntk, ps, st, res );
+  p.run();
+
+  if ( ps.verbose )
+  {
+    st.report();
+  }
+  if ( pst )
+  {
+    *pst = st;
+  }
+
+  return res;
+}
+
 // This function expects to receive a network where nodes are sorted in
 // topological order. Cuts are represented as a 64-bit bit vector where each bit
 // determines whether a given node exists in the cut.
@@ -32,12 +32,16 @@
 
 #pragma once
 
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <numeric>
 #include <optional>
-#include <set>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 #include "../networks/klut.hpp"
@@ -47,12 +51,15 @@
 #include "../utils/node_map.hpp"
 #include "../utils/progress_bar.hpp"
 #include "../utils/stopwatch.hpp"
+#include "../utils/thread_pool.hpp"
 #include "../views/cut_view.hpp"
 #include "../views/depth_view.hpp"
 #include "../views/fanout_view.hpp"
 #include "cleanup.hpp"
 #include "cut_enumeration.hpp"
+#include "detail/dry_run_overlay.hpp"
 #include "detail/mffc_utils.hpp"
+#include "detail/rewriting_library.hpp"
 #include "dont_cares.hpp"
 
 #include <fmt/format.h>
@@ -91,6 +98,9 @@ struct cut_rewriting_params
     greedy
   } candidate_selection_strategy = minimize_weight;
 
+  /*! \brief Time limit in milliseconds for improving the selected candidates by local search (0 = no local search). */
+  uint32_t mis_local_search_time{0u};
+
   /*! \brief Minimum candidate cut size */
   uint32_t min_cand_cut_size{3u};
 
@@ -100,6 +110,37 @@ struct cut_rewriting_params
   /*! \brief If true, candidates are only accepted if they do not increase logic level of node. */
   bool preserve_depth{false};
 
+  /*! \brief Number of threads for candidate synthesis (0 = default number of threads).
+   *
+   * Only used by `cut_rewriting_with_compatibility_graph`.  When this
+   * parameter is not 1, the rewriting function is called for all cuts in
+   * parallel, each thread synthesizing into its own scratch network.  The
+   * candidates are then copied into the network and their gain is evaluated
+   * in the same order as in the sequential algorithm, so the result does not
+   * depend on the number of threads.  The rewriting function must be safe to
+   * call concurrently, and must not depend on the network it synthesizes
+   * into beyond the given leaves.
+   */
+  uint32_t num_threads{1u};
+
+  /*! \brief Cache rewriting candidates by cut function.
+   *
+   * When true, the rewriting function is called only once for each cut
+   * function, into a scratch network, and its candidates are stored as
+   * compact index lists.  The candidates of all further cuts with the same
+   * function are instantiated from the cache, without calling the rewriting
+   * function again.  As for parallel candidate synthesis, the rewriting
+   * function must only depend on the function and the leaves.  The cache is
+   * not used together with don't cares or with `num_threads` other than 1.
+   *
+   * In `cut_rewriting`, the cached candidates of AIGs and XAGs are evaluated
+   * on a virtual overlay of the result network, using structural hashing
+   * lookups, and only the best candidate of each node is created.  This
+   * requires a structural cost function (see `is_structural_cost`), other
+   * cost functions evaluate the candidates in the result network.
+   */
+  bool use_candidate_cache{false};
+
   /*! \brief Show progress. */
   bool progress{false};
 
@@ -129,11 +170,21 @@ struct cut_rewriting_stats
   /*! \brief Runtime to find minimal independent set. */
   stopwatch<>::duration time_mis{0};
 
+  /*! \brief Number of cuts whose candidates were taken from the cache. */
+  uint32_t num_cache_hits{0u};
+
+  /*! \brief Number of cut functions passed to the rewriting function when caching. */
+  uint32_t num_cache_misses{0u};
+
   void report( bool show_time_mis = true ) const
   {
     fmt::print( "[i] total time     = {:>5.2f} secs\n", to_seconds( time_total ) );
     fmt::print( "[i] cut enum. time = {:>5.2f} secs\n", to_seconds( time_cuts ) );
     fmt::print( "[i] rewriting time = {:>5.2f} secs\n", to_seconds( time_rewriting ) );
+    if ( num_cache_hits + num_cache_misses > 0u )
+    {
+      fmt::print( "[i] cache hits     = {:>5} / {}\n", num_cache_hits, num_cache_hits + num_cache_misses );
+    }
     if ( show_time_mis )
     {
       fmt::print( "[i] ind. set time  = {:>5.2f} secs\n", to_seconds( time_mis ) );
@@ -144,142 +195,268 @@ struct cut_rewriting_stats
 namespace detail
 {
 
+/* undirected vertex-weighted graph in compressed sparse row format */
 class graph
 {
 public:
-  auto add_vertex( uint32_t weight )
-  {
-    auto index = _weights.size();
-    _weights.emplace_back( weight );
-    _adjacent.emplace_back();
-    ++_num_vertices;
-    return index;
-  }
+  graph() = default;
 
-  void add_edge( uint32_t v1, uint32_t v2 )
+  /* self-loops and parallel edges in `edges` are ignored */
+  graph( std::vector<int32_t> weights, std::vector<std::pair<uint32_t, uint32_t>> const& edges )
+      : _weights( std::move( weights ) ), _offsets( _weights.size() + 1u, 0u )
   {
-    if ( v1 == v2 )
-      return;
-    if ( _adjacent[v1].count( v2 ) )
-      return;
-
-    _adjacent[v1].insert( v2 );
-    _adjacent[v2].insert( v1 );
-    ++_num_edges;
-  }
-
-  void remove_vertex( uint32_t vertex )
-  {
-    assert( _weights[vertex] != -1 );
-    _weights[vertex] = -1;
-
-    _num_edges -= _adjacent[vertex].size();
+    for ( auto const& [v1, v2] : edges )
+    {
+      if ( v1 == v2 )
+        continue;
+      ++_offsets[v1 + 1u];
+      ++_offsets[v2 + 1u];
+    }
+    std::partial_sum( _offsets.begin(), _offsets.end(), _offsets.begin() );
 
-    for ( auto w : _adjacent[vertex] )
+    _adjacent.resize( _offsets.back() );
+    std::vector<uint32_t> fill( _offsets.begin(), _offsets.end() - 1 );
+    for ( auto const& [v1, v2] : edges )
     {
-      _adjacent[w].erase( vertex );
+      if ( v1 == v2 )
+        continue;
+      _adjacent[fill[v1]++] = v2;
+      _adjacent[fill[v2]++] = v1;
     }
-    _adjacent[vertex].clear();
 
-    --_num_vertices;
-  }
+    /* sort adjacency lists and remove parallel edges in place */
+    uint32_t pos{0u};
+    for ( auto v = 0u; v < _weights.size(); ++v )
+    {
+      auto const begin = _adjacent.begin() + _offsets[v];
+      auto const end = _adjacent.begin() + _offsets[v + 1u];
+      std::sort( begin, end );
+      auto const last = std::unique( begin, end );
 
-  bool has_vertex( uint32_t vertex ) const
-  {
-    return _weights[vertex] >= 0;
+      _offsets[v] = pos;
+      pos = static_cast<uint32_t>( std::copy( begin, last, _adjacent.begin() + pos ) - _adjacent.begin() );
+    }
+    _offsets.back() = pos;
+    _adjacent.resize( pos );
+    _adjacent.shrink_to_fit();
   }
 
   template<typename Fn>
   void foreach_adjacent( uint32_t vertex, Fn&& fn ) const
   {
-    std::for_each( _adjacent[vertex].begin(), _adjacent[vertex].end(), fn );
-  }
-
-  template<typename Fn>
-  void foreach_vertex( Fn&& fn ) const
-  {
-    for ( auto i = 0u; i < _weights.size(); ++i )
-    {
-      if ( has_vertex( i ) )
-      {
-        fn( i );
-      }
-    }
+    std::for_each( _adjacent.begin() + _offsets[vertex], _adjacent.begin() + _offsets[vertex + 1u], fn );
   }
 
-  auto degree( uint32_t vertex ) const { return _adjacent[vertex].size(); }
+  auto degree( uint32_t vertex ) const { return _offsets[vertex + 1u] - _offsets[vertex]; }
   auto weight( uint32_t vertex ) const { return _weights[vertex]; }
   auto gwmin_value( uint32_t vertex ) const { return (double)weight( vertex ) / ( degree( vertex ) + 1 ); }
   auto gwmax_value( uint32_t vertex ) const { return (double)weight( vertex ) / ( degree( vertex ) * ( degree( vertex ) + 1 ) ); }
 
-  auto num_vertices() const { return _num_vertices; }
-  auto num_edges() const { return _num_edges; }
+  auto num_vertices() const { return static_cast<uint32_t>( _weights.size() ); }
+  auto num_edges() const { return _adjacent.size() / 2u; }
 
 private:
-  uint32_t _num_vertices{0u};
-  std::size_t _num_edges{0u};
-
-  std::vector<std::set<uint32_t>> _adjacent;
-
-  std::vector<int32_t> _weights; /* degree = -1 means vertex is removed */
+  std::vector<int32_t> _weights;
+  std::vector<uint32_t> _offsets;
+  std::vector<uint32_t> _adjacent;
 };
 
-inline std::vector<uint32_t> maximum_weighted_independent_set_gwmin( graph& g )
+/* adds vertices to the independent set in the given order, skipping those adjacent to a vertex already in it */
+inline std::vector<uint32_t> greedy_independent_set( graph const& g, std::vector<uint32_t> const& order )
 {
   std::vector<uint32_t> mwis;
+  std::vector<bool> removed( g.num_vertices(), false );
 
+  for ( auto i : order )
+  {
+    if ( removed[i] )
+      continue;
+
+    mwis.emplace_back( i );
+    removed[i] = true;
+    g.foreach_adjacent( i, [&]( auto v ) { removed[v] = true; } );
+  }
+
+  return mwis;
+}
+
+inline std::vector<uint32_t> maximum_weighted_independent_set_gwmin( graph const& g )
+{
   std::vector<uint32_t> vertices( g.num_vertices() );
   std::iota( vertices.begin(), vertices.end(), 0 );
 
+  /* the order only depends on the initial degrees, so sorting once suffices */
   std::stable_sort( vertices.begin(), vertices.end(), [&g]( auto v, auto w ) {
     const auto value_v = g.gwmin_value( v );
     const auto value_w = g.gwmin_value( w );
     return value_v > value_w || ( value_v == value_w && g.degree( v ) > g.degree( w ) );
   } );
 
-  for ( auto i : vertices )
-  {
-    if ( !g.has_vertex( i ) )
-      continue;
+  return greedy_independent_set( g, vertices );
+}
 
-    /* add vertex to independent set, then remove it and all its neighbors */
-    mwis.emplace_back( i );
-    std::vector<uint32_t> neighbors;
-    g.foreach_adjacent( i, [&]( auto v ) { neighbors.emplace_back( v ); } );
-    g.remove_vertex( i );
+inline std::vector<uint32_t> maximal_weighted_independent_set( graph const& g )
+{
+  std::vector<uint32_t> vertices( g.num_vertices() );
+  std::iota( vertices.begin(), vertices.end(), 0 );
+
+  return greedy_independent_set( g, vertices );
+}
+
+/*! \brief Improves an independent set by local search.
+ *
+ * Two kinds of weighted swaps are applied until none of them improves the
+ * weight of the set, or until `time_limit` milliseconds have passed:
+ *
+ * - a vertex outside of the set replaces its neighbors in the set if its
+ *   weight exceeds their total weight;
+ * - a vertex in the set is replaced by some of its neighbors which are not
+ *   adjacent to any other vertex in the set (chosen greedily by weight) if
+ *   their total weight exceeds its weight.
+ *
+ * Each swap strictly increases the weight of the set.  Vertices that remain
+ * in the set keep their relative order, inserted vertices are appended.
+ */
+inline void improve_independent_set( graph const& g, std::vector<uint32_t>& mwis, uint32_t time_limit )
+{
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds( time_limit );
 
-    for ( auto v : neighbors )
+  std::vector<bool> in_set( g.num_vertices(), false );
+  /* number and total weight of neighbors in the set */
+  std::vector<uint32_t> tightness( g.num_vertices(), 0u );
+  std::vector<int64_t> blocking( g.num_vertices(), 0 );
+
+  std::vector<uint32_t> queue;
+  std::vector<bool> queued( g.num_vertices(), false );
+  const auto enqueue = [&]( uint32_t v ) {
+    if ( !queued[v] )
     {
-      g.remove_vertex( v );
+      queued[v] = true;
+      queue.push_back( v );
     }
-  }
+  };
 
-  return mwis;
-}
+  std::vector<uint32_t> inserted;
+  const auto update = [&]( uint32_t v, bool insert ) {
+    in_set[v] = insert;
+    if ( insert )
+    {
+      inserted.push_back( v );
+    }
+    g.foreach_adjacent( v, [&]( auto w ) {
+      tightness[w] += insert ? 1 : -1;
+      blocking[w] += insert ? g.weight( v ) : -g.weight( v );
+    } );
+  };
+  /* the swap candidates of vertices up to distance 2 from v may have changed */
+  const auto touch = [&]( uint32_t v ) {
+    enqueue( v );
+    g.foreach_adjacent( v, [&]( auto w ) {
+      enqueue( w );
+      g.foreach_adjacent( w, [&]( auto u ) {
+        if ( in_set[u] )
+          enqueue( u );
+      } );
+    } );
+  };
 
-inline std::vector<uint32_t> maximal_weighted_independent_set( graph& g )
-{
-  std::vector<uint32_t> mwis;
+  for ( auto v : mwis )
+  {
+    update( v, true );
+  }
+  inserted.clear();
+  for ( auto v = g.num_vertices(); v-- > 0u; )
+  {
+    enqueue( v );
+  }
 
-  auto num_vertices = g.num_vertices();
-  for ( auto i = 0u; i < num_vertices; ++i )
+  std::vector<bool> blocked( g.num_vertices(), false );
+  std::vector<uint32_t> changed;
+  auto iterations{0u};
+  while ( !queue.empty() )
   {
-    if ( !g.has_vertex( i ) )
-      continue;
+    if ( ( ++iterations & 0xffu ) == 0u && std::chrono::steady_clock::now() > deadline )
+      break;
 
-    /* add vertex to independent set, then remove it and all its neighbors */
-    mwis.emplace_back( i );
-    std::vector<uint32_t> neighbors;
-    g.foreach_adjacent( i, [&]( auto v ) { neighbors.emplace_back( v ); } );
-    g.remove_vertex( i );
+    const auto v = queue.back();
+    queue.pop_back();
+    queued[v] = false;
+    changed.clear();
+
+    if ( !in_set[v] )
+    {
+      if ( g.weight( v ) <= blocking[v] )
+        continue;
+
+      g.foreach_adjacent( v, [&]( auto w ) {
+        if ( in_set[w] )
+          changed.push_back( w );
+      } );
+      for ( auto w : changed )
+      {
+        update( w, false );
+      }
+      update( v, true );
+      changed.push_back( v );
+    }
+    else
+    {
+      /* neighbors that are only blocked by v, heaviest first */
+      std::vector<uint32_t> candidates;
+      g.foreach_adjacent( v, [&]( auto w ) {
+        if ( tightness[w] == 1u )
+          candidates.push_back( w );
+      } );
+      std::stable_sort( candidates.begin(), candidates.end(), [&]( auto a, auto b ) { return g.weight( a ) > g.weight( b ); } );
+
+      int64_t weight{0};
+      std::vector<uint32_t> chosen;
+      for ( auto w : candidates )
+      {
+        if ( blocked[w] )
+          continue;
+        chosen.push_back( w );
+        weight += g.weight( w );
+        g.foreach_adjacent( w, [&]( auto u ) { blocked[u] = true; } );
+      }
+      for ( auto w : chosen )
+      {
+        g.foreach_adjacent( w, [&]( auto u ) { blocked[u] = false; } );
+      }
+
+      if ( weight <= g.weight( v ) )
+        continue;
 
-    for ( auto v : neighbors )
+      update( v, false );
+      changed.push_back( v );
+      for ( auto w : chosen )
+      {
+        update( w, true );
+        changed.push_back( w );
+      }
+    }
+
+    for ( auto c : changed )
     {
-      g.remove_vertex( v );
+      touch( c );
     }
   }
 
-  return mwis;
+  /* keep the original order of the vertices that stayed, followed by the inserted ones */
+  std::vector<bool> listed( g.num_vertices(), false );
+  mwis.erase( std::remove_if( mwis.begin(), mwis.end(), [&]( auto v ) { return !in_set[v]; } ), mwis.end() );
+  for ( auto v : mwis )
+  {
+    listed[v] = true;
+  }
+  for ( auto v : inserted )
+  {
+    if ( in_set[v] && !listed[v] )
+    {
+      listed[v] = true;
+      mwis.push_back( v );
+    }
+  }
 }
 
 struct cut_enumeration_cut_rewriting_cut
@@ -295,12 +472,10 @@ std::tuple<graph, std::vector<std::pair<node<Ntk>, uint32_t>>> network_cuts_grap
   static_assert( has_foreach_node_v<Ntk>, "Ntk does not implement the foreach_node method" );
   static_assert( has_clear_visited_v<Ntk>, "Ntk does not implement the clear_visited method" );
 
-  graph g;
-
   using cut_addr = std::pair<node<Ntk>, uint32_t>;
-  std::vector<std::vector<cut_addr>> conflicts( cuts.nodes_size() );
+  std::vector<std::vector<uint32_t>> conflicts( cuts.nodes_size() );
   std::vector<cut_addr> vertex_to_cut_addr;
-  std::vector<std::vector<uint32_t>> cut_addr_to_vertex( cuts.nodes_size() );
+  std::vector<int32_t> weights;
 
   ntk.clear_visited();
 
@@ -332,40 +507,35 @@ std::tuple<graph, std::vector<std::pair<node<Ntk>, uint32_t>>> network_cuts_grap
       {
         leaves.push_back( ntk.index_to_node( leaf_index ) );
       }
+      auto const v = static_cast<uint32_t>( weights.size() );
       cut_view<Ntk> dcut( ntk, leaves, ntk.make_signal( n ) );
       dcut.foreach_gate( [&]( auto const& n2 ) {
         //if ( dcut.is_constant( n2 ) || dcut.is_pi( n2 ) )
         //  return;
-        conflicts[ntk.node_to_index( n2 )].emplace_back( n, cctr );
+        conflicts[ntk.node_to_index( n2 )].emplace_back( v );
       } );
 
-      auto v = g.add_vertex( ( *cut )->data.gain );
-      assert( v == vertex_to_cut_addr.size() );
+      weights.emplace_back( ( *cut )->data.gain );
       vertex_to_cut_addr.emplace_back( n, cctr );
-      cut_addr_to_vertex[ntk.node_to_index( n )].emplace_back( static_cast<uint32_t>( v ) );
 
       ++cctr;
     }
   } );
 
-  for ( auto n = 0u; n < conflicts.size(); ++n )
+  /* two cuts conflict if they share a gate */
+  std::vector<std::pair<uint32_t, uint32_t>> edges;
+  for ( auto const& vertices : conflicts )
   {
-    for ( auto j = 1u; j < conflicts[n].size(); ++j )
+    for ( auto j = 1u; j < vertices.size(); ++j )
     {
       for ( auto i = 0u; i < j; ++i )
       {
-        const auto [n1, c1] = conflicts[n][i];
-        const auto [n2, c2] = conflicts[n][j];
-
-        if ( cut_addr_to_vertex[ntk.node_to_index( n1 )][c1] != cut_addr_to_vertex[ntk.node_to_index( n2 )][c2] )
-        {
-          g.add_edge( cut_addr_to_vertex[ntk.node_to_index( n1 )][c1], cut_addr_to_vertex[ntk.node_to_index( n2 )][c2] );
-        }
+        edges.emplace_back( vertices[i], vertices[j] );
       }
     }
   }
 
-  return {g, vertex_to_cut_addr};
+  return {graph( std::move( weights ), edges ), vertex_to_cut_addr};
 }
 
 template<class Ntk, class RewritingFn, class Iterator, class = void>
@@ -397,11 +567,12 @@ public:
         rewriting_fn( rewriting_fn ),
         ps( ps ),
         st( st ),
-        cost_fn( cost_fn ) {}
+        cost_fn( cost_fn ),
+        workers( resolve_num_threads( ps.num_threads ), [this]() { return std::make_unique<rewriting_worker>( this->ps.cut_enumeration_ps.cut_size ); } ) {}
 
   void run()
   {
-    stopwatch t( st.time_total );
+    stopwatch t( st.time_total, "cut_rewriting" );
 
     /* enumerate cuts */
     const auto cuts = call_with_stopwatch( st.time_cuts, [&]() { return cut_enumeration<Ntk, true, cut_enumeration_cut_rewriting_cut>( ntk, ps.cut_enumeration_ps ); } );
@@ -415,6 +586,24 @@ public:
     /* store best replacement for each cut */
     node_map<std::vector<signal<Ntk>>, Ntk> best_replacements( ntk );
 
+    /* in parallel mode, candidates are synthesized up front and replayed in the loop below */
+    std::vector<rewriting_job> jobs;
+    if ( ps.num_threads != 1u )
+    {
+      call_with_stopwatch( st.time_rewriting, [&]() {
+        synthesize_candidates( cuts, jobs );
+      } );
+    }
+    auto next_job = 0u;
+
+    /* candidates per cut function */
+    const bool use_cache = ps.use_candidate_cache && ps.num_threads == 1u && !ps.use_dont_cares;
+    std::optional<rewriting_library<Ntk>> library;
+    if ( use_cache )
+    {
+      library.emplace( std::max( 1u, ps.cut_enumeration_ps.cut_size ) );
+    }
+
     /* iterate over all original nodes in the network */
     const auto size = ntk.size();
     auto max_total_gain = 0u;
@@ -450,14 +639,14 @@ public:
           children.push_back( ntk.make_signal( ntk.index_to_node( l ) ) );
         }
 
-        int32_t value = recursive_deref<Ntk, NodeCostFn>( ntk, n );
+        int32_t value = recursive_deref( ntk, n, cost_fn );
         {
           stopwatch t( st.time_rewriting );
           int32_t best_gain{-1};
 
           const auto on_signal = [&]( auto const& f_new ) {
             auto [v, contains] = recursive_ref_contains( ntk.get_node( f_new ), n );
-            recursive_deref<Ntk, NodeCostFn>( ntk, ntk.get_node( f_new ) );
+            recursive_deref( ntk, ntk.get_node( f_new ), cost_fn );
 
             int32_t gain = contains ? -1 : value - v;
 
@@ -478,7 +667,23 @@ public:
             return true;
           };
 
-          if ( ps.use_dont_cares )
+          if ( ps.num_threads != 1u )
+          {
+            auto const& job = jobs[next_job++];
+            assert( job.root == n );
+            std::unordered_map<node<base_ntk_t>, signal<Ntk>> copies;
+            for ( auto const& f : job.candidates )
+            {
+              on_signal( copy_candidate( workers[job.worker], f, children, copies ) );
+            }
+          }
+          else if ( use_cache )
+          {
+            library->foreach_candidate( library->lookup( tt, rewriting_fn ), [&]( auto const& c ) {
+              return on_signal( library->instantiate( ntk, c, children.begin() ) );
+            } );
+          }
+          else if ( ps.use_dont_cares )
           {
             if constexpr ( has_rewrite_with_dont_cares_v<Ntk, RewritingFn, decltype( children.begin() )> )
             {
@@ -505,13 +710,19 @@ public:
           }
         }
 
-        recursive_ref<Ntk, NodeCostFn>( ntk, n );
+        recursive_ref( ntk, n, cost_fn );
       }
 
       return true;
     } );
 
-    stopwatch t2( st.time_mis );
+    if ( library )
+    {
+      st.num_cache_hits += library->num_hits();
+      st.num_cache_misses += library->num_misses();
+    }
+
+    stopwatch t2( st.time_mis, "candidate_selection" );
     auto [g, map] = network_cuts_graph( ntk, cuts, ps );
 
     if ( ps.very_verbose )
@@ -519,7 +730,11 @@ public:
       std::cout << "[i] replacement dependency graph has " << g.num_vertices() << " vertices and " << g.num_edges() << " edges\n";
     }
 
-    const auto is = ( ps.candidate_selection_strategy == cut_rewriting_params::minimize_weight ) ? maximum_weighted_independent_set_gwmin( g ) : maximal_weighted_independent_set( g );
+    auto is = ( ps.candidate_selection_strategy == cut_rewriting_params::minimize_weight ) ? maximum_weighted_independent_set_gwmin( g ) : maximal_weighted_independent_set( g );
+    if ( ps.mis_local_search_time > 0u )
+    {
+      improve_independent_set( g, is, ps.mis_local_search_time );
+    }
 
     if ( ps.very_verbose )
     {
@@ -554,6 +769,33 @@ public:
   }
 
 private:
+  using base_ntk_t = typename Ntk::base_type;
+
+  /* a cut whose candidates are synthesized in parallel */
+  struct rewriting_job
+  {
+    node<Ntk> root;
+    kitty::dynamic_truth_table function;
+    std::optional<kitty::dynamic_truth_table> dont_cares;
+    uint32_t worker{0u};
+    std::vector<signal<base_ntk_t>> candidates;
+  };
+
+  /* thread-local scratch network whose PIs stand for the cut leaves */
+  struct rewriting_worker
+  {
+    explicit rewriting_worker( uint32_t num_leaves )
+    {
+      for ( auto i = 0u; i < num_leaves; ++i )
+      {
+        leaves.push_back( scratch.create_pi() );
+      }
+    }
+
+    base_ntk_t scratch;
+    std::vector<signal<base_ntk_t>> leaves;
+  };
+
   std::pair<int32_t, bool> recursive_ref_contains( node<Ntk> const& n, node<Ntk> const& repl )
   {
     /* terminate? */
@@ -575,12 +817,112 @@ private:
     return {value, contains};
   }
 
+  /* synthesizes the candidates of all cuts into per-thread scratch networks,
+   * the jobs are in the same order as they are visited in `run` */
+  template<class Cuts>
+  void synthesize_candidates( Cuts const& cuts, std::vector<rewriting_job>& jobs )
+  {
+    const auto size = ntk.size();
+    ntk.foreach_node( [&]( auto const& n, auto index ) {
+      if ( index >= size )
+        return false;
+      if ( ntk.is_constant( n ) || ntk.is_pi( n ) )
+        return true;
+      if ( mffc_size( ntk, n ) == 1 )
+        return true;
+
+      for ( auto& cut : cuts.cuts( ntk.node_to_index( n ) ) )
+      {
+        if ( cut->size() < ps.min_cand_cut_size )
+          continue;
+
+        auto& job = jobs.emplace_back();
+        job.root = n;
+        job.function = cuts.truth_table( *cut );
+        if constexpr ( has_rewrite_with_dont_cares_v<base_ntk_t, RewritingFn, typename std::vector<signal<base_ntk_t>>::iterator> )
+        {
+          if ( ps.use_dont_cares )
+          {
+            std::vector<node<Ntk>> pivots;
+            for ( auto l : *cut )
+            {
+              pivots.push_back( ntk.index_to_node( l ) );
+            }
+            job.dont_cares = satisfiability_dont_cares( ntk, pivots );
+          }
+        }
+      }
+      return true;
+    } );
+
+    workers.clear();
+    default_thread_pool().parallel_for(
+        0u, jobs.size(), [&]( uint64_t j, uint32_t t ) {
+          auto& w = workers[t];
+          auto& job = jobs[j];
+          job.worker = t;
+
+          auto const begin = w.leaves.begin();
+          auto const leaves_end = begin + job.function.num_vars();
+          auto const on_signal = [&]( auto const& f ) {
+            job.candidates.push_back( f );
+            return true;
+          };
+
+          if constexpr ( has_rewrite_with_dont_cares_v<base_ntk_t, RewritingFn, typename std::vector<signal<base_ntk_t>>::iterator> )
+          {
+            if ( job.dont_cares )
+            {
+              rewriting_fn( w.scratch, job.function, *job.dont_cares, begin, leaves_end, on_signal );
+              return;
+            }
+          }
+          rewriting_fn( w.scratch, job.function, begin, leaves_end, on_signal );
+        },
+        workers.size() );
+  }
+
+  /* copies the cone of `f` from a scratch network into the network, on top of `children` */
+  signal<Ntk> copy_candidate( rewriting_worker const& w, signal<base_ntk_t> const& f, std::vector<signal<Ntk>> const& children, std::unordered_map<node<base_ntk_t>, signal<Ntk>>& copies )
+  {
+    auto const& scratch = w.scratch;
+    auto const n = scratch.get_node( f );
+
+    signal<Ntk> s;
+    if ( scratch.is_constant( n ) )
+    {
+      s = ntk.get_constant( scratch.constant_value( n ) );
+    }
+    else if ( scratch.is_pi( n ) )
+    {
+      /* the scratch PIs are created right after the constants */
+      s = children[scratch.node_to_index( n ) - scratch.node_to_index( scratch.get_node( w.leaves.front() ) )];
+    }
+    else if ( auto it = copies.find( n ); it != copies.end() )
+    {
+      s = it->second;
+    }
+    else
+    {
+      std::vector<signal<Ntk>> fanins;
+      scratch.foreach_fanin( n, [&]( auto const& fi ) {
+        fanins.push_back( copy_candidate( w, fi, children, copies ) );
+      } );
+      s = ntk.clone_node( scratch, n, fanins );
+      copies.emplace( n, s );
+    }
+
+    return scratch.is_complemented( f ) ? ntk.create_not( s ) : s;
+  }
+
 private:
   Ntk& ntk;
   RewritingFn&& rewriting_fn;
   cut_rewriting_params const& ps;
   cut_rewriting_stats& st;
   NodeCostFn cost_fn;
+
+  per_thread<rewriting_worker> workers;
 };
 
 } /* namespace detail */
@@ -675,18 +1017,36 @@ void cut_rewriting_with_compatibility_graph( Ntk& ntk, RewritingFn&& rewriting_f
 namespace detail
 {
 
+/* stateful cost functions (e.g., switching_activity_cost) that can be bound
+ * to a network built from another one and take over the costs of replaced nodes */
+template<class NodeCostFn, class Ntk, class = void>
+struct has_bind_cost : std::false_type
+{
+};
+
+template<class NodeCostFn, class Ntk>
+struct has_bind_cost<NodeCostFn, Ntk,
+                     std::void_t<decltype( std::declval<NodeCostFn const&>().bind( std::declval<Ntk const&>() ) ),
+                                 decltype( std::declval<NodeCostFn&>().inherit( std::declval<Ntk const&>(), std::declval<signal<Ntk>>(), std::declval<NodeCostFn const&>(), std::declval<Ntk const&>(), std::declval<node<Ntk>>() ) )>> : std::true_type
+{
+};
+
+template<class NodeCostFn, class Ntk>
+inline constexpr bool has_bind_cost_v = has_bind_cost<NodeCostFn, Ntk>::value;
+
 template<class NtkDest, class Ntk, class RewritingFn, class NodeCostFn>
 struct cut_rewriting_impl
 {
-  cut_rewriting_impl( Ntk const& ntk, RewritingFn const& rewriting_fn, cut_rewriting_params const& ps, cut_rewriting_stats& st )
+  cut_rewriting_impl( Ntk const& ntk, RewritingFn const& rewriting_fn, cut_rewriting_params const& ps, cut_rewriting_stats& st, NodeCostFn const& cost_fn = {} )
       : ntk_( ntk ),
         rewriting_fn_( rewriting_fn ),
         ps_( ps ),
-        st_( st ) {}
+        st_( st ),
+        cost_fn_( cost_fn ) {}
 
   NtkDest run()
   {
-    stopwatch t( st_.time_total );
+    stopwatch t( st_.time_total, "cut_rewriting" );
 
     /* initial node map */
     node_map<signal<Ntk>, Ntk> old2new( ntk_ );
@@ -700,6 +1060,34 @@ struct cut_rewriting_impl
       old2new[n] = res.create_pi();
     } );
 
+    /* candidates are costed in `res` in the context of `ntk_`: a stateful cost
+     * function is bound to `res`, in which each node takes over the cost of the
+     * node in `ntk_` it is equivalent to */
+    auto res_cost_fn = [&]() {
+      if constexpr ( has_bind_cost_v<NodeCostFn, Ntk> )
+      {
+        return cost_fn_.bind( res );
+      }
+      else
+      {
+        return cost_fn_;
+      }
+    }();
+    const auto take_over = [&]( auto const& f, auto const& n ) {
+      if constexpr ( has_bind_cost_v<NodeCostFn, Ntk> )
+      {
+        res_cost_fn.inherit( res, f, cost_fn_, ntk_, n );
+      }
+      else
+      {
+        (void)f;
+        (void)n;
+      }
+    };
+    ntk_.foreach_pi( [&]( auto const& n ) {
+      take_over( old2new[n], n );
+    } );
+
     /* enumerate cuts */
     const auto cuts = call_with_stopwatch( st_.time_cuts, [&]() { return cut_enumeration<Ntk, true, cut_enumeration_cut_rewriting_cut>( ntk_, ps_.cut_enumeration_ps ); } );
 
@@ -707,14 +1095,23 @@ struct cut_rewriting_impl
     initialize_values_with_fanout( ntk_ );
 
     /* original cost */
-    const auto orig_cost = costs<Ntk, NodeCostFn>( ntk_ );
+    const auto orig_cost = costs<Ntk, NodeCostFn>( ntk_, cost_fn_ );
+
+    /* candidates per cut function, which are evaluated on an overlay if possible */
+    std::optional<rewriting_library<Ntk>> library;
+    if ( ps_.use_candidate_cache )
+    {
+      library.emplace( std::max( 1u, ps_.cut_enumeration_ps.cut_size ) );
+    }
+    dry_run_overlay<Ntk> overlay( res );
 
     progress_bar pbar{ntk_.num_gates(), "cut_rewriting |{0}| node = {1:>4} / " + std::to_string( ntk_.num_gates() ) + "   original cost = " + std::to_string( orig_cost ), ps_.progress};
     ntk_.foreach_gate( [&]( auto const& n, auto i ) {
       pbar( i, i );
 
       /* nothing to optimize? */
-      int32_t value = mffc_size<Ntk, NodeCostFn>( ntk_, n );
+      int32_t value = recursive_deref( ntk_, n, cost_fn_ );
+      recursive_ref( ntk_, n, cost_fn_ );
       if ( value == 1 )
       {
         std::vector<signal<Ntk>> children( ntk_.fanin_size( n ) );
@@ -729,6 +1126,8 @@ struct cut_rewriting_impl
         /* foreach cut */
         int32_t best_gain = -1;
         signal<Ntk> best_signal;
+        std::optional<uint32_t> best_candidate;
+        std::vector<signal<Ntk>> best_children;
         for ( auto& cut : cuts.cuts( ntk_.node_to_index( n ) ) )
         {
           /* skip small enough cuts */
@@ -746,8 +1145,9 @@ struct cut_rewriting_impl
           }
 
           const auto on_signal = [&]( auto const& f_new ) {
-            auto value2 = recursive_ref<Ntk, NodeCostFn>( res, res.get_node( f_new ) );
-            recursive_deref<Ntk, NodeCostFn>( res, res.get_node( f_new ) );
+            take_over( f_new, n );
+            auto value2 = recursive_ref( res, res.get_node( f_new ), res_cost_fn );
+            recursive_deref( res, res.get_node( f_new ), res_cost_fn );
             int32_t gain = value - value2;
 
             if ( ( gain > 0 || ( ps_.allow_zero_gain && gain == 0 ) ) && gain > best_gain )
@@ -758,19 +1158,52 @@ struct cut_rewriting_impl
                 {
                   best_gain = gain;
                   best_signal = f_new;
+                  best_candidate = std::nullopt;
                 }
               }
               else
               {
                 best_gain = gain;
                 best_signal = f_new;
+                best_candidate = std::nullopt;
               }
             }
 
             return true;
           };
           stopwatch<> t( st_.time_rewriting );
-          rewriting_fn_( res, cuts.truth_table( *cut ), children.begin(), children.end(), on_signal );
+          if ( ps_.use_candidate_cache )
+          {
+            library->foreach_candidate( library->lookup( tt, rewriting_fn_ ), [&]( auto const& c ) {
+              if constexpr ( dry_run_overlay<Ntk>::template is_supported<NodeCostFn> )
+              {
+                /* only the best candidate is created after all cuts have been evaluated */
+                if ( overlay.build( *library, c, children.begin() ) )
+                {
+                  int32_t gain = value - overlay.recursive_ref( cost_fn_ );
+                  overlay.recursive_deref( cost_fn_ );
+
+                  if ( ( gain > 0 || ( ps_.allow_zero_gain && gain == 0 ) ) && gain > best_gain )
+                  {
+                    best_gain = gain;
+                    best_candidate = c;
+                    best_children = children;
+                  }
+                  return true;
+                }
+              }
+              return on_signal( library->instantiate( res, c, children.begin() ) );
+            } );
+          }
+          else
+          {
+            rewriting_fn_( res, cuts.truth_table( *cut ), children.begin(), children.end(), on_signal );
+          }
+        }
+
+        if ( best_candidate )
+        {
+          best_signal = library->instantiate( res, *best_candidate, best_children.begin() );
         }
 
         if ( best_gain == -1 )
@@ -788,7 +1221,8 @@ struct cut_rewriting_impl
         }
       }
 
-      recursive_ref<Ntk, NodeCostFn>( res, res.get_node( old2new[n] ) );
+      take_over( old2new[n], n );
+      recursive_ref( res, res.get_node( old2new[n] ), res_cost_fn );
     } );
 
     /* create POs */
@@ -796,10 +1230,25 @@ struct cut_rewriting_impl
       res.create_po( ntk_.is_complemented( f ) ? res.create_not( old2new[f] ) : old2new[f] );
     } );
 
-    NtkDest ret = cleanup_dangling<NtkDest>( res );
+    if ( library )
+    {
+      st_.num_cache_hits += library->num_hits();
+      st_.num_cache_misses += library->num_misses();
+    }
 
-    /* new costs */
-    return costs<NtkDest, NodeCostFn>( ret ) > orig_cost ? static_cast<NtkDest>( ntk_ ) : ret;
+    /* new costs of the nodes in the transitive fanin of the outputs, with the
+     * same estimator as the candidates */
+    uint32_t new_cost{0u};
+    res.clear_values();
+    res.foreach_po( [&]( auto const& f ) {
+      if ( res.incr_value( res.get_node( f ) ) == 0u )
+      {
+        new_cost += recursive_ref( res, res.get_node( f ), res_cost_fn );
+      }
+    } );
+
+    NtkDest ret = cleanup_dangling<NtkDest>( res );
+    return new_cost > orig_cost ? static_cast<NtkDest>( ntk_ ) : ret;
   }
 
 private:
@@ -807,6 +1256,7 @@ private:
   RewritingFn const& rewriting_fn_;
   cut_rewriting_params const& ps_;
   cut_rewriting_stats& st_;
+  NodeCostFn cost_fn_;
 };
 
 } // namespace detail
@@ -834,20 +1284,21 @@ private:
  * \param rewriting_fn Rewriting function
  * \param ps Rewriting params
  * \param pst Rewriting statistics
+ * \param cost_fn Node cost function (a functor with signature `uint32_t(Ntk const&, node<Ntk> const&)`)
  */
 template<class Ntk, class RewritingFn, class NodeCostFn = unit_cost<Ntk>>
-Ntk cut_rewriting( Ntk const& ntk, RewritingFn const& rewriting_fn = {}, cut_rewriting_params const& ps = {}, cut_rewriting_stats* pst = nullptr )
+Ntk cut_rewriting( Ntk const& ntk, RewritingFn const& rewriting_fn = {}, cut_rewriting_params const& ps = {}, cut_rewriting_stats* pst = nullptr, NodeCostFn const& cost_fn = {} )
 {
   cut_rewriting_stats st;
   const auto result = [&]() {
     if ( ps.preserve_depth )
     {
-      depth_view<Ntk, NodeCostFn> depth_ntk{ntk};
-      return detail::cut_rewriting_impl<Ntk, depth_view<Ntk, NodeCostFn>, RewritingFn, NodeCostFn>( depth_ntk, rewriting_fn, ps, st ).run();
+      depth_view<Ntk, NodeCostFn> depth_ntk{ntk, cost_fn};
+      return detail::cut_rewriting_impl<Ntk, depth_view<Ntk, NodeCostFn>, RewritingFn, NodeCostFn>( depth_ntk, rewriting_fn, ps, st, cost_fn ).run();
     }
     else
     {
-      return detail::cut_rewriting_impl<Ntk, Ntk, RewritingFn, NodeCostFn>( ntk, rewriting_fn, ps, st ).run();
+      return detail::cut_rewriting_impl<Ntk, Ntk, RewritingFn, NodeCostFn>( ntk, rewriting_fn, ps, st, cost_fn ).run();
     }
   }();
 
@@ -0,0 +1,315 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2019  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file dry_run_overlay.hpp
+  \brief Virtual overlay to evaluate candidates without creating them
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../../traits.hpp"
+#include "../../utils/cost_functions.hpp"
+#include "rewriting_library.hpp"
+
+namespace mockturtle::detail
+{
+
+/* Builds candidates of a `rewriting_library` virtually on top of a network.
+ *
+ * Gates are looked up in the structural hash table of the network with
+ * `has_and` and `has_xor`, and only gates that do not exist yet are recorded
+ * in a scratch buffer.  Their signals use the indexes that the gates would get
+ * if they were created in order, such that the normalization rules of the
+ * network apply to them as well.  Reference counting on the overlay gives the
+ * same values as on the network after creating the candidate, but leaves the
+ * network unchanged.
+ *
+ * Virtual gates are costed by their prototype in the scratch network of the
+ * library, i.e., out of context.  The overlay therefore only supports
+ * structural cost functions (see `is_structural_cost`); for other cost
+ * functions, such as `switching_activity_cost`, candidates must be created in
+ * the network.
+ */
+template<class Ntk>
+class dry_run_overlay
+{
+public:
+  using scratch_t = typename rewriting_library<Ntk>::scratch_t;
+
+  template<class NodeCostFn>
+  static constexpr bool is_supported = std::is_same_v<Ntk, scratch_t> && has_has_and_v<Ntk> && is_structural_cost_v<NodeCostFn>;
+
+  explicit dry_run_overlay( Ntk const& ntk )
+      : ntk( ntk )
+  {
+  }
+
+  /* builds candidate `c` on top of the leaves starting at `begin`, returns
+   * std::nullopt if the candidate has gates that cannot be looked up */
+  template<class LeavesIterator>
+  std::optional<signal<Ntk>> build( rewriting_library<Ntk> const& library, typename rewriting_library<Ntk>::candidate c, LeavesIterator begin )
+  {
+    _scratch = &library.scratch();
+    _num_leaves = library.num_leaves();
+    _base = ntk.size();
+    _gates.clear();
+    _signals.clear();
+
+    bool supported = true;
+    const auto output = library.foreach_gate( c, [&]( auto const& gate, uint32_t const* fanins, uint32_t num_fanins ) {
+      if ( !supported || num_fanins != 2u )
+      {
+        supported = false;
+        return;
+      }
+
+      const auto a = literal_to_signal( fanins[0], begin );
+      const auto b = literal_to_signal( fanins[1], begin );
+      if ( _scratch->is_and( gate ) )
+      {
+        _signals.push_back( create_and( a, b, gate ) );
+        return;
+      }
+      if constexpr ( has_has_xor_v<Ntk> )
+      {
+        if ( _scratch->is_xor( gate ) )
+        {
+          _signals.push_back( create_xor( a, b, gate ) );
+          return;
+        }
+      }
+      supported = false;
+    } );
+
+    if ( !supported )
+    {
+      return std::nullopt;
+    }
+    _root = literal_to_signal( output, begin );
+    return _root;
+  }
+
+  /* returns whether `n` is a gate of the overlay */
+  bool is_virtual( node<Ntk> const& n ) const
+  {
+    return ntk.node_to_index( n ) >= _base;
+  }
+
+  /* number of gates of the last candidate that are not in the network */
+  uint32_t num_virtual_gates() const
+  {
+    return static_cast<uint32_t>( _gates.size() );
+  }
+
+  /* references the last candidate and returns the cost of its new nodes */
+  template<class NodeCostFn>
+  uint32_t recursive_ref( NodeCostFn const& cost_fn )
+  {
+    return recursive_ref( ntk.get_node( _root ), cost_fn );
+  }
+
+  /* undoes `recursive_ref` */
+  template<class NodeCostFn>
+  uint32_t recursive_deref( NodeCostFn const& cost_fn )
+  {
+    return recursive_deref( ntk.get_node( _root ), cost_fn );
+  }
+
+private:
+  struct virtual_gate
+  {
+    signal<Ntk> children[2];
+    node<scratch_t> prototype;
+    uint32_t value{0u};
+  };
+
+  template<class LeavesIterator>
+  signal<Ntk> literal_to_signal( uint32_t lit, LeavesIterator begin ) const
+  {
+    const auto id = lit >> 1u;
+    const bool complement = lit & 1u;
+    if ( id == 0u )
+    {
+      return ntk.get_constant( complement );
+    }
+
+    const auto s = id <= _num_leaves ? signal<Ntk>( *std::next( begin, id - 1u ) ) : _signals[id - 1u - _num_leaves];
+    return complement ? !s : s;
+  }
+
+  signal<Ntk> create_and( signal<Ntk> a, signal<Ntk> b, node<scratch_t> const& prototype )
+  {
+    if ( ntk.node_to_index( ntk.get_node( a ) ) < _base && ntk.node_to_index( ntk.get_node( b ) ) < _base )
+    {
+      if ( const auto f = ntk.has_and( a, b ) )
+      {
+        return *f;
+      }
+    }
+
+    /* same normalization as in create_and */
+    if ( a.index > b.index )
+    {
+      std::swap( a, b );
+    }
+    if ( a.index == b.index )
+    {
+      return a.complement == b.complement ? a : ntk.get_constant( false );
+    }
+    else if ( a.index == 0 )
+    {
+      return a.complement ? b : ntk.get_constant( false );
+    }
+    return find_or_add( a, b, prototype );
+  }
+
+  signal<Ntk> create_xor( signal<Ntk> a, signal<Ntk> b, node<scratch_t> const& prototype )
+  {
+    if ( ntk.node_to_index( ntk.get_node( a ) ) < _base && ntk.node_to_index( ntk.get_node( b ) ) < _base )
+    {
+      if ( const auto f = ntk.has_xor( a, b ) )
+      {
+        return *f;
+      }
+    }
+
+    /* same normalization as in create_xor */
+    if ( a.index < b.index )
+    {
+      std::swap( a, b );
+    }
+    const bool f_compl = a.complement != b.complement;
+    a.complement = b.complement = false;
+    if ( a.index == b.index )
+    {
+      return ntk.get_constant( f_compl );
+    }
+    else if ( b.index == 0 )
+    {
+      return f_compl ? !a : a;
+    }
+    const auto f = find_or_add( a, b, prototype );
+    return f_compl ? !f : f;
+  }
+
+  signal<Ntk> find_or_add( signal<Ntk> const& a, signal<Ntk> const& b, node<scratch_t> const& prototype )
+  {
+    for ( auto i = 0u; i < _gates.size(); ++i )
+    {
+      if ( _gates[i].children[0] == a && _gates[i].children[1] == b )
+      {
+        return signal<Ntk>( _base + i, 0 );
+      }
+    }
+    _gates.push_back( {{a, b}, prototype} );
+    return signal<Ntk>( _base + _gates.size() - 1u, 0 );
+  }
+
+  template<class NodeCostFn>
+  uint32_t recursive_ref( node<Ntk> const& n, NodeCostFn const& cost_fn )
+  {
+    static_assert( is_structural_cost_v<NodeCostFn>, "NodeCostFn cannot cost gates out of context" );
+
+    if ( !is_virtual( n ) )
+    {
+      if ( ntk.is_constant( n ) || ntk.is_pi( n ) )
+        return 0;
+
+      uint32_t value{cost_fn( ntk, n )};
+      ntk.foreach_fanin( n, [&]( auto const& s ) {
+        if ( ntk.incr_value( ntk.get_node( s ) ) == 0 )
+        {
+          value += recursive_ref( ntk.get_node( s ), cost_fn );
+        }
+      } );
+      return value;
+    }
+
+    auto const& g = _gates[ntk.node_to_index( n ) - _base];
+    uint32_t value{cost_fn( *_scratch, g.prototype )};
+    for ( auto const& s : g.children )
+    {
+      const auto child = ntk.get_node( s );
+      if ( is_virtual( child ) ? _gates[ntk.node_to_index( child ) - _base].value++ == 0 : ntk.incr_value( child ) == 0 )
+      {
+        value += recursive_ref( child, cost_fn );
+      }
+    }
+    return value;
+  }
+
+  template<class NodeCostFn>
+  uint32_t recursive_deref( node<Ntk> const& n, NodeCostFn const& cost_fn )
+  {
+    static_assert( is_structural_cost_v<NodeCostFn>, "NodeCostFn cannot cost gates out of context" );
+
+    if ( !is_virtual( n ) )
+    {
+      if ( ntk.is_constant( n ) || ntk.is_pi( n ) )
+        return 0;
+
+      uint32_t value{cost_fn( ntk, n )};
+      ntk.foreach_fanin( n, [&]( auto const& s ) {
+        if ( ntk.decr_value( ntk.get_node( s ) ) == 0 )
+        {
+          value += recursive_deref( ntk.get_node( s ), cost_fn );
+        }
+      } );
+      return value;
+    }
+
+    auto const& g = _gates[ntk.node_to_index( n ) - _base];
+    uint32_t value{cost_fn( *_scratch, g.prototype )};
+    for ( auto const& s : g.children )
+    {
+      const auto child = ntk.get_node( s );
+      if ( ( is_virtual( child ) ? --_gates[ntk.node_to_index( child ) - _base].value : ntk.decr_value( child ) ) == 0 )
+      {
+        value += recursive_deref( child, cost_fn );
+      }
+    }
+    return value;
+  }
+
+private:
+  Ntk const& ntk;
+  scratch_t const* _scratch{nullptr};
+  uint32_t _num_leaves{0u};
+  uint64_t _base{0u};
+
+  std::vector<virtual_gate> _gates;
+  std::vector<signal<Ntk>> _signals;
+  signal<Ntk> _root;
+};
+
+} // namespace mockturtle::detail
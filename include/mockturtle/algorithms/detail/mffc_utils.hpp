@@ -36,6 +36,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <type_traits>
 
 #include "../../traits.hpp"
 #include "../../utils/cost_functions.hpp"
@@ -58,42 +59,54 @@ void initialize_values_with_fanout( Ntk& ntk )
   } );
 }
 
-template<typename Ntk, typename TermCond, class NodeCostFn = unit_cost<Ntk>>
-uint32_t recursive_deref( Ntk const& ntk, node<Ntk> const& n, TermCond const& terminate )
+template<typename Ntk, typename TermCond, class NodeCostFn>
+uint32_t recursive_deref( Ntk const& ntk, node<Ntk> const& n, TermCond const& terminate, NodeCostFn const& cost_fn )
 {
   /* terminate? */
   if ( terminate( n ) )
     return 0;
 
   /* recursively collect nodes */
-  uint32_t value = NodeCostFn{}( ntk, n );
+  uint32_t value = cost_fn( ntk, n );
   ntk.foreach_fanin( n, [&]( auto const& s ) {
     if ( ntk.decr_value( ntk.get_node( s ) ) == 0 )
     {
-      value += recursive_deref<Ntk, TermCond, NodeCostFn>( ntk, ntk.get_node( s ), terminate );
+      value += recursive_deref( ntk, ntk.get_node( s ), terminate, cost_fn );
     }
   } );
   return value;
 }
 
-template<typename Ntk, typename TermCond, class NodeCostFn = unit_cost<Ntk>>
-uint32_t recursive_ref( Ntk const& ntk, node<Ntk> const& n, TermCond const& terminate )
+template<typename Ntk, typename TermCond, class NodeCostFn>
+uint32_t recursive_ref( Ntk const& ntk, node<Ntk> const& n, TermCond const& terminate, NodeCostFn const& cost_fn )
 {
   /* terminate? */
   if ( terminate( n ) )
     return 0;
 
   /* recursively collect nodes */
-  uint32_t value = NodeCostFn{}( ntk, n );
+  uint32_t value = cost_fn( ntk, n );
   ntk.foreach_fanin( n, [&]( auto const& s ) {
     if ( ntk.incr_value( ntk.get_node( s ) ) == 0 )
     {
-      value += recursive_ref<Ntk, TermCond, NodeCostFn>( ntk, ntk.get_node( s ), terminate );
+      value += recursive_ref( ntk, ntk.get_node( s ), terminate, cost_fn );
     }
   } );
   return value;
 }
 
+template<typename Ntk, typename TermCond, class NodeCostFn = unit_cost<Ntk>, std::enable_if_t<std::is_invocable_v<TermCond const&, node<Ntk> const&>, int> = 0>
+uint32_t recursive_deref( Ntk const& ntk, node<Ntk> const& n, TermCond const& terminate )
+{
+  return recursive_deref( ntk, n, terminate, NodeCostFn{} );
+}
+
+template<typename Ntk, typename TermCond, class NodeCostFn = unit_cost<Ntk>, std::enable_if_t<std::is_invocable_v<TermCond const&, node<Ntk> const&>, int> = 0>
+uint32_t recursive_ref( Ntk const& ntk, node<Ntk> const& n, TermCond const& terminate )
+{
+  return recursive_ref( ntk, n, terminate, NodeCostFn{} );
+}
+
 template<typename Ntk, typename LeavesIterator, class NodeCostFn = unit_cost<Ntk>>
 uint32_t recursive_deref( Ntk const& ntk, node<Ntk> const& n, LeavesIterator begin, LeavesIterator end )
 {
@@ -122,6 +135,22 @@ uint32_t recursive_ref( Ntk const& ntk, node<Ntk> const& n )
   return recursive_ref<Ntk, decltype( terminate ), NodeCostFn>( ntk, n, terminate );
 }
 
+/* MFFC bounded by constants and primary inputs, costed with an instance of a
+ * (possibly stateful) node cost function */
+template<typename Ntk, class NodeCostFn, std::enable_if_t<std::is_invocable_v<NodeCostFn const&, Ntk const&, node<Ntk> const&>, int> = 0>
+uint32_t recursive_deref( Ntk const& ntk, node<Ntk> const& n, NodeCostFn const& cost_fn )
+{
+  const auto terminate = [&]( auto const& n ) { return ntk.is_constant( n ) || ntk.is_pi( n ); };
+  return recursive_deref( ntk, n, terminate, cost_fn );
+}
+
+template<typename Ntk, class NodeCostFn, std::enable_if_t<std::is_invocable_v<NodeCostFn const&, Ntk const&, node<Ntk> const&>, int> = 0>
+uint32_t recursive_ref( Ntk const& ntk, node<Ntk> const& n, NodeCostFn const& cost_fn )
+{
+  const auto terminate = [&]( auto const& n ) { return ntk.is_constant( n ) || ntk.is_pi( n ); };
+  return recursive_ref( ntk, n, terminate, cost_fn );
+}
+
 template<typename Ntk, class NodeCostFn = unit_cost<Ntk>>
 uint32_t mffc_size( Ntk const& ntk, node<Ntk> const& n )
 {
@@ -0,0 +1,256 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2019  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file npn4_table.hpp
+  \brief NPN configurations of all 4-input functions
+*/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <kitty/bit_operations.hpp>
+#include <kitty/constructors.hpp>
+#include <kitty/npn.hpp>
+#include <kitty/operations.hpp>
+#include <kitty/static_truth_table.hpp>
+
+namespace mockturtle::detail
+{
+
+/*! \brief NPN configuration of a 4-input function.
+ *
+ * The function is obtained from the representative by negating the inputs
+ * in `phase` (bits 0 to 3), permuting the inputs by `perm`, and negating the
+ * output if bit 4 of `phase` is set.  This is the same configuration as
+ * returned by `kitty::exact_npn_canonization`.
+ */
+struct npn4_config
+{
+  kitty::static_truth_table<4u> repr;
+  uint32_t phase;
+  std::array<uint8_t, 4u> perm;
+};
+
+/*! \brief Table of NPN configurations of all 4-input functions.
+ *
+ * The table is built once per process on first use and shared by all
+ * resynthesis functions that canonize 4-input functions.  Instead of
+ * canonizing every function separately, it enumerates the transformation
+ * sequence of `kitty::exact_npn_canonization` once for each of the 222
+ * classes, which yields the same configuration for every function.
+ */
+class npn4_table
+{
+public:
+  static npn4_table const& instance()
+  {
+    static const npn4_table table;
+    return table;
+  }
+
+  /*! \brief Returns the NPN configuration of a function. */
+  npn4_config config( uint16_t function ) const
+  {
+    auto const entry = _entries[function];
+
+    npn4_config c;
+    kitty::create_from_words( c.repr, &_class_reprs[entry >> 24u], &_class_reprs[entry >> 24u] + 1 );
+    c.phase = entry & 0x1fu;
+    for ( auto i = 0u; i < 4u; ++i )
+    {
+      c.perm[i] = ( entry >> ( 8u + 2u * i ) ) & 3u;
+    }
+    return c;
+  }
+
+  /*! \brief Returns the NPN representative of a function. */
+  uint16_t representative( uint16_t function ) const
+  {
+    return static_cast<uint16_t>( _class_reprs[class_index( function )] );
+  }
+
+  /*! \brief Returns the index of the NPN class of a function.
+   *
+   * Classes are numbered in increasing order of their smallest function.
+   */
+  uint32_t class_index( uint16_t function ) const
+  {
+    return _entries[function] >> 24u;
+  }
+
+  /*! \brief Returns the number of NPN classes (222). */
+  uint32_t num_classes() const
+  {
+    return static_cast<uint32_t>( _class_reprs.size() );
+  }
+
+  /*! \brief Returns the representative of a class. */
+  kitty::static_truth_table<4u> class_representative( uint32_t index ) const
+  {
+    kitty::static_truth_table<4u> tt;
+    kitty::create_from_words( tt, &_class_reprs[index], &_class_reprs[index] + 1 );
+    return tt;
+  }
+
+private:
+  npn4_table()
+      : _entries( 1u << 16u, 0u )
+  {
+    /* the steps of the canonization: (swap, flip) indexes as used for the configuration */
+    auto const& swaps = kitty::detail::swaps[2u];
+    auto const& flips = kitty::detail::flips[2u];
+
+    std::vector<std::pair<int32_t, int32_t>> steps;
+    steps.emplace_back( -1, -1 );
+    for ( auto i = 0u; i < swaps.size(); ++i )
+    {
+      steps.emplace_back( i, -1 );
+    }
+    for ( auto j = 0u; j < flips.size(); ++j )
+    {
+      steps.emplace_back( -1, j );
+      for ( auto i = 0u; i < swaps.size(); ++i )
+      {
+        steps.emplace_back( i, j );
+      }
+    }
+
+    /* where each minterm is moved after each step */
+    std::vector<std::array<uint8_t, 16u>> moves;
+    {
+      std::array<kitty::static_truth_table<4u>, 16u> minterms;
+      const auto record = [&]() {
+        auto& m = moves.emplace_back();
+        for ( auto i = 0u; i < 16u; ++i )
+        {
+          m[i] = static_cast<uint8_t>( kitty::find_first_one_bit( minterms[i] ) );
+        }
+      };
+
+      for ( auto i = 0u; i < 16u; ++i )
+      {
+        kitty::set_bit( minterms[i], i );
+      }
+      record();
+      for ( auto pos : swaps )
+      {
+        for ( auto& tt : minterms )
+          kitty::swap_adjacent_inplace( tt, pos );
+        record();
+      }
+      for ( auto pos : flips )
+      {
+        for ( auto& tt : minterms )
+        {
+          kitty::swap_adjacent_inplace( tt, 0 );
+          kitty::flip_inplace( tt, pos );
+        }
+        record();
+        for ( auto pos2 : swaps )
+        {
+          for ( auto& tt : minterms )
+            kitty::swap_adjacent_inplace( tt, pos2 );
+          record();
+        }
+      }
+    }
+
+    /* configuration bits for each step, without output negation */
+    std::vector<uint32_t> step_configs;
+    for ( auto const& [best_swap, best_flip] : steps )
+    {
+      std::array<uint8_t, 4u> perm{0, 1, 2, 3};
+      for ( auto i = 0; i <= best_swap; ++i )
+      {
+        std::swap( perm[swaps[i]], perm[swaps[i] + 1] );
+      }
+      uint32_t phase{0u};
+      for ( auto i = 0; i <= best_flip; ++i )
+      {
+        phase ^= 1u << flips[i];
+      }
+      for ( auto i = 0u; i < 4u; ++i )
+      {
+        phase |= perm[i] << ( 8u + 2u * i );
+      }
+      step_configs.push_back( phase );
+    }
+
+    /* classes in increasing order of their smallest function */
+    std::vector<bool> classified( 1u << 16u, false );
+    std::vector<uint32_t> class_of( 1u << 16u );
+    for ( uint32_t f = 0u; f < ( 1u << 16u ); ++f )
+    {
+      if ( classified[f] )
+        continue;
+
+      kitty::static_truth_table<4u> tt;
+      kitty::create_from_words( tt, &f, &f + 1 );
+      const auto index = static_cast<uint32_t>( _class_reprs.size() );
+      const auto repr = std::get<0>( kitty::exact_npn_canonization( tt, [&]( auto const& t ) {
+        classified[*t.cbegin()] = true;
+        class_of[*t.cbegin()] = index;
+      } ) );
+      _class_reprs.push_back( *repr.cbegin() );
+    }
+
+    /* the canonization of f stops at the first step that maps f (or its
+     * complement) to the representative, i.e., at the first step whose
+     * inverse maps the representative (or its complement) to f */
+    std::vector<bool> assigned( 1u << 16u, false );
+    for ( auto index = 0u; index < _class_reprs.size(); ++index )
+    {
+      const auto repr = _class_reprs[index];
+      for ( auto k = 0u; k < moves.size(); ++k )
+      {
+        uint32_t f{0u};
+        for ( auto m = 0u; m < 16u; ++m )
+        {
+          f |= ( ( repr >> moves[k][m] ) & 1u ) << m;
+        }
+
+        for ( auto invo : {false, true} )
+        {
+          const auto g = invo ? ( ~f & 0xffffu ) : f;
+          if ( assigned[g] )
+            continue;
+          assigned[g] = true;
+          _entries[g] = ( index << 24u ) | step_configs[k] | ( uint32_t( invo ) << 4u );
+        }
+      }
+    }
+  }
+
+private:
+  /* class index (8 bits) | perm (4 x 2 bits) | phase (5 bits) */
+  std::vector<uint32_t> _entries;
+  std::vector<uint64_t> _class_reprs;
+};
+
+} // namespace mockturtle::detail
@@ -0,0 +1,260 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2019  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file rewriting_library.hpp
+  \brief Function-keyed cache of rewriting candidates
+*/
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <unordered_map>
+#include <vector>
+
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/hash.hpp>
+
+#include "../../traits.hpp"
+
+namespace mockturtle::detail
+{
+
+/* Caches the candidates of a rewriting function per cut function.
+ *
+ * On the first lookup of a function, the rewriting function is called on a
+ * scratch network whose PIs stand for the cut leaves, and each candidate is
+ * stored as a compact index list in a flat array.  A candidate record is laid
+ * out as
+ *
+ *   size, num_gates, output literal, (gate, num_fanins, fanin literals...)*
+ *
+ * where `gate` is the index of a scratch node that serves as prototype for
+ * `clone_node`.  Literals are `2 * id + complement`, where id 0 is the
+ * constant, ids 1 to `num_leaves` are the leaves, and the following ids are the
+ * gates of the record in topological order.  Candidates are instantiated on top
+ * of the leaves without hashing, and the caller may inspect the number of gates
+ * before instantiating a candidate.
+ */
+template<class Ntk>
+class rewriting_library
+{
+public:
+  using scratch_t = typename Ntk::base_type;
+  using candidate = uint32_t;
+
+  explicit rewriting_library( uint32_t num_leaves )
+  {
+    assert( num_leaves > 0u );
+    for ( auto i = 0u; i < num_leaves; ++i )
+    {
+      _leaves.push_back( _scratch.create_pi() );
+    }
+    _first_leaf = _scratch.node_to_index( _scratch.get_node( _leaves.front() ) );
+  }
+
+  /* returns the entry for `function`, which is synthesized by `rewriting_fn` on a miss */
+  template<class RewritingFn>
+  uint32_t lookup( kitty::dynamic_truth_table const& function, RewritingFn&& rewriting_fn )
+  {
+    assert( static_cast<uint32_t>( function.num_vars() ) <= _leaves.size() );
+
+    if ( const auto it = _entries.find( function ); it != _entries.end() )
+    {
+      ++_num_hits;
+      return it->second;
+    }
+    ++_num_misses;
+
+    const auto index = static_cast<uint32_t>( _offsets.size() );
+    _offsets.push_back( static_cast<uint32_t>( _data.size() ) );
+    _num_candidates.push_back( 0u );
+    rewriting_fn( _scratch, function, _leaves.begin(), _leaves.begin() + function.num_vars(), [&]( auto const& f ) {
+      record( f );
+      ++_num_candidates[index];
+      return true;
+    } );
+    _entries.emplace( function, index );
+    return index;
+  }
+
+  /* calls `fn` for each candidate of an entry until it returns false */
+  template<class Fn>
+  void foreach_candidate( uint32_t entry, Fn&& fn ) const
+  {
+    auto offset = _offsets[entry];
+    for ( auto i = 0u; i < _num_candidates[entry]; ++i )
+    {
+      if ( !fn( offset ) )
+      {
+        return;
+      }
+      offset += _data[offset];
+    }
+  }
+
+  uint32_t num_gates( candidate c ) const
+  {
+    return _data[c + 1u];
+  }
+
+  /* calls `fn( gate, fanins, num_fanins )` for each gate of a candidate in
+   * topological order, where `fanins` points to the fanin literals, and returns
+   * the output literal */
+  template<class Fn>
+  uint32_t foreach_gate( candidate c, Fn&& fn ) const
+  {
+    auto const* p = &_data[c + 3u];
+    for ( auto i = 0u; i < _data[c + 1u]; ++i )
+    {
+      const auto gate = _scratch.index_to_node( p[0] );
+      const auto num_fanins = p[1];
+      fn( gate, p + 2, num_fanins );
+      p += 2u + num_fanins;
+    }
+    return _data[c + 2u];
+  }
+
+  /* creates the candidate in `ntk` on top of the leaves starting at `begin` */
+  template<class LeavesIterator>
+  signal<Ntk> instantiate( Ntk& ntk, candidate c, LeavesIterator begin )
+  {
+    _signals.clear();
+    const auto output = foreach_gate( c, [&]( auto const& gate, uint32_t const* fanins, uint32_t num_fanins ) {
+      _fanins.clear();
+      for ( auto j = 0u; j < num_fanins; ++j )
+      {
+        _fanins.push_back( literal_to_signal( ntk, fanins[j], begin ) );
+      }
+      _signals.push_back( ntk.clone_node( _scratch, gate, _fanins ) );
+    } );
+    return literal_to_signal( ntk, output, begin );
+  }
+
+  scratch_t const& scratch() const
+  {
+    return _scratch;
+  }
+
+  uint32_t num_leaves() const
+  {
+    return static_cast<uint32_t>( _leaves.size() );
+  }
+
+  uint32_t num_entries() const
+  {
+    return static_cast<uint32_t>( _offsets.size() );
+  }
+
+  uint32_t num_hits() const
+  {
+    return _num_hits;
+  }
+
+  uint32_t num_misses() const
+  {
+    return _num_misses;
+  }
+
+private:
+  template<class LeavesIterator>
+  signal<Ntk> literal_to_signal( Ntk& ntk, uint32_t lit, LeavesIterator begin ) const
+  {
+    const auto id = lit >> 1u;
+    const bool complement = lit & 1u;
+    if ( id == 0u )
+    {
+      return ntk.get_constant( complement );
+    }
+
+    const auto s = id <= _leaves.size() ? signal<Ntk>( *std::next( begin, id - 1u ) ) : _signals[id - 1u - _leaves.size()];
+    return complement ? ntk.create_not( s ) : s;
+  }
+
+  void record( signal<scratch_t> const& f )
+  {
+    const auto start = _data.size();
+    _data.insert( _data.end(), {0u, 0u, 0u} );
+    _literals.resize( _scratch.size() );
+    _scratch.incr_trav_id();
+
+    uint32_t num_gates{0u};
+    const auto output = record_rec( _scratch.get_node( f ), num_gates ) ^ ( _scratch.is_complemented( f ) ? 1u : 0u );
+    _data[start] = static_cast<uint32_t>( _data.size() - start );
+    _data[start + 1u] = num_gates;
+    _data[start + 2u] = output;
+  }
+
+  uint32_t record_rec( node<scratch_t> const& n, uint32_t& num_gates )
+  {
+    if ( _scratch.is_constant( n ) )
+    {
+      return _scratch.constant_value( n ) ? 1u : 0u;
+    }
+    if ( _scratch.is_pi( n ) )
+    {
+      return 2u * ( _scratch.node_to_index( n ) - _first_leaf + 1u );
+    }
+    if ( _scratch.visited( n ) == _scratch.trav_id() )
+    {
+      return _literals[_scratch.node_to_index( n )];
+    }
+
+    std::vector<uint32_t> fanins;
+    _scratch.foreach_fanin( n, [&]( auto const& fi ) {
+      fanins.push_back( record_rec( _scratch.get_node( fi ), num_gates ) ^ ( _scratch.is_complemented( fi ) ? 1u : 0u ) );
+    } );
+
+    _data.push_back( _scratch.node_to_index( n ) );
+    _data.push_back( static_cast<uint32_t>( fanins.size() ) );
+    _data.insert( _data.end(), fanins.begin(), fanins.end() );
+
+    const auto lit = 2u * ( static_cast<uint32_t>( _leaves.size() ) + 1u + num_gates++ );
+    _scratch.set_visited( n, _scratch.trav_id() );
+    _literals[_scratch.node_to_index( n )] = lit;
+    return lit;
+  }
+
+private:
+  scratch_t _scratch;
+  std::vector<signal<scratch_t>> _leaves;
+  uint32_t _first_leaf{0u};
+
+  std::unordered_map<kitty::dynamic_truth_table, uint32_t, kitty::hash<kitty::dynamic_truth_table>> _entries;
+  std::vector<uint32_t> _offsets;
+  std::vector<uint32_t> _num_candidates;
+  std::vector<uint32_t> _data;
+
+  std::vector<uint32_t> _literals;
+  std::vector<signal<Ntk>> _signals;
+  std::vector<signal<Ntk>> _fanins;
+
+  uint32_t _num_hits{0u};
+  uint32_t _num_misses{0u};
+};
+
+} // namespace mockturtle::detail
@@ -99,7 +99,7 @@ public:
 
   std::optional<bool> run()
   {
-    stopwatch<> t( st_.time_total );
+    stopwatch<> t( st_.time_total, "equivalence_checking" );
 
     percy::bsat_wrapper solver;
     int output = generate_cnf( miter_, [&]( auto const& clause ) {
@@ -32,7 +32,11 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <vector>
 
@@ -50,12 +54,27 @@
 #include "../networks/xag.hpp"
 #include "../utils/progress_bar.hpp"
 #include "../utils/stopwatch.hpp"
+#include "../utils/thread_pool.hpp"
 #include "../views/cnf_view.hpp"
 #include "cnf.hpp"
 
 namespace mockturtle
 {
 
+/*! \brief Encoding options of one configuration in a portfolio.
+ *
+ * The options have the same meaning as the ones with the same name in
+ * `exact_mc_synthesis_params`.
+ */
+struct exact_mc_synthesis_encoding
+{
+  bool use_cegar{false};
+  bool break_subset_symmetries{true};
+  bool break_multi_level_subset_symmetries{true};
+  bool break_symmetric_variables{true};
+  bool ensure_to_use_gates{true};
+};
+
 struct exact_mc_synthesis_params
 {
   /* \brief Minimum number of AND gates. */
@@ -94,6 +113,29 @@ struct exact_mc_synthesis_params
    */
   bool ignore_conflict_limit_for_first_solution{false};
 
+  /*! \brief Number of threads for portfolio solving (0 = default number of threads).
+   *
+   * When this parameter is not 1, the SAT problems for several numbers of
+   * AND gates and several encodings (see `portfolio`) are solved in
+   * parallel.  Jobs are started in the order of increasing number of AND
+   * gates.  A job is cancelled when a solution with fewer AND gates has been
+   * found, or when its number of AND gates has been proven to be
+   * insufficient by another job.  The returned network is the one with the
+   * fewest AND gates; ties are resolved by the order of the encodings.
+   */
+  uint32_t num_threads{1u};
+
+  /*! \brief Encodings in the portfolio.
+   *
+   * If empty, the portfolio consists of the encoding given by these
+   * parameters, and the variants with toggled `use_cegar` and without
+   * multi-level subset symmetry breaking.
+   */
+  std::vector<exact_mc_synthesis_encoding> portfolio;
+
+  /*! \brief Number of conflicts after which a job checks for cancellation. */
+  uint32_t portfolio_conflict_slice{10000u};
+
   /*! \brief Show progress (in CEGAR). */
   bool progress{false};
 
@@ -121,6 +163,12 @@ struct exact_mc_synthesis_stats
   /*! \brief Total number of clauses. */
   uint32_t num_clauses{};
 
+  /*! \brief Number of jobs in portfolio solving. */
+  uint32_t num_jobs{};
+
+  /*! \brief Number of cancelled jobs in portfolio solving. */
+  uint32_t num_cancelled_jobs{};
+
   /*! \brief Prints report. */
   void report() const
   {
@@ -128,6 +176,10 @@ struct exact_mc_synthesis_stats
     fmt::print( "[i] solving time  = {:>5.2f} secs\n", to_seconds( time_solving ) );
     fmt::print( "[i] total vars    = {}\n", num_vars );
     fmt::print( "[i] total clauses = {}\n", num_clauses );
+    if ( num_jobs > 0u )
+    {
+      fmt::print( "[i] jobs          = {} ({} cancelled)\n", num_jobs, num_cancelled_jobs );
+    }
   }
 };
 
@@ -152,65 +204,98 @@ struct exact_mc_synthesis_impl
 
   std::vector<Ntk> run()
   {
-    stopwatch<> t( st_.time_total );
+    stopwatch<> t( st_.time_total, "exact_mc_synthesis" );
 
     std::vector<Ntk> ntks;
-    const auto degree = kitty::polynomial_degree( func_ );
-    uint32_t num_ands = std::max( ps_.min_and_gates, degree == 0u ? degree : degree - 1u );
+    uint32_t num_ands = initial_num_ands();
 
     while ( true )
     {
-      if ( ps_.verbose )
+      if ( const auto sol = run_bound( num_ands ); sol )
       {
-        fmt::print( "try with {} AND gates\n", num_ands );
+        ntks.push_back( *sol );
+        enumerate( ntks );
+        return ntks;
       }
+      ++num_ands;
+    }
+  }
 
-      cnf_view_params cvps;
-      cvps.write_dimacs = ps_.write_dimacs;
-      problem_network_t pntk( cvps );
-      reset( pntk );
+  /* lower bound on the number of AND gates */
+  uint32_t initial_num_ands() const
+  {
+    const auto degree = kitty::polynomial_degree( func_ );
+    return std::max( ps_.min_and_gates, degree == 0u ? degree : degree - 1u );
+  }
 
-      for ( auto i = 0u; i < num_ands; ++i )
-      {
-        add_gate( pntk );
-      }
-      add_output( pntk );
-      if ( ps_.heuristic_xor_bound || ps_.auto_update_xor_bound )
-      {
-        add_xor_counter( pntk );
-      }
+  /* solves the problem for a fixed number of AND gates */
+  std::optional<Ntk> run_bound( uint32_t num_ands )
+  {
+    if ( ps_.verbose )
+    {
+      fmt::print( "try with {} AND gates\n", num_ands );
+    }
+
+    cnf_view_params cvps;
+    cvps.write_dimacs = ps_.write_dimacs;
+    pntk_ = std::make_unique<problem_network_t>( cvps );
+    auto& pntk = *pntk_;
+    reset( pntk );
 
-      // TODO use LUT mapping before CNF generation
-      if ( const auto sol = ps_.use_cegar ? solve_with_cegar( pntk ) : solve_direct( pntk ); sol )
+    for ( auto i = 0u; i < num_ands; ++i )
+    {
+      add_gate( pntk );
+    }
+    add_output( pntk );
+    if ( ps_.heuristic_xor_bound || ps_.auto_update_xor_bound )
+    {
+      add_xor_counter( pntk );
+    }
+
+    // TODO use LUT mapping before CNF generation
+    auto sol = ps_.use_cegar ? solve_with_cegar( pntk ) : solve_direct( pntk );
+    if ( sol && ps_.very_verbose )
+    {
+      debug_solution( pntk );
+    }
+    return sol;
+  }
+
+  /* adds further solutions with the number of AND gates of the last solution */
+  void enumerate( std::vector<Ntk>& ntks )
+  {
+    auto& pntk = *pntk_;
+    while ( ntks.size() < num_solutions_ )
+    {
+      block( pntk );
+      if ( const auto result = solve( pntk, false ); result && *result )
       {
-        ntks.push_back( *sol );
+        ntks.push_back( extract_network( pntk ) );
         if ( ps_.very_verbose )
         {
           debug_solution( pntk );
+          fmt::print( "[i] found {} solutions so far\n", ntks.size() );
         }
-        while ( ntks.size() < num_solutions_ )
-        {
-          block( pntk );
-          if ( const auto result = solve( pntk, false ); result && *result )
-          {
-            ntks.push_back( extract_network( pntk ) );
-            if ( ps_.very_verbose )
-            {
-              debug_solution( pntk );
-              fmt::print( "[i] found {} solutions so far\n", ntks.size() );
-            }
-          }
-          else
-          {
-            break;
-          }
-        }
-        return ntks;
       }
-      ++num_ands;
+      else
+      {
+        break;
+      }
     }
   }
 
+  /* SAT calls return without result once `cancel` is set */
+  void set_cancel_flag( std::atomic<bool> const* cancel )
+  {
+    cancel_ = cancel;
+  }
+
+  /* result of the last SAT call (`false` if the last bound is infeasible) */
+  std::optional<bool> last_result() const
+  {
+    return last_result_;
+  }
+
 private:
   std::optional<Ntk> solve_direct( problem_network_t& pntk )
   {
@@ -282,7 +367,32 @@ private:
         assumptions.push_back( pntk.lit( !xor_counter_[pos] ) );
       }
     }
-    const auto res = pntk.solve( assumptions, ps_.ignore_conflict_limit_for_first_solution && first ? 0u : ps_.conflict_limit );
+    const uint32_t limit = ps_.ignore_conflict_limit_for_first_solution && first ? 0u : ps_.conflict_limit;
+    std::optional<bool> res;
+    if ( cancel_ )
+    {
+      /* solve in slices to react to cancellation */
+      uint32_t conflicts{0u};
+      do
+      {
+        if ( cancel_->load( std::memory_order_relaxed ) )
+        {
+          break;
+        }
+        auto slice = ps_.portfolio_conflict_slice;
+        if ( limit )
+        {
+          slice = std::min( slice, limit - conflicts );
+        }
+        res = pntk.solve( assumptions, slice );
+        conflicts += slice;
+      } while ( !res && ( !limit || conflicts < limit ) );
+    }
+    else
+    {
+      res = pntk.solve( assumptions, limit );
+    }
+    last_result_ = res;
 
     if ( ps_.auto_update_xor_bound && res && *res )
     {
@@ -594,6 +704,185 @@ private:
   uint32_t num_solutions_;
   exact_mc_synthesis_params const& ps_;
   exact_mc_synthesis_stats& st_;
+
+  std::unique_ptr<problem_network_t> pntk_;
+  std::atomic<bool> const* cancel_{nullptr};
+  std::optional<bool> last_result_;
+};
+
+template<class Ntk, bill::solvers Solver>
+class exact_mc_synthesis_portfolio_impl
+{
+  using impl_t = exact_mc_synthesis_impl<Ntk, Solver>;
+
+  struct job
+  {
+    uint32_t num_ands;
+    uint32_t encoding;
+    std::atomic<bool> cancel{false};
+  };
+
+public:
+  exact_mc_synthesis_portfolio_impl( kitty::dynamic_truth_table const& func, uint32_t num_solutions, exact_mc_synthesis_params const& ps, exact_mc_synthesis_stats& st )
+      : func_( func ),
+        num_solutions_( num_solutions ),
+        ps_( ps ),
+        st_( st )
+  {
+    auto encodings = ps.portfolio;
+    if ( encodings.empty() )
+    {
+      exact_mc_synthesis_encoding const e{ps.use_cegar, ps.break_subset_symmetries, ps.break_multi_level_subset_symmetries, ps.break_symmetric_variables, ps.ensure_to_use_gates};
+      encodings.push_back( e );
+      encodings.push_back( e );
+      encodings.back().use_cegar = !e.use_cegar;
+      if ( e.break_multi_level_subset_symmetries )
+      {
+        encodings.push_back( e );
+        encodings.back().break_multi_level_subset_symmetries = false;
+      }
+    }
+
+    for ( auto const& e : encodings )
+    {
+      auto& cps = configurations_.emplace_back( ps );
+      cps.use_cegar = e.use_cegar;
+      cps.break_subset_symmetries = e.break_subset_symmetries;
+      cps.break_multi_level_subset_symmetries = e.break_multi_level_subset_symmetries;
+      cps.break_symmetric_variables = e.break_symmetric_variables;
+      cps.ensure_to_use_gates = e.ensure_to_use_gates;
+      cps.progress = false;
+      cps.verbose = false;
+      cps.very_verbose = false;
+      cps.write_dimacs = std::nullopt;
+    }
+  }
+
+  std::vector<Ntk> run()
+  {
+    stopwatch<> t( st_.time_total, "exact_mc_synthesis" );
+
+    exact_mc_synthesis_stats dummy;
+    first_bound_ = impl_t{func_, 1u, configurations_.front(), dummy}.initial_num_ands();
+
+    default_thread_pool().run( ps_.num_threads, [&]( uint32_t ) {
+      while ( auto* j = next_job() )
+      {
+        process( *j );
+      }
+    } );
+
+    std::vector<Ntk> ntks;
+    ntks.push_back( *best_ntk_ );
+    best_impl_->enumerate( ntks );
+    return ntks;
+  }
+
+private:
+  /* returns the next job that is not dominated, or `nullptr` */
+  job* next_job()
+  {
+    std::lock_guard<std::mutex> lock( mutex_ );
+    while ( true )
+    {
+      auto const index = next_index_++;
+      auto const num_ands = first_bound_ + static_cast<uint32_t>( index / configurations_.size() );
+      auto const encoding = static_cast<uint32_t>( index % configurations_.size() );
+      if ( num_ands > best_num_ands_ || ( num_ands == best_num_ands_ && encoding > best_encoding_ ) )
+      {
+        return nullptr;
+      }
+      if ( infeasible( num_ands ) )
+      {
+        continue;
+      }
+
+      auto& j = *jobs_.emplace_back( std::make_unique<job>() );
+      j.num_ands = num_ands;
+      j.encoding = encoding;
+      ++st_.num_jobs;
+      return &j;
+    }
+  }
+
+  /* runs in a worker thread */
+  void process( job& j )
+  {
+    exact_mc_synthesis_stats job_st;
+    auto impl = std::make_unique<impl_t>( func_, num_solutions_, configurations_[j.encoding], job_st );
+    impl->set_cancel_flag( &j.cancel );
+    auto sol = impl->run_bound( j.num_ands );
+
+    std::lock_guard<std::mutex> lock( mutex_ );
+    st_.time_solving += job_st.time_solving;
+    st_.num_vars += job_st.num_vars;
+    st_.num_clauses += job_st.num_clauses;
+
+    if ( sol )
+    {
+      if ( ps_.verbose )
+      {
+        fmt::print( "[i] encoding {} found solution with {} AND gates\n", j.encoding, j.num_ands );
+      }
+      if ( j.num_ands < best_num_ands_ || ( j.num_ands == best_num_ands_ && j.encoding < best_encoding_ ) )
+      {
+        best_num_ands_ = j.num_ands;
+        best_encoding_ = j.encoding;
+        best_ntk_ = std::move( sol );
+        best_impl_ = std::move( impl );
+        cancel_dominated();
+      }
+    }
+    else if ( j.cancel )
+    {
+      ++st_.num_cancelled_jobs;
+    }
+    else if ( auto const res = impl->last_result(); res && !*res )
+    {
+      if ( ps_.verbose )
+      {
+        fmt::print( "[i] encoding {} proved that {} AND gates are insufficient\n", j.encoding, j.num_ands );
+      }
+      infeasible_.resize( std::max<std::size_t>( infeasible_.size(), j.num_ands - first_bound_ + 1u ), false );
+      infeasible_[j.num_ands - first_bound_] = true;
+      cancel_dominated();
+    }
+  }
+
+  bool infeasible( uint32_t num_ands ) const
+  {
+    auto const i = num_ands - first_bound_;
+    return i < infeasible_.size() && infeasible_[i];
+  }
+
+  /* must be called with locked mutex */
+  void cancel_dominated()
+  {
+    for ( auto const& j : jobs_ )
+    {
+      if ( j->num_ands > best_num_ands_ || ( j->num_ands == best_num_ands_ && j->encoding > best_encoding_ ) || infeasible( j->num_ands ) )
+      {
+        j->cancel = true;
+      }
+    }
+  }
+
+private:
+  kitty::dynamic_truth_table const& func_;
+  uint32_t num_solutions_;
+  exact_mc_synthesis_params const& ps_;
+  exact_mc_synthesis_stats& st_;
+  std::vector<exact_mc_synthesis_params> configurations_;
+
+  std::mutex mutex_;
+  uint32_t first_bound_{};
+  uint64_t next_index_{};
+  std::vector<std::unique_ptr<job>> jobs_;
+  std::vector<bool> infeasible_;
+  uint32_t best_num_ands_{std::numeric_limits<uint32_t>::max()};
+  uint32_t best_encoding_{std::numeric_limits<uint32_t>::max()};
+  std::optional<Ntk> best_ntk_;
+  std::unique_ptr<impl_t> best_impl_;
 };
 
 } // namespace detail
@@ -602,7 +891,8 @@ template<class Ntk = xag_network, bill::solvers Solver = bill::solvers::glucose_
 Ntk exact_mc_synthesis( kitty::dynamic_truth_table const& func, exact_mc_synthesis_params const& ps = {}, exact_mc_synthesis_stats* pst = nullptr )
 {
   exact_mc_synthesis_stats st;
-  const auto xag = detail::exact_mc_synthesis_impl<Ntk, Solver>{func, 1u, ps, st}.run().front();
+  const auto xag = ps.num_threads != 1u ? detail::exact_mc_synthesis_portfolio_impl<Ntk, Solver>{func, 1u, ps, st}.run().front()
+                                        : detail::exact_mc_synthesis_impl<Ntk, Solver>{func, 1u, ps, st}.run().front();
 
   if ( ps.verbose )
   {
@@ -620,7 +910,8 @@ template<class Ntk = xag_network, bill::solvers Solver = bill::solvers::glucose_
 std::vector<Ntk> exact_mc_synthesis_multiple( kitty::dynamic_truth_table const& func, uint32_t num_solutions, exact_mc_synthesis_params const& ps = {}, exact_mc_synthesis_stats* pst = nullptr )
 {
   exact_mc_synthesis_stats st;
-  const auto xags = detail::exact_mc_synthesis_impl<Ntk, Solver>{func, num_solutions, ps, st}.run();
+  const auto xags = ps.num_threads != 1u ? detail::exact_mc_synthesis_portfolio_impl<Ntk, Solver>{func, num_solutions, ps, st}.run()
+                                         : detail::exact_mc_synthesis_impl<Ntk, Solver>{func, num_solutions, ps, st}.run();
 
   if ( ps.verbose )
   {
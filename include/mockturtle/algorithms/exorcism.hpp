@@ -32,6 +32,7 @@
 
 #pragma once
 
+#include <mutex>
 #include <vector>
 
 #include <eabc/exor.h>
@@ -64,6 +65,10 @@ inline std::vector<kitty::cube> exorcism( std::vector<kitty::cube> const& esop,
   }
 
   std::vector<kitty::cube> exorcism_esop;
+
+  /* ABC's exorcism keeps its state in global variables */
+  static std::mutex exorcism_mutex;
+  std::lock_guard<std::mutex> lock( exorcism_mutex );
   abc::exorcism::Abc_ExorcismMain( vesop, num_vars, 1, [&]( uint32_t bits, uint32_t mask ) { exorcism_esop.emplace_back( bits, mask ); }, 2, 0, 4 * esop.size(), 0 );
 
   abc::exorcism::Vec_WecFree( vesop );
@@ -32,10 +32,12 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
 #include <iostream>
 #include <optional>
-#include <unordered_map>
-#include <unordered_set>
+#include <tuple>
 #include <vector>
 
 #include "../algorithms/cnf.hpp"
@@ -46,6 +48,8 @@
 #include "../traits.hpp"
 
 #include <fmt/format.h>
+#include <kitty/bit_operations.hpp>
+#include <kitty/detail/mscfix.hpp>
 
 namespace mockturtle
 {
@@ -179,177 +183,237 @@ public:
   }
 };
 
-struct pair_hash
+/* Dense bit-matrix for Paar's algorithm
+ *
+ * Each column of the linear matrix (one per signal) is stored as a packed
+ * bitset over the rows (outputs).  The number of rows in which a pair of
+ * columns occurs together is the popcount of the AND of both columns.  These
+ * counts are kept in a triangular matrix and updated incrementally: when the
+ * pair (a, b) is replaced by a new column c in the rows R, the counts of all
+ * pairs (i, a) and (i, b) decrease by |col_i & R|, which is also the count of
+ * the new pair (i, c).  For each column, the best partner among the previous
+ * columns is cached and only recomputed if one of its counts decreased.
+ */
+class linear_pair_matrix
 {
-  template<class T1, class T2>
-  std::size_t operator()( std::pair<T1, T2> const& p ) const
+public:
+  explicit linear_pair_matrix( uint32_t num_rows )
+      : num_rows_( num_rows ),
+        num_words_( ( num_rows + 63u ) >> 6u )
   {
-    return std::hash<T1>()( p.first ) ^ std::hash<T2>()( p.second );
   }
-};
 
-template<class Ntk>
-struct linear_resynthesis_paar_impl
-{
-public:
-  using index_pair_t = std::pair<uint32_t, uint32_t>;
+  uint32_t num_columns() const
+  {
+    return static_cast<uint32_t>( columns_.size() );
+  }
 
-  linear_resynthesis_paar_impl( Ntk const& xag ) : xag( xag ) {}
+  uint32_t add_column()
+  {
+    columns_.emplace_back( num_words_, UINT64_C( 0 ) );
+    counts_.emplace_back( columns_.size() - 1u, 0u );
+    best_.push_back( {0u, 0u} );
+    return num_columns() - 1u;
+  }
 
-  Ntk run()
+  void set( uint32_t row, uint32_t column )
   {
-    xag.foreach_pi( [&]( auto const& ) {
-      signals.push_back( dest.create_pi() );
-    } );
+    columns_[column][row >> 6u] |= UINT64_C( 1 ) << ( row & 63u );
+  }
 
-    extract_linear_equations();
+  bool get( uint32_t row, uint32_t column ) const
+  {
+    return ( columns_[column][row >> 6u] >> ( row & 63u ) ) & 1u;
+  }
 
-    while ( !occurrance_to_pairs.empty() )
+  /* computes all pair counts (after the initial columns have been set) */
+  void init_counts()
+  {
+    for ( auto j = 1u; j < columns_.size(); ++j )
     {
-      const auto p = *( occurrance_to_pairs.back().begin() );
-      replace_one_pair( p );
-    }
-
-    xag.foreach_po( [&]( auto const& f, auto i ) {
-      if ( linear_equations[i].empty() )
+      for ( auto i = 0u; i < j; ++i )
       {
-        dest.create_po( dest.get_constant( xag.is_complemented( f ) ) );
+        counts_[j][i] = and_count( columns_[i], columns_[j] );
       }
-      else
+      update_best( j );
+    }
+  }
+
+  /* returns the most frequent pair (i, j) with i < j and its count; ties are
+   * broken by the smallest j, and then by the smallest i */
+  std::tuple<uint32_t, uint32_t, uint32_t> best_pair() const
+  {
+    std::tuple<uint32_t, uint32_t, uint32_t> best{0u, 0u, 0u};
+    for ( auto j = 1u; j < best_.size(); ++j )
+    {
+      if ( best_[j].second > std::get<2>( best ) )
       {
-        assert( linear_equations[i].size() == 1u );
-        dest.create_po( signals[linear_equations[i].front()] ^ xag.is_complemented( f ) );
+        best = {best_[j].first, j, best_[j].second};
       }
-    } );
-
-    return dest;
+    }
+    return best;
   }
 
-private:
-  void extract_linear_equations()
+  /* replaces pair (a, b) in all rows that contain both by a new column */
+  uint32_t replace_pair( uint32_t a, uint32_t b )
   {
-    occurrance_to_pairs.resize( 1u );
-
-    linear_xag lxag{xag};
-    linear_equations = simulate<std::vector<uint32_t>>( lxag, linear_sum_simulator{} );
+    auto const c = add_column();
+    auto& rows = columns_[c];
+    for ( auto w = 0u; w < num_words_; ++w )
+    {
+      rows[w] = columns_[a][w] & columns_[b][w];
+      columns_[a][w] &= ~rows[w];
+      columns_[b][w] &= ~rows[w];
+    }
 
-    for ( auto o = 0u; o < linear_equations.size(); ++o )
+    for ( auto i = 0u; i < c; ++i )
     {
-      const auto& lin_eq = linear_equations[o];
-      for ( auto j = 1u; j < lin_eq.size(); ++j )
+      if ( i == a || i == b )
       {
-        for ( auto i = 0u; i < j; ++i )
-        {
-          const auto p = std::make_pair( lin_eq[i], lin_eq[j] );
-          pairs_to_output[p].push_back( o );
-          add_pair( p );
-        }
+        continue;
+      }
+      auto const d = and_count( columns_[i], rows );
+      counts_[c][i] = d;
+      if ( d == 0u )
+      {
+        continue;
       }
+      decrease( i, a, d );
+      decrease( i, b, d );
     }
+    counts_[std::max( a, b )][std::min( a, b )] = 0u;
+    update_best( a );
+    update_best( b );
+    update_best( c );
+
+    return c;
   }
 
-  void add_pair( index_pair_t const& p )
+  /* returns the column of each row, or -1 for empty rows; requires that each
+   * row has at most one column */
+  std::vector<int32_t> row_columns() const
   {
-    if ( auto it = pair_to_occurrance.find( p ); it != pair_to_occurrance.end() )
+    std::vector<int32_t> result( num_rows_, -1 );
+    for ( auto j = 0u; j < columns_.size(); ++j )
     {
-      // found another time
-      const auto occ = it->second;
-      occurrance_to_pairs[occ - 1u].erase( p );
-      if ( occurrance_to_pairs.size() <= occ + 1u )
+      for ( auto w = 0u; w < num_words_; ++w )
       {
-        occurrance_to_pairs.resize( occ + 1u );
+        for ( auto word = columns_[j][w]; word; word &= word - 1u )
+        {
+          auto const row = ( w << 6u ) + static_cast<uint32_t>( kitty::find_first_bit_in_word( word ) );
+          assert( result[row] == -1 );
+          result[row] = static_cast<int32_t>( j );
+        }
       }
-      occurrance_to_pairs[occ].insert( p );
-      it->second++;
     }
-    else
+    return result;
+  }
+
+private:
+  uint32_t and_count( std::vector<uint64_t> const& c1, std::vector<uint64_t> const& c2 ) const
+  {
+    uint32_t count{0u};
+    for ( auto w = 0u; w < num_words_; ++w )
     {
-      // first time found
-      pair_to_occurrance[p] = 1u;
-      occurrance_to_pairs[0u].insert( p );
+      auto const word = c1[w] & c2[w];
+      count += uint32_t( __builtin_popcount( static_cast<uint32_t>( word & 0xffffffff ) ) ) + uint32_t( __builtin_popcount( static_cast<uint32_t>( word >> 32 ) ) );
     }
+    return count;
   }
 
-  void remove_all_pairs( index_pair_t const& p )
+  void decrease( uint32_t i, uint32_t j, uint32_t d )
   {
-    auto it = pair_to_occurrance.find( p );
-    const auto occ = it->second;
-    pair_to_occurrance.erase( it );
-    occurrance_to_pairs[occ - 1u].erase( p );
-    while ( !occurrance_to_pairs.empty() && occurrance_to_pairs.back().empty() )
+    auto const lo = std::min( i, j );
+    auto const hi = std::max( i, j );
+    counts_[hi][lo] -= d;
+    if ( best_[hi].first == lo )
     {
-      occurrance_to_pairs.pop_back();
+      update_best( hi );
     }
-    pairs_to_output.erase( p );
   }
 
-  void remove_one_pair( index_pair_t const& p, uint32_t output )
+  void update_best( uint32_t j )
   {
-    auto it = pair_to_occurrance.find( p );
-    const auto occ = it->second;
-    occurrance_to_pairs[occ - 1u].erase( p );
-    if ( occ > 1u )
+    best_[j] = {0u, 0u};
+    for ( auto i = 0u; i < j; ++i )
     {
-      occurrance_to_pairs[occ - 2u].insert( p );
+      if ( counts_[j][i] > best_[j].second )
+      {
+        best_[j] = {i, counts_[j][i]};
+      }
     }
-    it->second--;
-    pairs_to_output[p].erase( std::remove( pairs_to_output[p].begin(), pairs_to_output[p].end(), output ), pairs_to_output[p].end() );
   }
 
-  void replace_one_pair( index_pair_t const& p )
+private:
+  uint32_t num_rows_;
+  uint32_t num_words_;
+  std::vector<std::vector<uint64_t>> columns_;
+  std::vector<std::vector<uint32_t>> counts_;           /* counts_[j][i] for i < j */
+  std::vector<std::pair<uint32_t, uint32_t>> best_;     /* best partner and count */
+};
+
+template<class Ntk>
+struct linear_resynthesis_paar_impl
+{
+public:
+  linear_resynthesis_paar_impl( Ntk const& xag ) : xag( xag ), matrix( xag.num_pos() ) {}
+
+  Ntk run()
   {
-    const auto [a, b] = p;
-    auto c = static_cast<uint32_t>( signals.size() );
-    signals.push_back( dest.create_xor( signals[a], signals[b] ) );
+    xag.foreach_pi( [&]( auto const& ) {
+      signals.push_back( dest.create_pi() );
+      matrix.add_column();
+    } );
+
+    extract_linear_equations();
 
-    /* update data structures */
-    for ( auto o : pairs_to_output[p] )
+    while ( true )
     {
-      auto& leq = linear_equations[o];
-      leq.erase( std::remove( leq.begin(), leq.end(), a ), leq.end() );
-      leq.erase( std::remove( leq.begin(), leq.end(), b ), leq.end() );
-      for ( auto i : leq )
+      const auto [a, b, count] = matrix.best_pair();
+      if ( count == 0u )
       {
-        remove_one_pair( {std::min( i, a ), std::max( i, a )}, o );
-        remove_one_pair( {std::min( i, b ), std::max( i, b )}, o );
-        add_pair( {i, c} );
-        pairs_to_output[{i, c}].push_back( o );
+        break;
       }
-      leq.push_back( c );
+      signals.push_back( dest.create_xor( signals[a], signals[b] ) );
+      matrix.replace_pair( a, b );
     }
-    remove_all_pairs( p );
+
+    const auto columns = matrix.row_columns();
+    xag.foreach_po( [&]( auto const& f, auto i ) {
+      if ( columns[i] == -1 )
+      {
+        dest.create_po( dest.get_constant( xag.is_complemented( f ) ) );
+      }
+      else
+      {
+        dest.create_po( signals[columns[i]] ^ xag.is_complemented( f ) );
+      }
+    } );
+
+    return dest;
   }
 
-  void print_linear_matrix()
+private:
+  void extract_linear_equations()
   {
-    for ( auto const& le : linear_equations )
+    linear_xag lxag{xag};
+    const auto linear_equations = simulate<std::vector<uint32_t>>( lxag, linear_sum_simulator{} );
+
+    for ( auto o = 0u; o < linear_equations.size(); ++o )
     {
-      auto it = le.begin();
-      for ( auto i = 0u; i < signals.size(); ++i )
+      for ( auto i : linear_equations[o] )
       {
-        if ( it != le.end() && *it == i )
-        {
-          std::cout << " 1";
-          it++;
-        }
-        else
-        {
-          std::cout << " 0";
-        }
+        matrix.set( o, i );
       }
-      assert( it == le.end() );
-      std::cout << "\n";
     }
+    matrix.init_counts();
   }
 
 private:
   Ntk const& xag;
   Ntk dest;
   std::vector<signal<Ntk>> signals;
-  std::vector<std::vector<uint32_t>> linear_equations;
-  std::vector<std::unordered_set<index_pair_t, pair_hash>> occurrance_to_pairs;
-  std::unordered_map<index_pair_t, uint32_t, pair_hash> pair_to_occurrance;
-  std::unordered_map<index_pair_t, std::vector<uint32_t>, pair_hash> pairs_to_output;
+  linear_pair_matrix matrix;
 };
 
 } // namespace detail
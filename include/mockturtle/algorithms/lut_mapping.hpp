@@ -36,6 +36,7 @@
 
 #include <fmt/format.h>
 
+#include "../utils/cost_functions.hpp"
 #include "../utils/stopwatch.hpp"
 #include "../views/topo_view.hpp"
 #include "cut_enumeration.hpp"
@@ -107,7 +108,7 @@ struct lut_mapping_update_cuts
 namespace detail
 {
 
-template<class Ntk, bool StoreFunction, typename CutData>
+template<class Ntk, bool StoreFunction, typename CutData, class NodeCostFn>
 class lut_mapping_impl
 {
 public:
@@ -115,10 +116,11 @@ public:
   using cut_t = typename network_cuts_t::cut_t;
 
 public:
-  lut_mapping_impl( Ntk& ntk, lut_mapping_params const& ps, lut_mapping_stats& st )
+  lut_mapping_impl( Ntk& ntk, lut_mapping_params const& ps, lut_mapping_stats& st, NodeCostFn const& cost_fn )
       : ntk( ntk ),
         ps( ps ),
         st( st ),
+        cost_fn( cost_fn ),
         flow_refs( ntk.size() ),
         map_refs( ntk.size(), 0 ),
         flows( ntk.size() ),
@@ -130,7 +132,7 @@ public:
 
   void run()
   {
-    stopwatch t( st.time_total );
+    stopwatch t( st.time_total, "lut_mapping" );
 
     /* compute and save topological order */
     top_order.reserve( ntk.size() );
@@ -158,9 +160,9 @@ public:
   }
 
 private:
-  uint32_t cut_area( cut_t const& cut ) const
+  uint32_t cut_area( uint32_t index, cut_t const& cut ) const
   {
-    return static_cast<uint32_t>( cut->data.cost );
+    return static_cast<uint32_t>( cut->data.cost ) * cost_fn( ntk, ntk.index_to_node( index ) );
   }
 
   void init_nodes()
@@ -244,7 +246,7 @@ private:
     ++iteration;
   }
 
-  std::pair<float, uint32_t> cut_flow( cut_t const& cut )
+  std::pair<float, uint32_t> cut_flow( uint32_t index, cut_t const& cut )
   {
     uint32_t time{0u};
     float flow{0.0f};
@@ -255,16 +257,16 @@ private:
       flow += flows[leaf];
     }
 
-    return {flow + cut_area( cut ), time + 1u};
+    return {flow + cut_area( index, cut ), time + 1u};
   }
 
   /* reference cut:
    *   adds cut to current mapping and recursively adds best cuts of leaf
    *   nodes, if they are not part of the current mapping.
    */
-  uint32_t cut_ref( cut_t const& cut )
+  uint32_t cut_ref( uint32_t index, cut_t const& cut )
   {
-    uint32_t count = cut_area( cut );
+    uint32_t count = cut_area( index, cut );
     for ( auto leaf : cut )
     {
       if ( ntk.is_constant( ntk.index_to_node( leaf ) ) || ntk.is_pi( ntk.index_to_node( leaf ) ) )
@@ -272,7 +274,7 @@ private:
 
       if ( map_refs[leaf]++ == 0 )
       {
-        count += cut_ref( cuts.cuts( leaf )[0] );
+        count += cut_ref( leaf, cuts.cuts( leaf )[0] );
       }
     }
     return count;
@@ -283,9 +285,9 @@ private:
    *   leaf nodes, if they are part of the current mapping.
    *   (this is the inverse operation to cut_ref)
    */
-  uint32_t cut_deref( cut_t const& cut )
+  uint32_t cut_deref( uint32_t index, cut_t const& cut )
   {
-    uint32_t count = cut_area( cut );
+    uint32_t count = cut_area( index, cut );
     for ( auto leaf : cut )
     {
       if ( ntk.is_constant( ntk.index_to_node( leaf ) ) || ntk.is_pi( ntk.index_to_node( leaf ) ) )
@@ -293,7 +295,7 @@ private:
 
       if ( --map_refs[leaf] == 0 )
       {
-        count += cut_deref( cuts.cuts( leaf ).best() );
+        count += cut_deref( leaf, cuts.cuts( leaf ).best() );
       }
     }
     return count;
@@ -305,9 +307,9 @@ private:
    *   2. it remembers all cuts for which the reference count increases in the
    *      vector `tmp_area`.
    */
-  uint32_t cut_ref_limit_save( cut_t const& cut, uint32_t limit )
+  uint32_t cut_ref_limit_save( uint32_t index, cut_t const& cut, uint32_t limit )
   {
-    uint32_t count = cut_area( cut );
+    uint32_t count = cut_area( index, cut );
     if ( limit == 0 )
       return count;
 
@@ -319,7 +321,7 @@ private:
       tmp_area.push_back( leaf );
       if ( map_refs[leaf]++ == 0 )
       {
-        count += cut_ref_limit_save( cuts.cuts( leaf ).best(), limit - 1 );
+        count += cut_ref_limit_save( leaf, cuts.cuts( leaf ).best(), limit - 1 );
       }
     }
     return count;
@@ -330,10 +332,10 @@ private:
    *   would be needed to add to the mapping if `cut` were to be added.  It
    *   temporarily modifies the reference counters but reverts them eventually.
    */
-  uint32_t cut_area_estimation( cut_t const& cut )
+  uint32_t cut_area_estimation( uint32_t index, cut_t const& cut )
   {
     tmp_area.clear();
-    const auto count = cut_ref_limit_save( cut, 8 );
+    const auto count = cut_ref_limit_save( index, cut, 8 );
     for ( auto const& n : tmp_area )
     {
       map_refs[n]--;
@@ -357,7 +359,7 @@ private:
     {
       if ( map_refs[index] > 0 )
       {
-        cut_deref( cuts.cuts( index )[0] );
+        cut_deref( index, cuts.cuts( index )[0] );
       }
     }
 
@@ -369,11 +371,11 @@ private:
 
       if constexpr ( ELA )
       {
-        flow = static_cast<float>( cut_area_estimation( *cut ) );
+        flow = static_cast<float>( cut_area_estimation( index, *cut ) );
       }
       else
       {
-        std::tie( flow, time ) = cut_flow( *cut );
+        std::tie( flow, time ) = cut_flow( index, *cut );
       }
 
       if ( best_cut == -1 || best_flow > flow + mf_eps || ( best_flow > flow - mf_eps && best_time > time ) )
@@ -391,7 +393,7 @@ private:
     {
       if ( map_refs[index] > 0 )
       {
-        cut_ref( cuts.cuts( index )[best_cut] );
+        cut_ref( index, cuts.cuts( index )[best_cut] );
       }
     }
     else
@@ -400,7 +402,7 @@ private:
     }
     if constexpr ( ELA )
     {
-      best_time = cut_flow( cuts.cuts( index )[best_cut] ).second;
+      best_time = cut_flow( index, cuts.cuts( index )[best_cut] ).second;
     }
     delays[index] = best_time;
     flows[index] = best_flow / flow_refs[index];
@@ -452,6 +454,7 @@ private:
   Ntk& ntk;
   lut_mapping_params const& ps;
   lut_mapping_stats& st;
+  NodeCostFn cost_fn;
 
   uint32_t iteration{0}; /* current mapping iteration */
   uint32_t delay{0};     /* current delay of the mapping */
@@ -490,6 +493,11 @@ private:
  * example of a CutData type that implements the cost function that is used in
  * the LUT mapper `&mf` in ABC.
  *
+ * The area of a LUT is the cost of its cut multiplied by the node cost
+ * `cost_fn` of its root, which is 1 by default.  A non-unit node cost, e.g.,
+ * `switching_activity_cost`, lets area flow and exact area minimize the sum
+ * of these node costs instead of the number of LUTs.
+ *
  * **Required network functions:**
  * - `size`
  * - `is_pi`
@@ -512,8 +520,8 @@ private:
       mapping command ``&mf`` in ABC.
    \endverbatim
  */
-template<class Ntk, bool StoreFunction = false, typename CutData = cut_enumeration_mf_cut>
-void lut_mapping( Ntk& ntk, lut_mapping_params const& ps = {}, lut_mapping_stats* pst = nullptr )
+template<class Ntk, bool StoreFunction = false, typename CutData = cut_enumeration_mf_cut, class NodeCostFn = unit_cost<Ntk>>
+void lut_mapping( Ntk& ntk, lut_mapping_params const& ps = {}, lut_mapping_stats* pst = nullptr, NodeCostFn const& cost_fn = {} )
 {
   static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
   static_assert( has_size_v<Ntk>, "Ntk does not implement the size method" );
@@ -530,7 +538,7 @@ void lut_mapping( Ntk& ntk, lut_mapping_params const& ps = {}, lut_mapping_stats
   static_assert( !StoreFunction || has_set_cell_function_v<Ntk>, "Ntk does not implement the set_cell_function method" );
 
   lut_mapping_stats st;
-  detail::lut_mapping_impl<Ntk, StoreFunction, CutData> p( ntk, ps, st );
+  detail::lut_mapping_impl<Ntk, StoreFunction, CutData, NodeCostFn> p( ntk, ps, st, cost_fn );
   p.run();
   if ( ps.verbose )
   {
@@ -105,7 +105,7 @@ public:
 
   void run()
   {
-    stopwatch t( st.time_total );
+    stopwatch t( st.time_total, "mig_algebraic_rewriting" );
 
     switch ( ps.strategy )
     {
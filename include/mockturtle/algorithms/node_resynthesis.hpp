@@ -89,7 +89,7 @@ public:
 
   NtkDest run()
   {
-    stopwatch t( st.time_total );
+    stopwatch t( st.time_total, "node_resynthesis" );
 
     node_map<signal<NtkDest>, NtkSource> node2new( ntk );
 
@@ -33,12 +33,15 @@
 #pragma once
 
 #include <cstdint>
+#include <cstring>
 #if __GNUC__ == 7
 #include <experimental/filesystem>
 #else
 #include <filesystem>
 #endif
 #include <fstream>
+#include <memory>
+#include <unordered_map>
 #include <unordered_set>
 #include <kitty/dynamic_truth_table.hpp>
 #include <kitty/hash.hpp>
@@ -47,6 +50,7 @@
 #include "traits.hpp"
 #include "../../traits.hpp"
 #include "../../algorithms/cleanup.hpp"
+#include "../../utils/binary_cache.hpp"
 #include "../../utils/json_utils.hpp"
 #include "../../utils/network_cache.hpp"
 
@@ -74,6 +78,18 @@ void from_json( nlohmann::json const& j, no_blacklist_cache_info& info )
   (void)info;
 }
 
+/*! \brief Resynthesis function with a cache.
+ *
+ * Wraps a resynthesis function and stores the network that it computes for
+ * each function (and each set of existing functions), as well as the
+ * functions for which it failed.
+ *
+ * If a cache file name is given, the cache is stored in a `binary_cache`
+ * file: results are appended to the file as soon as they are computed, and
+ * opening the file only indexes the stored results, which are copied into
+ * the network when they are first used.  Cache files in the former JSON
+ * format are converted into the binary format when they are opened.
+ */
 template<class Ntk, class ResynthesisFn, class BlacklistCacheInfo = no_blacklist_cache_info>
 class cached_resynthesis
 {
@@ -91,14 +107,6 @@ public:
     }
   }
 
-  ~cached_resynthesis()
-  {
-    if ( !_cache_filename.empty() )
-    {
-      save();
-    }
-  }
-
 private:
   using cache_key_t = std::pair<kitty::dynamic_truth_table, std::vector<kitty::dynamic_truth_table>>;
 
@@ -140,6 +148,19 @@ private:
   {
     auto it = _blacklist_cache.find( {tt, _blacklist_cache_info} );
 
+    /* blacklisted function that has not been used since the cache file was opened */
+    if ( it == _blacklist_cache.end() && _file )
+    {
+      /* the first word is the number of bytes; corrupted records are ignored */
+      if ( const auto value = _file->find( blacklist_record, blacklist_key( tt ) );
+           value && value->first != value->second && *value->first <= sizeof( binary_cache::word ) * ( value->second - value->first - 1 ) )
+      {
+        std::vector<uint8_t> const bytes( reinterpret_cast<uint8_t const*>( value->first + 1 ),
+                                          reinterpret_cast<uint8_t const*>( value->first + 1 ) + *value->first );
+        it = _blacklist_cache.insert( {tt, nlohmann::json::from_cbor( bytes ).get<BlacklistCacheInfo>()} ).first;
+      }
+    }
+
     /* function cannot be found in black list cache */
     if ( it == _blacklist_cache.end() )
     {
@@ -163,7 +184,7 @@ public:
   void operator()( Ntk& ntk, kitty::dynamic_truth_table const& function, LeavesIterator begin, LeavesIterator end, Fn&& fn )
   {
     if ( auto const key = std::make_pair( function, _existing_functions );
-         _cache.has( key ) )
+         _cache.has( key ) || load_entry( key ) )
     {
       ++_cache_hits;
       std::vector<signal<Ntk>> signals( _cache.pis().size(), ntk.get_constant( false ) );
@@ -185,6 +206,10 @@ public:
           ++_cache_misses;
           _cache.insert_signal( key, f );
           found_one = true;
+          if ( _file )
+          {
+            _file->insert( entry_record, entry_key( key ), encode_entry( key, f ) );
+          }
 
           std::vector<signal<Ntk>> signals( _cache.pis().size(), ntk.get_constant( false ) );
           std::copy( begin, end, signals.begin() );
@@ -198,6 +223,10 @@ public:
       if ( !found_one )
       {
         _blacklist_cache.insert( {function, _blacklist_cache_info} );
+        if ( _file )
+        {
+          _file->insert( blacklist_record, blacklist_key( function ), encode_blacklist_info( _blacklist_cache_info ) );
+        }
       }
     }
   }
@@ -245,13 +274,35 @@ public:
     fmt::print( "[i] cache misses            = {}\n", _cache_misses );
     fmt::print( "[i] size of cache           = {}\n", _cache.size() );
     fmt::print( "[i] size of blacklist cache = {}\n", _blacklist_cache.size() );
+    if ( _file )
+    {
+      fmt::print( "[i] size of cache file      = {}\n", _file->size() );
+    }
   }
 
 private:
+  /* record kinds in the cache file */
+  static constexpr binary_cache::word entry_record = 1u;
+  static constexpr binary_cache::word blacklist_record = 2u;
+
   void load()
   {
-    std::ifstream is( _cache_filename.c_str(), std::ifstream::in );
-    if ( !is.good() ) return;
+    if ( std::ifstream is( _cache_filename.c_str(), std::ifstream::in ); is.good() && !binary_cache::is_binary_cache_file( _cache_filename ) )
+    {
+      load_json( is );
+      is.close();
+      convert_json();
+    }
+
+    _file = std::make_unique<binary_cache>( _cache_filename );
+    if ( !_file->is_persistent() )
+    {
+      _file.reset();
+    }
+  }
+
+  void load_json( std::istream& is )
+  {
     nlohmann::json data;
     is >> data;
 
@@ -260,7 +311,8 @@ private:
     data["initial_size"].get_to( _initial_size );
   }
 
-  void save()
+  /* replaces a cache file in JSON format by a binary cache file with the same content */
+  void convert_json()
   {
 #if __GNUC__ == 7
     namespace fs = std::experimental::filesystem::v1;
@@ -268,34 +320,290 @@ private:
     namespace fs = std::filesystem;
 #endif
 
-    nlohmann::json data{
-      {"cache", _cache.to_json()},
-      {"blacklist_cache", _blacklist_cache},
-      {"initial_size", _initial_size}
+    const auto tmp_filename = fmt::format( "{}.tmp", _cache_filename );
+    if ( fs::exists( tmp_filename ) )
+    {
+      fs::remove( tmp_filename );
+    }
+
+    {
+      binary_cache file( tmp_filename );
+      for ( auto const& key : _cache.keys() )
+      {
+        file.insert( entry_record, entry_key( key ), encode_entry( key, _cache.get( key ) ) );
+      }
+      for ( auto const& [tt, info] : _blacklist_cache )
+      {
+        file.insert( blacklist_record, blacklist_key( tt ), encode_blacklist_info( info ) );
+      }
+    }
+
+    fs::rename( tmp_filename, _cache_filename );
+  }
+
+  /* copies a cache entry from the cache file into the cache network */
+  bool load_entry( cache_key_t const& key )
+  {
+    if ( !_file )
+    {
+      return false;
+    }
+
+    const auto value = _file->find( entry_record, entry_key( key ) );
+    if ( !value )
+    {
+      return false;
+    }
+
+    /* corrupted records, whose counts do not fit the record, are cache misses */
+    auto it = value->first;
+    const auto end = value->second;
+    const auto remaining = [&]( uint64_t num_words ) {
+      return static_cast<uint64_t>( end - it ) >= num_words;
     };
+    if ( !remaining( 2u ) )
+    {
+      return false;
+    }
+    const auto num_pis = *it++;
+    const auto num_gates = *it++;
+    if ( num_pis != key.first.num_vars() + key.second.size() )
+    {
+      return false;
+    }
+
+    auto& db = _cache.network();
 
-    // make a backup of existing cache file, if it exists
-    std::string _backup_filename = fmt::format( "{}.bak", _cache_filename );
-    if ( fs::exists( _cache_filename ) )
+    /* literal 2i + c refers to constant (i = 0), input (1 <= i <= num_pis), or gate */
+    std::vector<signal<Ntk>> signals{db.get_constant( false )};
+    for ( auto i = 0u; i < num_pis; ++i )
     {
-      fs::copy( _cache_filename, _backup_filename );
+      signals.push_back( _cache.pis()[pi_position( key, i )] );
     }
+    const auto literal = [&]( binary_cache::word lit ) {
+      const auto s = signals[lit >> 1];
+      return ( lit & 1 ) ? db.create_not( s ) : s;
+    };
 
-    std::ofstream os( _cache_filename.c_str(), std::ofstream::out );
-    os << data.dump() << "\n";
-    os.close();
+    std::vector<signal<Ntk>> children;
+    for ( auto g = 0u; g < num_gates; ++g )
+    {
+      if ( !remaining( 2u ) )
+      {
+        return false;
+      }
+      const auto type = *it++;
+      const auto num_fanins = *it++;
+      if ( !remaining( num_fanins ) || ( type != gate_function && num_fanins != ( type == gate_and || type == gate_xor ? 2u : 3u ) ) )
+      {
+        return false;
+      }
+      children.clear();
+      for ( auto i = 0u; i < num_fanins; ++i )
+      {
+        if ( ( *it >> 1 ) >= signals.size() )
+        {
+          return false;
+        }
+        children.push_back( literal( *it++ ) );
+      }
 
-    if ( fs::exists( _backup_filename ) )
+      switch ( type )
+      {
+      case gate_and:
+        if constexpr ( has_create_and_v<Ntk> )
+        {
+          signals.push_back( db.create_and( children[0], children[1] ) );
+        }
+        break;
+      case gate_xor:
+        if constexpr ( has_create_xor_v<Ntk> )
+        {
+          signals.push_back( db.create_xor( children[0], children[1] ) );
+        }
+        break;
+      case gate_maj:
+        if constexpr ( has_create_maj_v<Ntk> )
+        {
+          signals.push_back( db.create_maj( children[0], children[1], children[2] ) );
+        }
+        break;
+      case gate_xor3:
+        if constexpr ( has_create_xor3_v<Ntk> )
+        {
+          signals.push_back( db.create_xor3( children[0], children[1], children[2] ) );
+        }
+        break;
+      default:
+        if constexpr ( has_create_node_v<Ntk> )
+        {
+          const auto function = read_truth_table( it, end );
+          if ( !function || function->num_vars() != num_fanins )
+          {
+            return false;
+          }
+          signals.push_back( db.create_node( children, *function ) );
+        }
+        break;
+      }
+
+      /* the file was written for a different network type */
+      if ( signals.size() != 2u + num_pis + g )
+      {
+        return false;
+      }
+    }
+
+    if ( !remaining( 1u ) || ( *it >> 1 ) >= signals.size() )
+    {
+      return false;
+    }
+    _cache.insert_signal( key, literal( *it ) );
+    return true;
+  }
+
+  /* position of the i-th input of an entry among the cache PIs */
+  uint32_t pi_position( cache_key_t const& key, uint32_t i ) const
+  {
+    const auto num_vars = static_cast<uint32_t>( key.first.num_vars() );
+    return i < num_vars ? i : _initial_size + ( i - num_vars );
+  }
+
+  /* encodes the cone of f as index list over the inputs of the entry */
+  std::vector<binary_cache::word> encode_entry( cache_key_t const& key, signal<Ntk> const& f )
+  {
+    auto const& db = _cache.network();
+    const auto num_pis = static_cast<uint32_t>( key.first.num_vars() + key.second.size() );
+
+    std::unordered_map<node<Ntk>, binary_cache::word> lits;
+    for ( auto i = 0u; i < num_pis; ++i )
+    {
+      lits[db.get_node( _cache.pis()[pi_position( key, i )] )] = 2u * ( i + 1u );
+    }
+
+    std::vector<binary_cache::word> gates;
+    binary_cache::word num_gates{0u};
+    const auto literal = [&]( auto const& encode, signal<Ntk> const& s ) -> binary_cache::word {
+      const auto n = db.get_node( s );
+      binary_cache::word lit{0u};
+      if ( db.is_constant( n ) )
+      {
+        lit = db.constant_value( n ) ? 1u : 0u;
+      }
+      else if ( const auto it = lits.find( n ); it != lits.end() )
+      {
+        lit = it->second;
+      }
+      else
+      {
+        lit = encode( encode, n );
+      }
+      if constexpr ( has_is_complemented_v<Ntk> )
+      {
+        lit ^= db.is_complemented( s ) ? 1u : 0u;
+      }
+      return lit;
+    };
+    const auto encode = [&]( auto const& self, node<Ntk> const& n ) -> binary_cache::word {
+      std::vector<binary_cache::word> fanins;
+      db.foreach_fanin( n, [&]( auto const& fi ) {
+        fanins.push_back( literal( self, fi ) );
+      } );
+
+      const auto type = gate_type( n );
+      gates.push_back( type );
+      gates.push_back( static_cast<binary_cache::word>( fanins.size() ) );
+      gates.insert( gates.end(), fanins.begin(), fanins.end() );
+      if ( type == gate_function )
+      {
+        if constexpr ( has_node_function_v<Ntk> )
+        {
+          append_truth_table( gates, db.node_function( n ) );
+        }
+      }
+      return lits[n] = 2u * ( 1u + num_pis + num_gates++ );
+    };
+
+    const auto output = literal( encode, f );
+    std::vector<binary_cache::word> words{num_pis, num_gates};
+    words.insert( words.end(), gates.begin(), gates.end() );
+    words.push_back( output );
+    return words;
+  }
+
+  binary_cache::word gate_type( node<Ntk> const& n )
+  {
+    auto const& db = _cache.network();
+    if constexpr ( !has_create_node_v<Ntk> )
     {
-      fs::remove( _backup_filename );
+      if constexpr ( has_is_and_v<Ntk> )
+      {
+        if ( db.is_and( n ) )
+          return gate_and;
+      }
+      if constexpr ( has_is_xor_v<Ntk> )
+      {
+        if ( db.is_xor( n ) )
+          return gate_xor;
+      }
+      if constexpr ( has_is_maj_v<Ntk> )
+      {
+        if ( db.is_maj( n ) )
+          return gate_maj;
+      }
+      if constexpr ( has_is_xor3_v<Ntk> )
+      {
+        if ( db.is_xor3( n ) )
+          return gate_xor3;
+      }
+    }
+    (void)db;
+    (void)n;
+    return gate_function;
+  }
+
+  static std::vector<binary_cache::word> entry_key( cache_key_t const& key )
+  {
+    std::vector<binary_cache::word> words;
+    append_truth_table( words, key.first );
+    words.push_back( static_cast<binary_cache::word>( key.second.size() ) );
+    for ( auto const& tt : key.second )
+    {
+      append_truth_table( words, tt );
     }
+    return words;
+  }
+
+  static std::vector<binary_cache::word> blacklist_key( kitty::dynamic_truth_table const& tt )
+  {
+    std::vector<binary_cache::word> words;
+    append_truth_table( words, tt );
+    return words;
   }
 
+  /* the blacklist info is stored as CBOR: number of bytes, followed by the bytes */
+  static std::vector<binary_cache::word> encode_blacklist_info( BlacklistCacheInfo const& info )
+  {
+    const auto bytes = nlohmann::json::to_cbor( nlohmann::json( info ) );
+    std::vector<binary_cache::word> words( 1u + ( bytes.size() + sizeof( binary_cache::word ) - 1u ) / sizeof( binary_cache::word ), 0u );
+    words[0] = static_cast<binary_cache::word>( bytes.size() );
+    std::memcpy( words.data() + 1, bytes.data(), bytes.size() );
+    return words;
+  }
+
+  /* gate types in cache file entries */
+  static constexpr binary_cache::word gate_function = 0u;
+  static constexpr binary_cache::word gate_and = 1u;
+  static constexpr binary_cache::word gate_xor = 2u;
+  static constexpr binary_cache::word gate_maj = 3u;
+  static constexpr binary_cache::word gate_xor3 = 4u;
+
 private:
   ResynthesisFn _resyn_fn;
   network_cache<Ntk, cache_key_t, cache_hash> _cache;
   std::unordered_set<blacklist_cache_key_t, blacklist_cache_hash, blacklist_cache_equal> _blacklist_cache;
   std::string _cache_filename;
+  std::unique_ptr<binary_cache> _file;
   BlacklistCacheInfo _blacklist_cache_info;
   uint32_t _initial_size{};
 
@@ -33,6 +33,7 @@
 #pragma once
 
 #include <iostream>
+#include <iterator>
 #include <memory>
 #include <optional>
 #include <unordered_map>
@@ -46,6 +47,8 @@
 #include "../../networks/aig.hpp"
 #include "../../networks/xmg.hpp"
 #include "../../networks/klut.hpp"
+#include "../../utils/binary_cache.hpp"
+#include "../../utils/profiler.hpp"
 #include "../../utils/include/percy.hpp"
 
 namespace mockturtle
@@ -62,6 +65,15 @@ struct exact_resynthesis_params
   cache_t cache;
   blacklist_cache_t blacklist_cache;
 
+  /*! \brief Persistent cache for chains and blacklisted functions.
+   *
+   * If set, it is consulted after `cache` and before synthesis, and all
+   * synthesis results (and failures) are appended to it.  In contrast to
+   * `cache`, its entries are kept apart for different fanin sizes and gate
+   * types.
+   */
+  std::shared_ptr<binary_cache> persistent_cache;
+
   bool add_alonce_clauses{true};
   bool add_colex_clauses{true};
   bool add_lex_clauses{false};
@@ -78,6 +90,98 @@ struct exact_resynthesis_params
   percy::SynthMethod synthesis_method = percy::SYNTH_STD;
 };
 
+namespace detail
+{
+
+/* record kinds of exact synthesis results in a binary cache */
+static constexpr binary_cache::word exact_chain_record = 1u;
+static constexpr binary_cache::word exact_blacklist_record = 2u;
+
+inline std::vector<binary_cache::word> exact_cache_key( binary_cache::word context, kitty::dynamic_truth_table const& function )
+{
+  std::vector<binary_cache::word> key{context};
+  append_truth_table( key, function );
+  return key;
+}
+
+/* encodes a chain as index list: inputs, fanin size, steps, outputs, then
+ * fanins and operator of each step, and finally the output literals */
+inline std::vector<binary_cache::word> encode_chain( percy::chain const& c )
+{
+  std::vector<binary_cache::word> words{static_cast<binary_cache::word>( c.get_nr_inputs() ),
+                                        static_cast<binary_cache::word>( c.get_fanin() ),
+                                        static_cast<binary_cache::word>( c.get_nr_steps() ),
+                                        static_cast<binary_cache::word>( c.get_nr_outputs() )};
+  for ( auto i = 0; i < c.get_nr_steps(); ++i )
+  {
+    for ( auto fanin : c.get_step( i ) )
+    {
+      words.push_back( static_cast<binary_cache::word>( fanin ) );
+    }
+    auto const op = c.get_operator( i )._bits[0];
+    words.push_back( static_cast<binary_cache::word>( op ) );
+    words.push_back( static_cast<binary_cache::word>( op >> 32u ) );
+  }
+  for ( auto lit : c.get_outputs() )
+  {
+    words.push_back( static_cast<binary_cache::word>( lit ) );
+  }
+  return words;
+}
+
+/* decodes a chain written by `encode_chain`; returns `std::nullopt` if the
+ * record is corrupted, i.e., its counts do not fit the record length */
+inline std::optional<percy::chain> decode_chain( binary_cache::value_t const& value )
+{
+  auto it = value.first;
+  auto const size = static_cast<uint64_t>( std::distance( value.first, value.second ) );
+  if ( size < 4u )
+  {
+    return std::nullopt;
+  }
+  auto const nr_in = *it++;
+  auto const fanin = *it++;
+  auto const nr_steps = *it++;
+  auto const nr_out = *it++;
+
+  /* operators are stored in one 64-bit word */
+  if ( fanin == 0u || fanin > 6u || size != 4u + uint64_t( nr_steps ) * ( fanin + 2u ) + nr_out )
+  {
+    return std::nullopt;
+  }
+
+  percy::chain c;
+  c.reset( static_cast<int>( nr_in ), static_cast<int>( nr_out ), static_cast<int>( nr_steps ), static_cast<int>( fanin ) );
+  std::vector<int> fanins( fanin );
+  kitty::dynamic_truth_table op( fanin );
+  for ( auto i = 0u; i < nr_steps; ++i )
+  {
+    for ( auto& f : fanins )
+    {
+      if ( *it >= nr_in + i )
+      {
+        return std::nullopt;
+      }
+      f = static_cast<int>( *it++ );
+    }
+    op._bits[0] = static_cast<uint64_t>( it[0] ) | ( static_cast<uint64_t>( it[1] ) << 32u );
+    op.mask_bits();
+    it += 2;
+    c.set_step( i, fanins, op );
+  }
+  for ( auto i = 0u; i < nr_out; ++i )
+  {
+    if ( ( *it >> 1u ) > nr_in + nr_steps )
+    {
+      return std::nullopt;
+    }
+    c.set_output( i, static_cast<int>( *it++ ) );
+  }
+  return c;
+}
+
+} /* namespace detail */
+
 /*! \brief Resynthesis function based on exact synthesis.
  *
  * This resynthesis function can be passed to ``node_resynthesis``,
@@ -172,6 +276,7 @@ public:
         const auto it = _ps.cache->find( function );
         if ( it != _ps.cache->end() )
         {
+          profile_counter( "exact.cache_hits" );
           return it->second;
         }
       }
@@ -184,6 +289,27 @@ public:
         }
       }
 
+      const auto key = _ps.persistent_cache ? detail::exact_cache_key( _fanin_size, function ) : std::vector<binary_cache::word>{};
+      if ( !with_dont_cares && _ps.persistent_cache )
+      {
+        if ( const auto value = _ps.persistent_cache->find( detail::exact_chain_record, key ) )
+        {
+          /* corrupted records are cache misses */
+          if ( auto chain = detail::decode_chain( *value ) )
+          {
+            profile_counter( "exact.cache_hits" );
+            return chain;
+          }
+        }
+        if ( const auto value = _ps.persistent_cache->find( detail::exact_blacklist_record, key );
+             value && value->first != value->second && _ps.conflict_limit >= static_cast<int32_t>( *value->first ) )
+        {
+          return std::nullopt;
+        }
+      }
+
+      profile_scope scope( "exact_synthesis" );
+      profile_counter( "exact.synthesis_calls" );
       percy::chain c;
       if ( const auto result = percy::synthesize( spec, c, _ps.solver_type,
                                              _ps.encoder_type,
@@ -194,6 +320,10 @@ public:
         {
           ( *_ps.blacklist_cache )[function] = result == percy::timeout ? _ps.conflict_limit : 0;
         }
+        if ( !with_dont_cares && _ps.persistent_cache )
+        {
+          _ps.persistent_cache->insert( detail::exact_blacklist_record, key, {static_cast<binary_cache::word>( result == percy::timeout ? _ps.conflict_limit : 0 )} );
+        }
         return std::nullopt;
       }
       c.denormalize();
@@ -201,6 +331,10 @@ public:
       {
         ( *_ps.cache )[function] = c;
       }
+      if ( !with_dont_cares && _ps.persistent_cache )
+      {
+        _ps.persistent_cache->insert( detail::exact_chain_record, key, detail::encode_chain( c ) );
+      }
       return c;
     }();
 
@@ -328,6 +462,19 @@ public:
         }
       }
 
+      /* AIG and XAG chains are kept apart from k-LUT chains */
+      const auto key = _ps.persistent_cache ? detail::exact_cache_key( _allow_xor ? 0x201u : 0x200u, function ) : std::vector<binary_cache::word>{};
+      if ( !with_dont_cares && _ps.persistent_cache )
+      {
+        if ( const auto value = _ps.persistent_cache->find( detail::exact_chain_record, key ) )
+        {
+          if ( auto chain = detail::decode_chain( *value ) )
+          {
+            return chain;
+          }
+        }
+      }
+
       percy::chain c;
       if ( const auto result = percy::synthesize( spec, c, _ps.solver_type,
                                                   _ps.encoder_type,
@@ -340,6 +487,10 @@ public:
       {
         ( *_ps.cache )[function] = c;
       }
+      if ( !with_dont_cares && _ps.persistent_cache )
+      {
+        _ps.persistent_cache->insert( detail::exact_chain_record, key, detail::encode_chain( c ) );
+      }
       return c;
     }();
 
@@ -222,7 +222,7 @@ public:
   template<typename LeavesIterator, typename Fn>
   void operator()( xag_network& xag, kitty::dynamic_truth_table const& function, LeavesIterator begin, LeavesIterator end, Fn&& fn )
   {
-    stopwatch t1( st.time_total );
+    stopwatch t1( st.time_total, "xag_minmc" );
 
     const auto func_ext = kitty::extend_to<6u>( function );
     std::vector<kitty::detail::spectral_operation> trans;
@@ -355,7 +355,7 @@ public:
 private:
   void build_db( std::string const& filename )
   {
-    stopwatch t1( st.time_total );
+    stopwatch t1( st.time_total, "xag_minmc" );
     stopwatch t2( st.time_parse_db );
 
     std::generate( db_pis->begin(), db_pis->end(), [&]() { return db->create_pi(); } );
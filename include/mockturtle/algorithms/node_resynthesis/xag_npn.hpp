@@ -43,6 +43,7 @@
 #include <kitty/print.hpp>
 #include <kitty/static_truth_table.hpp>
 
+#include "../../algorithms/detail/npn4_table.hpp"
 #include "../../algorithms/simulation.hpp"
 #include "../../io/index_list.hpp"
 #include "../../networks/xag.hpp"
@@ -102,8 +103,7 @@ class xag_npn_resynthesis
 public:
   xag_npn_resynthesis( xag_npn_resynthesis_params const& ps = {}, xag_npn_resynthesis_stats* pst = nullptr )
       : ps( ps ),
-        pst( pst ),
-        _repr( 1u << 16u )
+        pst( pst )
   {
     static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
     static_assert( has_get_constant_v<Ntk>, "Ntk does not implement the get_constant method" );
@@ -146,11 +146,11 @@ public:
     kitty::static_truth_table<4u> tt = kitty::extend_to<4u>( function );
 
     /* get representative of function */
-    const auto [repr, phase, perm] = _repr[*tt.cbegin()];
+    const auto [repr, phase, perm] = _npn->config( static_cast<uint16_t>( *tt.cbegin() ) );
 
     /* check if representative has circuits */
-    const auto it = _repr_to_signal.find( repr );
-    if ( it == _repr_to_signal.end() )
+    const auto it = _db->repr_to_signal.find( repr );
+    if ( it == _db->repr_to_signal.end() )
     {
       return;
     }
@@ -167,8 +167,8 @@ public:
 
     for ( auto const& cand : it->second )
     {
-      const auto f = copy_db_entry( ntk, _db.get_node( cand ), db_to_ntk );
-      if ( !fn( _db.is_complemented( cand ) != ( phase >> 4 & 1 ) ? ntk.create_not( f ) : f ) )
+      const auto f = copy_db_entry( ntk, _db->ntk.get_node( cand ), db_to_ntk );
+      if ( !fn( _db->ntk.is_complemented( cand ) != ( phase >> 4 & 1 ) ? ntk.create_not( f ) : f ) )
       {
         return;
       }
@@ -185,12 +185,12 @@ private:
     }
 
     std::array<signal<Ntk>, 2> fanin{};
-    _db.foreach_fanin( n, [&]( auto const& f, auto i ) {
-      const auto ntk_f = copy_db_entry( ntk, _db.get_node( f ), db_to_ntk );
-      fanin[i] = _db.is_complemented( f ) ? ntk.create_not( ntk_f ) : ntk_f;
+    _db->ntk.foreach_fanin( n, [&]( auto const& f, auto i ) {
+      const auto ntk_f = copy_db_entry( ntk, _db->ntk.get_node( f ), db_to_ntk );
+      fanin[i] = _db->ntk.is_complemented( f ) ? ntk.create_not( ntk_f ) : ntk_f;
     } );
 
-    const auto f = _db.is_xor( n ) ? ntk.create_xor( fanin[0], fanin[1] ) : ntk.create_and( fanin[0], fanin[1] );
+    const auto f = _db->ntk.is_xor( n ) ? ntk.create_xor( fanin[0], fanin[1] ) : ntk.create_and( fanin[0], fanin[1] );
     db_to_ntk.insert( {n, f} );
     return f;
   }
@@ -198,62 +198,62 @@ private:
   void build_classes()
   {
     stopwatch t( st.time_classes );
-
-    kitty::static_truth_table<4u> tt;
-    do {
-      _repr[*tt.cbegin()] = kitty::exact_npn_canonization( tt );
-      kitty::next_inplace( tt );
-    } while ( !kitty::is_const0( tt ) );
+    _npn = &detail::npn4_table::instance();
   }
 
   void build_db()
   {
     stopwatch t( st.time_db );
 
-    _db = create_from_binary_index_list<DatabaseNtk>( subgraphs );
-    const auto sim_res = simulate_nodes<kitty::static_truth_table<4u>>( _db );
+    _db = &database::instance();
 
-    _db.foreach_node( [&]( auto n ) {
-      if ( std::get<0>( _repr[*sim_res[n].cbegin()] ) == sim_res[n] )
-      {
-        if ( _repr_to_signal.count( sim_res[n] ) == 0 )
+    st.db_size = _db->ntk.size();
+    st.covered_classes = static_cast<uint32_t>( _db->repr_to_signal.size() );
+  }
+
+  /* the database is built once per process from the compact index list
+   * below and only read afterwards, such that it can be shared by all
+   * instances */
+  struct database
+  {
+    static database const& instance()
+    {
+      static const database db;
+      return db;
+    }
+
+    database()
+        : ntk( create_from_binary_index_list<DatabaseNtk>( subgraphs ) )
+    {
+      const auto npn = &detail::npn4_table::instance();
+      const auto sim_res = simulate_nodes<kitty::static_truth_table<4u>>( ntk );
+
+      ntk.foreach_node( [&]( auto n ) {
+        if ( npn->representative( static_cast<uint16_t>( *sim_res[n].cbegin() ) ) == *sim_res[n].cbegin() )
         {
-          _repr_to_signal.insert( {sim_res[n], {_db.make_signal( n )}} );
+          repr_to_signal[sim_res[n]].push_back( ntk.make_signal( n ) );
         }
         else
         {
-          _repr_to_signal[sim_res[n]].push_back( _db.make_signal( n ) );
-        }
-      }
-      else
-      {
-        const auto f = ~sim_res[n];
-        if ( std::get<0>( _repr[*f.cbegin()] ) == f )
-        {
-          if ( _repr_to_signal.count( f ) == 0 )
-          {
-            _repr_to_signal.insert( {f, {!_db.make_signal( n )}} );
-          }
-          else
+          const auto f = ~sim_res[n];
+          if ( npn->representative( static_cast<uint16_t>( *f.cbegin() ) ) == *f.cbegin() )
           {
-            _repr_to_signal[f].push_back( !_db.make_signal( n ) );
+            repr_to_signal[f].push_back( !ntk.make_signal( n ) );
           }
         }
-      }
-    } );
+      } );
+    }
 
-    st.db_size = _db.size();
-    st.covered_classes = static_cast<uint32_t>( _repr_to_signal.size() );
-  }
+    DatabaseNtk ntk;
+    std::unordered_map<kitty::static_truth_table<4u>, std::vector<signal<DatabaseNtk>>, kitty::hash<kitty::static_truth_table<4u>>> repr_to_signal;
+  };
 
   xag_npn_resynthesis_params ps;
   xag_npn_resynthesis_stats st;
   xag_npn_resynthesis_stats* pst{nullptr};
 
-  std::vector<std::tuple<kitty::static_truth_table<4u>, uint32_t, std::vector<uint8_t>>> _repr;
-  std::unordered_map<kitty::static_truth_table<4u>, std::vector<signal<DatabaseNtk>>, kitty::hash<kitty::static_truth_table<4u>>> _repr_to_signal;
-
-  DatabaseNtk _db;
+  detail::npn4_table const* _npn{nullptr};
+  database const* _db{nullptr};
 
   // clang-format off
   inline static const uint32_t subgraphs[] = {1780 << 16 | 0 << 8 | 4,
@@ -43,6 +43,7 @@
 #include <kitty/print.hpp>
 #include <kitty/static_truth_table.hpp>
 
+#include "../../algorithms/detail/npn4_table.hpp"
 #include "../../algorithms/simulation.hpp"
 #include "../../io/write_bench.hpp"
 #include "../../networks/xmg.hpp"
@@ -103,8 +104,7 @@ class xmg3_npn_resynthesis
 public:
   xmg3_npn_resynthesis( xmg3_npn_resynthesis_params const& ps = {}, xmg3_npn_resynthesis_stats* pst = nullptr )
       : ps( ps ),
-        pst( pst ),
-        _classes( 1 << 16 )
+        pst( pst )
   {
     static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
     static_assert( has_get_constant_v<Ntk>, "Ntk does not implement the get_constant method" );
@@ -124,7 +124,6 @@ public:
     static_assert( has_foreach_node_v<DatabaseNtk>, "DatabaseNtk does not implement the foreach_node method" );
     static_assert( has_make_signal_v<DatabaseNtk>, "DatabaseNtk does not implement the make_signal method" );
 
-    _repr.reserve( 222u );
     build_classes();
     build_db();
   }
@@ -148,30 +147,26 @@ public:
     kitty::static_truth_table<4u> tt = kitty::extend_to<4u>( function );
 
     /* get representative of function */
-    const auto repr = _repr[_classes[*tt.cbegin()]];
+    const auto config = _npn->config( static_cast<uint16_t>( *tt.cbegin() ) );
 
     /* check if representative has circuits */
-    const auto it = _repr_to_signal.find( repr );
-    if ( it == _repr_to_signal.end() )
+    const auto it = _db->repr_to_signal.find( config.repr );
+    if ( it == _db->repr_to_signal.end() )
     {
       return;
     }
 
-    const auto config = kitty::exact_npn_canonization( tt );
-
-    assert( repr == std::get<0>( config ) );
-
     std::vector<signal<Ntk>> pis( 4, ntk.get_constant( false ) );
     std::copy( begin, end, pis.begin() );
 
     std::vector<signal<Ntk>> pis_perm;
-    auto perm = std::get<2>( config );
+    auto const& perm = config.perm;
     for ( auto i = 0; i < 4; ++i )
     {
       pis_perm.push_back( pis[perm[i]] );
     }
 
-    const auto& phase = std::get<1>( config );
+    const auto& phase = config.phase;
     for ( auto i = 0; i < 4; ++i )
     {
       if ( ( phase >> perm[i] ) & 1 )
@@ -189,8 +184,8 @@ public:
       {
         db_to_ntk.insert( {i + 1, pis_perm[i]} );
       }
-      auto f = copy_db_entry( ntk, _db.get_node( cand ), db_to_ntk );
-      if ( _db.is_complemented( cand ) != ( ( phase >> 4 ) & 1 ) )
+      auto f = copy_db_entry( ntk, _db->ntk.get_node( cand ), db_to_ntk );
+      if ( _db->ntk.is_complemented( cand ) != ( ( phase >> 4 ) & 1 ) )
       {
         f = ntk.create_not( f );
       }
@@ -212,16 +207,16 @@ private:
 
     std::vector<signal<Ntk>> fanin;
     //std::array<signal<Ntk>, 2> fanin;
-    _db.foreach_fanin( n, [&]( auto const& f ) {
-      auto ntk_f = copy_db_entry( ntk, _db.get_node( f ), db_to_ntk );
-      if ( _db.is_complemented( f ) )
+    _db->ntk.foreach_fanin( n, [&]( auto const& f ) {
+      auto ntk_f = copy_db_entry( ntk, _db->ntk.get_node( f ), db_to_ntk );
+      if ( _db->ntk.is_complemented( f ) )
       {
         ntk_f = ntk.create_not( ntk_f );
       }
       fanin.push_back( ntk_f );
     } );
 
-    const auto f = _db.is_xor3( n ) ? ntk.create_xor3( fanin[0], fanin[1], fanin[2] ) : ntk.create_maj( fanin[0], fanin[1], fanin[2] );
+    const auto f = _db->ntk.is_xor3( n ) ? ntk.create_xor3( fanin[0], fanin[1], fanin[2] ) : ntk.create_maj( fanin[0], fanin[1], fanin[2] );
     db_to_ntk.insert( {n, f} );
     return f;
   }
@@ -229,108 +224,94 @@ private:
   void build_classes()
   {
     stopwatch t( st.time_classes );
-
-    kitty::dynamic_truth_table map( 16u );
-    std::transform( map.cbegin(), map.cend(), map.begin(), []( auto word ) { return ~word; } );
-
-    int64_t index = 0;
-    kitty::static_truth_table<4u> tt;
-    while ( index != -1 )
-    {
-      kitty::create_from_words( tt, &index, &index + 1 );
-      const auto res = kitty::exact_npn_canonization( tt, [&]( const auto& tt ) {
-        _classes[*tt.cbegin()] = _repr.size();
-        kitty::clear_bit( map, *tt.cbegin() );
-      } );
-      _repr.push_back( std::get<0>( res ) );
-
-      /* find next non-classified truth table */
-      index = find_first_one_bit( map );
-    }
+    _npn = &detail::npn4_table::instance();
   }
 
   void build_db()
   {
     stopwatch t( st.time_db );
 
-    _db.get_constant( false );
-    /* four primary inputs */
-    _db.create_pi();
-    _db.create_pi();
-    _db.create_pi();
-    _db.create_pi();
+    _db = &database::instance();
 
-    auto* p = subgraphs;
-    while ( true )
-    {
-      auto entry0 = *p++;
-      auto entry1 = *p++;
-      auto entry2 = *p++;
+    st.db_size = _db->ntk.size();
+    st.covered_classes = static_cast<uint32_t>( _db->repr_to_signal.size() );
+  }
 
-      if ( entry0 == 0 && entry1 == 0 && entry2 == 0 )
-        break;
+  /* the database is built once per process from the compact encoding below
+   * and only read afterwards, such that it can be shared by all instances */
+  struct database
+  {
+    static database const& instance()
+    {
+      static const database db;
+      return db;
+    }
 
-      auto is_xor = entry0 & 1;
-      entry0 >>= 1;
+    database()
+    {
+      ntk.get_constant( false );
+      /* four primary inputs */
+      ntk.create_pi();
+      ntk.create_pi();
+      ntk.create_pi();
+      ntk.create_pi();
+
+      auto* p = subgraphs;
+      while ( true )
+      {
+        auto entry0 = *p++;
+        auto entry1 = *p++;
+        auto entry2 = *p++;
 
-      const auto child0 = _db.make_signal( entry0 >> 1 ) ^ ( entry0 & 1 );
-      const auto child1 = _db.make_signal( entry1 >> 1 ) ^ ( entry1 & 1 );
-      const auto child2 = _db.make_signal( entry2 >> 1 ) ^ ( entry2 & 1 );
+        if ( entry0 == 0 && entry1 == 0 && entry2 == 0 )
+          break;
 
-      if ( is_xor )
-      {
-        _db.create_xor3( child0, child1, child2 );
-      }
-      else
-      {
-        _db.create_maj( child0, child1, child2 );
-      }
-    }
+        auto is_xor = entry0 & 1;
+        entry0 >>= 1;
 
-    const auto sim_res = simulate_nodes<kitty::static_truth_table<4u>>( _db );
+        const auto child0 = ntk.make_signal( entry0 >> 1 ) ^ ( entry0 & 1 );
+        const auto child1 = ntk.make_signal( entry1 >> 1 ) ^ ( entry1 & 1 );
+        const auto child2 = ntk.make_signal( entry2 >> 1 ) ^ ( entry2 & 1 );
 
-    _db.foreach_node( [&]( auto n ) {
-      if ( _repr[_classes[*sim_res[n].cbegin()]] == sim_res[n] )
-      {
-        if ( _repr_to_signal.count( sim_res[n] ) == 0 )
+        if ( is_xor )
         {
-          _repr_to_signal.insert( {sim_res[n], {_db.make_signal( n )}} );
+          ntk.create_xor3( child0, child1, child2 );
         }
         else
         {
-          _repr_to_signal[sim_res[n]].push_back( _db.make_signal( n ) );
+          ntk.create_maj( child0, child1, child2 );
         }
       }
-      else
-      {
-        const auto f = ~sim_res[n];
-        if ( _repr[_classes[*f.cbegin()]] == f )
+
+      const auto npn = &detail::npn4_table::instance();
+      const auto sim_res = simulate_nodes<kitty::static_truth_table<4u>>( ntk );
+
+      ntk.foreach_node( [&]( auto n ) {
+        if ( npn->representative( static_cast<uint16_t>( *sim_res[n].cbegin() ) ) == *sim_res[n].cbegin() )
         {
-          if ( _repr_to_signal.count( f ) == 0 )
-          {
-            _repr_to_signal.insert( {f, {!_db.make_signal( n )}} );
-          }
-          else
+          repr_to_signal[sim_res[n]].push_back( ntk.make_signal( n ) );
+        }
+        else
+        {
+          const auto f = ~sim_res[n];
+          if ( npn->representative( static_cast<uint16_t>( *f.cbegin() ) ) == *f.cbegin() )
           {
-            _repr_to_signal[f].push_back( !_db.make_signal( n ) );
+            repr_to_signal[f].push_back( !ntk.make_signal( n ) );
           }
         }
-      }
-    } );
+      } );
+    }
 
-    st.db_size = _db.size();
-    st.covered_classes = static_cast<uint32_t>( _repr_to_signal.size() );
-  }
+    DatabaseNtk ntk;
+    std::unordered_map<kitty::static_truth_table<4u>, std::vector<signal<DatabaseNtk>>, kitty::hash<kitty::static_truth_table<4u>>> repr_to_signal;
+  };
 
   xmg3_npn_resynthesis_params ps;
   xmg3_npn_resynthesis_stats st;
   xmg3_npn_resynthesis_stats* pst{nullptr};
 
-  std::vector<kitty::static_truth_table<4u>> _repr;
-  std::vector<uint32_t> _classes;
-  std::unordered_map<kitty::static_truth_table<4u>, std::vector<signal<DatabaseNtk>>, kitty::hash<kitty::static_truth_table<4u>>> _repr_to_signal;
-
-  DatabaseNtk _db;
+  detail::npn4_table const* _npn{nullptr};
+  database const* _db{nullptr};
 
   // clang-format off
   inline static const uint16_t subgraphs[]
@@ -34,6 +34,7 @@
 
 #include "../utils/progress_bar.hpp"
 #include "../utils/stopwatch.hpp"
+#include "../utils/thread_pool.hpp"
 #include <bill/sat/interface/abc_bsat2.hpp>
 #include <bill/sat/interface/z3.hpp>
 #include <kitty/partial_truth_table.hpp>
@@ -41,6 +42,8 @@
 #include <mockturtle/algorithms/dont_cares.hpp>
 #include <mockturtle/algorithms/simulation.hpp>
 #include <mockturtle/networks/aig.hpp>
+#include <memory>
+#include <optional>
 #include <random>
 
 namespace mockturtle
@@ -76,6 +79,21 @@ struct pattern_generation_params
 
   /*! \brief Maximum number of clauses of the SAT solver. (incremental CNF construction) */
   uint32_t max_clauses{1000};
+
+  /*! \brief Number of threads for stuck-at checking (0 = default number of threads).
+   *
+   * When this parameter is not 1, the nodes are checked in rounds.  In each
+   * round, a batch of nodes is distributed among the threads, each of which
+   * has its own SAT solver.  The generated patterns are then merged into the
+   * simulator and the network is re-simulated, such that nodes covered by
+   * the new patterns are not checked anymore.  The result only depends on
+   * the number of threads, not on thread scheduling.  Only supported when
+   * `odc_levels == 0`; otherwise the stuck-at check is done sequentially.
+   */
+  uint32_t num_threads{1u};
+
+  /*! \brief Number of nodes checked by each thread in one round. */
+  uint32_t batch_size{64u};
 };
 
 struct pattern_generation_stats
@@ -106,6 +124,9 @@ struct pattern_generation_stats
 
   /*! \brief Number of unobservable nodes (node for which an observable pattern can not be found). */
   uint32_t unobservable_node{0};
+
+  /*! \brief Statistics of the SAT validators (summed over all threads). */
+  validator_stats validator_st;
 };
 
 namespace detail
@@ -127,7 +148,7 @@ public:
 
   void run()
   {
-    stopwatch t( st.time_total );
+    stopwatch t( st.time_total, "pattern_generation" );
 
     call_with_stopwatch( st.time_sim, [&]() {
       simulate_nodes<Ntk>( ntk, tts, sim, true );
@@ -135,7 +156,21 @@ public:
 
     if ( ps.num_stuck_at > 0 )
     {
-      stuck_at_check();
+      if constexpr ( !use_odc )
+      {
+        if ( ps.num_threads != 1u )
+        {
+          stuck_at_check_parallel();
+        }
+        else
+        {
+          stuck_at_check();
+        }
+      }
+      else
+      {
+        stuck_at_check();
+      }
       if constexpr( std::is_same_v<Simulator, bit_packed_simulator> )
       {
         sim.pack_bits();
@@ -168,6 +203,8 @@ public:
         } );
       }
     }
+
+    st.validator_st += validator.stats();
   }
 
 private:
@@ -281,6 +318,198 @@ private:
     } );
   }
 
+  /* a node to be checked in parallel stuck-at checking */
+  struct stuck_at_job
+  {
+    node n;
+
+    /* wanted value of n */
+    bool value;
+
+    /* whether n is constant under all current patterns */
+    bool is_constant;
+
+    /* existing patterns for which n is `value` (only if not constant) */
+    std::vector<std::vector<bool>> known_patterns;
+  };
+
+  /* thread-local solver and pattern shard for parallel stuck-at checking */
+  struct stuck_at_worker
+  {
+    stuck_at_worker( Ntk const& ntk, validator_params const& wps )
+        : vps( wps ), validator( ntk, vps ), shard( std::in_place, ntk.num_pis(), 0 ), shard_tts( ntk )
+    {
+    }
+
+    validator_params vps;
+    circuit_validator<Ntk, bill::solvers::bsat2, true, true, false> validator;
+
+    /* patterns generated in the current round, used to skip covered nodes */
+    std::optional<partial_simulator> shard;
+    TT shard_tts;
+
+    std::vector<std::pair<std::vector<bool>, node>> patterns;
+    std::vector<signal> const_nodes;
+  };
+
+  void stuck_at_check_parallel()
+  {
+    uint32_t const num_threads = resolve_num_threads( ps.num_threads );
+
+    std::vector<std::unique_ptr<stuck_at_worker>> workers;
+    for ( auto t = 0u; t < num_threads; ++t )
+    {
+      validator_params wps = vps;
+      wps.odc_levels = 0;
+      wps.random_seed = vps.random_seed + t;
+      workers.emplace_back( std::make_unique<stuck_at_worker>( ntk, wps ) );
+    }
+
+    std::vector<node> gates;
+    ntk.foreach_gate( [&]( auto const& n ) {
+      gates.emplace_back( n );
+    } );
+
+    progress_bar pbar{static_cast<uint32_t>( gates.size() ), "patgen-sa |{0}| node = {1:>4} #pat = {2:>4}", ps.progress};
+
+    std::vector<stuck_at_job> jobs;
+    auto next = 0u;
+    while ( next < gates.size() )
+    {
+      pbar( next, next, sim.num_bits() );
+
+      /* collect the next batch of nodes that need to be checked */
+      jobs.clear();
+      kitty::partial_truth_table const zero = sim.compute_constant( false );
+      while ( next < gates.size() && jobs.size() < num_threads * ps.batch_size )
+      {
+        auto const n = gates[next++];
+        if ( tts[n].num_bits() != sim.num_bits() )
+        {
+          call_with_stopwatch( st.time_sim, [&]() {
+            simulate_node<Ntk>( ntk, n, tts, sim );
+          } );
+        }
+
+        auto const& tt = tts[n];
+        if ( ( tt == zero ) || ( tt == ~zero ) )
+        {
+          jobs.push_back( {n, tt == zero, true, {}} );
+        }
+        else if ( ps.num_stuck_at > 1 )
+        {
+          if ( kitty::count_ones( tt ) < ps.num_stuck_at )
+          {
+            jobs.push_back( {n, true, false, collect_patterns( tt, true )} );
+          }
+          else if ( kitty::count_zeros( tt ) < ps.num_stuck_at )
+          {
+            jobs.push_back( {n, false, false, collect_patterns( tt, false )} );
+          }
+        }
+      }
+
+      if ( jobs.empty() )
+      {
+        continue;
+      }
+
+      /* check the batch, each thread takes a contiguous chunk (the patterns
+       * found depend on the worker, stealing would make them non-deterministic) */
+      call_with_stopwatch( st.time_sat, [&]() {
+        uint64_t const chunk_size = ( jobs.size() + num_threads - 1u ) / num_threads;
+        default_thread_pool().run( static_cast<uint32_t>( ( jobs.size() + chunk_size - 1u ) / chunk_size ), [&]( uint32_t t ) {
+          auto const end = std::min<uint64_t>( jobs.size(), ( t + 1u ) * chunk_size );
+          for ( auto j = t * chunk_size; j < end; ++j )
+          {
+            check_stuck_at( *workers[t], jobs[j] );
+          }
+        } );
+      } );
+
+      /* merge results in a deterministic order and re-simulate */
+      for ( auto& w : workers )
+      {
+        st.num_constant += static_cast<uint32_t>( w->const_nodes.size() );
+        std::copy( w->const_nodes.begin(), w->const_nodes.end(), std::back_inserter( const_nodes ) );
+        for ( auto const& [pattern, n] : w->patterns )
+        {
+          new_pattern( pattern, n );
+        }
+
+        w->const_nodes.clear();
+        w->patterns.clear();
+        w->shard.emplace( ntk.num_pis(), 0 );
+        w->shard_tts.reset();
+      }
+
+      if ( sim.num_bits() % 64 != 0 )
+      {
+        call_with_stopwatch( st.time_sim, [&]() {
+          simulate_nodes<Ntk>( ntk, tts, sim, false );
+        } );
+      }
+    }
+
+    for ( auto const& w : workers )
+    {
+      st.validator_st += w->validator.stats();
+    }
+  }
+
+  /* runs in a worker thread, must not modify shared data */
+  void check_stuck_at( stuck_at_worker& w, stuck_at_job const& job )
+  {
+    auto const add_pattern = [&]( std::vector<bool> const& pattern ) {
+      w.patterns.emplace_back( pattern, job.n );
+      w.shard->add_pattern( pattern );
+      w.shard_tts.reset();
+    };
+
+    if ( !job.is_constant )
+    {
+      auto const generated = w.validator.generate_pattern( job.n, job.value, job.known_patterns, ps.num_stuck_at - job.known_patterns.size() );
+      for ( auto const& pattern : generated )
+      {
+        add_pattern( pattern );
+      }
+      return;
+    }
+
+    /* skip node if a pattern generated in this round already covers it */
+    if ( ps.num_stuck_at == 1 && w.shard->num_bits() > 0u )
+    {
+      simulate_node<Ntk>( ntk, job.n, w.shard_tts, *w.shard );
+      auto const shard_zero = w.shard->compute_constant( false );
+      if ( w.shard_tts[job.n] != ( job.value ? shard_zero : ~shard_zero ) )
+      {
+        return;
+      }
+    }
+
+    const auto res = w.validator.validate( job.n, !job.value );
+    if ( !res )
+    {
+      return; /* timeout */
+    }
+    else if ( !( *res ) ) /* SAT, pattern found */
+    {
+      auto const cex = w.validator.cex;
+      add_pattern( cex );
+      if ( ps.num_stuck_at > 1 )
+      {
+        for ( auto const& pattern : w.validator.generate_pattern( job.n, job.value, {cex}, ps.num_stuck_at - 1 ) )
+        {
+          add_pattern( pattern );
+        }
+      }
+    }
+    else /* UNSAT, constant node */
+    {
+      w.const_nodes.emplace_back( job.value ? ntk.make_signal( job.n ) : !ntk.make_signal( job.n ) );
+    }
+  }
+
   void observability_check()
   {
     progress_bar pbar{ntk.size(), "patgen-obs |{0}| node = {1:>4} #pat = {2:>4}", ps.progress};
@@ -415,9 +644,9 @@ private:
     }
   }
 
-  void generate_more_patterns( node const& n, kitty::partial_truth_table const& tt, bool value, kitty::partial_truth_table& zero )
+  /* collect the patterns for which a node with simulation signature `tt` is `value` */
+  std::vector<std::vector<bool>> collect_patterns( kitty::partial_truth_table const& tt, bool value )
   {
-    /* collect the `value` patterns */
     std::vector<std::vector<bool>> patterns;
     for ( auto i = 0u; i < tt.num_bits(); ++i )
     {
@@ -429,6 +658,13 @@ private:
         } );
       }
     }
+    return patterns;
+  }
+
+  void generate_more_patterns( node const& n, kitty::partial_truth_table const& tt, bool value, kitty::partial_truth_table& zero )
+  {
+    /* collect the `value` patterns */
+    auto const patterns = collect_patterns( tt, value );
 
     auto generated = call_with_stopwatch( st.time_sat, [&]() {
       vps.odc_levels = ps.odc_levels;
@@ -34,6 +34,7 @@
 
 #include "../networks/mig.hpp"
 #include "../traits.hpp"
+#include "../utils/allocators.hpp"
 #include "../utils/cost_functions.hpp"
 #include "../utils/progress_bar.hpp"
 #include "../utils/stopwatch.hpp"
@@ -41,7 +42,9 @@
 #include "../views/mffc_view.hpp"
 #include "../views/topo_view.hpp"
 #include "cleanup.hpp"
+#include "detail/dry_run_overlay.hpp"
 #include "detail/mffc_utils.hpp"
+#include "detail/rewriting_library.hpp"
 #include "dont_cares.hpp"
 #include "simulation.hpp"
 
@@ -67,6 +70,18 @@ struct refactoring_params
   /*! \brief Use don't cares for optimization. */
   bool use_dont_cares{false};
 
+  /*! \brief Cache refactoring candidates by MFFC function.
+   *
+   * When true, the refactoring function is called only once for each MFFC
+   * function, into a scratch network, and must therefore only depend on the
+   * function and the leaves.  For AIGs and XAGs, the candidate is evaluated on
+   * a virtual overlay of the network using structural hashing lookups and is
+   * only created if it is accepted, which leaves no dangling nodes from
+   * rejected candidates, provided that the cost function is structural (see
+   * `is_structural_cost`).  Not used together with don't cares.
+   */
+  bool use_candidate_cache{false};
+
   /*! \brief Show progress. */
   bool progress{false};
 
@@ -130,13 +145,19 @@ class refactoring_impl
 {
 public:
   refactoring_impl( Ntk& ntk, RefactoringFn&& refactoring_fn, refactoring_params const& ps, refactoring_stats& st, NodeCostFn const& cost_fn )
-      : ntk( ntk ), refactoring_fn( refactoring_fn ), ps( ps ), st( st ), cost_fn( cost_fn ) {}
+      : ntk( ntk ), refactoring_fn( refactoring_fn ), ps( ps ), st( st ), cost_fn( cost_fn ), overlay( ntk )
+  {
+    if ( ps.use_candidate_cache && !ps.use_dont_cares )
+    {
+      library.emplace( std::max( 1u, ps.max_pis ) );
+    }
+  }
 
   void run()
   {
     progress_bar pbar{ntk.size(), "refactoring |{0}| node = {1:>4}   cand = {2:>4}   est. reduction = {3:>5}", ps.progress};
 
-    stopwatch t( st.time_total );
+    stopwatch t( st.time_total, "refactoring" );
 
     ntk.clear_visited();
     ntk.clear_values();
@@ -163,7 +184,7 @@ public:
         return true;
       }
 
-      std::vector<signal<Ntk>> leaves( mffc.num_pis() );
+      std::vector<signal<Ntk>, pool_allocator<signal<Ntk>>> leaves( mffc.num_pis() );
       mffc.foreach_pi( [&]( auto const& m, auto j ) {
         leaves[j] = ntk.make_signal( m );
       } );
@@ -173,6 +194,50 @@ public:
                                            [&]() { return simulate<kitty::dynamic_truth_table>( mffc, sim )[0]; } );
 
       signal<Ntk> new_f;
+      if ( library )
+      {
+        std::optional<uint32_t> candidate;
+        {
+          stopwatch t( st.time_refactoring );
+          library->foreach_candidate( library->lookup( tt, refactoring_fn ), [&]( auto const& c ) {
+            candidate = c;
+            return false;
+          } );
+        }
+        if ( !candidate )
+        {
+          return true;
+        }
+
+        if constexpr ( dry_run_overlay<Ntk>::template is_supported<NodeCostFn> )
+        {
+          if ( const auto f = overlay.build( *library, *candidate, leaves.begin() ) )
+          {
+            if ( n == ntk.get_node( *f ) )
+            {
+              return true;
+            }
+
+            int32_t gain = recursive_deref( n );
+            gain -= overlay.recursive_ref( cost_fn );
+            overlay.recursive_deref( cost_fn );
+
+            if ( gain > 0 || ( ps.allow_zero_gain && gain == 0 ) )
+            {
+              new_f = library->instantiate( ntk, *candidate, leaves.begin() );
+              recursive_ref( ntk.get_node( new_f ) );
+              substitute( n, new_f, leaves, gain );
+            }
+            else
+            {
+              recursive_ref( n );
+            }
+            return true;
+          }
+        }
+        new_f = library->instantiate( ntk, *candidate, leaves.begin() );
+      }
+      else
       {
         if ( ps.use_dont_cares )
         {
@@ -210,16 +275,7 @@ public:
 
       if ( gain > 0 || ( ps.allow_zero_gain && gain == 0 ) )
       {
-
-        ++_candidates;
-        _estimated_gain += gain;
-        ntk.substitute_node( n, new_f );
-        ntk.set_value( n, 0 );
-        ntk.set_value( ntk.get_node( new_f ), ntk.fanout_size( ntk.get_node( new_f ) ) );
-        for ( auto i = 0u; i < leaves.size(); i++ )
-        {
-          ntk.set_value( ntk.get_node( leaves[i] ), ntk.fanout_size( ntk.get_node( leaves[i] ) ) );
-        }
+        substitute( n, new_f, leaves, gain );
       }
       else
       {
@@ -231,6 +287,20 @@ public:
   }
 
 private:
+  template<class Leaves>
+  void substitute( node<Ntk> const& n, signal<Ntk> const& new_f, Leaves const& leaves, int32_t gain )
+  {
+    ++_candidates;
+    _estimated_gain += gain;
+    ntk.substitute_node( n, new_f );
+    ntk.set_value( n, 0 );
+    ntk.set_value( ntk.get_node( new_f ), ntk.fanout_size( ntk.get_node( new_f ) ) );
+    for ( auto i = 0u; i < leaves.size(); i++ )
+    {
+      ntk.set_value( ntk.get_node( leaves[i] ), ntk.fanout_size( ntk.get_node( leaves[i] ) ) );
+    }
+  }
+
   uint32_t recursive_deref( node<Ntk> const& n )
   {
     /* terminate? */
@@ -272,6 +342,9 @@ private:
   refactoring_stats& st;
   NodeCostFn cost_fn;
 
+  std::optional<rewriting_library<Ntk>> library; /* only with ps.use_candidate_cache */
+  dry_run_overlay<Ntk> overlay;
+
   uint32_t _candidates{0};
   uint32_t _estimated_gain{0};
 };
@@ -258,7 +258,7 @@ public:
     });
 
     /* collect the divisor nodes in the cut */
-    bool div_comp_success = call_with_stopwatch( st.time_divs, [&]() {
+    bool div_comp_success = call_with_stopwatch( st.time_divs, "divisor_collection", [&]() {
       return collect_divisors( n );
     });
 
@@ -544,12 +544,12 @@ private:
 
       /* compute truth tables of inner nodes */
       sim.assign( d, i - uint32_t( leaves.size() ) + ps.max_pis + 1 );
-      std::vector<TTsim> tts;
+      fanin_tts.clear();
       ntk.foreach_fanin( d, [&]( const auto& s ) {
-        tts.emplace_back( sim.get_tt( ntk.make_signal( ntk.get_node( s ) ) ) ); /* ignore sign */
+        fanin_tts.emplace_back( sim.get_tt( ntk.make_signal( ntk.get_node( s ) ) ) ); /* ignore sign */
       } );
 
-      auto const tt = ntk.compute( d, tts.begin(), tts.end() );
+      auto const tt = ntk.compute( d, fanin_tts.begin(), fanin_tts.end() );
       sim.set_tt( i - uint32_t( leaves.size() ) + ps.max_pis + 1, tt );
     }
 
@@ -564,6 +564,9 @@ private:
   stats& st;
 
   window_simulator<Ntk, TTsim> sim;
+
+  /* truth tables of the fanins of a node, reused for all nodes of all windows */
+  std::vector<TTsim> fanin_tts;
 }; /* window_based_resub_engine */
 
 /*! \brief The top-level resubstitution framework.
@@ -633,7 +636,7 @@ public:
 
   void run( resub_callback_t const& callback = substitute_fn<Ntk> )
   {
-    stopwatch t( st.time_total );
+    stopwatch t( st.time_total, "resubstitution" );
 
     /* start the managers */
     DivCollector collector( ntk, ps, collector_st );
@@ -654,10 +657,11 @@ public:
       {
         return true; /* next */
       }
+      profile_counter( "nodes_visited" );
 
       /* compute cut, collect divisors, compute MFFC */
       mffc_result_t potential_gain;
-      const auto collector_success = call_with_stopwatch( st.time_divs, [&]() {
+      const auto collector_success = call_with_stopwatch( st.time_divs, "divisor_collection", [&]() {
         return collector.run( n, potential_gain );
       });
       if ( !collector_success )
@@ -670,7 +674,7 @@ public:
       st.num_total_divisors += collector.divs.size();
 
       /* try to find a resubstitution with the divisors */
-      auto g = call_with_stopwatch( st.time_resub, [&]() {
+      auto g = call_with_stopwatch( st.time_resub, "resub_engine", [&]() {
         if constexpr ( ResubEngine::require_leaves_and_mffc ) /* window-based */
         {
           return resub_engine.run( n, collector.leaves, collector.divs, collector.mffc, potential_gain, last_gain );
@@ -690,7 +694,7 @@ public:
       st.estimated_gain += last_gain;
 
       /* update network */
-      call_with_stopwatch( st.time_callback, [&]() {
+      call_with_stopwatch( st.time_callback, "substitution", [&]() {
         return callback( ntk, n, *g );
       } );
 
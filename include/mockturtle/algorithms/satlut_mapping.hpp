@@ -33,12 +33,15 @@
 #pragma once
 
 #include <cmath>
+#include <memory>
+#include <vector>
 
 #include "../generators/sorting.hpp"
 #include "../utils/include/percy.hpp"
 #include "../utils/node_map.hpp"
 #include "../utils/progress_bar.hpp"
 #include "../utils/stopwatch.hpp"
+#include "../utils/thread_pool.hpp"
 #include "../views/topo_view.hpp"
 #include "cell_window.hpp"
 #include "cut_enumeration.hpp"
@@ -75,6 +78,19 @@ struct satlut_mapping_params
    */
   uint32_t conflict_limit{0u};
 
+  /*! \brief Number of threads for windowed mapping (0 = default number of threads).
+   *
+   * When this parameter is not 1, the windowed version collects batches of
+   * windows with disjoint gates, solves the SAT problems of a batch
+   * concurrently, each with its own solver, and then updates the mapping of
+   * the windows in the order in which they were collected.  The result does
+   * not depend on the number of threads.
+   */
+  uint32_t num_threads{1u};
+
+  /*! \brief Maximum number of windows in a batch (if `num_threads` is not 1). */
+  uint32_t batch_size{32u};
+
   /*! \brief Show progress. */
   bool progress{false};
 
@@ -104,12 +120,26 @@ struct satlut_mapping_stats
   /*! \brief Number of SAT clauses. */
   uint64_t num_clauses{0u};
 
+  /*! \brief Number of windows (windowed mapping). */
+  uint32_t num_windows{0u};
+
+  /*! \brief Number of batches (parallel windowed mapping). */
+  uint32_t num_batches{0u};
+
   void report()
   {
     std::cout << fmt::format( "[i] total time              = {:>7.2f} secs\n", to_seconds( time_total ) )
               << fmt::format( "[i] SAT solving time        = {:>7.2f} secs\n", to_seconds( time_sat ) )
               << fmt::format( "[i] number of SAT variables = {}\n", num_vars )
               << fmt::format( "[i] number of SAT clauses   = {}\n", num_clauses );
+    if ( num_windows > 0u )
+    {
+      std::cout << fmt::format( "[i] number of windows       = {}\n", num_windows );
+    }
+    if ( num_batches > 0u )
+    {
+      std::cout << fmt::format( "[i] number of batches       = {}\n", num_batches );
+    }
   }
 };
 
@@ -193,7 +223,17 @@ public:
 
   void run()
   {
-    stopwatch t( st.time_total );
+    if ( solve() )
+    {
+      commit();
+    }
+  }
+
+  /* finds the smallest mapping without changing the network, returns false
+   * if no mapping was found */
+  bool solve()
+  {
+    stopwatch t( st.time_total, "satlut_mapping" );
 
     std::vector<int> card_inp;
     node_map<int, Ntk> gate_var( ntk );
@@ -243,8 +283,8 @@ public:
       solver.add_clause( &lit, &lit + 1 );
     } );
 
-    st.num_vars = solver.nr_vars();
-    st.num_clauses = solver.nr_clauses();
+    st.num_vars += solver.nr_vars();
+    st.num_clauses += solver.nr_clauses();
 
     auto best_size = ntk.has_mapping() ? ntk.num_cells() + 1 : card_inp.size();
 
@@ -261,10 +301,11 @@ public:
       }
       auto assump = pabc::Abc_Var2Lit( card_out[card_out.size() - best_size], 1 );
 
-      const auto result = call_with_stopwatch( st.time_sat, [&]() { return solver.solve( &assump, &assump + 1, ps.conflict_limit ); } );
+      profile_counter( "sat_calls" );
+      const auto result = call_with_stopwatch( st.time_sat, "sat", [&]() { return solver.solve( &assump, &assump + 1, ps.conflict_limit ); } );
       if ( result == percy::success )
       {
-        ntk.clear_mapping();
+        best.clear();
         ntk.foreach_gate( [&]( auto n ) {
           if ( solver.var_value( gate_var[n] ) )
           {
@@ -272,37 +313,49 @@ public:
             {
               if ( solver.var_value( cut_vars[n][i] ) )
               {
-                const auto index = ntk.node_to_index( n );
-                std::vector<node<Ntk>> nodes;
-                for ( auto const& l : cuts.cuts( index )[i] )
-                {
-                  nodes.push_back( ntk.index_to_node( l ) );
-                }
-                ntk.add_to_mapping( n, nodes.begin(), nodes.end() );
-
-                if constexpr ( StoreFunction )
-                {
-                  ntk.set_cell_function( n, cuts.truth_table( cuts.cuts( index )[i] ) );
-                }
+                best.emplace_back( n, i );
                 break;
               }
             }
           }
         } );
 
-        if ( ntk.num_cells() == ntk.num_pos() )
+        if ( best.size() == ntk.num_pos() )
         {
           /* no further improvement possible */
           break;
         }
 
-        best_size = ntk.num_cells();
+        best_size = best.size();
       }
       else
       {
         break;
       }
     }
+
+    return !best.empty();
+  }
+
+  /* replaces the mapping by the one found by `solve` */
+  void commit()
+  {
+    ntk.clear_mapping();
+    for ( auto const& [n, i] : best )
+    {
+      const auto index = ntk.node_to_index( n );
+      std::vector<node<Ntk>> nodes;
+      for ( auto const& l : cuts.cuts( index )[i] )
+      {
+        nodes.push_back( ntk.index_to_node( l ) );
+      }
+      ntk.add_to_mapping( n, nodes.begin(), nodes.end() );
+
+      if constexpr ( StoreFunction )
+      {
+        ntk.set_cell_function( n, cuts.truth_table( cuts.cuts( index )[i] ) );
+      }
+    }
   }
 
 private:
@@ -310,6 +363,152 @@ private:
   satlut_mapping_params const& ps;
   satlut_mapping_stats& st;
   network_cuts_t cuts;
+  std::vector<std::pair<node<Ntk>, uint32_t>> best; /* mapped gates with index of their cut */
+};
+
+template<class Ntk, bool StoreFunction, typename CutData>
+class satlut_window_batches
+{
+public:
+  using window_t = cell_window<Ntk>;
+  using window_topo_t = topo_view<window_t>;
+  using mapper_t = satlut_mapping_impl<window_topo_t, StoreFunction, CutData>;
+
+public:
+  satlut_window_batches( Ntk& ntk, uint32_t window_size, satlut_mapping_params const& ps, satlut_mapping_stats& st )
+      : ntk( ntk ),
+        window( ntk, window_size ),
+        ps( ps ),
+        st( st ),
+        claimed( ntk )
+  {
+  }
+
+  void run( progress_bar& pbar )
+  {
+    ntk.foreach_gate( [&]( auto n, int index ) {
+      pbar( index, ntk.node_to_index( n ) );
+      if ( !ntk.is_cell_root( n ) || !window.compute_window_for( n ) )
+      {
+        return true;
+      }
+
+      if ( overlaps_batch() )
+      {
+        /* the window depends on the mapping of the batch, recompute it afterwards */
+        window.forget_window();
+        solve_batch();
+        if ( !ntk.is_cell_root( n ) || !window.compute_window_for( n ) )
+        {
+          return true;
+        }
+      }
+
+      if ( ps.verbose )
+      {
+        std::cout << fmt::format( "[i] cell {:>5}   size = {:>4}   nodes = {:>2}   gates = {:>3}   pis = {:>3}   pos = {:>3}\n",
+                                  n,
+                                  window.size(),
+                                  window.num_cells(),
+                                  window.num_gates(),
+                                  window.num_pis(),
+                                  window.num_pos() );
+      }
+      if ( window.num_cells() == window.num_pos() || window.num_pos() == 0 )
+      {
+        return true;
+      }
+
+      add_to_batch();
+      if ( batch.size() == ps.batch_size )
+      {
+        solve_batch();
+      }
+      return true;
+    } );
+
+    solve_batch();
+  }
+
+private:
+  /* a window may share leaves with the windows in the batch, but its gates
+   * must not be gates or leaves of another window and vice versa */
+  bool overlaps_batch() const
+  {
+    auto overlaps = false;
+    window.foreach_gate( [&]( auto const& g ) {
+      overlaps = claimed.has( g );
+      return !overlaps;
+    } );
+    if ( !overlaps )
+    {
+      window.foreach_pi( [&]( auto const& l ) {
+        overlaps = claimed.has( l ) && claimed[l];
+        return !overlaps;
+      } );
+    }
+    return overlaps;
+  }
+
+  void add_to_batch()
+  {
+    window.foreach_gate( [&]( auto const& g ) {
+      claimed[g] = true;
+    } );
+    window.foreach_pi( [&]( auto const& l ) {
+      if ( !claimed.has( l ) )
+      {
+        claimed[l] = false;
+      }
+    } );
+
+    /* topological views change values in the network and are created here */
+    batch.emplace_back( std::make_unique<window_topo_t>( window.snapshot() ) );
+  }
+
+  void solve_batch()
+  {
+    if ( batch.empty() )
+    {
+      return;
+    }
+    ++st.num_batches;
+    st.num_windows += static_cast<uint32_t>( batch.size() );
+
+    std::vector<std::unique_ptr<mapper_t>> mappers( batch.size() );
+    std::vector<satlut_mapping_stats> window_st( batch.size() );
+    std::vector<uint8_t> found( batch.size(), 0u );
+    default_thread_pool().parallel_for(
+        0u, batch.size(), [&]( uint64_t i, uint32_t ) {
+          mappers[i] = std::make_unique<mapper_t>( *batch[i], ps, window_st[i] );
+          found[i] = mappers[i]->solve();
+        },
+        ps.num_threads );
+
+    /* update the mapping in the order of the batch */
+    for ( auto i = 0u; i < batch.size(); ++i )
+    {
+      if ( found[i] )
+      {
+        mappers[i]->commit();
+      }
+      st.time_sat += window_st[i].time_sat;
+      st.num_vars += window_st[i].num_vars;
+      st.num_clauses += window_st[i].num_clauses;
+    }
+
+    batch.clear();
+    claimed.reset();
+  }
+
+private:
+  Ntk& ntk;
+  cell_window<Ntk> window;
+  satlut_mapping_params const& ps;
+  satlut_mapping_stats& st;
+
+  std::vector<std::unique_ptr<window_topo_t>> batch;
+  unordered_node_map<bool, Ntk> claimed; /* true for gates, false for leaves of the batch */
 };
 
 } // namespace detail
@@ -427,41 +626,52 @@ void satlut_mapping( Ntk& ntk, uint32_t window_size, satlut_mapping_params ps =
 
   satlut_mapping_stats st;
   stopwatch<>::duration time_total{};
-  cell_window window( ntk, window_size );
   progress_bar pbar{ntk.size(), "satlut (windowed) |{0}| node = {1:>4} / " + std::to_string( ntk.size() ), ps.progress};
   ps.progress = false; /* do not show inner progress */
-  ntk.foreach_gate( [&]( auto n, int index ) {
+
+  if ( ps.num_threads != 1u )
+  {
     stopwatch<> t( time_total );
-    pbar( index, ntk.node_to_index( n ) );
-    if ( ntk.is_cell_root( n ) )
-    {
-      if ( !window.compute_window_for( n ) ) /* window has been visited before */
+    detail::satlut_window_batches<Ntk, StoreFunction, CutData> batches( ntk, window_size, ps, st );
+    batches.run( pbar );
+  }
+  else
+  {
+    cell_window window( ntk, window_size );
+    ntk.foreach_gate( [&]( auto n, int index ) {
+      stopwatch<> t( time_total );
+      pbar( index, ntk.node_to_index( n ) );
+      if ( ntk.is_cell_root( n ) )
       {
-        return true;
-      }
+        if ( !window.compute_window_for( n ) ) /* window has been visited before */
+        {
+          return true;
+        }
 
-      if ( ps.verbose )
-      {
-        std::cout << fmt::format( "[i] cell {:>5}   size = {:>4}   nodes = {:>2}   gates = {:>3}   pis = {:>3}   pos = {:>3}\n",
-                                  n,
-                                  window.size(),
-                                  window.num_cells(),
-                                  window.num_gates(),
-                                  window.num_pis(),
-                                  window.num_pos() );
-      }
-      if ( window.num_cells() == window.num_pos() || window.num_pos() == 0 )
-      {
+        if ( ps.verbose )
+        {
+          std::cout << fmt::format( "[i] cell {:>5}   size = {:>4}   nodes = {:>2}   gates = {:>3}   pis = {:>3}   pos = {:>3}\n",
+                                    n,
+                                    window.size(),
+                                    window.num_cells(),
+                                    window.num_gates(),
+                                    window.num_pis(),
+                                    window.num_pos() );
+        }
+        if ( window.num_cells() == window.num_pos() || window.num_pos() == 0 )
+        {
+          return true;
+        }
+        ++st.num_windows;
+        topo_view window_topo{window};
+        detail::satlut_mapping_impl<decltype(window_topo), StoreFunction, CutData> p( window_topo, ps, st );
+        p.run();
         return true;
       }
-      topo_view window_topo{window};
-      detail::satlut_mapping_impl<decltype(window_topo), StoreFunction, CutData> p( window_topo, ps, st );
-      p.run();
-      return true;
-    }
 
-    return true;
-  } );
+      return true;
+    } );
+  }
 
   st.time_total = time_total;
 
@@ -0,0 +1,510 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2019  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file sequential_simulation.hpp
+  \brief Bit-parallel multi-cycle simulation of sequential networks
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+#include <kitty/detail/mscfix.hpp>
+#include <kitty/static_truth_table.hpp>
+
+#include "../traits.hpp"
+#include "../utils/node_map.hpp"
+#include "../utils/stopwatch.hpp"
+
+namespace mockturtle
+{
+
+/*! \brief Parameters for simulate_sequential.
+ *
+ * The data structure `sequential_simulation_params` holds configurable
+ * parameters with default arguments for `simulate_sequential`.
+ */
+struct sequential_simulation_params
+{
+  /*! \brief Maximum number of cycles (fewer if the stimuli end earlier). */
+  uint32_t num_cycles{64u};
+
+  /*! \brief Number of 64-bit words per signal.
+   *
+   * The simulator simulates `64 * num_words` traces in parallel.
+   */
+  uint32_t num_words{1u};
+
+  /*! \brief Seed for the initial values of registers without reset value. */
+  uint64_t random_seed{1u};
+
+  /*! \brief Record the values of the primary outputs in each cycle. */
+  bool record_outputs{true};
+
+  /*! \brief Compute signal probabilities and switching activities. */
+  bool compute_activity{false};
+
+  /*! \brief Be verbose. */
+  bool verbose{false};
+};
+
+/*! \brief Statistics for simulate_sequential. */
+struct sequential_simulation_stats
+{
+  /*! \brief Total runtime. */
+  stopwatch<>::duration time_total{0};
+
+  /*! \brief Number of simulated cycles. */
+  uint32_t num_cycles{0u};
+
+  void report() const
+  {
+    std::cout << fmt::format( "[i] simulated cycles = {}\n", num_cycles );
+    std::cout << fmt::format( "[i] total time       = {:>5.2f} secs\n", to_seconds( time_total ) );
+  }
+};
+
+/*! \brief Result of simulate_sequential.
+ *
+ * Values of several traces are packed into words: bit `t` of word `w` is the
+ * value in trace `64 * w + t`.
+ */
+template<class Ntk>
+struct sequential_simulation_result
+{
+  explicit sequential_simulation_result( Ntk const& ntk )
+      : probability( ntk, 0.0 ),
+        switching( ntk, 0.0 )
+  {
+  }
+
+  /*! \brief Number of simulated cycles. */
+  uint32_t num_cycles{0u};
+
+  /*! \brief Output values, `outputs[cycle][po * num_words + w]`. */
+  std::vector<std::vector<uint64_t>> outputs;
+
+  /*! \brief Fraction of cycles and traces in which a node is 1. */
+  node_map<double, Ntk> probability;
+
+  /*! \brief Fraction of cycle transitions and traces in which a node toggles. */
+  node_map<double, Ntk> switching;
+};
+
+/*! \brief Random input stimuli.
+ *
+ * Assigns uniformly distributed random values to the primary inputs in each
+ * cycle.
+ */
+class random_stimuli
+{
+public:
+  explicit random_stimuli( uint64_t seed = 1u )
+      : _gen( seed )
+  {
+  }
+
+  bool operator()( uint32_t cycle, uint32_t num_words, std::vector<uint64_t>& pi_words )
+  {
+    (void)cycle;
+    (void)num_words;
+    for ( auto& w : pi_words )
+    {
+      w = _gen();
+    }
+    return true;
+  }
+
+private:
+  std::mt19937_64 _gen;
+};
+
+/*! \brief Input stimuli from a stream.
+ *
+ * Reads the stimuli cycle by cycle, such that the stream does not need to be
+ * kept in memory.  Each line contains the values of one cycle, which are
+ * given as one hexadecimal number per primary input, separated by
+ * whitespace.  Bit `t` of the number is the value of the input in trace `t`,
+ * i.e., for a single trace the numbers are `0` and `1`.  Empty lines and
+ * lines starting with `#` are ignored.  The stimuli end with the stream.
+ */
+class stimuli_reader
+{
+public:
+  explicit stimuli_reader( std::istream& in )
+      : _in( in )
+  {
+  }
+
+  bool operator()( uint32_t cycle, uint32_t num_words, std::vector<uint64_t>& pi_words )
+  {
+    std::string line;
+    while ( std::getline( _in, line ) )
+    {
+      if ( line.empty() || line[0] == '#' || line.find_first_not_of( " \t\r" ) == std::string::npos )
+      {
+        continue;
+      }
+
+      std::fill( pi_words.begin(), pi_words.end(), UINT64_C( 0 ) );
+      std::istringstream tokens( line );
+      std::string token;
+      auto pi = 0u;
+      while ( tokens >> token )
+      {
+        if ( ( pi + 1u ) * num_words > pi_words.size() )
+        {
+          std::cerr << fmt::format( "[e] cycle {}: more values than primary inputs\n", cycle );
+          return false;
+        }
+        if ( !parse( token, num_words, pi_words.data() + pi * num_words ) )
+        {
+          std::cerr << fmt::format( "[e] cycle {}: invalid value '{}'\n", cycle, token );
+          return false;
+        }
+        ++pi;
+      }
+      if ( pi * num_words != pi_words.size() )
+      {
+        std::cerr << fmt::format( "[e] cycle {}: expected {} values, got {}\n", cycle, pi_words.size() / num_words, pi );
+        return false;
+      }
+      return true;
+    }
+    return false;
+  }
+
+private:
+  static bool parse( std::string const& token, uint32_t num_words, uint64_t* words )
+  {
+    if ( token.size() > 16u * num_words )
+    {
+      return false;
+    }
+    for ( auto k = 0u; k < token.size(); ++k )
+    {
+      auto const c = token[token.size() - 1u - k];
+      uint64_t digit;
+      if ( c >= '0' && c <= '9' )
+      {
+        digit = c - '0';
+      }
+      else if ( c >= 'a' && c <= 'f' )
+      {
+        digit = c - 'a' + 10;
+      }
+      else if ( c >= 'A' && c <= 'F' )
+      {
+        digit = c - 'A' + 10;
+      }
+      else
+      {
+        return false;
+      }
+      words[k >> 4u] |= digit << ( 4u * ( k & 15u ) );
+    }
+    return true;
+  }
+
+  std::istream& _in;
+};
+
+/*! \brief Bit-parallel cycle-based simulator.
+ *
+ * The values of all nodes are stored in one flat buffer with `num_words`
+ * consecutive words per node.  Registers are initialized with their reset
+ * values; registers without a defined reset value (see `latch_reset`) get a
+ * random value per trace.
+ *
+ * **Required network functions:**
+ * - `size`
+ * - `node_to_index`
+ * - `get_node`
+ * - `get_constant`
+ * - `constant_value`
+ * - `foreach_pi`
+ * - `foreach_po`
+ * - `foreach_ro`
+ * - `foreach_ri`
+ * - `foreach_gate`
+ * - `foreach_fanin`
+ * - `fanin_size`
+ * - `is_complemented`
+ * - `latch_reset`
+ * - `compute` for `kitty::static_truth_table<6u>`
+ */
+template<class Ntk>
+class sequential_simulator
+{
+public:
+  using node = typename Ntk::node;
+  using signal = typename Ntk::signal;
+
+  sequential_simulator( Ntk const& ntk, uint32_t num_words = 1u, uint64_t random_seed = 1u )
+      : _ntk( ntk ),
+        _num_words( num_words ),
+        _values( static_cast<std::size_t>( ntk.size() ) * num_words ),
+        _gen( random_seed )
+  {
+    static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
+    static_assert( has_size_v<Ntk>, "Ntk does not implement the size method" );
+    static_assert( has_node_to_index_v<Ntk>, "Ntk does not implement the node_to_index method" );
+    static_assert( has_get_node_v<Ntk>, "Ntk does not implement the get_node method" );
+    static_assert( has_get_constant_v<Ntk>, "Ntk does not implement the get_constant method" );
+    static_assert( has_constant_value_v<Ntk>, "Ntk does not implement the constant_value method" );
+    static_assert( has_foreach_pi_v<Ntk>, "Ntk does not implement the foreach_pi method" );
+    static_assert( has_foreach_po_v<Ntk>, "Ntk does not implement the foreach_po method" );
+    static_assert( has_foreach_ro_v<Ntk>, "Ntk does not implement the foreach_ro method" );
+    static_assert( has_foreach_ri_v<Ntk>, "Ntk does not implement the foreach_ri method" );
+    static_assert( has_foreach_gate_v<Ntk>, "Ntk does not implement the foreach_gate method" );
+    static_assert( has_foreach_fanin_v<Ntk>, "Ntk does not implement the foreach_fanin method" );
+    static_assert( has_fanin_size_v<Ntk>, "Ntk does not implement the fanin_size method" );
+    static_assert( has_is_complemented_v<Ntk>, "Ntk does not implement the is_complemented method" );
+    static_assert( has_compute_v<Ntk, kitty::static_truth_table<6u>>, "Ntk does not implement the compute method for static truth tables" );
+
+    _ntk.foreach_ro( [&]( auto const& ) { ++_num_registers; } );
+    _state.resize( static_cast<std::size_t>( _num_registers ) * num_words );
+
+    for ( auto c : {false, true} )
+    {
+      auto const n = _ntk.get_node( _ntk.get_constant( c ) );
+      std::fill_n( words( n ), num_words, _ntk.constant_value( n ) ? ~UINT64_C( 0 ) : UINT64_C( 0 ) );
+    }
+
+    reset();
+  }
+
+  /*! \brief Returns the number of words per signal. */
+  uint32_t num_words() const
+  {
+    return _num_words;
+  }
+
+  /*! \brief Sets all registers to their reset values. */
+  void reset()
+  {
+    for ( auto i = 0u; i < _num_registers; ++i )
+    {
+      auto const r = _ntk.latch_reset( i );
+      for ( auto w = 0u; w < _num_words; ++w )
+      {
+        _state[i * _num_words + w] = r == 0 ? UINT64_C( 0 ) : ( r == 1 ? ~UINT64_C( 0 ) : _gen() );
+      }
+    }
+  }
+
+  /*! \brief Simulates one cycle.
+   *
+   * Computes all node values for the given input values (`num_words` words
+   * per primary input) and the current register values, and then updates
+   * the registers.
+   */
+  void step( std::vector<uint64_t> const& pi_words )
+  {
+    _ntk.foreach_pi( [&]( auto const& n, auto i ) {
+      std::copy_n( pi_words.begin() + i * _num_words, _num_words, words( n ) );
+    } );
+    _ntk.foreach_ro( [&]( auto const& n, auto i ) {
+      std::copy_n( _state.begin() + i * _num_words, _num_words, words( n ) );
+    } );
+
+    _ntk.foreach_gate( [&]( auto const& n ) {
+      _fanins.resize( _ntk.fanin_size( n ) );
+      _fanin_words.resize( _fanins.size() );
+      _ntk.foreach_fanin( n, [&]( auto const& f, auto i ) {
+        _fanin_words[i] = words( _ntk.get_node( f ) );
+      } );
+
+      auto* result = words( n );
+      for ( auto w = 0u; w < _num_words; ++w )
+      {
+        for ( auto i = 0u; i < _fanins.size(); ++i )
+        {
+          _fanins[i]._bits = _fanin_words[i][w];
+        }
+        result[w] = _ntk.compute( n, _fanins.begin(), _fanins.end() )._bits;
+      }
+    } );
+
+    _ntk.foreach_ri( [&]( auto const& f, auto i ) {
+      signal_words( f, _state.data() + i * _num_words );
+    } );
+  }
+
+  /*! \brief Values of a node in the last simulated cycle (`num_words` words). */
+  uint64_t const* values( node const& n ) const
+  {
+    return _values.data() + static_cast<std::size_t>( _ntk.node_to_index( n ) ) * _num_words;
+  }
+
+  /*! \brief Writes the values of the primary outputs in the last cycle. */
+  void output_values( std::vector<uint64_t>& po_words ) const
+  {
+    po_words.resize( static_cast<std::size_t>( _ntk.num_pos() ) * _num_words );
+    _ntk.foreach_po( [&]( auto const& f, auto i ) {
+      signal_words( f, po_words.data() + i * _num_words );
+    } );
+  }
+
+private:
+  uint64_t* words( node const& n )
+  {
+    return _values.data() + static_cast<std::size_t>( _ntk.node_to_index( n ) ) * _num_words;
+  }
+
+  void signal_words( signal const& f, uint64_t* out ) const
+  {
+    auto const* in = values( _ntk.get_node( f ) );
+    auto const mask = _ntk.is_complemented( f ) ? ~UINT64_C( 0 ) : UINT64_C( 0 );
+    for ( auto w = 0u; w < _num_words; ++w )
+    {
+      out[w] = in[w] ^ mask;
+    }
+  }
+
+private:
+  Ntk const& _ntk;
+  uint32_t _num_words;
+  uint32_t _num_registers{0u};
+  std::vector<uint64_t> _values;
+  std::vector<uint64_t> _state;
+  std::mt19937_64 _gen;
+
+  std::vector<kitty::static_truth_table<6u>> _fanins;
+  std::vector<uint64_t const*> _fanin_words;
+};
+
+/*! \brief Multi-cycle simulation of a sequential network.
+ *
+ * Simulates `64 * ps.num_words` traces in parallel for at most
+ * `ps.num_cycles` cycles, starting from the reset values of the registers.
+ * The input values of each cycle are provided by `stimuli`, which is called
+ * as `stimuli( cycle, num_words, pi_words )` and must write `num_words`
+ * words per primary input into `pi_words`; it returns `false` if there are
+ * no more stimuli.  Use `random_stimuli` for random simulation and
+ * `stimuli_reader` to read stimuli from a file.
+ *
+ * The result contains the output values of each cycle (if
+ * `ps.record_outputs` is true), and the signal probability and switching
+ * activity of each node (if `ps.compute_activity` is true).
+ *
+ * **Required network functions:**
+ * See `sequential_simulator`.
+ *
+ * \param ntk Network
+ * \param stimuli Input stimuli
+ * \param ps Parameters
+ * \param pst Statistics
+ */
+template<class Ntk, class Stimuli = random_stimuli>
+sequential_simulation_result<Ntk> simulate_sequential( Ntk const& ntk, Stimuli&& stimuli = Stimuli(), sequential_simulation_params const& ps = {}, sequential_simulation_stats* pst = nullptr )
+{
+  sequential_simulation_stats st;
+  sequential_simulation_result<Ntk> result( ntk );
+
+  {
+    stopwatch t( st.time_total );
+
+    sequential_simulator<Ntk> sim( ntk, ps.num_words, ps.random_seed );
+    std::vector<uint64_t> pi_words( static_cast<std::size_t>( ntk.num_pis() ) * ps.num_words );
+
+    /* number of 1s and toggles per node */
+    std::vector<uint64_t> ones, toggles, previous;
+    if ( ps.compute_activity )
+    {
+      ones.resize( ntk.size() );
+      toggles.resize( ntk.size() );
+      previous.resize( static_cast<std::size_t>( ntk.size() ) * ps.num_words );
+    }
+
+    for ( auto cycle = 0u; cycle < ps.num_cycles; ++cycle )
+    {
+      if ( !stimuli( cycle, ps.num_words, pi_words ) )
+      {
+        break;
+      }
+      sim.step( pi_words );
+      ++result.num_cycles;
+
+      if ( ps.record_outputs )
+      {
+        sim.output_values( result.outputs.emplace_back() );
+      }
+
+      if ( ps.compute_activity )
+      {
+        auto const popcount = []( uint64_t word ) {
+          return uint32_t( __builtin_popcount( static_cast<uint32_t>( word & 0xffffffff ) ) ) + uint32_t( __builtin_popcount( static_cast<uint32_t>( word >> 32 ) ) );
+        };
+        ntk.foreach_node( [&]( auto const& n ) {
+          auto const index = ntk.node_to_index( n );
+          auto const* cur = sim.values( n );
+          auto* prev = previous.data() + static_cast<std::size_t>( index ) * ps.num_words;
+          for ( auto w = 0u; w < ps.num_words; ++w )
+          {
+            ones[index] += popcount( cur[w] );
+            if ( cycle > 0u )
+            {
+              toggles[index] += popcount( cur[w] ^ prev[w] );
+            }
+            prev[w] = cur[w];
+          }
+        } );
+      }
+    }
+
+    if ( ps.compute_activity && result.num_cycles > 0u )
+    {
+      auto const traces = 64.0 * ps.num_words;
+      ntk.foreach_node( [&]( auto const& n ) {
+        auto const index = ntk.node_to_index( n );
+        result.probability[n] = ones[index] / ( traces * result.num_cycles );
+        result.switching[n] = result.num_cycles > 1u ? toggles[index] / ( traces * ( result.num_cycles - 1u ) ) : 0.0;
+      } );
+    }
+  }
+  st.num_cycles = result.num_cycles;
+
+  if ( ps.verbose )
+  {
+    st.report();
+  }
+  if ( pst )
+  {
+    *pst = st;
+  }
+
+  return result;
+}
+
+} // namespace mockturtle
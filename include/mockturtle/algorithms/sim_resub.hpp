@@ -36,6 +36,7 @@
 #include <algorithm>
 
 #include "../utils/abc_resub.hpp"
+#include "../utils/allocators.hpp"
 #include "../utils/progress_bar.hpp"
 #include "../utils/stopwatch.hpp"
 #include "../utils/abc_resub.hpp"
@@ -133,8 +134,9 @@ public:
   {
     using signal = typename Ntk::signal;
 
-    std::vector<std::pair<signal, uint32_t>> positive_divisors;
-    std::vector<std::pair<signal, uint32_t>> negative_divisors;
+    /* the functor is created for each root, recycle the memory of the previous one */
+    std::vector<std::pair<signal, uint32_t>, pool_allocator<std::pair<signal, uint32_t>>> positive_divisors;
+    std::vector<std::pair<signal, uint32_t>, pool_allocator<std::pair<signal, uint32_t>>> negative_divisors;
 
     void clear()
     {
@@ -718,6 +720,9 @@ struct sim_resub_stats
   /*! \brief Number of SAT solver timeout. */
   uint32_t num_timeout{0};
 
+  /*! \brief Statistics of the circuit validator. */
+  validator_stats validator_st;
+
   ResubFnSt functor_st;
 
   void report() const
@@ -729,6 +734,7 @@ struct sim_resub_stats
     std::cout << fmt::format( "[i]     #resub   = {:6d}\n", num_resub );
     std::cout << fmt::format( "[i]     #CEX     = {:6d}\n", num_cex );
     std::cout << fmt::format( "[i]     #timeout = {:6d}\n", num_timeout );
+    std::cout << fmt::format( "[i]     CNF reuse = {:>5.2f}% ({} restarts)\n", validator_st.hit_rate() * 100.0, validator_st.num_restarts );
     std::cout <<              "[i]     ======== Runtime ========\n";
     std::cout << fmt::format( "[i]     generate pattern: {:>5.2f} secs\n", to_seconds( time_patgen ) );
     std::cout << fmt::format( "[i]     simulation:       {:>5.2f} secs\n", to_seconds( time_sim ) );
@@ -821,6 +827,7 @@ public:
 
   ~simulation_based_resub_engine()
   {
+    st.validator_st += validator.stats();
     if ( ps.save_patterns )
     {
       write_patterns( sim, *ps.save_patterns );
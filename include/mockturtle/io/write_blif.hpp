@@ -33,6 +33,8 @@
 #pragma once
 
 #include "../traits.hpp"
+#include "../networks/storage.hpp"
+#include "../utils/output_buffer.hpp"
 #include "../views/topo_view.hpp"
 
 #include <kitty/constructors.hpp>
@@ -45,6 +47,7 @@
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <vector>
 
 namespace mockturtle
 {
@@ -52,12 +55,24 @@ namespace mockturtle
   struct write_blif_params
   {
     uint32_t skip_feedthrough = 0u;
+
+    /*! \brief Number of bytes collected before writing to the stream. */
+    uint64_t buffer_size{1u << 20u};
+
+    /*! \brief Number of threads to format nodes (0 uses the default number of threads). */
+    uint32_t num_threads{1u};
   };
 
 /*! \brief Writes network in BLIF format into output stream
  *
  * An overloaded variant exists that writes the network into a file.
  *
+ * The output is collected in a buffer of `ps.buffer_size` bytes before it
+ * is written to the stream.  If `ps.num_threads` is different from 1, the
+ * covers of the nodes are computed and formatted in contiguous chunks of the
+ * topological order by several threads and concatenated afterwards; the
+ * output does not depend on the number of threads.
+ *
  * **Required network functions:**
  * - `fanin_size`
  * - `foreach_fanin`
@@ -73,6 +88,7 @@ namespace mockturtle
  *
  * \param ntk Network
  * \param os Output stream
+ * \param ps Parameters
  */
 template<class Ntk>
 void write_blif( Ntk const& ntk, std::ostream& os, write_blif_params const& ps = {} )
@@ -91,14 +107,15 @@ void write_blif( Ntk const& ntk, std::ostream& os, write_blif_params const& ps =
   static_assert( has_node_function_v<Ntk>, "Ntk does not implement the node_function method" );
 
   topo_view topo_ntk{ntk};
+  output_buffer buf( os, ps.buffer_size );
 
   /* write model */
-  os << ".model top\n";
+  buf.put( ".model top\n" );
 
   /* write inputs */
   if ( topo_ntk.num_pis() > 0u )
   {
-    os << ".inputs ";
+    buf.put( ".inputs " );
     topo_ntk.foreach_ci( [&]( auto const& n, auto index ) 
     {
       if ( ( ( index + 1 ) <= topo_ntk.num_cis() - topo_ntk.num_latches() ) ) 
@@ -106,22 +123,32 @@ void write_blif( Ntk const& ntk, std::ostream& os, write_blif_params const& ps =
         if constexpr ( has_has_name_v<Ntk> && has_get_name_v<Ntk> )
         {
           signal<Ntk> const s = topo_ntk.make_signal( topo_ntk.node_to_index( n ) );
-          std::string const name = topo_ntk.has_name( s ) ? topo_ntk.get_name( s ) : fmt::format( "pi{}", topo_ntk.get_node( s ) );
-          os << name << ' ';
+          if ( topo_ntk.has_name( s ) )
+          {
+            buf.put( topo_ntk.get_name( s ) );
+          }
+          else
+          {
+            buf.put( "pi" );
+            buf.put_uint( topo_ntk.node_to_index( topo_ntk.get_node( s ) ) );
+          }
+          buf.put( ' ' );
         }
         else
         {
-          os << fmt::format( "pi{} ", topo_ntk.node_to_index( n ) );
+          buf.put( "pi" );
+          buf.put_uint( topo_ntk.node_to_index( n ) );
+          buf.put( ' ' );
         }
       }
     } );
-    os << "\n";
+    buf.put( '\n' );
   }
 
   /* write outputs */
   if ( topo_ntk.num_pos() > 0u )
   {
-    os << ".outputs ";
+    buf.put( ".outputs " );
     topo_ntk.foreach_co( [&]( auto const& f, auto index ) 
     {
       (void)f;
@@ -129,16 +156,26 @@ void write_blif( Ntk const& ntk, std::ostream& os, write_blif_params const& ps =
       {
         if constexpr ( has_has_output_name_v<Ntk> && has_get_output_name_v<Ntk> )
         {
-          std::string const output_name = topo_ntk.has_output_name( index ) ? topo_ntk.get_output_name( index ) : fmt::format( "po{}", index );
-          os << output_name << ' ';
+          if ( topo_ntk.has_output_name( index ) )
+          {
+            buf.put( topo_ntk.get_output_name( index ) );
+          }
+          else
+          {
+            buf.put( "po" );
+            buf.put_uint( index );
+          }
+          buf.put( ' ' );
         }
         else
         {
-          os << fmt::format( "po{} ", index );
+          buf.put( "po" );
+          buf.put_uint( index );
+          buf.put( ' ' );
         }
       }
     } );
-    os << "\n";
+    buf.put( '\n' );
   }
 
   if ( topo_ntk.num_latches() > 0u )
@@ -148,18 +185,18 @@ void write_blif( Ntk const& ntk, std::ostream& os, write_blif_params const& ps =
     {
       if( index >= topo_ntk.num_cos() - topo_ntk.num_latches() ) 
       {
-        os << ".latch ";
+        buf.put( ".latch " );
         auto const ro_sig = topo_ntk.make_signal( topo_ntk.ri_to_ro( f ) );
         mockturtle::latch_info l_info = topo_ntk._storage->latch_information[topo_ntk.get_node(ro_sig)];
         if constexpr ( has_has_name_v<Ntk> && has_get_name_v<Ntk> )
         {
           std::string const ri_name = topo_ntk.has_output_name( index ) ? topo_ntk.get_output_name( index ) : fmt::format( "new_n{}", topo_ntk.get_node( f ) );
           std::string const ro_name = topo_ntk.has_name( ro_sig ) ? topo_ntk.get_name( ro_sig ) : fmt::format( "new_n{}", topo_ntk.get_node( ro_sig ) );
-          os << fmt::format( "{} {} {} {} {}\n", ri_name, ro_name, l_info.type, l_info.control, l_info.init);
+          buf.put( fmt::format( "{} {} {} {} {}\n", ri_name, ro_name, l_info.type, l_info.control, l_info.init) );
         }
         else
         {
-          os << fmt::format( "li{} new_n{} {} {} {}\n", latch_idx, topo_ntk.get_node( ro_sig ), l_info.type, l_info.control, l_info.init );
+          buf.put( fmt::format( "li{} new_n{} {} {} {}\n", latch_idx, topo_ntk.get_node( ro_sig ), l_info.type, l_info.control, l_info.init ) );
           latch_idx++;
         }
       }
@@ -167,43 +204,47 @@ void write_blif( Ntk const& ntk, std::ostream& os, write_blif_params const& ps =
   }
 
   /* write constants */
-  os << ".names new_n0\n";
-  os << "0\n";
+  buf.put( ".names new_n0\n" );
+  buf.put( "0\n" );
 
   if ( topo_ntk.get_constant( false ) != topo_ntk.get_constant( true ) ) 
   {
-    os << ".names new_n1\n";
-    os << "1\n";
+    buf.put( ".names new_n1\n" );
+    buf.put( "1\n" );
   }
 
-  /* write nodes */
-  topo_ntk.foreach_node( [&]( auto const& n ) 
-  {
+  /* name of a node that is not a PI */
+  auto const put_node_name = [&]( output_buffer& out, node<Ntk> const& n ) {
+    if constexpr ( has_has_name_v<Ntk> && has_get_name_v<Ntk> )
+    {
+      auto const s = topo_ntk.make_signal( n );
+      if ( topo_ntk.has_name( s ) )
+      {
+        out.put( topo_ntk.get_name( s ) );
+        return;
+      }
+    }
+    out.put( "new_n" );
+    out.put_uint( topo_ntk.node_to_index( n ) );
+  };
 
+  /* write a node, the cover is computed only once */
+  auto const put_node = [&]( output_buffer& out, node<Ntk> const& n ) {
     if ( topo_ntk.is_constant( n ) || topo_ntk.is_ci( n ) )
       return; /* continue */
 
     /* write truth table of node */
-    auto func = topo_ntk.node_function( n );
+    auto const cubes = isop( topo_ntk.node_function( n ) );
 
-    if(isop( func ).size() == 0) 
+    if ( cubes.size() == 0 )
     {
-      if constexpr ( has_has_name_v<Ntk> && has_get_name_v<Ntk> )
-      {
-        auto const s = topo_ntk.make_signal( n );
-        std::string const name = topo_ntk.has_name( s ) ? topo_ntk.get_name( s ) : fmt::format( "new_n{}", topo_ntk.get_node( s ) );
-        os << fmt::format( ".names {}\n", name );
-        os << "0" << '\n';
-      }
-      else
-      {
-        os << fmt::format( ".names new_n{}\n", n );
-        os << "0" << '\n';
-      }
+      out.put( ".names " );
+      put_node_name( out, n );
+      out.put( "\n0\n" );
       return;
     }
 
-    os << fmt::format( ".names " );
+    out.put( ".names " );
 
     /* write fanins of node */
     topo_ntk.foreach_fanin( n, [&]( auto const& f ) 
@@ -212,31 +253,24 @@ void write_blif( Ntk const& ntk, std::ostream& os, write_blif_params const& ps =
       if constexpr ( has_has_name_v<Ntk> && has_get_name_v<Ntk> )
       {
         signal<Ntk> const s = topo_ntk.make_signal( f_node );
-        std::string const name = topo_ntk.has_name( s ) ? topo_ntk.get_name( s ) : topo_ntk.is_pi( f_node ) ? fmt::format( "pi{} ", f_node ) : fmt::format( "new_n{} ", f_node );
-        os << name << ' ';
-      }
-      else
-      {
-        std::string const name = topo_ntk.is_pi( f_node ) ? fmt::format( "pi{} ", f_node ) : fmt::format( "new_n{} ", f_node );
-        os << name;
+        if ( topo_ntk.has_name( s ) )
+        {
+          out.put( topo_ntk.get_name( s ) );
+          out.put( ' ' );
+          return;
+        }
       }
+      out.put( topo_ntk.is_pi( f_node ) ? "pi" : "new_n" );
+      out.put_uint( topo_ntk.node_to_index( f_node ) );
+      out.put( ' ' );
     });
 
     /* write fanout of node */
-    if constexpr ( has_has_name_v<Ntk> && has_get_name_v<Ntk> )
-    {
-      auto const s = topo_ntk.make_signal( n );
-      std::string const name = topo_ntk.has_name( s ) ? topo_ntk.get_name( s ) : fmt::format( "new_n{}", topo_ntk.get_node( s ) );
-      os << name << '\n';
-    }
-    else
-    {
-      os << fmt::format( "new_n{}\n", n );
-    }
-
+    put_node_name( out, n );
+    out.put( '\n' );
 
-    int count = 0;
-    for ( auto cube : isop( func ) )
+    auto const num_fanins = topo_ntk.fanin_size( n );
+    for ( auto cube : cubes )
     {
       topo_ntk.foreach_fanin( n, [&]( auto const& f, auto index ) 
       {
@@ -244,11 +278,30 @@ void write_blif( Ntk const& ntk, std::ostream& os, write_blif_params const& ps =
           cube.flip_bit( index );
       });
 
-      cube.print( topo_ntk.fanin_size( n ), os );
-      os << " 1\n";
-      count++;
+      for ( auto i = 0u; i < num_fanins; ++i )
+      {
+        out.put( cube.get_mask( i ) ? ( cube.get_bit( i ) ? '1' : '0' ) : '-' );
+      }
+      out.put( " 1\n" );
     }
-  } );
+  };
+
+  /* write nodes */
+  if ( ps.num_threads == 1u )
+  {
+    topo_ntk.foreach_node( [&]( auto const& n ) {
+      put_node( buf, n );
+    } );
+  }
+  else
+  {
+    std::vector<node<Ntk>> nodes;
+    nodes.reserve( topo_ntk.size() );
+    topo_ntk.foreach_node( [&]( auto const& n ) {
+      nodes.emplace_back( n );
+    } );
+    put_in_chunks( buf, nodes, ps.num_threads, put_node );
+  }
 
   auto latch_idx = 0;
   topo_ntk.foreach_co( [&]( auto const& f, auto index )
@@ -261,28 +314,37 @@ void write_blif( Ntk const& ntk, std::ostream& os, write_blif_params const& ps =
       std::string const node_name = topo_ntk.has_name( s ) ? topo_ntk.get_name( s ) : fmt::format( "new_n{}", topo_ntk.get_node( s ) );
       std::string const output_name = topo_ntk.has_output_name( index ) ? topo_ntk.get_output_name( index ) : fmt::format( "po{}", index );
       if(!ps.skip_feedthrough || ( node_name != output_name ) )
-        os << fmt::format( ".names {} {}\n{} 1\n", node_name, output_name, minterm_string, index );
+        buf.put( fmt::format( ".names {} {}\n{} 1\n", node_name, output_name, minterm_string ) );
     }
     else
     {
       if( index >= topo_ntk.num_cos() - topo_ntk.num_latches() ) 
       {
         if(!ps.skip_feedthrough || ( topo_ntk.get_node( f ) != index)){
-          os << fmt::format( ".names new_n{} li{}\n{} 1\n", f_node, latch_idx, minterm_string );
+          buf.put( fmt::format( ".names new_n{} li{}\n{} 1\n", f_node, latch_idx, minterm_string ) );
           latch_idx++;
         }
       }
       else
       {
-        std::string const node_name = topo_ntk.is_pi( f_node ) ? fmt::format( "pi{}", f_node ) : fmt::format( "new_n{}", f_node );
         if(!ps.skip_feedthrough ||  ( topo_ntk.get_node( f ) != index ) )
-          os << fmt::format( ".names {} po{}\n{} 1\n", node_name, index, minterm_string );
+        {
+          buf.put( ".names " );
+          buf.put( topo_ntk.is_pi( f_node ) ? "pi" : "new_n" );
+          buf.put_uint( topo_ntk.node_to_index( f_node ) );
+          buf.put( " po" );
+          buf.put_uint( index );
+          buf.put( '\n' );
+          buf.put( minterm_string );
+          buf.put( " 1\n" );
+        }
       }
       
     }
   } );
 
-  os << ".end\n";
+  buf.put( ".end\n" );
+  buf.flush();
   os << std::flush;
 }
 
@@ -36,13 +36,13 @@
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <vector>
 
-#include <lorina/verilog.hpp>
 #include <fmt/format.h>
 
 #include "../traits.hpp"
 #include "../utils/node_map.hpp"
-#include "../utils/string_utils.hpp"
+#include "../utils/output_buffer.hpp"
 #include "../views/topo_view.hpp"
 
 namespace mockturtle
@@ -50,215 +50,292 @@ namespace mockturtle
 
 using namespace std::string_literals;
 
-namespace detail
-{
-
-template<class Ntk>
-std::vector<std::pair<bool, std::string>>
-format_fanin( Ntk const& ntk, node<Ntk> const& n, node_map<std::string, Ntk>& node_names )
-{
-  std::vector<std::pair<bool, std::string>> children;
-  ntk.foreach_fanin( n, [&]( auto const& f ) {
-      children.emplace_back( std::make_pair( ntk.is_complemented( f ), node_names[f] ) );
-    });
-  return children;
-}
-
-} // namespace detail
-
 struct write_verilog_params
 {
   std::string module_name = "top";
   std::vector<std::pair<std::string, uint32_t>> input_names;
   std::vector<std::pair<std::string, uint32_t>> output_names;
+
+  /*! \brief Number of bytes collected before writing to the stream. */
+  uint64_t buffer_size{1u << 20u};
+
+  /*! \brief Number of threads to format gates (0 uses the default number of threads). */
+  uint32_t num_threads{1u};
 };
 
-/*! \brief Writes network in structural Verilog format into output stream
- *
- * An overloaded variant exists that writes the network into a file.
- *
- * **Required network functions:**
- * - `num_pis`
- * - `num_pos`
- * - `foreach_pi`
- * - `foreach_node`
- * - `foreach_fanin`
- * - `get_node`
- * - `get_constant`
- * - `is_constant`
- * - `is_pi`
- * - `is_and`
- * - `is_or`
- * - `is_xor`
- * - `is_xor3`
- * - `is_maj`
- * - `node_to_index`
- *
- * \param ntk Network
- * \param os Output stream
- */
-template<class Ntk>
-void write_verilog( Ntk const& ntk, std::ostream& os, write_verilog_params const& ps = {} )
+namespace detail
 {
-  static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
-  static_assert( has_num_pis_v<Ntk>, "Ntk does not implement the num_pis method" );
-  static_assert( has_num_pos_v<Ntk>, "Ntk does not implement the num_pos method" );
-  static_assert( has_foreach_pi_v<Ntk>, "Ntk does not implement the foreach_pi method" );
-  static_assert( has_foreach_node_v<Ntk>, "Ntk does not implement the foreach_node method" );
-  static_assert( has_foreach_fanin_v<Ntk>, "Ntk does not implement the foreach_fanin method" );
-  static_assert( has_get_node_v<Ntk>, "Ntk does not implement the get_node method" );
-  static_assert( has_get_constant_v<Ntk>, "Ntk does not implement the get_constant method" );
-  static_assert( has_is_constant_v<Ntk>, "Ntk does not implement the is_constant method" );
-  static_assert( has_is_pi_v<Ntk>, "Ntk does not implement the is_pi method" );
-  static_assert( has_is_and_v<Ntk>, "Ntk does not implement the is_and method" );
-  static_assert( has_is_or_v<Ntk>, "Ntk does not implement the is_or method" );
-  static_assert( has_is_xor_v<Ntk>, "Ntk does not implement the is_xor method" );
-  static_assert( has_is_xor3_v<Ntk>, "Ntk does not implement the is_xor3 method" );
-  static_assert( has_is_maj_v<Ntk>, "Ntk does not implement the is_maj method" );
-  static_assert( has_node_to_index_v<Ntk>, "Ntk does not implement the node_to_index method" );
-
-  assert( ntk.is_combinational() && "Network has to be combinational" );
 
-  std::vector<std::string> xs, inputs;
-  if ( ps.input_names.empty() )
+template<class Ntk>
+class verilog_writer_impl
+{
+public:
+  verilog_writer_impl( Ntk const& ntk, std::ostream& os, write_verilog_params const& ps )
+      : ntk( ntk ),
+        ps( ps ),
+        buf( os, ps.buffer_size ),
+        pi_pos( ntk )
   {
-    for ( auto i = 0u; i < ntk.num_pis(); ++i )
-      xs.emplace_back( fmt::format( "x{}", i ) );
-    inputs = xs;
   }
-  else
+
+  void run()
   {
-    uint32_t ctr{0u};
-    for ( auto const& [name, width] : ps.input_names )
+    compute_io_names();
+
+    auto const& module_inputs = ps.input_names.empty() ? xs : inputs;
+    auto const& module_outputs = ps.output_names.empty() ? ys : outputs;
+    buf.put( "module " );
+    buf.put( ps.module_name );
+    buf.put( "( " );
+    put_list( module_inputs );
+    if ( !module_inputs.empty() && !module_outputs.empty() )
+    {
+      buf.put( " , " );
+    }
+    put_list( module_outputs );
+    buf.put( " );\n" );
+
+    if ( ps.input_names.empty() )
     {
-      inputs.emplace_back( name );
-      ctr += width;
-      for ( auto i = 0u; i < width; ++i )
+      buf.put( "  input " );
+      put_list( xs );
+      buf.put( " ;\n" );
+    }
+    else
+    {
+      for ( auto const& [name, width] : ps.input_names )
       {
-        xs.emplace_back( fmt::format( "{}[{}]", name, i ) );
+        put_register( "input", name, width );
       }
     }
-    if ( ctr != ntk.num_pis() )
+    if ( ps.output_names.empty() )
     {
-      std::cerr << "[e] input names do not partition all inputs\n";
+      buf.put( "  output " );
+      put_list( ys );
+      buf.put( " ;\n" );
+    }
+    else
+    {
+      for ( auto const& [name, width] : ps.output_names )
+      {
+        put_register( "output", name, width );
+      }
     }
-  }
 
-  std::vector<std::string> ys, outputs;
-  if ( ps.output_names.empty() )
-  {
-    for ( auto i = 0u; i < ntk.num_pos(); ++i )
-      ys.emplace_back( fmt::format( "y{}", i ) );
-    outputs = ys;
+    bool has_wires{false};
+    ntk.foreach_gate( [&]( auto const& n ) {
+      buf.put( has_wires ? " , " : "  wire " );
+      has_wires = true;
+      put_gate_name( buf, n );
+    } );
+    if ( has_wires )
+    {
+      buf.put( " ;\n" );
+    }
+
+    topo_view ntk_topo{ntk};
+    if ( ps.num_threads == 1u )
+    {
+      ntk_topo.foreach_node( [&]( auto const& n ) {
+        put_node( buf, n );
+      } );
+    }
+    else
+    {
+      std::vector<node<Ntk>> nodes;
+      nodes.reserve( ntk_topo.size() );
+      ntk_topo.foreach_node( [&]( auto const& n ) {
+        nodes.emplace_back( n );
+      } );
+      put_in_chunks( buf, nodes, ps.num_threads, [&]( output_buffer& chunk, node<Ntk> const& n ) {
+        put_node( chunk, n );
+      } );
+    }
+
+    ntk.foreach_po( [&]( auto const& f, auto i ) {
+      buf.put( "  assign " );
+      buf.put( ys[i] );
+      buf.put( " = " );
+      put_signal( buf, f );
+      buf.put( " ;\n" );
+    } );
+
+    buf.put( "endmodule\n" );
+    buf.flush();
   }
-  else
+
+private:
+  void compute_io_names()
   {
-    uint32_t ctr{0u};
-    for ( auto const& [name, width] : ps.output_names )
+    if ( ps.input_names.empty() )
+    {
+      for ( auto i = 0u; i < ntk.num_pis(); ++i )
+        xs.emplace_back( fmt::format( "x{}", i ) );
+    }
+    else
+    {
+      uint32_t ctr{0u};
+      for ( auto const& [name, width] : ps.input_names )
+      {
+        inputs.emplace_back( name );
+        ctr += width;
+        for ( auto i = 0u; i < width; ++i )
+        {
+          xs.emplace_back( fmt::format( "{}[{}]", name, i ) );
+        }
+      }
+      if ( ctr != ntk.num_pis() )
+      {
+        std::cerr << "[e] input names do not partition all inputs\n";
+      }
+    }
+
+    if ( ps.output_names.empty() )
+    {
+      for ( auto i = 0u; i < ntk.num_pos(); ++i )
+        ys.emplace_back( fmt::format( "y{}", i ) );
+    }
+    else
     {
-      outputs.emplace_back( name );
-      ctr += width;
-      for ( auto i = 0u; i < width; ++i )
+      uint32_t ctr{0u};
+      for ( auto const& [name, width] : ps.output_names )
+      {
+        outputs.emplace_back( name );
+        ctr += width;
+        for ( auto i = 0u; i < width; ++i )
+        {
+          ys.emplace_back( fmt::format( "{}[{}]", name, i ) );
+        }
+      }
+      if ( ctr != ntk.num_pos() )
       {
-        ys.emplace_back( fmt::format( "{}[{}]", name, i ) );
+        std::cerr << "[e] output names do not partition all outputs\n";
       }
     }
-    if ( ctr != ntk.num_pos() )
+
+    ntk.foreach_pi( [&]( auto const& n, auto i ) {
+      pi_pos[n] = i;
+    } );
+  }
+
+  void put_list( std::vector<std::string> const& names )
+  {
+    for ( auto i = 0u; i < names.size(); ++i )
     {
-      std::cerr << "[e] output names do not partition all outputs\n";
+      if ( i != 0u )
+      {
+        buf.put( " , " );
+      }
+      buf.put( names[i] );
     }
   }
 
-  std::vector<std::string> ws;
-  ntk.foreach_gate( [&]( auto const& n ) {
-    ws.emplace_back( fmt::format( "n{}", ntk.node_to_index( n ) ) );
-  } );
+  void put_register( char const* kind, std::string const& name, uint32_t width )
+  {
+    buf.put( "  " );
+    buf.put( kind );
+    buf.put( " [" );
+    buf.put_uint( width - 1 );
+    buf.put( ":0] " );
+    buf.put( name );
+    buf.put( " ;\n" );
+  }
 
-  lorina::verilog_writer writer( os );
-  writer.on_module_begin( ps.module_name, inputs, outputs );
-  if ( ps.input_names.empty() )
+  void put_gate_name( output_buffer& out, node<Ntk> const& n ) const
   {
-    writer.on_input( xs );
+    out.put( 'n' );
+    out.put_uint( ntk.node_to_index( n ) );
   }
-  else
+
+  void put_name( output_buffer& out, node<Ntk> const& n ) const
   {
-    for ( auto const& [name, width] : ps.input_names )
+    if ( ntk.is_constant( n ) )
     {
-      writer.on_input( width, name );
+      out.put( n == ntk.get_node( ntk.get_constant( false ) ) ? "1'b0" : "1'b1" );
+    }
+    else if ( ntk.is_pi( n ) )
+    {
+      out.put( xs[pi_pos[n]] );
+    }
+    else
+    {
+      put_gate_name( out, n );
     }
   }
-  if ( ps.output_names.empty() )
-  {
-    writer.on_output( ys );
-  }
-  else
+
+  void put_signal( output_buffer& out, signal<Ntk> const& f ) const
   {
-    for ( auto const& [name, width] : ps.output_names )
+    if ( ntk.is_complemented( f ) )
     {
-      writer.on_output( width, name );
+      out.put( '~' );
     }
+    put_name( out, ntk.get_node( f ) );
   }
-  if ( !ws.empty() )
+
+  void put_assign( output_buffer& out, node<Ntk> const& n, char const* op ) const
   {
-    writer.on_wire( ws );
+    out.put( "  assign " );
+    put_gate_name( out, n );
+    out.put( " = " );
+    ntk.foreach_fanin( n, [&]( auto const& f, auto i ) {
+      if ( i != 0u )
+      {
+        out.put( op );
+      }
+      put_signal( out, f );
+    } );
+    out.put( " ;\n" );
   }
 
-  node_map<std::string, Ntk> node_names( ntk );
-  node_names[ntk.get_constant( false )] = "1'b0";
-  if ( ntk.get_node( ntk.get_constant( false ) ) != ntk.get_node( ntk.get_constant( true ) ) )
-    node_names[ntk.get_constant( true )] = "1'b1";
-
-  ntk.foreach_pi( [&]( auto const& n, auto i ) {
-    node_names[n] = xs[i];
-  } );
-
-  topo_view ntk_topo{ntk};
-
-  ntk_topo.foreach_node( [&]( auto const& n ) {
+  void put_node( output_buffer& out, node<Ntk> const& n ) const
+  {
     if ( ntk.is_constant( n ) || ntk.is_pi( n ) )
-      return true;
-
-    /* assign a name */
-    node_names[n] = fmt::format( "n{}", ntk.node_to_index( n ) );
+      return;
 
     if ( ntk.is_and( n ) )
     {
-      writer.on_assign( node_names[n], detail::format_fanin<Ntk>( ntk, n, node_names ), "&" );
+      put_assign( out, n, " & " );
     }
     else if ( ntk.is_or( n ) )
     {
-      writer.on_assign( node_names[n], detail::format_fanin<Ntk>( ntk, n, node_names ), "|" );
+      put_assign( out, n, " | " );
     }
     else if ( ntk.is_xor( n ) || ntk.is_xor3( n ) )
     {
-      writer.on_assign( node_names[n], detail::format_fanin<Ntk>( ntk, n, node_names ), "^" );
+      put_assign( out, n, " ^ " );
     }
     else if ( ntk.is_maj( n ) )
     {
       std::array<signal<Ntk>, 3> children;
       ntk.foreach_fanin( n, [&]( auto const& f, auto i ) { children[i] = f; } );
 
+      out.put( "  assign " );
+      put_gate_name( out, n );
       if ( ntk.is_constant( ntk.get_node( children[0u] ) ) )
       {
-        std::vector<std::pair<bool, std::string>> vs;
-        vs.emplace_back( std::make_pair( ntk.is_complemented( children[1u] ), node_names[ntk.get_node( children[1u] )] ) );
-        vs.emplace_back( std::make_pair( ntk.is_complemented( children[2u] ), node_names[ntk.get_node( children[2u] )] ) );
-
-        if ( ntk.is_complemented( children[0u] ) )
-        {
-          // or
-          writer.on_assign( node_names[n], {vs[0u], vs[1u]}, "|" );
-        }
-        else
-        {
-          // and
-          writer.on_assign( node_names[n], {vs[0u], vs[1u]}, "&" );
-        }
+        out.put( " = " );
+        put_signal( out, children[1u] );
+        /* or, if constant is complemented, and otherwise */
+        out.put( ntk.is_complemented( children[0u] ) ? " | " : " & " );
+        put_signal( out, children[2u] );
       }
       else
       {
-        writer.on_assign_maj3( node_names[n], detail::format_fanin<Ntk>( ntk, n, node_names ) );
+        out.put( " = ( " );
+        put_signal( out, children[0u] );
+        out.put( " & " );
+        put_signal( out, children[1u] );
+        out.put( " ) | ( " );
+        put_signal( out, children[0u] );
+        out.put( " & " );
+        put_signal( out, children[2u] );
+        out.put( " ) | ( " );
+        put_signal( out, children[1u] );
+        out.put( " & " );
+        put_signal( out, children[2u] );
+        out.put( " )" );
       }
+      out.put( " ;\n" );
     }
     else
     {
@@ -266,37 +343,99 @@ void write_verilog( Ntk const& ntk, std::ostream& os, write_verilog_params const
       {
         if ( ntk.is_nary_and( n ) )
         {
-          writer.on_assign( node_names[n], detail::format_fanin<Ntk>( ntk, n, node_names ), "&" );
-          return true;
+          put_assign( out, n, " & " );
+          return;
         }
       }
       if constexpr ( has_is_nary_or_v<Ntk> )
       {
         if ( ntk.is_nary_or( n ) )
         {
-          writer.on_assign( node_names[n], detail::format_fanin<Ntk>( ntk, n, node_names ), "|" );
-          return true;
+          put_assign( out, n, " | " );
+          return;
         }
       }
       if constexpr ( has_is_nary_xor_v<Ntk> )
       {
         if ( ntk.is_nary_xor( n ) )
         {
-          writer.on_assign( node_names[n], detail::format_fanin<Ntk>( ntk, n, node_names ), "^" );
-          return true;
+          put_assign( out, n, " ^ " );
+          return;
         }
       }
-      writer.on_assign_unknown_gate( node_names[n] );
+      out.put( "  assign " );
+      put_gate_name( out, n );
+      out.put( " = unknown gate;\n" );
     }
+  }
+
+private:
+  Ntk const& ntk;
+  write_verilog_params const& ps;
+
+  output_buffer buf;
+  std::vector<std::string> xs, inputs, ys, outputs;
+  node_map<uint32_t, Ntk> pi_pos;
+};
+
+} // namespace detail
 
-    return true;
-  } );
+/*! \brief Writes network in structural Verilog format into output stream
+ *
+ * An overloaded variant exists that writes the network into a file.
+ *
+ * Node names are generated on the fly from node indexes and the output is
+ * collected in a buffer of `ps.buffer_size` bytes before it is written to
+ * the stream.  If `ps.num_threads` is different from 1, the gate
+ * assignments are formatted in contiguous chunks of the topological order
+ * by several threads and concatenated afterwards; the output does not
+ * depend on the number of threads.
+ *
+ * **Required network functions:**
+ * - `num_pis`
+ * - `num_pos`
+ * - `foreach_pi`
+ * - `foreach_node`
+ * - `foreach_fanin`
+ * - `get_node`
+ * - `get_constant`
+ * - `is_constant`
+ * - `is_pi`
+ * - `is_and`
+ * - `is_or`
+ * - `is_xor`
+ * - `is_xor3`
+ * - `is_maj`
+ * - `node_to_index`
+ *
+ * \param ntk Network
+ * \param os Output stream
+ * \param ps Parameters
+ */
+template<class Ntk>
+void write_verilog( Ntk const& ntk, std::ostream& os, write_verilog_params const& ps = {} )
+{
+  static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
+  static_assert( has_num_pis_v<Ntk>, "Ntk does not implement the num_pis method" );
+  static_assert( has_num_pos_v<Ntk>, "Ntk does not implement the num_pos method" );
+  static_assert( has_foreach_pi_v<Ntk>, "Ntk does not implement the foreach_pi method" );
+  static_assert( has_foreach_node_v<Ntk>, "Ntk does not implement the foreach_node method" );
+  static_assert( has_foreach_fanin_v<Ntk>, "Ntk does not implement the foreach_fanin method" );
+  static_assert( has_get_node_v<Ntk>, "Ntk does not implement the get_node method" );
+  static_assert( has_get_constant_v<Ntk>, "Ntk does not implement the get_constant method" );
+  static_assert( has_is_constant_v<Ntk>, "Ntk does not implement the is_constant method" );
+  static_assert( has_is_pi_v<Ntk>, "Ntk does not implement the is_pi method" );
+  static_assert( has_is_and_v<Ntk>, "Ntk does not implement the is_and method" );
+  static_assert( has_is_or_v<Ntk>, "Ntk does not implement the is_or method" );
+  static_assert( has_is_xor_v<Ntk>, "Ntk does not implement the is_xor method" );
+  static_assert( has_is_xor3_v<Ntk>, "Ntk does not implement the is_xor3 method" );
+  static_assert( has_is_maj_v<Ntk>, "Ntk does not implement the is_maj method" );
+  static_assert( has_node_to_index_v<Ntk>, "Ntk does not implement the node_to_index method" );
 
-  ntk.foreach_po( [&]( auto const& f, auto i ) {
-    writer.on_assign_po( ys[i], std::make_pair( ntk.is_complemented( f ), node_names[f] ) );
-  } );
+  assert( ntk.is_combinational() && "Network has to be combinational" );
 
-  writer.on_module_end();
+  detail::verilog_writer_impl<Ntk> p( ntk, os, ps );
+  p.run();
 }
 
 /*! \brief Writes network in structural Verilog format into a file
@@ -46,6 +46,7 @@
 #include "../traits.hpp"
 #include "../utils/algorithm.hpp"
 #include "../utils/include/spp.hpp"
+#include "../utils/memory.hpp"
 #include "detail/foreach.hpp"
 
 namespace mockturtle
@@ -105,6 +106,16 @@ struct abstract_xag_storage
 
   uint32_t trav_id = 0u;
   uint32_t depth = 0u;
+
+  uint64_t memory_usage() const
+  {
+    uint64_t bytes = sizeof( *this ) + heap_memory_usage( nodes ) + heap_memory_usage( children ) + heap_memory_usage( inputs ) + heap_memory_usage( outputs ) + heap_memory_usage( hash );
+    for ( auto const& n : nodes )
+    {
+      bytes += n.fanin_size * sizeof( uint32_t );
+    }
+    return bytes;
+  }
 };
 
 class abstract_xag_network
@@ -839,6 +850,14 @@ public:
   }
 #pragma endregion
 
+#pragma region General methods
+  /*! \brief Memory used by the storage of the network (in bytes). */
+  uint64_t memory_usage() const
+  {
+    return _storage->memory_usage();
+  }
+#pragma endregion
+
 public:
   storage _storage;
 };
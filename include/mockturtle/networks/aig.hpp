@@ -72,8 +72,15 @@ struct aig_storage_data
   uint32_t num_pos = 0u;
   std::vector<int8_t> latches;
   uint32_t trav_id = 0u;
+
+  uint64_t memory_usage() const
+  {
+    return sizeof( *this ) + heap_memory_usage( latches );
+  }
 };
 
+using aig_node = regular_node<2, 2, 1>;
+
 /*! \brief AIG storage container
 
   AIGs have nodes with fan-in 2.  We split of one bit of the index pointer to
@@ -83,100 +90,128 @@ struct aig_storage_data
   `data[0].h1`: Fan-out size (we use MSB to indicate whether a node is dead)
   `data[0].h2`: Application-specific value
   `data[1].h1`: Visited flag
+
+  The node vector, the inputs, and the outputs are allocated with
+  `Allocator`, see `storage`.
 */
-using aig_storage = storage<regular_node<2, 2, 1>,
-                            aig_storage_data,
-                            aig_hash<regular_node<2, 2, 1>>>;
+template<class Allocator = std::allocator<aig_node>>
+using basic_aig_storage = storage<aig_node,
+                                  aig_storage_data,
+                                  aig_hash<aig_node>,
+                                  Allocator>;
+
+using aig_storage = basic_aig_storage<>;
+
+/*! \brief AIG signal
 
-class aig_network
+  The signal type does not depend on the allocator of the storage, such that
+  signals can be passed between AIGs with different allocators.
+*/
+struct aig_signal
 {
-public:
-#pragma region Types and constructors
-  static constexpr auto min_fanin_size = 2u;
-  static constexpr auto max_fanin_size = 2u;
+  aig_signal() = default;
 
-  using base_type = aig_network;
-  using storage = std::shared_ptr<aig_storage>;
-  using node = uint64_t;
+  aig_signal( uint64_t index, uint64_t complement )
+      : complement( complement ), index( index )
+  {
+  }
 
-  struct signal
+  explicit aig_signal( uint64_t data )
+      : data( data )
   {
-    signal() = default;
+  }
 
-    signal( uint64_t index, uint64_t complement )
-        : complement( complement ), index( index )
-    {
-    }
+  aig_signal( aig_node::pointer_type const& p )
+      : complement( p.weight ), index( p.index )
+  {
+  }
 
-    explicit signal( uint64_t data )
-        : data( data )
+  union {
+    struct
     {
-    }
+      uint64_t complement : 1;
+      uint64_t index : 63;
+    };
+    uint64_t data;
+  };
 
-    signal( aig_storage::node_type::pointer_type const& p )
-        : complement( p.weight ), index( p.index )
-    {
-    }
+  aig_signal operator!() const
+  {
+    return aig_signal( data ^ 1 );
+  }
 
-    union {
-      struct
-      {
-        uint64_t complement : 1;
-        uint64_t index : 63;
-      };
-      uint64_t data;
-    };
+  aig_signal operator+() const
+  {
+    return {index, 0};
+  }
 
-    signal operator!() const
-    {
-      return signal( data ^ 1 );
-    }
+  aig_signal operator-() const
+  {
+    return {index, 1};
+  }
 
-    signal operator+() const
-    {
-      return {index, 0};
-    }
+  aig_signal operator^( bool complement ) const
+  {
+    return aig_signal( data ^ ( complement ? 1 : 0 ) );
+  }
 
-    signal operator-() const
-    {
-      return {index, 1};
-    }
+  bool operator==( aig_signal const& other ) const
+  {
+    return data == other.data;
+  }
 
-    signal operator^( bool complement ) const
-    {
-      return signal( data ^ ( complement ? 1 : 0 ) );
-    }
+  bool operator!=( aig_signal const& other ) const
+  {
+    return data != other.data;
+  }
 
-    bool operator==( signal const& other ) const
-    {
-      return data == other.data;
-    }
+  bool operator<( aig_signal const& other ) const
+  {
+    return data < other.data;
+  }
 
-    bool operator!=( signal const& other ) const
-    {
-      return data != other.data;
-    }
+  operator aig_node::pointer_type() const
+  {
+    return {index, complement};
+  }
+};
 
-    bool operator<( signal const& other ) const
-    {
-      return data < other.data;
-    }
+/*! \brief AIG network with a custom storage allocator
 
-    operator aig_storage::node_type::pointer_type() const
-    {
-      return {index, complement};
-    }
-  };
+  `aig_network` is the instance with `std::allocator`.  Other allocators, e.g.,
+  an `arena_allocator` for AIGs that only live as long as a window, are passed
+  to the constructor.
+*/
+template<class Allocator = std::allocator<aig_node>>
+class basic_aig_network
+{
+public:
+#pragma region Types and constructors
+  static constexpr auto min_fanin_size = 2u;
+  static constexpr auto max_fanin_size = 2u;
+
+  using base_type = basic_aig_network;
+  using storage = std::shared_ptr<basic_aig_storage<Allocator>>;
+  using allocator_type = Allocator;
+  using node = uint64_t;
+
+  using signal = aig_signal;
+
+  basic_aig_network()
+      : _storage( std::make_shared<basic_aig_storage<Allocator>>() ),
+        _events( std::make_shared<network_events<base_type>>() )
+  {
+  }
 
-  aig_network()
-      : _storage( std::make_shared<aig_storage>() ),
-        _events( std::make_shared<decltype( _events )::element_type>() )
+  explicit basic_aig_network( Allocator const& alloc )
+      : _storage( std::make_shared<basic_aig_storage<Allocator>>( alloc ) ),
+        _events( std::make_shared<network_events<base_type>>() )
   {
   }
 
-  aig_network( std::shared_ptr<aig_storage> storage )
+  basic_aig_network( std::shared_ptr<basic_aig_storage<Allocator>> storage )
       : _storage( storage ),
-        _events( std::make_shared<decltype( _events )::element_type>() )
+        _events( std::make_shared<network_events<base_type>>() )
   {
   }
 #pragma endregion
@@ -305,7 +340,7 @@ public:
       return a.complement ? b : get_constant( false );
     }
 
-    storage::element_type::node_type node;
+    aig_node node;
     node.children[0] = a;
     node.children[1] = b;
 
@@ -340,6 +375,42 @@ public:
     return {index, 0};
   }
 
+  /*! \brief Looks up an AND gate without creating it.
+   *
+   * Returns the signal that `create_and( a, b )` would return if this does not
+   * require to create a new node, and `std::nullopt` otherwise.
+   */
+  std::optional<signal> has_and( signal a, signal b ) const
+  {
+    /* order inputs */
+    if ( a.index > b.index )
+    {
+      std::swap( a, b );
+    }
+
+    /* trivial cases */
+    if ( a.index == b.index )
+    {
+      return ( a.complement == b.complement ) ? a : get_constant( false );
+    }
+    else if ( a.index == 0 )
+    {
+      return a.complement ? b : get_constant( false );
+    }
+
+    aig_node node;
+    node.children[0] = a;
+    node.children[1] = b;
+
+    /* structural hashing */
+    const auto it = _storage->hash.find( node );
+    if ( it != _storage->hash.end() )
+    {
+      return signal( it->second, 0 );
+    }
+    return std::nullopt;
+  }
+
   signal create_nand( signal const& a, signal const& b )
   {
     return !create_and( a, b );
@@ -427,7 +498,7 @@ public:
 #pragma endregion
 
 #pragma region Create arbitrary functions
-  signal clone_node( aig_network const& other, node const& source, std::vector<signal> const& children )
+  signal clone_node( basic_aig_network const& other, node const& source, std::vector<signal> const& children )
   {
     (void)other;
     (void)source;
@@ -478,7 +549,7 @@ public:
     }
 
     // node already in hash table
-    storage::element_type::node_type _hash_obj;
+    aig_node _hash_obj;
     _hash_obj.children[0] = child0;
     _hash_obj.children[1] = child1;
     if ( const auto it = _storage->hash.find( _hash_obj ); it != _storage->hash.end() )
@@ -1109,22 +1180,30 @@ public:
   {
     return *_events;
   }
+
+  /*! \brief Memory used by the storage of the network (in bytes). */
+  uint64_t memory_usage() const
+  {
+    return _storage->memory_usage();
+  }
 #pragma endregion
 
 public:
-  std::shared_ptr<aig_storage> _storage;
+  std::shared_ptr<basic_aig_storage<Allocator>> _storage;
   std::shared_ptr<network_events<base_type>> _events;
 };
 
+using aig_network = basic_aig_network<>;
+
 } // namespace mockturtle
 
 namespace std
 {
 
 template<>
-struct hash<mockturtle::aig_network::signal>
+struct hash<mockturtle::aig_signal>
 {
-  uint64_t operator()( mockturtle::aig_network::signal const &s ) const noexcept
+  uint64_t operator()( mockturtle::aig_signal const &s ) const noexcept
   {
     uint64_t k = s.data;
     k ^= k >> 33;
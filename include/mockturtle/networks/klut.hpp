@@ -55,6 +55,11 @@ struct klut_storage_data
   uint32_t num_pos = 0u;
   std::vector<int8_t> latches;
   uint32_t trav_id = 0u;
+
+  uint64_t memory_usage() const
+  {
+    return sizeof( *this ) + heap_memory_usage( cache ) + heap_memory_usage( latches );
+  }
 };
 
 /*! \brief k-LUT node
@@ -867,6 +872,12 @@ signal create_maj( signal a, signal b, signal c )
   {
     return *_events;
   }
+
+  /*! \brief Memory used by the storage of the network (in bytes). */
+  uint64_t memory_usage() const
+  {
+    return _storage->memory_usage();
+  }
 #pragma endregion
 
 public:
@@ -35,10 +35,12 @@
 
 #include <array>
 #include <iostream>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
 #include "../utils/include/spp.hpp"
+#include "../utils/memory.hpp"
 
 namespace mockturtle
 {
@@ -128,6 +130,10 @@ struct mixed_fanin_node
   {
     return children == other.children;
   }
+  uint64_t memory_usage() const
+  {
+    return sizeof( *this ) + heap_memory_usage( children );
+  }
 };
 
 /*! \brief Hash function for 64-bit word */
@@ -181,16 +187,42 @@ struct latch_info
   std::string control = "";
   uint64_t init = 3;
   std::string type = "";
+
+  uint64_t memory_usage() const
+  {
+    return sizeof( *this ) + heap_memory_usage( control ) + heap_memory_usage( type );
+  }
 };
 
 struct empty_storage_data
 {
 };
 
-template<typename Node, typename T = empty_storage_data, typename NodeHasher = node_hash<Node>>
+/*! \brief Storage container of a network
+ *
+ * The node vector, the inputs, and the outputs are allocated with
+ * `Allocator` (rebound to the respective element type), e.g., with an
+ * `arena_allocator` for networks whose lifetime is bounded by a window.  The
+ * structural hash table uses the allocator of *sparsepp*, which requires
+ * reallocation support.
+ */
+template<typename Node, typename T = empty_storage_data, typename NodeHasher = node_hash<Node>, typename Allocator = std::allocator<Node>>
 struct storage
 {
+  template<typename U>
+  using rebind_alloc = typename std::allocator_traits<Allocator>::template rebind_alloc<U>;
+
+  using allocator_type = Allocator;
+
   storage()
+      : storage( Allocator() )
+  {
+  }
+
+  explicit storage( Allocator const& alloc )
+      : nodes( alloc ),
+        inputs( alloc ),
+        outputs( alloc )
   {
     nodes.reserve( 10000u );
     hash.reserve( 10000u );
@@ -202,14 +234,26 @@ struct storage
 
   using node_type = Node;
 
-  std::vector<node_type> nodes;
-  std::vector<uint64_t> inputs;
-  std::vector<typename node_type::pointer_type> outputs;
+  std::vector<node_type, Allocator> nodes;
+  std::vector<uint64_t, rebind_alloc<uint64_t>> inputs;
+  std::vector<typename node_type::pointer_type, rebind_alloc<typename node_type::pointer_type>> outputs;
   std::unordered_map<uint64_t, latch_info> latch_information;
 
   spp::sparse_hash_map<node_type, uint64_t, NodeHasher> hash;
 
   T data;
+
+  /*! \brief Memory used by the storage (in bytes).
+   *
+   * Includes the node vector, inputs, outputs, latch information, the
+   * structural hash table, and the additional data.  Memory reserved but not
+   * used by the containers is included as well.
+   */
+  uint64_t memory_usage() const
+  {
+    return sizeof( *this ) + heap_memory_usage( nodes ) + heap_memory_usage( inputs ) + heap_memory_usage( outputs ) +
+           heap_memory_usage( latch_information ) + heap_memory_usage( hash ) + heap_memory_usage( data );
+  }
 };
 
 } /* namespace mockturtle */
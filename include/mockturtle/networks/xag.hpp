@@ -70,6 +70,11 @@ struct xag_storage_data
   uint32_t num_pos = 0u;
   std::vector<int8_t> latches;
   uint32_t trav_id = 0;
+
+  uint64_t memory_usage() const
+  {
+    return sizeof( *this ) + heap_memory_usage( latches );
+  }
 };
 
 /*! \brief XAG storage container
@@ -321,6 +326,20 @@ public:
     return {index, 0};
   }
 
+  std::optional<signal> _find_node( signal a, signal b ) const
+  {
+    storage::element_type::node_type node;
+    node.children[0] = a;
+    node.children[1] = b;
+
+    const auto it = _storage->hash.find( node );
+    if ( it != _storage->hash.end() )
+    {
+      return signal( it->second, 0 );
+    }
+    return std::nullopt;
+  }
+
   signal create_and( signal a, signal b )
   {
     /* order inputs a < b it is a AND */
@@ -339,6 +358,29 @@ public:
     return _create_node( a, b );
   }
 
+  /*! \brief Looks up an AND gate without creating it.
+   *
+   * Returns the signal that `create_and( a, b )` would return if this does not
+   * require to create a new node, and `std::nullopt` otherwise.
+   */
+  std::optional<signal> has_and( signal a, signal b ) const
+  {
+    /* order inputs a < b it is a AND */
+    if ( a.index > b.index )
+    {
+      std::swap( a, b );
+    }
+    if ( a.index == b.index )
+    {
+      return a.complement == b.complement ? a : get_constant( false );
+    }
+    else if ( a.index == 0 )
+    {
+      return a.complement == false ? get_constant( false ) : b;
+    }
+    return _find_node( a, b );
+  }
+
   signal create_nand( signal const& a, signal const& b )
   {
     return !create_and( a, b );
@@ -387,6 +429,38 @@ public:
     return _create_node( a, b ) ^ f_compl;
   }
 
+  /*! \brief Looks up an XOR gate without creating it.
+   *
+   * Returns the signal that `create_xor( a, b )` would return if this does not
+   * require to create a new node, and `std::nullopt` otherwise.
+   */
+  std::optional<signal> has_xor( signal a, signal b ) const
+  {
+    /* order inputs a > b it is a XOR */
+    if ( a.index < b.index )
+    {
+      std::swap( a, b );
+    }
+
+    bool f_compl = a.complement != b.complement;
+    a.complement = b.complement = false;
+
+    if ( a.index == b.index )
+    {
+      return get_constant( f_compl );
+    }
+    else if ( b.index == 0 )
+    {
+      return a ^ f_compl;
+    }
+
+    if ( const auto f = _find_node( a, b ) )
+    {
+      return *f ^ f_compl;
+    }
+    return std::nullopt;
+  }
+
   signal create_xnor( signal const& a, signal const& b )
   {
     return !create_xor( a, b );
@@ -1176,6 +1250,12 @@ public:
   {
     return *_events;
   }
+
+  /*! \brief Memory used by the storage of the network (in bytes). */
+  uint64_t memory_usage() const
+  {
+    return _storage->memory_usage();
+  }
 #pragma endregion
 
 public:
@@ -55,6 +55,11 @@ struct xmg_storage_data
   uint32_t num_pos = 0u;
   std::vector<int8_t> latches;
   uint32_t trav_id = 0u;
+
+  uint64_t memory_usage() const
+  {
+    return sizeof( *this ) + heap_memory_usage( latches );
+  }
 };
 
 /*! \brief XMG storage container
@@ -1264,6 +1269,12 @@ public:
   {
     return *_events;
   }
+
+  /*! \brief Memory used by the storage of the network (in bytes). */
+  uint64_t memory_usage() const
+  {
+    return _storage->memory_usage();
+  }
 #pragma endregion
 
 public:
@@ -0,0 +1,511 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2019  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file switching_activity.hpp
+  \brief Signal probabilities, switching activity, and power cost
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <kitty/detail/mscfix.hpp>
+#include <kitty/operations.hpp>
+#include <kitty/partial_truth_table.hpp>
+
+#include "../algorithms/cut_enumeration.hpp"
+#include "../algorithms/simulation.hpp"
+#include "../traits.hpp"
+#include "../utils/node_map.hpp"
+
+namespace mockturtle
+{
+
+/*! \brief Parameters for switching_activity.
+ *
+ * The data structure `switching_activity_params` holds configurable
+ * parameters with default arguments for `switching_activity`.
+ */
+struct switching_activity_params
+{
+  /*! \brief Estimation method.
+   *
+   * `simulation` simulates random patterns and interprets consecutive
+   * patterns as consecutive clock cycles.  `propagation` computes
+   * probabilities from the functions of cuts, assuming that the leaves of a
+   * cut are independent, which is exact for cuts without reconvergence
+   * outside of the cut.
+   */
+  enum
+  {
+    simulation,
+    propagation
+  } method = simulation;
+
+  /*! \brief Number of random patterns (simulation). */
+  uint32_t num_patterns{4096u};
+
+  /*! \brief Seed for random patterns (simulation). */
+  uint32_t random_seed{1u};
+
+  /*! \brief Maximum cut size (propagation). */
+  uint32_t cut_size{6u};
+
+  /*! \brief Maximum number of cuts per node (propagation). */
+  uint32_t cut_limit{8u};
+
+  /*! \brief Probability of primary inputs to be 1 (propagation). */
+  double input_probability{0.5};
+};
+
+/*! \brief Signal statistics computed by switching_activity. */
+template<class Ntk>
+struct switching_activity_result
+{
+  explicit switching_activity_result( Ntk const& ntk )
+      : probability( ntk, 0.0 ),
+        switching( ntk, 0.0 )
+  {
+  }
+
+  /*! \brief Probability that a node is 1. */
+  node_map<double, Ntk> probability;
+
+  /*! \brief Probability that a node changes its value between two cycles. */
+  node_map<double, Ntk> switching;
+};
+
+namespace detail
+{
+
+/* probability of a function to be 1 for independent inputs */
+template<class TT, class Probability>
+double function_probability( TT const& tt, Probability&& input_probability )
+{
+  double p{0.0};
+  for ( uint64_t m = 0u; m < tt.num_bits(); ++m )
+  {
+    if ( !kitty::get_bit( tt, m ) )
+    {
+      continue;
+    }
+    double q{1.0};
+    for ( auto i = 0u; i < static_cast<uint32_t>( tt.num_vars() ); ++i )
+    {
+      auto const pi = input_probability( i );
+      q *= ( ( m >> i ) & 1u ) ? pi : 1.0 - pi;
+    }
+    p += q;
+  }
+  return p;
+}
+
+} // namespace detail
+
+/*! \brief Computes signal probabilities and switching activities.
+ *
+ * Computes for each node the probability to be 1 and the switching activity,
+ * i.e., the probability that the value changes between two clock cycles.
+ *
+ * With the `simulation` method, `ps.num_patterns` random patterns are
+ * simulated bit-parallel with `partial_simulator`; the switching activity is
+ * the fraction of consecutive patterns in which a node toggles.  With the
+ * `propagation` method, the probability of each node is computed from the
+ * function of its largest cut (preferring leaves close to the inputs) and the
+ * probabilities of the cut leaves, and
+ * the switching activity is `2p(1 - p)` assuming that the inputs of
+ * consecutive cycles are independent.
+ *
+ * **Required network functions:**
+ * - `foreach_node`
+ * - `foreach_pi`
+ * - `is_constant`
+ * - `is_ci`
+ * - `constant_value`
+ * - `node_to_index`
+ * - `compute` for `kitty::partial_truth_table` (simulation)
+ * - `foreach_fanin` (propagation)
+ * - `node_function` (propagation)
+ *
+ * \param ntk Network
+ * \param ps Parameters
+ */
+template<class Ntk>
+switching_activity_result<Ntk> switching_activity( Ntk const& ntk, switching_activity_params const& ps = {} )
+{
+  static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
+  static_assert( has_foreach_node_v<Ntk>, "Ntk does not implement the foreach_node method" );
+  static_assert( has_foreach_pi_v<Ntk>, "Ntk does not implement the foreach_pi method" );
+  static_assert( has_is_constant_v<Ntk>, "Ntk does not implement the is_constant method" );
+  static_assert( has_is_ci_v<Ntk>, "Ntk does not implement the is_ci method" );
+  static_assert( has_constant_value_v<Ntk>, "Ntk does not implement the constant_value method" );
+  static_assert( has_node_to_index_v<Ntk>, "Ntk does not implement the node_to_index method" );
+
+  switching_activity_result<Ntk> result( ntk );
+
+  if ( ps.method == switching_activity_params::simulation )
+  {
+    partial_simulator const sim( std::max( 1u, ntk.num_pis() ), ps.num_patterns, ps.random_seed );
+    auto const values = simulate_nodes<kitty::partial_truth_table>( ntk, sim );
+
+    auto const num_bits = ps.num_patterns;
+    auto const popcount = []( uint64_t word ) {
+      return uint32_t( __builtin_popcount( static_cast<uint32_t>( word & 0xffffffff ) ) ) + uint32_t( __builtin_popcount( static_cast<uint32_t>( word >> 32 ) ) );
+    };
+    ntk.foreach_node( [&]( auto const& n ) {
+      auto const& tt = values[n];
+      uint64_t toggles{0u};
+      for ( auto w = 0u; w < tt.num_blocks(); ++w )
+      {
+        /* bit j of the xor is set if patterns j and j + 1 differ */
+        auto const word = tt._bits[w];
+        if ( w + 1u < tt.num_blocks() )
+        {
+          toggles += popcount( word ^ ( ( word >> 1u ) | ( tt._bits[w + 1u] << 63u ) ) );
+        }
+        else
+        {
+          auto const valid = num_bits - 64u * w;
+          toggles += popcount( ( word ^ ( word >> 1u ) ) & ( ( UINT64_C( 1 ) << ( valid - 1u ) ) - 1u ) );
+        }
+      }
+      result.probability[n] = static_cast<double>( kitty::count_ones( tt ) ) / num_bits;
+      result.switching[n] = num_bits > 1u ? static_cast<double>( toggles ) / ( num_bits - 1u ) : 0.0;
+    } );
+  }
+  else
+  {
+    cut_enumeration_params cps;
+    cps.cut_size = ps.cut_size;
+    cps.cut_limit = ps.cut_limit;
+    auto const cuts = cut_enumeration<Ntk, true>( ntk, cps );
+
+    ntk.foreach_node( [&]( auto const& n ) {
+      double p;
+      if ( ntk.is_constant( n ) )
+      {
+        p = ntk.constant_value( n ) ? 1.0 : 0.0;
+      }
+      else if ( ntk.is_ci( n ) )
+      {
+        p = ps.input_probability;
+      }
+      else
+      {
+        /* fanins as independent inputs, which also is the probability that
+         * the trivial cut evaluates to */
+        std::vector<double> leaves;
+        ntk.foreach_fanin( n, [&]( auto const& f ) {
+          auto const q = result.probability[ntk.get_node( f )];
+          leaves.push_back( ntk.is_complemented( f ) ? 1.0 - q : q );
+        } );
+        result.probability[n] = detail::function_probability( ntk.node_function( n ), [&]( auto i ) { return leaves[i]; } );
+
+        /* largest cut, and among those the one closest to the inputs */
+        auto const& set = cuts.cuts( ntk.node_to_index( n ) );
+        auto const* best = &set[0];
+        auto const leaf_sum = []( auto const& cut ) { return std::accumulate( cut.begin(), cut.end(), uint64_t{0} ); };
+        for ( auto const* cut : set )
+        {
+          if ( cut->size() > best->size() || ( cut->size() == best->size() && leaf_sum( *cut ) < leaf_sum( *best ) ) )
+          {
+            best = cut;
+          }
+        }
+        leaves.clear();
+        for ( auto l : *best )
+        {
+          leaves.push_back( result.probability[ntk.index_to_node( l )] );
+        }
+        p = detail::function_probability( cuts.truth_table( *best ), [&]( auto i ) { return leaves[i]; } );
+      }
+      result.probability[n] = p;
+      result.switching[n] = 2.0 * p * ( 1.0 - p );
+    } );
+  }
+
+  return result;
+}
+
+/*! \brief Power cost function.
+ *
+ * A node cost function (see `cut_rewriting`, `refactoring`, and
+ * `lut_mapping`) that returns the switching activity of a node, scaled by
+ * `scale` and rounded to an integer.  The cost is at least 1, such that
+ * every gate contributes to the size of a network.
+ *
+ * The cost function is bound to one network, the one it is constructed from
+ * or created for with `bind`, or otherwise the first network it is evaluated
+ * on.  Views and copies of that network share its storage and are identified
+ * with it.  The activities of its nodes are computed with
+ * `switching_activity`; the probabilities of nodes that are created later,
+ * e.g., during optimization, are propagated from their fanins based on the
+ * node function, assuming independent fanins, and cached.  Nodes of other
+ * networks are evaluated in the same way, with a second cache for the network
+ * that was evaluated last.  Copies of the cost function share the caches.
+ */
+template<class Ntk>
+class switching_activity_cost
+{
+public:
+  switching_activity_cost()
+      : switching_activity_cost( 100.0 )
+  {
+  }
+
+  /*! \brief Cost function that is not bound to a network. */
+  explicit switching_activity_cost( double scale, double input_probability = 0.5 )
+      : _scale( scale ),
+        _input_probability( input_probability ),
+        _table( std::make_shared<table>() ),
+        _scratch( std::make_shared<table>() )
+  {
+  }
+
+  /*! \brief Cost function bound to `ntk` with activities computed by `switching_activity`. */
+  explicit switching_activity_cost( Ntk const& ntk, switching_activity_params const& ps = {}, double scale = 100.0 )
+      : switching_activity_cost( scale, ps.input_probability )
+  {
+    attach( *_table, ntk );
+    auto const result = switching_activity( ntk, ps );
+    ntk.foreach_node( [&]( auto const& n ) {
+      _table->probability[ntk.node_to_index( n )] = result.probability[n];
+      _table->switching[ntk.node_to_index( n )] = result.switching[n];
+    } );
+  }
+
+  uint32_t operator()( Ntk const& ntk, node<Ntk> const& n ) const
+  {
+    return std::max<uint32_t>( 1u, static_cast<uint32_t>( std::lround( _scale * switching( ntk, n ) ) ) );
+  }
+
+  /*! \brief Returns the switching activity of a node. */
+  double switching( Ntk const& ntk, node<Ntk> const& n ) const
+  {
+    auto& t = lookup( ntk );
+    return t.switching[update( t, ntk, n )];
+  }
+
+  /*! \brief Returns the probability of a node to be 1. */
+  double probability( Ntk const& ntk, node<Ntk> const& n ) const
+  {
+    auto& t = lookup( ntk );
+    return t.probability[update( t, ntk, n )];
+  }
+
+  /*! \brief Returns a cost function with the same parameters bound to `ntk`.
+   *
+   * No activities are precomputed; they are either taken over with `inherit`
+   * or propagated from the fanins.
+   */
+  switching_activity_cost bind( Ntk const& ntk ) const
+  {
+    switching_activity_cost cost( _scale, _input_probability );
+    cost.attach( *cost._table, ntk );
+    return cost;
+  }
+
+  /*! \brief Takes over the activity of node `n` in `other_ntk` for signal `f` in `ntk`.
+   *
+   * The cost function must be bound to `ntk`, and `f` must compute the same
+   * function as `n`, e.g., because it replaces `n` in a copy of `other_ntk`.
+   * The activity of `n` is computed by `other`.
+   */
+  void inherit( Ntk const& ntk, signal<Ntk> const& f, switching_activity_cost const& other, Ntk const& other_ntk, node<Ntk> const& n )
+  {
+    assert( is_bound( ntk ) );
+    auto const p = other.probability( other_ntk, n );
+    auto const index = ntk.node_to_index( ntk.get_node( f ) );
+    resize( *_table, ntk );
+    _table->probability[index] = ntk.is_complemented( f ) ? 1.0 - p : p;
+    _table->switching[index] = other.switching( other_ntk, n );
+  }
+
+private:
+  struct table
+  {
+    void const* handle{nullptr};
+    std::shared_ptr<void const> owner;
+    std::vector<double> probability; /* negative if not yet computed */
+    std::vector<double> switching;
+  };
+
+  template<class _Ntk, class = void>
+  struct has_storage : std::false_type
+  {
+  };
+
+  template<class _Ntk>
+  struct has_storage<_Ntk, std::void_t<decltype( std::declval<_Ntk const&>()._storage.get() )>> : std::true_type
+  {
+  };
+
+  /* networks are handles to a shared storage, which identifies them across
+   * copies and views; the storage is kept alive to rule out that another
+   * network is created at the same address */
+  static void const* handle( Ntk const& ntk )
+  {
+    if constexpr ( has_storage<Ntk>::value )
+    {
+      return ntk._storage.get();
+    }
+    else
+    {
+      return &ntk;
+    }
+  }
+
+  static void attach( table& t, Ntk const& ntk )
+  {
+    t.handle = handle( ntk );
+    if constexpr ( has_storage<Ntk>::value )
+    {
+      t.owner = ntk._storage;
+    }
+    t.probability.clear();
+    t.switching.clear();
+    resize( t, ntk );
+  }
+
+  bool is_bound( Ntk const& ntk ) const
+  {
+    return _table->handle != nullptr && _table->handle == handle( ntk );
+  }
+
+  /* the cache for `ntk`, binds the cost function on first use */
+  table& lookup( Ntk const& ntk ) const
+  {
+    if ( _table->handle == nullptr )
+    {
+      attach( *_table, ntk );
+    }
+    if ( is_bound( ntk ) )
+    {
+      return *_table;
+    }
+    if ( _scratch->handle != handle( ntk ) )
+    {
+      attach( *_scratch, ntk );
+    }
+    return *_scratch;
+  }
+
+  static void resize( table& t, Ntk const& ntk )
+  {
+    /* networks only grow */
+    assert( t.probability.size() <= ntk.size() );
+    if ( t.probability.size() < ntk.size() )
+    {
+      t.probability.resize( ntk.size(), -1.0 );
+      t.switching.resize( ntk.size(), -1.0 );
+    }
+  }
+
+  /* computes missing probabilities in the transitive fanin of `n` (without
+   * recursion, networks can be deep), returns the index of `n` */
+  uint32_t update( table& t, Ntk const& ntk, node<Ntk> const& n ) const
+  {
+    auto const index = ntk.node_to_index( n );
+    resize( t, ntk );
+    if ( t.probability[index] >= 0.0 )
+    {
+      return index;
+    }
+
+    std::vector<std::pair<node<Ntk>, bool>> stack{{n, false}};
+    std::vector<double> fanins;
+    while ( !stack.empty() )
+    {
+      auto const [m, expanded] = stack.back();
+      auto const i = ntk.node_to_index( m );
+      if ( t.probability[i] >= 0.0 )
+      {
+        stack.pop_back();
+        continue;
+      }
+
+      if ( ntk.is_constant( m ) || ntk.is_ci( m ) )
+      {
+        stack.pop_back();
+        auto const p = ntk.is_constant( m ) ? ( ntk.constant_value( m ) ? 1.0 : 0.0 ) : _input_probability;
+        t.probability[i] = p;
+        t.switching[i] = 2.0 * p * ( 1.0 - p );
+        continue;
+      }
+
+      if ( !expanded )
+      {
+        stack.back().second = true;
+        ntk.foreach_fanin( m, [&]( auto const& f ) {
+          if ( t.probability[ntk.node_to_index( ntk.get_node( f ) )] < 0.0 )
+          {
+            stack.emplace_back( ntk.get_node( f ), false );
+          }
+        } );
+        continue;
+      }
+
+      stack.pop_back();
+      fanins.clear();
+      ntk.foreach_fanin( m, [&]( auto const& f ) {
+        auto const p = t.probability[ntk.node_to_index( ntk.get_node( f ) )];
+        fanins.push_back( ntk.is_complemented( f ) ? 1.0 - p : p );
+      } );
+
+      double p;
+      if constexpr ( has_is_and_v<Ntk> )
+      {
+        if ( ntk.is_and( m ) )
+        {
+          p = fanins[0] * fanins[1];
+          t.probability[i] = p;
+          t.switching[i] = 2.0 * p * ( 1.0 - p );
+          continue;
+        }
+      }
+      p = detail::function_probability( ntk.node_function( m ), [&]( auto j ) { return fanins[j]; } );
+      t.probability[i] = p;
+      t.switching[i] = 2.0 * p * ( 1.0 - p );
+    }
+    return index;
+  }
+
+private:
+  double _scale;
+  double _input_probability;
+  std::shared_ptr<table> _table;
+  std::shared_ptr<table> _scratch;
+};
+
+} // namespace mockturtle
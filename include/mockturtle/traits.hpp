@@ -293,6 +293,21 @@ template<class Ntk>
 inline constexpr bool has_create_and_v = has_create_and<Ntk>::value;
 #pragma endregion
 
+#pragma region has_has_and
+template<class Ntk, class = void>
+struct has_has_and : std::false_type
+{
+};
+
+template<class Ntk>
+struct has_has_and<Ntk, std::void_t<decltype( std::declval<Ntk>().has_and( std::declval<signal<Ntk>>(), std::declval<signal<Ntk>>() ) )>> : std::true_type
+{
+};
+
+template<class Ntk>
+inline constexpr bool has_has_and_v = has_has_and<Ntk>::value;
+#pragma endregion
+
 #pragma region has_create_nand
 template<class Ntk, class = void>
 struct has_create_nand : std::false_type
@@ -413,6 +428,21 @@ template<class Ntk>
 inline constexpr bool has_create_xor_v = has_create_xor<Ntk>::value;
 #pragma endregion
 
+#pragma region has_has_xor
+template<class Ntk, class = void>
+struct has_has_xor : std::false_type
+{
+};
+
+template<class Ntk>
+struct has_has_xor<Ntk, std::void_t<decltype( std::declval<Ntk>().has_xor( std::declval<signal<Ntk>>(), std::declval<signal<Ntk>>() ) )>> : std::true_type
+{
+};
+
+template<class Ntk>
+inline constexpr bool has_has_xor_v = has_has_xor<Ntk>::value;
+#pragma endregion
+
 #pragma region has_create_xnor
 template<class Ntk, class = void>
 struct has_create_xnor : std::false_type
@@ -0,0 +1,380 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2019  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file allocators.hpp
+  \brief Arena and pool allocators for short-lived containers
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace mockturtle
+{
+
+/*! \brief Monotonic memory arena
+ *
+ * Memory is taken from large chunks by advancing a pointer; individual
+ * deallocations are ignored.  Calling `reset` makes all memory available
+ * again but keeps the chunks, such that an arena that is reset after each
+ * window does not allocate from the heap once it has reached its peak size.
+ *
+ * Containers use the arena through `arena_allocator`.  All containers that
+ * use an arena must be destroyed (or must no longer be used) before the
+ * arena is reset.  An arena must not be used by several threads at the
+ * same time.
+ *
+ * **Example**
+
+   \verbatim embed:rst
+
+   .. code-block:: c++
+
+      arena mem;
+      ntk.foreach_gate( [&]( auto const& n ) {
+        node_map<uint32_t, Ntk, std::vector<uint32_t, arena_allocator<uint32_t>>> values( ntk, arena_allocator<uint32_t>( mem ) );
+        // ... work on window of n
+        mem.reset();
+      } );
+   \endverbatim
+ */
+class arena
+{
+public:
+  /*! \brief Creates an arena.
+   *
+   * \param chunk_size Size of a chunk in bytes (larger requests get their own chunk)
+   */
+  explicit arena( std::size_t chunk_size = 1u << 16u )
+      : _chunk_size( chunk_size )
+  {
+  }
+
+  ~arena()
+  {
+    release();
+  }
+
+  arena( arena const& ) = delete;
+  arena& operator=( arena const& ) = delete;
+
+  /*! \brief Allocates `bytes` bytes with the given alignment. */
+  void* allocate( std::size_t bytes, std::size_t alignment = alignof( std::max_align_t ) )
+  {
+    while ( _current < _chunks.size() )
+    {
+      auto& c = _chunks[_current];
+      void* p = c.data + _offset;
+      std::size_t space = c.size - _offset;
+      if ( std::align( alignment, bytes, p, space ) )
+      {
+        _offset = c.size - space + bytes;
+        _used += bytes;
+        return p;
+      }
+
+      /* continue with the next chunk, or insert a larger one */
+      ++_current;
+      _offset = 0u;
+      if ( _current < _chunks.size() && _chunks[_current].size < bytes + alignment )
+      {
+        break;
+      }
+    }
+
+    auto const size = std::max( _chunk_size, bytes + alignment );
+    _chunks.insert( _chunks.begin() + _current, chunk{static_cast<uint8_t*>( ::operator new( size ) ), size} );
+    _capacity += size;
+    _offset = 0u;
+    return allocate( bytes, alignment );
+  }
+
+  /*! \brief Makes all memory available again (keeps the chunks). */
+  void reset()
+  {
+    _current = 0u;
+    _offset = 0u;
+    _used = 0u;
+  }
+
+  /*! \brief Returns all chunks to the heap. */
+  void release()
+  {
+    for ( auto const& c : _chunks )
+    {
+      ::operator delete( c.data );
+    }
+    _chunks.clear();
+    _capacity = 0u;
+    reset();
+  }
+
+  /*! \brief Returns the number of bytes allocated since the last reset. */
+  std::size_t used() const
+  {
+    return _used;
+  }
+
+  /*! \brief Returns the number of bytes in all chunks. */
+  std::size_t capacity() const
+  {
+    return _capacity;
+  }
+
+private:
+  struct chunk
+  {
+    uint8_t* data;
+    std::size_t size;
+  };
+
+  std::size_t _chunk_size;
+  std::vector<chunk> _chunks;
+  std::size_t _current{0u};
+  std::size_t _offset{0u};
+  std::size_t _used{0u};
+  std::size_t _capacity{0u};
+};
+
+/*! \brief Standard allocator that allocates from an `arena`.
+ *
+ * Deallocation does nothing; the memory is reclaimed when the arena is
+ * reset.
+ */
+template<typename T>
+class arena_allocator
+{
+public:
+  using value_type = T;
+
+  explicit arena_allocator( arena& mem ) noexcept
+      : _arena( &mem )
+  {
+  }
+
+  template<typename U>
+  arena_allocator( arena_allocator<U> const& other ) noexcept
+      : _arena( other._arena )
+  {
+  }
+
+  T* allocate( std::size_t n )
+  {
+    return static_cast<T*>( _arena->allocate( n * sizeof( T ), alignof( T ) ) );
+  }
+
+  void deallocate( T*, std::size_t ) noexcept
+  {
+  }
+
+  template<typename U>
+  bool operator==( arena_allocator<U> const& other ) const noexcept
+  {
+    return _arena == other._arena;
+  }
+
+  template<typename U>
+  bool operator!=( arena_allocator<U> const& other ) const noexcept
+  {
+    return _arena != other._arena;
+  }
+
+private:
+  template<typename U>
+  friend class arena_allocator;
+
+  arena* _arena;
+};
+
+/*! \brief Thread-local cache of memory blocks
+ *
+ * Blocks of up to `max_block_size` bytes are rounded up to a power of two
+ * and, when freed, kept in a free list of the calling thread instead of
+ * being returned to the heap.  Subsequent allocations of the same size
+ * class are served from that list without locking.  Larger blocks are taken
+ * from the heap directly.  At most `max_cached_bytes` bytes are cached per
+ * size class, and cached blocks are returned to the heap when the thread
+ * exits.
+ *
+ * Each block is allocated individually from the heap, so a block may be
+ * freed by a different thread than the one that allocated it.
+ */
+class memory_pool
+{
+public:
+  static constexpr std::size_t min_block_size = 16u;
+  static constexpr std::size_t max_block_size = 1u << 16u;
+  static constexpr std::size_t max_cached_bytes = 1u << 20u;
+
+  /*! \brief Returns the pool of the calling thread (`nullptr` during thread exit). */
+  static memory_pool* local()
+  {
+    thread_local bool destroyed{false};
+    if ( destroyed )
+    {
+      return nullptr;
+    }
+    thread_local memory_pool pool( destroyed );
+    return &pool;
+  }
+
+  ~memory_pool()
+  {
+    for ( auto& head : _free )
+    {
+      while ( head )
+      {
+        auto* next = head->next;
+        ::operator delete( head );
+        head = next;
+      }
+    }
+    _destroyed = true;
+  }
+
+  memory_pool( memory_pool const& ) = delete;
+  memory_pool& operator=( memory_pool const& ) = delete;
+
+  /*! \brief Allocates a block of at least `bytes` bytes. */
+  static void* allocate( std::size_t bytes )
+  {
+    if ( bytes <= max_block_size )
+    {
+      auto const c = size_class( bytes );
+      if ( auto* pool = local(); pool && pool->_free[c] )
+      {
+        auto* block = pool->_free[c];
+        pool->_free[c] = block->next;
+        pool->_cached[c] -= block_size( c );
+        return block;
+      }
+      return ::operator new( block_size( c ) );
+    }
+    return ::operator new( bytes );
+  }
+
+  /*! \brief Frees a block that was allocated with `bytes` bytes. */
+  static void deallocate( void* p, std::size_t bytes ) noexcept
+  {
+    if ( bytes <= max_block_size )
+    {
+      auto const c = size_class( bytes );
+      if ( auto* pool = local(); pool && pool->_cached[c] + block_size( c ) <= max_cached_bytes )
+      {
+        auto* block = static_cast<free_block*>( p );
+        block->next = pool->_free[c];
+        pool->_free[c] = block;
+        pool->_cached[c] += block_size( c );
+        return;
+      }
+    }
+    ::operator delete( p );
+  }
+
+private:
+  struct free_block
+  {
+    free_block* next;
+  };
+
+  static constexpr std::size_t num_classes = 13u; /* 16 bytes to 64 KiB */
+
+  explicit memory_pool( bool& destroyed )
+      : _destroyed( destroyed )
+  {
+  }
+
+  static std::size_t size_class( std::size_t bytes )
+  {
+    std::size_t c{0u};
+    while ( block_size( c ) < bytes )
+    {
+      ++c;
+    }
+    return c;
+  }
+
+  static constexpr std::size_t block_size( std::size_t c )
+  {
+    return min_block_size << c;
+  }
+
+  bool& _destroyed;
+  std::array<free_block*, num_classes> _free{};
+  std::array<std::size_t, num_classes> _cached{};
+};
+
+/*! \brief Standard allocator that recycles memory in a thread-local pool.
+ *
+ * The allocator is stateless and uses `memory_pool`.  It is suited for
+ * containers that are created and dropped for each window of an algorithm,
+ * since their memory is reused by the containers of the next window.
+ */
+template<typename T>
+class pool_allocator
+{
+public:
+  using value_type = T;
+
+  pool_allocator() = default;
+
+  template<typename U>
+  pool_allocator( pool_allocator<U> const& ) noexcept
+  {
+  }
+
+  T* allocate( std::size_t n )
+  {
+    static_assert( alignof( T ) <= alignof( std::max_align_t ), "over-aligned types are not supported" );
+    return static_cast<T*>( memory_pool::allocate( n * sizeof( T ) ) );
+  }
+
+  void deallocate( T* p, std::size_t n ) noexcept
+  {
+    memory_pool::deallocate( p, n * sizeof( T ) );
+  }
+
+  template<typename U>
+  bool operator==( pool_allocator<U> const& ) const noexcept
+  {
+    return true;
+  }
+
+  template<typename U>
+  bool operator!=( pool_allocator<U> const& ) const noexcept
+  {
+    return false;
+  }
+};
+
+} // namespace mockturtle
@@ -0,0 +1,496 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2019  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file binary_cache.hpp
+  \brief Append-only binary cache file
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined( _WIN32 )
+#define MOCKTURTLE_BINARY_CACHE_NO_MMAP
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <kitty/dynamic_truth_table.hpp>
+
+namespace mockturtle
+{
+
+/*! \brief Append-only binary cache.
+ *
+ * A binary cache maps keys to values, both of which are sequences of 32-bit
+ * words, and distinguishes records of different kinds (e.g., synthesis
+ * results and blacklisted functions).  If a file name is given, all records
+ * are stored in that file, which is never rewritten: inserting a record
+ * appends it to the end of the file, and a later record for the same key
+ * replaces an earlier one.
+ *
+ * When the cache is opened, the file is mapped into memory read-only and
+ * only an index is built, i.e., values are not decoded until they are looked
+ * up.  Several processes can open the same file at the same time; records
+ * are appended under an exclusive file lock, such that they never interleave.
+ * Records that other processes append after the cache was opened become
+ * visible when the file is opened again.  An incomplete record at the end of
+ * the file (e.g., after a crash) is discarded.
+ *
+ * Lookups do not lock and can be called from several threads, also while
+ * another thread inserts.  Inserts are serialized.
+ *
+ * The file consists of a header of four words (magic number, version, and
+ * two reserved words) followed by records.  Each record consists of its size
+ * in words (including these three header words), its kind, the size of its
+ * key, the key, and the value.  Words are stored in the byte order of the
+ * machine.
+ *
+   \verbatim embed:rst
+
+   Example
+
+   .. code-block:: c++
+
+      binary_cache cache( "results.cache" );
+      cache.insert( 0u, {0x1u, 0x8u}, {42u} );
+      if ( const auto value = cache.find( 0u, {0x1u, 0x8u} ) )
+      {
+        std::cout << *value->first << "\n"; // 42
+      }
+   \endverbatim
+ */
+class binary_cache
+{
+public:
+  using word = uint32_t;
+
+  /*! \brief Pointers to the first and past-the-last word of a value. */
+  using value_t = std::pair<word const*, word const*>;
+
+  static constexpr word magic = 0x4342544du; /* "MTBC" */
+  static constexpr word version = 1u;
+
+public:
+  /*! \brief Constructs a cache in memory. */
+  binary_cache()
+  {
+    _table.store( new_table( 64u ) );
+  }
+
+  /*! \brief Opens (or creates) a cache file.
+   *
+   * If the file cannot be opened or is not a binary cache, the cache is kept
+   * in memory only, which can be checked with `is_persistent`.
+   */
+  explicit binary_cache( std::string const& filename )
+      : binary_cache()
+  {
+    if ( !filename.empty() )
+    {
+      open( filename );
+    }
+  }
+
+  binary_cache( binary_cache const& ) = delete;
+  binary_cache& operator=( binary_cache const& ) = delete;
+
+  ~binary_cache()
+  {
+#ifndef MOCKTURTLE_BINARY_CACHE_NO_MMAP
+    if ( _mapped )
+    {
+      munmap( const_cast<word*>( _mapped ), _mapped_size );
+    }
+    if ( _fd != -1 )
+    {
+      ::close( _fd );
+    }
+#endif
+  }
+
+  /*! \brief Checks whether a file is a binary cache. */
+  static bool is_binary_cache_file( std::string const& filename )
+  {
+    std::ifstream is( filename, std::ifstream::binary );
+    word header[2];
+    return is.read( reinterpret_cast<char*>( header ), sizeof( header ) ) && header[0] == magic && header[1] == version;
+  }
+
+  /*! \brief Returns whether records are stored in a file. */
+  bool is_persistent() const
+  {
+    return _persistent;
+  }
+
+  /*! \brief Returns the number of keys. */
+  uint64_t size() const
+  {
+    return _size.load( std::memory_order_relaxed );
+  }
+
+  /*! \brief Returns the number of records read from the file when it was opened. */
+  uint64_t num_loaded() const
+  {
+    return _num_loaded;
+  }
+
+  /*! \brief Looks up the value of a key.
+   *
+   * The returned pointers remain valid for the lifetime of the cache.
+   */
+  std::optional<value_t> find( word kind, std::vector<word> const& key ) const
+  {
+    auto const* table = _table.load( std::memory_order_acquire );
+    auto const mask = table->capacity - 1u;
+    for ( auto i = hash( kind, key.data(), key.size() ) & mask;; i = ( i + 1u ) & mask )
+    {
+      auto const* rec = table->slots[i].load( std::memory_order_acquire );
+      if ( rec == nullptr )
+      {
+        return std::nullopt;
+      }
+      if ( matches( rec, kind, key.data(), key.size() ) )
+      {
+        return value_t{rec + 3u + rec[2], rec + rec[0]};
+      }
+    }
+  }
+
+  /*! \brief Inserts (or replaces) the value of a key. */
+  void insert( word kind, std::vector<word> const& key, std::vector<word> const& value )
+  {
+    auto const size = 3u + key.size() + value.size();
+    auto record = std::make_unique<word[]>( size );
+    record[0] = static_cast<word>( size );
+    record[1] = kind;
+    record[2] = static_cast<word>( key.size() );
+    std::copy( key.begin(), key.end(), record.get() + 3u );
+    std::copy( value.begin(), value.end(), record.get() + 3u + key.size() );
+
+    std::lock_guard<std::mutex> lock( _mutex );
+    if ( _persistent )
+    {
+      append( record.get(), size );
+    }
+    index( record.get() );
+    _records.push_back( std::move( record ) );
+  }
+
+  /*! \brief Calls a function for each key and its current value.
+   *
+   * The function is called with the kind, the key (as pair of pointers), and
+   * the value (as pair of pointers).
+   */
+  template<typename Fn>
+  void foreach_record( Fn&& fn ) const
+  {
+    auto const* table = _table.load( std::memory_order_acquire );
+    for ( auto i = 0u; i < table->capacity; ++i )
+    {
+      if ( auto const* rec = table->slots[i].load( std::memory_order_acquire ) )
+      {
+        fn( rec[1], value_t{rec + 3u, rec + 3u + rec[2]}, value_t{rec + 3u + rec[2], rec + rec[0]} );
+      }
+    }
+  }
+
+private:
+  struct index_table
+  {
+    explicit index_table( uint64_t capacity )
+        : capacity( capacity ),
+          slots( new std::atomic<word const*>[capacity] )
+    {
+      for ( auto i = 0u; i < capacity; ++i )
+      {
+        slots[i].store( nullptr, std::memory_order_relaxed );
+      }
+    }
+
+    uint64_t capacity;
+    std::unique_ptr<std::atomic<word const*>[]> slots;
+  };
+
+  index_table* new_table( uint64_t capacity )
+  {
+    return _tables.emplace_back( std::make_unique<index_table>( capacity ) ).get();
+  }
+
+  static uint64_t hash( word kind, word const* key, uint64_t size )
+  {
+    uint64_t h = 0xcbf29ce484222325ull ^ kind;
+    for ( auto i = 0u; i < size; ++i )
+    {
+      h = ( h ^ key[i] ) * 0x100000001b3ull;
+      h ^= h >> 29u;
+    }
+    return h;
+  }
+
+  static bool matches( word const* rec, word kind, word const* key, uint64_t size )
+  {
+    return rec[1] == kind && rec[2] == size && std::equal( key, key + size, rec + 3u );
+  }
+
+  /* adds a record to the index (must be called while holding the mutex, or before the cache is shared) */
+  void index( word const* rec )
+  {
+    auto* table = _table.load( std::memory_order_relaxed );
+    if ( 2u * ( _size.load( std::memory_order_relaxed ) + 1u ) > table->capacity )
+    {
+      /* readers may still probe the old table, which is kept until destruction */
+      auto* grown = new_table( 2u * table->capacity );
+      for ( auto i = 0u; i < table->capacity; ++i )
+      {
+        if ( auto const* r = table->slots[i].load( std::memory_order_relaxed ) )
+        {
+          insert_slot( *grown, r );
+        }
+      }
+      _table.store( grown, std::memory_order_release );
+      table = grown;
+    }
+
+    if ( insert_slot( *table, rec ) )
+    {
+      _size.fetch_add( 1u, std::memory_order_relaxed );
+    }
+  }
+
+  /* returns true, if the key was not yet in the table */
+  static bool insert_slot( index_table& table, word const* rec )
+  {
+    auto const mask = table.capacity - 1u;
+    for ( auto i = hash( rec[1], rec + 3u, rec[2] ) & mask;; i = ( i + 1u ) & mask )
+    {
+      auto const* other = table.slots[i].load( std::memory_order_relaxed );
+      if ( other == nullptr )
+      {
+        table.slots[i].store( rec, std::memory_order_release );
+        return true;
+      }
+      if ( matches( other, rec[1], rec + 3u, rec[2] ) )
+      {
+        table.slots[i].store( rec, std::memory_order_release );
+        return false;
+      }
+    }
+  }
+
+  /* indexes all complete records in words [begin, end) and returns the end of the last complete one */
+  word const* index_records( word const* begin, word const* end )
+  {
+    auto it = begin;
+    while ( end - it >= 3 && it[0] >= 3ull + it[2] && it[0] <= static_cast<uint64_t>( end - it ) )
+    {
+      index( it );
+      ++_num_loaded;
+      it += it[0];
+    }
+    return it;
+  }
+
+#ifndef MOCKTURTLE_BINARY_CACHE_NO_MMAP
+  void open( std::string const& filename )
+  {
+    _fd = ::open( filename.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644 );
+    if ( _fd == -1 )
+    {
+      return;
+    }
+
+    flock( _fd, LOCK_EX );
+    struct stat st;
+    fstat( _fd, &st );
+    auto size = static_cast<uint64_t>( st.st_size );
+
+    if ( size == 0u )
+    {
+      const word header[4] = {magic, version, 0u, 0u};
+      _persistent = write_all( header, sizeof( header ) );
+      size = _persistent ? sizeof( header ) : 0u;
+    }
+    else if ( size >= 4u * sizeof( word ) )
+    {
+      void* data = mmap( nullptr, size, PROT_READ, MAP_SHARED, _fd, 0 );
+      if ( data != MAP_FAILED )
+      {
+        _mapped = static_cast<word const*>( data );
+        _mapped_size = size;
+        if ( _mapped[0] == magic && _mapped[1] == version )
+        {
+          auto const* end = index_records( _mapped + 4u, _mapped + size / sizeof( word ) );
+          auto const valid = static_cast<uint64_t>( end - _mapped ) * sizeof( word );
+
+          /* discard an incomplete record at the end of the file */
+          _persistent = valid == size || ftruncate( _fd, valid ) == 0;
+        }
+      }
+    }
+    flock( _fd, LOCK_UN );
+
+    if ( !_persistent )
+    {
+      ::close( _fd );
+      _fd = -1;
+    }
+  }
+
+  void append( word const* rec, uint64_t size )
+  {
+    flock( _fd, LOCK_EX );
+    write_all( rec, size * sizeof( word ) );
+    flock( _fd, LOCK_UN );
+  }
+
+  bool write_all( void const* data, uint64_t bytes )
+  {
+    auto const* ptr = static_cast<char const*>( data );
+    while ( bytes > 0u )
+    {
+      auto const written = ::write( _fd, ptr, bytes );
+      if ( written <= 0 )
+      {
+        return false;
+      }
+      ptr += written;
+      bytes -= written;
+    }
+    return true;
+  }
+#else
+  void open( std::string const& filename )
+  {
+    {
+      std::ifstream is( filename, std::ifstream::binary | std::ifstream::ate );
+      if ( is.good() && is.tellg() > 0 )
+      {
+        const auto size = static_cast<uint64_t>( is.tellg() );
+        _buffer.resize( size / sizeof( word ) );
+        is.seekg( 0 );
+        is.read( reinterpret_cast<char*>( _buffer.data() ), _buffer.size() * sizeof( word ) );
+        if ( _buffer.size() < 4u || _buffer[0] != magic || _buffer[1] != version )
+        {
+          return;
+        }
+        index_records( _buffer.data() + 4u, _buffer.data() + _buffer.size() );
+        _filename = filename;
+        _persistent = true;
+        return;
+      }
+    }
+
+    std::ofstream os( filename, std::ofstream::binary );
+    const word header[4] = {magic, version, 0u, 0u};
+    _persistent = static_cast<bool>( os.write( reinterpret_cast<char const*>( header ), sizeof( header ) ) );
+    _filename = filename;
+  }
+
+  void append( word const* rec, uint64_t size )
+  {
+    std::ofstream os( _filename, std::ofstream::binary | std::ofstream::app );
+    os.write( reinterpret_cast<char const*>( rec ), size * sizeof( word ) );
+  }
+#endif
+
+private:
+  std::vector<std::unique_ptr<index_table>> _tables;
+  std::atomic<index_table*> _table{nullptr};
+  std::atomic<uint64_t> _size{0u};
+  uint64_t _num_loaded{0u};
+
+  std::vector<std::unique_ptr<word[]>> _records;
+  std::mutex _mutex;
+  bool _persistent{false};
+
+#ifndef MOCKTURTLE_BINARY_CACHE_NO_MMAP
+  int _fd{-1};
+  word const* _mapped{nullptr};
+  uint64_t _mapped_size{0u};
+#else
+  std::string _filename;
+  std::vector<word> _buffer;
+#endif
+};
+
+/*! \brief Appends a truth table to a cache key or value.
+ *
+ * The number of variables is followed by the words of the truth table, each
+ * split into two 32-bit words.
+ */
+inline void append_truth_table( std::vector<binary_cache::word>& words, kitty::dynamic_truth_table const& tt )
+{
+  words.push_back( tt.num_vars() );
+  for ( auto it = tt.cbegin(); it != tt.cend(); ++it )
+  {
+    words.push_back( static_cast<binary_cache::word>( *it ) );
+    words.push_back( static_cast<binary_cache::word>( *it >> 32u ) );
+  }
+}
+
+/*! \brief Reads a truth table written by `append_truth_table`.
+ *
+ * The pointer is advanced past the truth table.  Returns `std::nullopt` if
+ * the truth table does not fit into the words before `end`, e.g., for a
+ * corrupted record.
+ */
+inline std::optional<kitty::dynamic_truth_table> read_truth_table( binary_cache::word const*& it, binary_cache::word const* end )
+{
+  if ( it == end || *it > 16u )
+  {
+    return std::nullopt;
+  }
+  kitty::dynamic_truth_table tt( *it );
+  if ( static_cast<uint64_t>( end - it - 1 ) < 2u * tt.num_blocks() )
+  {
+    return std::nullopt;
+  }
+  ++it;
+  for ( auto& w : tt._bits )
+  {
+    w = static_cast<uint64_t>( it[0] ) | ( static_cast<uint64_t>( it[1] ) << 32u );
+    it += 2;
+  }
+  tt.mask_bits();
+  return tt;
+}
+
+} // namespace mockturtle
@@ -33,6 +33,7 @@
 #pragma once
 
 #include <cstdint>
+#include <type_traits>
 
 #include "../traits.hpp"
 
@@ -108,14 +109,37 @@ struct mc_cost
   }
 };
 
+/*! \brief Whether a node cost function only depends on the node itself.
+ *
+ * The cost of a structural cost function is the same for equal gates in any
+ * network, independent of their fanin and fanout cones.  Algorithms may then
+ * cost gates that are not (yet) part of the network.
+ */
+template<class NodeCostFn>
+struct is_structural_cost : std::false_type
+{
+};
+
+template<class Ntk>
+struct is_structural_cost<unit_cost<Ntk>> : std::true_type
+{
+};
+
+template<class Ntk>
+struct is_structural_cost<mc_cost<Ntk>> : std::true_type
+{
+};
+
+template<class NodeCostFn>
+inline constexpr bool is_structural_cost_v = is_structural_cost<NodeCostFn>::value;
+
 template<class Ntk, class NodeCostFn = unit_cost<Ntk>>
-uint32_t costs( Ntk const& ntk )
+uint32_t costs( Ntk const& ntk, NodeCostFn const& cost_fn = {} )
 {
   static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
   static_assert( has_foreach_gate_v<Ntk>, "Ntk does not implement the foreach_gate method" );
 
   uint32_t total{0u};
-  NodeCostFn cost_fn{};
   ntk.foreach_gate( [&]( auto const& n ) {
     total += cost_fn( ntk, n );
   });
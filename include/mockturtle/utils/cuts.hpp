@@ -32,6 +32,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <iostream>
@@ -298,15 +299,47 @@ bool cut<MaxLeaves, T>::merge( cut const& that, cut& res, uint32_t cut_size ) co
     }
   }
 
-  auto it = std::set_union( begin(), end(), that.begin(), that.end(), res.begin() );
-  if ( auto length = std::distance( res.begin(), it ); length <= cut_size )
+  /* bounded union: the signature check misses leaves that collide modulo 64,
+     so the union may be larger than `res` can hold */
+  const auto limit = std::min<uint32_t>( cut_size, MaxLeaves );
+  auto it1 = begin(), it2 = that.begin();
+  auto it = res.begin();
+  uint32_t length = 0;
+  while ( it1 != end() && it2 != that.end() )
   {
-    res._cend = res._end = it;
-    res._length = static_cast<uint32_t>( length );
-    res._signature = _signature | that._signature;
-    return true;
+    if ( length == limit )
+    {
+      return false;
+    }
+    if ( *it1 < *it2 )
+    {
+      *it++ = *it1++;
+    }
+    else if ( *it2 < *it1 )
+    {
+      *it++ = *it2++;
+    }
+    else
+    {
+      *it++ = *it1++;
+      ++it2;
+    }
+    ++length;
   }
-  return false;
+
+  const auto rest1 = static_cast<uint32_t>( std::distance( it1, end() ) );
+  const auto rest2 = static_cast<uint32_t>( std::distance( it2, that.end() ) );
+  if ( length + rest1 + rest2 > limit )
+  {
+    return false;
+  }
+  it = std::copy( it1, end(), it );
+  it = std::copy( it2, that.end(), it );
+
+  res._cend = res._end = it;
+  res._length = length + rest1 + rest2;
+  res._signature = _signature | that._signature;
+  return true;
 }
 
 /*! \brief A data-structure to hold a set of cuts.
@@ -0,0 +1,266 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2019  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file memory.hpp
+  \brief Memory accounting of containers and the process
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+#include <sys/resource.h>
+#endif
+
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/partial_truth_table.hpp>
+
+#include "include/spp.hpp"
+
+namespace mockturtle
+{
+
+namespace detail
+{
+
+template<typename T, typename = void>
+struct has_memory_usage : std::false_type
+{
+};
+
+template<typename T>
+struct has_memory_usage<T, std::void_t<decltype( std::declval<T const&>().memory_usage() )>> : std::true_type
+{
+};
+
+} // namespace detail
+
+/*! \brief Heap memory owned by an object (in bytes).
+ *
+ * Returns the number of bytes that are allocated on the heap by `value`,
+ * not counting `sizeof( value )` itself.  Objects that implement a method
+ * `memory_usage()`, which returns the total number of bytes including the
+ * object itself, are supported as well as standard containers, hash maps of
+ * *sparsepp*, and truth tables of *kitty*.  For other types, 0 is returned.
+ *
+ * The values for node-based containers and hash maps are estimates, since
+ * the overhead of the allocator and of the container implementation is not
+ * known exactly.
+ */
+template<typename T>
+uint64_t heap_memory_usage( T const& value );
+
+template<typename T, typename Allocator>
+uint64_t heap_memory_usage( std::vector<T, Allocator> const& values );
+
+template<typename T, typename Allocator>
+uint64_t heap_memory_usage( std::deque<T, Allocator> const& values );
+
+template<typename T, std::size_t N>
+uint64_t heap_memory_usage( std::array<T, N> const& values );
+
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+uint64_t heap_memory_usage( std::unordered_map<K, V, Hash, KeyEqual, Allocator> const& map );
+
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+uint64_t heap_memory_usage( spp::sparse_hash_map<K, V, Hash, KeyEqual, Allocator> const& map );
+
+inline uint64_t heap_memory_usage( std::string const& s )
+{
+  /* short strings are stored inside the object */
+  auto const* begin = reinterpret_cast<char const*>( &s );
+  auto const* data = s.data();
+  return ( data >= begin && data < begin + sizeof( std::string ) ) ? 0u : s.capacity() + 1u;
+}
+
+inline uint64_t heap_memory_usage( kitty::dynamic_truth_table const& tt )
+{
+  return tt._bits.capacity() * sizeof( uint64_t );
+}
+
+inline uint64_t heap_memory_usage( kitty::partial_truth_table const& tt )
+{
+  return tt._bits.capacity() * sizeof( uint64_t );
+}
+
+template<typename T>
+uint64_t heap_memory_usage( T const& value )
+{
+  if constexpr ( detail::has_memory_usage<T>::value )
+  {
+    return value.memory_usage() - sizeof( T );
+  }
+  else
+  {
+    (void)value;
+    return 0u;
+  }
+}
+
+template<typename T, typename Allocator>
+uint64_t heap_memory_usage( std::vector<T, Allocator> const& values )
+{
+  uint64_t bytes = values.capacity() * sizeof( T );
+  if constexpr ( !std::is_trivially_copyable_v<T> )
+  {
+    for ( auto const& v : values )
+    {
+      bytes += heap_memory_usage( v );
+    }
+  }
+  return bytes;
+}
+
+template<typename T, typename Allocator>
+uint64_t heap_memory_usage( std::deque<T, Allocator> const& values )
+{
+  /* elements and the map of block pointers */
+  uint64_t bytes = values.size() * sizeof( T ) + values.size() / std::max<std::size_t>( 1u, 512u / sizeof( T ) ) * sizeof( void* );
+  if constexpr ( !std::is_trivially_copyable_v<T> )
+  {
+    for ( auto const& v : values )
+    {
+      bytes += heap_memory_usage( v );
+    }
+  }
+  return bytes;
+}
+
+template<typename T, std::size_t N>
+uint64_t heap_memory_usage( std::array<T, N> const& values )
+{
+  uint64_t bytes{0u};
+  if constexpr ( !std::is_trivially_copyable_v<T> )
+  {
+    for ( auto const& v : values )
+    {
+      bytes += heap_memory_usage( v );
+    }
+  }
+  return bytes;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+uint64_t heap_memory_usage( std::unordered_map<K, V, Hash, KeyEqual, Allocator> const& map )
+{
+  /* bucket array, and per element a node with next pointer and hash value */
+  uint64_t bytes = map.bucket_count() * sizeof( void* ) + map.size() * ( sizeof( std::pair<K const, V> ) + sizeof( void* ) + sizeof( std::size_t ) );
+  if constexpr ( !std::is_trivially_copyable_v<K> || !std::is_trivially_copyable_v<V> )
+  {
+    for ( auto const& [k, v] : map )
+    {
+      bytes += heap_memory_usage( k ) + heap_memory_usage( v );
+    }
+  }
+  return bytes;
+}
+
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+uint64_t heap_memory_usage( spp::sparse_hash_map<K, V, Hash, KeyEqual, Allocator> const& map )
+{
+  /* elements are stored densely in groups of 32 buckets; each group has two
+   * bitmaps, a pointer to its elements, and their number */
+  uint64_t bytes = ( map.bucket_count() + 31u ) / 32u * ( 2u * sizeof( uint32_t ) + sizeof( void* ) + sizeof( uint64_t ) ) + map.size() * sizeof( std::pair<K const, V> );
+  if constexpr ( !std::is_trivially_copyable_v<K> || !std::is_trivially_copyable_v<V> )
+  {
+    for ( auto const& [k, v] : map )
+    {
+      bytes += heap_memory_usage( k ) + heap_memory_usage( v );
+    }
+  }
+  return bytes;
+}
+
+/*! \brief Resident set size of the process (in bytes).
+ *
+ * Reads `/proc/self/status` on Linux and returns 0 on other systems.
+ */
+inline uint64_t current_rss()
+{
+  std::ifstream in( "/proc/self/status" );
+  std::string line;
+  while ( std::getline( in, line ) )
+  {
+    if ( line.compare( 0u, 6u, "VmRSS:" ) == 0 )
+    {
+      return std::stoull( line.substr( 6u ) ) * 1024u;
+    }
+  }
+  return 0u;
+}
+
+/*! \brief Peak resident set size of the process (in bytes).
+ *
+ * Returns the peak since the start of the process or since the last call
+ * to `reset_peak_rss`.  Reads `/proc/self/status` on Linux and falls back
+ * to `getrusage` on other Unix systems, which cannot be reset.
+ */
+inline uint64_t peak_rss()
+{
+  std::ifstream in( "/proc/self/status" );
+  std::string line;
+  while ( std::getline( in, line ) )
+  {
+    if ( line.compare( 0u, 6u, "VmHWM:" ) == 0 )
+    {
+      return std::stoull( line.substr( 6u ) ) * 1024u;
+    }
+  }
+
+#if defined( __APPLE__ )
+  rusage usage;
+  getrusage( RUSAGE_SELF, &usage );
+  return static_cast<uint64_t>( usage.ru_maxrss );
+#elif defined( __unix__ )
+  rusage usage;
+  getrusage( RUSAGE_SELF, &usage );
+  return static_cast<uint64_t>( usage.ru_maxrss ) * 1024u;
+#else
+  return 0u;
+#endif
+}
+
+/*! \brief Resets the peak resident set size to the current one.
+ *
+ * Only has an effect on Linux, and only if the process may write to
+ * `/proc/self/clear_refs`.
+ */
+inline void reset_peak_rss()
+{
+  std::ofstream( "/proc/self/clear_refs" ) << "5";
+}
+
+} // namespace mockturtle
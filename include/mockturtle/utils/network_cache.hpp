@@ -130,7 +130,13 @@ public:
 
   signal<Ntk> get( Key const& key ) const
   {
-    return _map.at( key ).first;
+    return _map.at( key );
+  }
+
+  /*! \brief Returns the keys in the order in which they were inserted. */
+  std::vector<Key> const& keys() const
+  {
+    return _output_functions;
   }
 
   auto get_view( Key const& key ) const
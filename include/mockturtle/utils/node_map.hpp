@@ -33,12 +33,18 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <deque>
+#include <limits>
 #include <memory>
+#include <stdexcept>
 #include <unordered_map>
 #include <vector>
 
 #include "../traits.hpp"
+#include "memory.hpp"
 
 namespace mockturtle
 {
@@ -79,7 +85,9 @@ class node_map;
  * node is derived.
  *
  * The implementation uses a vector as underlying data structure which
- * is indexed by the node's index.
+ * is indexed by the node's index.  The vector and its shared control block
+ * are allocated with `Allocator`, e.g., an `arena_allocator` for maps whose
+ * lifetime is bounded by a window.
  *
  * **Required network functions:**
  * - `size`
@@ -87,20 +95,22 @@ class node_map;
  * - `node_to_index`
  *
  */
-template<class T, class Ntk>
-class node_map<T, Ntk, std::vector<T>>
+template<class T, class Ntk, class Allocator>
+class node_map<T, Ntk, std::vector<T, Allocator>>
 {
 public:
   using node = typename Ntk::node;
   using signal = typename Ntk::signal;
+  using container_type = std::vector<T, Allocator>;
+  using allocator_type = Allocator;
 
-  using reference = typename std::vector<T>::reference;
-  using const_reference = typename std::vector<T>::const_reference;
+  using reference = typename container_type::reference;
+  using const_reference = typename container_type::const_reference;
 public:
   /*! \brief Default constructor. */
-  explicit node_map( Ntk const& ntk )
+  explicit node_map( Ntk const& ntk, Allocator const& alloc = Allocator() )
       : ntk( ntk ),
-        data( std::make_shared<std::vector<T>>( ntk.size() ) )
+        data( std::allocate_shared<container_type>( alloc, ntk.size(), alloc ) )
   {
     static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
     static_assert( has_size_v<Ntk>, "Ntk does not implement the size method" );
@@ -112,9 +122,9 @@ public:
    *
    * Initializes all values in the container to `init_value`.
    */
-  node_map( Ntk const& ntk, T const& init_value )
+  node_map( Ntk const& ntk, T const& init_value, Allocator const& alloc = Allocator() )
       : ntk( ntk ),
-        data( std::make_shared<std::vector<T>>( ntk.size(), init_value ) )
+        data( std::allocate_shared<container_type>( alloc, ntk.size(), init_value, alloc ) )
   {
     static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
     static_assert( has_size_v<Ntk>, "Ntk does not implement the size method" );
@@ -189,9 +199,18 @@ public:
     }
   }
 
+  /*! \brief Returns memory used by the map (in bytes).
+   *
+   * The values are shared among copies of the map and counted by each copy.
+   */
+  uint64_t memory_usage() const
+  {
+    return sizeof( *this ) + sizeof( container_type ) + heap_memory_usage( *data );
+  }
+
 private:
   Ntk const& ntk;
-  std::shared_ptr<std::vector<T>> data;
+  std::shared_ptr<container_type> data;
 };
 
 /*! \brief Unordered node map
@@ -202,27 +221,31 @@ private:
  * the corresponding node is derived.
  *
  * The implementation uses an std::unordered_map as underlying data
- * structure which is indexed by the node's index.
+ * structure which is indexed by the node's index.  Its entries are
+ * allocated with `Allocator`, e.g., a `pool_allocator`, which recycles the
+ * entries of maps that are created and dropped for each window.
  *
  * **Required network functions:**
  * - `get_node`
  * - `node_to_index`
  *
  */
-template<class T, class Ntk>
-class node_map<T, Ntk, std::unordered_map<typename Ntk::node, T>>
+template<class T, class Ntk, class Hash, class KeyEqual, class Allocator>
+class node_map<T, Ntk, std::unordered_map<typename Ntk::node, T, Hash, KeyEqual, Allocator>>
 {
 public:
   using node = typename Ntk::node;
   using signal = typename Ntk::signal;
+  using container_type = std::unordered_map<node, T, Hash, KeyEqual, Allocator>;
+  using allocator_type = Allocator;
 
   using reference = T&;
   using const_reference = const T&;
 
 public:
-  explicit node_map( Ntk const& ntk )
+  explicit node_map( Ntk const& ntk, Allocator const& alloc = Allocator() )
     : ntk( ntk ),
-      data( std::make_shared<std::unordered_map<typename Ntk::node, T>>() )
+      data( std::allocate_shared<container_type>( alloc, alloc ) )
   {
   }
 
@@ -247,9 +270,9 @@ public:
   }
 
   /* Make a deep copy */
-  node_map<T, Ntk, std::unordered_map<typename Ntk::node, T>> copy() const
+  node_map<T, Ntk, container_type> copy() const
   {
-    node_map<T, Ntk, std::unordered_map<typename Ntk::node, T>> copy(ntk);
+    node_map<T, Ntk, container_type> copy( ntk, data->get_allocator() );
     *(copy.data) = *data;
     return copy;
   }
@@ -300,14 +323,377 @@ public:
     data->clear();
   }
 
+  /*! \brief Returns memory used by the map (in bytes).
+   *
+   * The values are shared among copies of the map and counted by each copy.
+   */
+  uint64_t memory_usage() const
+  {
+    return sizeof( *this ) + sizeof( container_type ) + heap_memory_usage( *data );
+  }
+
+protected:
+  Ntk const& ntk;
+  std::shared_ptr<container_type> data;
+};
+
+/*! \brief Flat hash table from node indexes to values
+ *
+ * An open-addressing hash table with linear probing.  The slots store the
+ * key, the index of the value, and the epoch in which they were written; a
+ * slot is occupied only if its epoch is the current one.  Therefore,
+ * `clear` runs in constant time by starting a new epoch.  The values are
+ * stored in a `std::deque`, such that references to values remain valid
+ * when other values are inserted; values of a previous epoch are reused
+ * (and reassigned with a default-constructed value) by later insertions.
+ *
+ * The table is the implementation of `unordered_node_map`.
+ */
+template<class T, class Allocator = std::allocator<T>>
+class flat_node_table
+{
+private:
+  struct slot
+  {
+    uint64_t key;
+    uint32_t epoch;
+    uint32_t value;
+  };
+
+  template<typename U>
+  using rebind_alloc = typename std::allocator_traits<Allocator>::template rebind_alloc<U>;
+
+public:
+  using key_type = uint64_t;
+  using mapped_type = T;
+  using allocator_type = Allocator;
+
+  explicit flat_node_table( Allocator const& alloc = Allocator() )
+      : _slots( rebind_alloc<slot>( alloc ) ),
+        _values( rebind_alloc<T>( alloc ) ),
+        _free( rebind_alloc<uint32_t>( alloc ) ),
+        _alloc( alloc )
+  {
+  }
+
+  /*! \brief Returns a pointer to the value of `key`, or `nullptr`. */
+  T* find( uint64_t key )
+  {
+    auto const pos = position( key );
+    return pos == npos ? nullptr : &_values[_slots[pos].value];
+  }
+
+  /*! \brief Returns a pointer to the value of `key`, or `nullptr`. */
+  T const* find( uint64_t key ) const
+  {
+    auto const pos = position( key );
+    return pos == npos ? nullptr : &_values[_slots[pos].value];
+  }
+
+  /*! \brief Returns the value of `key`, throws `std::out_of_range` if it is missing. */
+  T const& at( uint64_t key ) const
+  {
+    auto const pos = position( key );
+    if ( pos == npos )
+    {
+      throw std::out_of_range( "flat_node_table::at" );
+    }
+    return _values[_slots[pos].value];
+  }
+
+  /*! \brief Returns the value of `key`, inserts a default value if needed. */
+  T& operator[]( uint64_t key )
+  {
+    if ( auto const pos = position( key ); pos != npos )
+    {
+      return _values[_slots[pos].value];
+    }
+
+    /* the table only grows when a key is inserted */
+    if ( ( _size + 1u ) * 2u > _slots.size() )
+    {
+      rehash( std::max<std::size_t>( 16u, _slots.size() * 2u ) );
+    }
+
+    auto i = home( key );
+    while ( _slots[i].epoch == _epoch )
+    {
+      i = ( i + 1u ) & ( _slots.size() - 1u );
+    }
+
+    _slots[i] = {key, _epoch, new_value()};
+    ++_size;
+    return _values[_slots[i].value];
+  }
+
+  /*! \brief Removes `key` from the table, returns whether it was contained. */
+  bool erase( uint64_t key )
+  {
+    auto i = position( key );
+    if ( i == npos )
+    {
+      return false;
+    }
+    _free.push_back( _slots[i].value );
+    --_size;
+
+    /* backward-shift deletion keeps probe sequences without tombstones */
+    auto const mask = _slots.size() - 1u;
+    auto j = i;
+    while ( true )
+    {
+      j = ( j + 1u ) & mask;
+      if ( _slots[j].epoch != _epoch )
+      {
+        break;
+      }
+      auto const k = home( _slots[j].key );
+      if ( ( i <= j ) ? ( k <= i || k > j ) : ( k <= i && k > j ) )
+      {
+        _slots[i] = _slots[j];
+        i = j;
+      }
+    }
+    _slots[i].epoch = 0u;
+    return true;
+  }
+
+  /*! \brief Removes all entries in constant time. */
+  void clear()
+  {
+    if ( ++_epoch == 0u )
+    {
+      for ( auto& s : _slots )
+      {
+        s.epoch = 0u;
+      }
+      _epoch = 1u;
+    }
+    _size = 0u;
+    _used_values = 0u;
+    _free.clear();
+  }
+
+  /*! \brief Returns the number of entries. */
+  std::size_t size() const
+  {
+    return _size;
+  }
+
+  /*! \brief Returns the allocator. */
+  allocator_type get_allocator() const
+  {
+    return _alloc;
+  }
+
+  /*! \brief Returns memory used by the table (in bytes). */
+  uint64_t memory_usage() const
+  {
+    return sizeof( *this ) + heap_memory_usage( _slots ) + heap_memory_usage( _values ) + heap_memory_usage( _free );
+  }
+
+private:
+  static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+  std::size_t home( uint64_t key ) const
+  {
+    /* Fibonacci hashing spreads consecutive node indexes */
+    return static_cast<std::size_t>( ( key * UINT64_C( 0x9e3779b97f4a7c15 ) ) >> _shift );
+  }
+
+  std::size_t position( uint64_t key ) const
+  {
+    if ( _size == 0u )
+    {
+      return npos;
+    }
+
+    auto i = home( key );
+    while ( _slots[i].epoch == _epoch )
+    {
+      if ( _slots[i].key == key )
+      {
+        return i;
+      }
+      i = ( i + 1u ) & ( _slots.size() - 1u );
+    }
+    return npos;
+  }
+
+  uint32_t new_value()
+  {
+    uint32_t index;
+    if ( !_free.empty() )
+    {
+      index = _free.back();
+      _free.pop_back();
+      _values[index] = T();
+    }
+    else if ( _used_values < _values.size() )
+    {
+      index = _used_values++;
+      _values[index] = T();
+    }
+    else
+    {
+      _values.emplace_back();
+      index = _used_values++;
+    }
+    return index;
+  }
+
+  void rehash( std::size_t capacity )
+  {
+    std::vector<slot, rebind_alloc<slot>> slots( capacity, slot{0u, 0u, 0u}, rebind_alloc<slot>( _alloc ) );
+    std::swap( slots, _slots );
+    _shift = 64u;
+    for ( auto c = capacity; c > 1u; c >>= 1u )
+    {
+      --_shift;
+    }
+
+    for ( auto const& s : slots )
+    {
+      if ( s.epoch == _epoch )
+      {
+        auto i = home( s.key );
+        while ( _slots[i].epoch == _epoch )
+        {
+          i = ( i + 1u ) & ( capacity - 1u );
+        }
+        _slots[i] = s;
+      }
+    }
+  }
+
+private:
+  std::vector<slot, rebind_alloc<slot>> _slots;
+  std::deque<T, rebind_alloc<T>> _values;
+  std::vector<uint32_t, rebind_alloc<uint32_t>> _free;
+  Allocator _alloc;
+
+  uint32_t _epoch{1u};
+  uint32_t _shift{64u};
+  std::size_t _size{0u};
+  uint32_t _used_values{0u};
+};
+
+/*! \brief Unordered node map (flat hash table)
+ *
+ * Same interface as the node map based on `std::unordered_map`, but the
+ * entries are stored in a `flat_node_table`: lookups probe a contiguous
+ * array instead of following pointers, `reset` runs in constant time, and
+ * inserting a value does not allocate once the map has reached its peak
+ * size.  References to values remain valid until the map is reset.
+ *
+ * **Required network functions:**
+ * - `get_node`
+ * - `node_to_index`
+ *
+ */
+template<class T, class Ntk, class Allocator>
+class node_map<T, Ntk, flat_node_table<T, Allocator>>
+{
+public:
+  using node = typename Ntk::node;
+  using signal = typename Ntk::signal;
+  using container_type = flat_node_table<T, Allocator>;
+  using allocator_type = Allocator;
+
+  using reference = T&;
+  using const_reference = const T&;
+
+public:
+  explicit node_map( Ntk const& ntk, Allocator const& alloc = Allocator() )
+    : ntk( ntk ),
+      data( std::allocate_shared<container_type>( alloc, alloc ) )
+  {
+  }
+
+  /*! \brief Check if a key is already defined. */
+  bool has( node const& n ) const
+  {
+    return data->find( ntk.node_to_index( n ) ) != nullptr;
+  }
+
+  /*! \brief Check if a key is already defined. */
+  bool has( signal const& f ) const
+  {
+    return data->find( ntk.node_to_index( ntk.get_node( f ) ) ) != nullptr;
+  }
+
+  void erase( node const& n )
+  {
+    data->erase( ntk.node_to_index( n ) );
+  }
+
+  /* Make a deep copy */
+  node_map<T, Ntk, container_type> copy() const
+  {
+    node_map<T, Ntk, container_type> copy( ntk, data->get_allocator() );
+    *(copy.data) = *data;
+    return copy;
+  }
+
+  /*! \brief Mutable access to value by node. */
+  reference operator[]( node const& n )
+  {
+    return (*data)[ntk.node_to_index( n )];
+  }
+
+  /*! \brief Constant access to value by node. */
+  const_reference operator[]( node const& n ) const
+  {
+    assert( has( n ) && "index out of bounds" );
+    return data->at( ntk.node_to_index( n ) );
+  }
+
+  /*! \brief Mutable access to value by signal.
+   *
+   * This method derives the node from the signal.  If the node and signal type
+   * are the same in the network implementation, this method is disabled.
+   */
+  template<typename _Ntk = Ntk, typename = std::enable_if_t<!std::is_same_v<typename _Ntk::signal, typename _Ntk::node>>>
+  reference operator[]( signal const& f )
+  {
+    return (*data)[ntk.node_to_index( ntk.get_node( f ) )];
+  }
+
+  /*! \brief Constant access to value by signal.
+   *
+   * This method derives the node from the signal.  If the node and signal type
+   * are the same in the network implementation, this method is disabled.
+   */
+  template<typename _Ntk = Ntk, typename = std::enable_if_t<!std::is_same_v<typename _Ntk::signal, typename _Ntk::node>>>
+  const_reference operator[]( signal const& f ) const
+  {
+    assert( has( ntk.get_node( f ) ) && "index out of bounds" );
+    return data->at( ntk.node_to_index( ntk.get_node( f ) ) );
+  }
+
+  /*! \brief Resets the map in constant time. */
+  void reset()
+  {
+    data->clear();
+  }
+
+  /*! \brief Returns memory used by the map (in bytes).
+   *
+   * The values are shared among copies of the map and counted by each copy.
+   */
+  uint64_t memory_usage() const
+  {
+    return sizeof( *this ) + data->memory_usage();
+  }
+
 protected:
   Ntk const& ntk;
-  std::shared_ptr<std::unordered_map<node, T>> data;
+  std::shared_ptr<container_type> data;
 };
 
 /*! \brief Template alias `unordered_node_map` */
-template<class T, class Ntk>
-using unordered_node_map = node_map<T, Ntk, std::unordered_map<typename Ntk::node, T>>;
+template<class T, class Ntk, class Allocator = std::allocator<T>>
+using unordered_node_map = node_map<T, Ntk, flat_node_table<T, Allocator>>;
 
 /*! \brief Initializes a network for copying together with node map.
  *
@@ -0,0 +1,227 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2020  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file output_buffer.hpp
+  \brief Buffered character output for network writers
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "thread_pool.hpp"
+
+namespace mockturtle
+{
+
+/*! \brief Buffered character output
+ *
+ * This class collects characters in a contiguous buffer that is reused
+ * across writes and only handed to the output stream when it is full (or
+ * when `flush` is called explicitly).  Unsigned integers are formatted
+ * directly into the buffer without creating intermediate strings, which is
+ * what most network writers need to generate names such as `n42`.
+ *
+ * A buffer that is not attached to a stream grows without bound.  Such
+ * buffers are used to format parts of the output independently (e.g., in
+ * separate threads), which are then appended to the attached buffer in the
+ * correct order.
+ *
+   \verbatim embed:rst
+
+   Example
+
+   .. code-block:: c++
+
+      output_buffer buf( std::cout );
+      buf.put( "assign n" );
+      buf.put_uint( 42u );
+      buf.put( " = 1'b0 ;\n" );
+      buf.flush();
+   \endverbatim
+ */
+class output_buffer
+{
+public:
+  /*! \brief Constructs an unattached buffer. */
+  output_buffer() = default;
+
+  /*! \brief Constructs a buffer attached to an output stream.
+   *
+   * \param os Output stream
+   * \param capacity Number of bytes collected before the buffer is written
+   */
+  explicit output_buffer( std::ostream& os, uint64_t capacity = 1u << 20u )
+      : _os( &os ),
+        _capacity( capacity )
+  {
+    _data.reserve( capacity );
+  }
+
+  output_buffer( output_buffer const& ) = delete;
+  output_buffer& operator=( output_buffer const& ) = delete;
+  output_buffer( output_buffer&& ) = default;
+  output_buffer& operator=( output_buffer&& ) = default;
+
+  /*! \brief Writes remaining characters to the attached stream. */
+  ~output_buffer()
+  {
+    flush();
+  }
+
+  /*! \brief Appends a character. */
+  void put( char c )
+  {
+    _data.push_back( c );
+    check_capacity();
+  }
+
+  /*! \brief Appends a string. */
+  void put( std::string_view s )
+  {
+    _data.append( s.data(), s.size() );
+    check_capacity();
+  }
+
+  /*! \brief Appends the decimal representation of an unsigned integer. */
+  void put_uint( uint64_t value )
+  {
+    fmt::format_int const str( value );
+    _data.append( str.data(), str.size() );
+    check_capacity();
+  }
+
+  /*! \brief Appends the contents of another buffer and clears it. */
+  void put( output_buffer& other )
+  {
+    put( other.view() );
+    other.clear();
+  }
+
+  /*! \brief Returns a view to the characters that have not been written yet. */
+  std::string_view view() const
+  {
+    return std::string_view( _data.data(), _data.size() );
+  }
+
+  /*! \brief Returns the number of characters that have not been written yet. */
+  uint64_t size() const
+  {
+    return _data.size();
+  }
+
+  /*! \brief Discards all characters that have not been written yet. */
+  void clear()
+  {
+    _data.clear();
+  }
+
+  /*! \brief Writes all characters to the attached stream.
+   *
+   * Does nothing, if the buffer is not attached to a stream.
+   */
+  void flush()
+  {
+    if ( _os == nullptr )
+      return;
+
+    _os->write( _data.data(), _data.size() );
+    _data.clear();
+  }
+
+private:
+  void check_capacity()
+  {
+    if ( _os != nullptr && _data.size() >= _capacity )
+    {
+      flush();
+    }
+  }
+
+private:
+  std::ostream* _os{nullptr};
+  uint64_t _capacity{0u};
+  std::string _data;
+};
+
+/*! \brief Formats a sequence of elements in parallel chunks.
+ *
+ * The elements are split into at most `num_threads` contiguous chunks, each
+ * of which is formatted into its own unattached buffer by calling
+ * `fn( buffer, element )` for every element.  The chunk buffers are appended
+ * to `buf` in order, such that the result is the same as if all elements
+ * were formatted sequentially into `buf`.  Sequences that are too short to
+ * profit from threads are formatted sequentially.
+ *
+ * The function `fn` must be safe to be called concurrently.
+ *
+ * \param buf Buffer to append to
+ * \param elements Random access sequence of elements
+ * \param num_threads Maximum number of threads (0 uses the default number of threads)
+ * \param fn Formatting function
+ */
+template<class Container, class Fn>
+void put_in_chunks( output_buffer& buf, Container const& elements, uint32_t num_threads, Fn&& fn )
+{
+  constexpr uint64_t min_chunk_size = 1024u;
+
+  uint64_t const size = std::size( elements );
+  num_threads = static_cast<uint32_t>( std::min<uint64_t>( resolve_num_threads( num_threads ), size / min_chunk_size ) );
+
+  if ( num_threads <= 1u )
+  {
+    for ( auto const& e : elements )
+    {
+      fn( buf, e );
+    }
+    return;
+  }
+
+  /* contiguous chunks keep the output order, each thread formats one chunk */
+  std::vector<output_buffer> chunks( num_threads );
+  default_thread_pool().run( num_threads, [&]( uint32_t t ) {
+    auto const begin = std::begin( elements ) + size * t / num_threads;
+    auto const end = std::begin( elements ) + size * ( t + 1u ) / num_threads;
+    for ( auto it = begin; it != end; ++it )
+    {
+      fn( chunks[t], *it );
+    }
+  } );
+
+  for ( auto& chunk : chunks )
+  {
+    buf.put( chunk );
+  }
+}
+
+} // namespace mockturtle
@@ -0,0 +1,782 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2020  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file profiler.hpp
+  \brief Hierarchical timers and counters
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fmt/format.h>
+
+namespace mockturtle
+{
+
+/*! \brief Aggregated profile of a scope.
+ *
+ * Scopes with the same name and the same parent scope are merged, also
+ * across threads.
+ */
+struct profile_scope_data
+{
+  /*! \brief Name of the scope. */
+  std::string name;
+
+  /*! \brief Number of times the scope was entered. */
+  uint64_t calls{0u};
+
+  /*! \brief Total time spent in the scope (in nanoseconds). */
+  uint64_t time_ns{0u};
+
+  /*! \brief Counters incremented directly in this scope. */
+  std::map<std::string, uint64_t> counters;
+
+  /*! \brief Number of allocations reported directly in this scope. */
+  uint64_t allocations{0u};
+
+  /*! \brief Bytes allocated directly in this scope. */
+  uint64_t allocated_bytes{0u};
+
+  /*! \brief Maximum increase of live bytes during a call, including nested scopes. */
+  uint64_t peak_bytes{0u};
+
+  /*! \brief Nested scopes. */
+  std::vector<profile_scope_data> children;
+};
+
+/*! \brief Hierarchical profiler
+ *
+ * The profiler collects the time spent in named, nested scopes and the
+ * values of named counters.  It is a process-wide object that is disabled
+ * by default; when it is disabled, opening a scope or incrementing a
+ * counter costs a single relaxed atomic load.
+ *
+ * Each thread records into its own buffer, so no synchronization is needed
+ * while recording.  The buffers are merged when the profile is exported,
+ * which must not happen while other threads are recording.
+ *
+ * Scopes are opened with `profile_scope` or with a named `stopwatch`, and
+ * counters are incremented with `profile_counter`.  Scope and counter names
+ * must have static storage duration (e.g., string literals).  The
+ * algorithms of the library open a scope named after the algorithm around
+ * their main loop, and increment counters such as the number of SAT calls,
+ * such that the time of a complete flow can be broken down without changing
+ * the algorithms.
+ *
+ * Heap allocations are attributed to the open scope if they are reported
+ * with `profile_allocation` and `profile_deallocation`, either by containers
+ * that use `tracking_allocator` or by a replaced global `operator new`.  For
+ * each scope, the profiler reports the number of allocations, the allocated
+ * bytes, and the peak of live bytes above the level at which the scope was
+ * entered, such that one can see which pass inflated memory.  Memory that is
+ * allocated in one thread and freed in another is attributed to both.
+ *
+ * If the environment variable `MOCKTURTLE_PROFILE` is set, the profiler is
+ * enabled at start-up and the profile is written at exit: as Chrome trace
+ * to the file named by the variable, or as report to standard output if
+ * the variable is `-`.
+ *
+ * **Example**
+
+   \verbatim embed:rst
+
+   .. code-block:: c++
+
+      profiler::instance().enable();
+      {
+        profile_scope scope( "flow" );
+        for ( auto i = 0u; i < 30u; ++i )
+        {
+          cut_rewriting( mig, resyn );
+          mig = cleanup_dangling( mig );
+        }
+      }
+      profiler::instance().report();
+
+      std::ofstream os( "flow.json" );
+      profiler::instance().write_chrome_trace( os );
+   \endverbatim
+ */
+class profiler
+{
+public:
+  using clock = std::chrono::steady_clock;
+
+  /*! \brief Returns the process-wide profiler. */
+  static profiler& instance()
+  {
+    static profiler p;
+    return p;
+  }
+
+  ~profiler()
+  {
+    if ( _exit_file.empty() )
+    {
+      return;
+    }
+
+    if ( _exit_file == "-" )
+    {
+      report();
+    }
+    else
+    {
+      std::ofstream os( _exit_file );
+      write_chrome_trace( os );
+    }
+  }
+
+  profiler( profiler const& ) = delete;
+  profiler& operator=( profiler const& ) = delete;
+
+  /*! \brief Enables recording.
+   *
+   * \param record_events Also record every scope as event for `write_chrome_trace`
+   */
+  void enable( bool record_events = false )
+  {
+    _record_events.store( record_events, std::memory_order_relaxed );
+    _enabled.store( true, std::memory_order_relaxed );
+  }
+
+  /*! \brief Disables recording. */
+  void disable()
+  {
+    _enabled.store( false, std::memory_order_relaxed );
+  }
+
+  /*! \brief Returns whether recording is enabled. */
+  bool is_enabled() const
+  {
+    return _enabled.load( std::memory_order_relaxed );
+  }
+
+  /*! \brief Clears all times, counters, and events.
+   *
+   * Scopes that are open remain open.
+   */
+  void reset()
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    for ( auto& b : _buffers )
+    {
+      for ( auto& n : b->nodes )
+      {
+        n.calls = n.time_ns = 0u;
+        n.allocations = n.allocated_bytes = n.peak_bytes = 0u;
+        n.counters.clear();
+      }
+      b->events.clear();
+    }
+  }
+
+  /*! \brief Returns the aggregated profile.
+   *
+   * The returned root scope has an empty name, its children are the
+   * outermost scopes of all threads.
+   */
+  profile_scope_data aggregate() const
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    profile_scope_data root;
+    for ( auto const& b : _buffers )
+    {
+      merge( root, *b, 0u );
+    }
+    prune( root );
+    return root;
+  }
+
+  /*! \brief Returns the total value of a counter over all scopes and threads. */
+  uint64_t counter( std::string_view name ) const
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    uint64_t value{0u};
+    for ( auto const& b : _buffers )
+    {
+      for ( auto const& n : b->nodes )
+      {
+        for ( auto const& [c, v] : n.counters )
+        {
+          if ( name == c )
+          {
+            value += v;
+          }
+        }
+      }
+    }
+    return value;
+  }
+
+  /*! \brief Prints the scope tree with times and counters. */
+  void report( std::ostream& os = std::cout ) const
+  {
+    auto const root = aggregate();
+    os << "[i] profile\n";
+    for ( auto const& c : root.children )
+    {
+      report_scope( os, c, 1u, 0u );
+    }
+
+    std::map<std::string, uint64_t> totals;
+    collect_counters( root, totals );
+    for ( auto const& [name, value] : totals )
+    {
+      os << fmt::format( "[i] {:<40} = {:>12}\n", name, value );
+    }
+  }
+
+  /*! \brief Writes the aggregated profile as JSON.
+   *
+   * The output contains the scope tree (`scopes`) with the fields `name`,
+   * `calls`, `time` (in seconds), `allocations`, `allocated_bytes`,
+   * `peak_bytes`, `counters`, and `children`, and the total
+   * value of each counter (`counters`).
+   */
+  void write_json( std::ostream& os ) const
+  {
+    auto const root = aggregate();
+    os << "{\"scopes\":[";
+    for ( auto i = 0u; i < root.children.size(); ++i )
+    {
+      if ( i )
+        os << ',';
+      write_json_scope( os, root.children[i] );
+    }
+
+    std::map<std::string, uint64_t> totals;
+    collect_counters( root, totals );
+    os << "],\"counters\":";
+    write_json_counters( os, totals );
+    os << "}\n";
+  }
+
+  /*! \brief Writes the recorded events in Chrome trace format.
+   *
+   * The output can be loaded in `chrome://tracing` or Perfetto.  Each
+   * thread is shown in its own row.  Only scopes that were recorded while
+   * `enable( true )` was active are included; the total counter values are
+   * added as metadata.
+   */
+  void write_chrome_trace( std::ostream& os ) const
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    os << "{\"traceEvents\":[";
+    bool first{true};
+    for ( auto const& b : _buffers )
+    {
+      for ( auto const& e : b->events )
+      {
+        if ( !first )
+          os << ",\n";
+        first = false;
+        os << fmt::format( "{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":0,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}", escape( e.name ), b->id, e.start_ns / 1000.0, e.time_ns / 1000.0 );
+      }
+    }
+
+    std::map<std::string, uint64_t> totals;
+    for ( auto const& b : _buffers )
+    {
+      for ( auto const& n : b->nodes )
+      {
+        for ( auto const& [c, v] : n.counters )
+        {
+          totals[c] += v;
+        }
+      }
+    }
+    os << "],\"displayTimeUnit\":\"ms\",\"otherData\":";
+    write_json_counters( os, totals );
+    os << "}\n";
+  }
+
+public: /* recording interface, use profile_scope and profile_counter */
+  uint64_t now() const
+  {
+    return static_cast<uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>( clock::now() - _epoch ).count() );
+  }
+
+  void begin( char const* name )
+  {
+    recording_guard guard;
+    auto& b = buffer();
+    auto const index = b.child( b.current, name );
+    b.current = index;
+    b.frames.push_back( {now(), b.live, b.live} );
+  }
+
+  void end()
+  {
+    recording_guard guard;
+    auto& b = buffer();
+    auto const f = b.frames.back();
+    auto const time_ns = now() - f.start_ns;
+    b.frames.pop_back();
+
+    auto& n = b.nodes[b.current];
+    ++n.calls;
+    n.time_ns += time_ns;
+    n.peak_bytes = std::max( n.peak_bytes, static_cast<uint64_t>( f.peak_bytes - f.base_bytes ) );
+    if ( !b.frames.empty() )
+    {
+      b.frames.back().peak_bytes = std::max( b.frames.back().peak_bytes, f.peak_bytes );
+    }
+    if ( _record_events.load( std::memory_order_relaxed ) )
+    {
+      b.events.push_back( {n.name, f.start_ns, time_ns} );
+    }
+    b.current = n.parent;
+  }
+
+  void count( char const* name, uint64_t value )
+  {
+    recording_guard guard;
+    auto& b = buffer();
+    auto& counters = b.nodes[b.current].counters;
+    for ( auto& [c, v] : counters )
+    {
+      if ( c == name || std::strcmp( c, name ) == 0 )
+      {
+        v += value;
+        return;
+      }
+    }
+    counters.emplace_back( name, value );
+  }
+
+  void allocate( uint64_t bytes )
+  {
+    recording_guard guard;
+    auto& b = buffer();
+    auto& n = b.nodes[b.current];
+    ++n.allocations;
+    n.allocated_bytes += bytes;
+    b.live += static_cast<int64_t>( bytes );
+    if ( !b.frames.empty() && b.live > b.frames.back().peak_bytes )
+    {
+      b.frames.back().peak_bytes = b.live;
+    }
+  }
+
+  void deallocate( uint64_t bytes )
+  {
+    recording_guard guard;
+    buffer().live -= static_cast<int64_t>( bytes );
+  }
+
+  /* true while the calling thread records into the profiler; allocations
+   * of the profiler itself are not reported */
+  static bool& is_recording()
+  {
+    thread_local bool recording{false};
+    return recording;
+  }
+
+private:
+  struct recording_guard
+  {
+    recording_guard()
+        : previous( is_recording() )
+    {
+      is_recording() = true;
+    }
+
+    ~recording_guard()
+    {
+      is_recording() = previous;
+    }
+
+    bool previous;
+  };
+
+  struct scope_node
+  {
+    scope_node( char const* name, uint32_t parent )
+        : name( name ), parent( parent )
+    {
+    }
+
+    char const* name;
+    uint32_t parent;
+    uint64_t calls{0u};
+    uint64_t time_ns{0u};
+    uint64_t allocations{0u};
+    uint64_t allocated_bytes{0u};
+    uint64_t peak_bytes{0u};
+    std::vector<uint32_t> children;
+    std::vector<std::pair<char const*, uint64_t>> counters;
+  };
+
+  struct event
+  {
+    char const* name;
+    uint64_t start_ns;
+    uint64_t time_ns;
+  };
+
+  struct frame
+  {
+    uint64_t start_ns;
+    int64_t base_bytes;
+    int64_t peak_bytes;
+  };
+
+  struct thread_buffer
+  {
+    explicit thread_buffer( uint32_t id )
+        : id( id )
+    {
+      nodes.emplace_back( "", 0u );
+    }
+
+    uint32_t child( uint32_t parent, char const* name )
+    {
+      for ( auto c : nodes[parent].children )
+      {
+        if ( nodes[c].name == name || std::strcmp( nodes[c].name, name ) == 0 )
+        {
+          return c;
+        }
+      }
+      auto const index = static_cast<uint32_t>( nodes.size() );
+      nodes.emplace_back( name, parent );
+      nodes[parent].children.push_back( index );
+      return index;
+    }
+
+    uint32_t id;
+    uint32_t current{0u};
+    int64_t live{0};
+    std::vector<scope_node> nodes;
+    std::vector<frame> frames;
+    std::vector<event> events;
+  };
+
+  profiler()
+      : _epoch( clock::now() )
+  {
+    if ( auto const* file = std::getenv( "MOCKTURTLE_PROFILE" ); file && *file )
+    {
+      _exit_file = file;
+      enable( _exit_file != "-" );
+    }
+  }
+
+  thread_buffer& buffer()
+  {
+    thread_local thread_buffer* local = nullptr;
+    if ( !local )
+    {
+      std::lock_guard<std::mutex> lock( _mutex );
+      local = _buffers.emplace_back( std::make_unique<thread_buffer>( static_cast<uint32_t>( _buffers.size() ) ) ).get();
+    }
+    return *local;
+  }
+
+  static void merge( profile_scope_data& data, thread_buffer const& b, uint32_t index )
+  {
+    auto const& n = b.nodes[index];
+    data.calls += n.calls;
+    data.time_ns += n.time_ns;
+    data.allocations += n.allocations;
+    data.allocated_bytes += n.allocated_bytes;
+    data.peak_bytes = std::max( data.peak_bytes, n.peak_bytes );
+    for ( auto const& [c, v] : n.counters )
+    {
+      data.counters[c] += v;
+    }
+
+    for ( auto c : n.children )
+    {
+      auto it = std::find_if( data.children.begin(), data.children.end(), [&]( auto const& d ) { return d.name == b.nodes[c].name; } );
+      if ( it == data.children.end() )
+      {
+        it = data.children.insert( data.children.end(), profile_scope_data{} );
+        it->name = b.nodes[c].name;
+      }
+      merge( *it, b, c );
+    }
+  }
+
+  /* removes scopes without calls or counters, e.g., after reset */
+  static bool prune( profile_scope_data& data )
+  {
+    data.children.erase( std::remove_if( data.children.begin(), data.children.end(), []( auto& d ) { return !prune( d ); } ), data.children.end() );
+    return data.calls > 0u || data.allocations > 0u || !data.counters.empty() || !data.children.empty();
+  }
+
+  static void collect_counters( profile_scope_data const& data, std::map<std::string, uint64_t>& totals )
+  {
+    for ( auto const& [c, v] : data.counters )
+    {
+      totals[c] += v;
+    }
+    for ( auto const& d : data.children )
+    {
+      collect_counters( d, totals );
+    }
+  }
+
+  static void report_scope( std::ostream& os, profile_scope_data const& data, uint32_t depth, uint64_t parent_ns )
+  {
+    auto const label = std::string( 2u * depth, ' ' ) + data.name;
+    auto const share = parent_ns ? fmt::format( "{:>6.1f}%", 100.0 * data.time_ns / parent_ns ) : std::string( 7u, ' ' );
+    os << fmt::format( "[i] {:<40} {:>9.3f} secs {} {:>9} calls\n", label, data.time_ns / 1e9, share, data.calls );
+    for ( auto const& [c, v] : data.counters )
+    {
+      os << fmt::format( "[i] {:<40} {:>9}\n", std::string( 2u * depth + 2u, ' ' ) + "#" + c, v );
+    }
+    if ( data.allocations > 0u || data.peak_bytes > 0u )
+    {
+      os << fmt::format( "[i] {:<40} {:>9.2f} MB in {} allocations, peak {:.2f} MB\n", std::string( 2u * depth + 2u, ' ' ) + "@heap", data.allocated_bytes / 1048576.0, data.allocations, data.peak_bytes / 1048576.0 );
+    }
+    for ( auto const& d : data.children )
+    {
+      report_scope( os, d, depth + 1u, data.time_ns );
+    }
+  }
+
+  static std::string escape( std::string_view s )
+  {
+    std::string r;
+    for ( auto c : s )
+    {
+      if ( c == '"' || c == '\\' )
+      {
+        r += '\\';
+      }
+      r += c;
+    }
+    return r;
+  }
+
+  static void write_json_counters( std::ostream& os, std::map<std::string, uint64_t> const& counters )
+  {
+    os << '{';
+    bool first{true};
+    for ( auto const& [c, v] : counters )
+    {
+      if ( !first )
+        os << ',';
+      first = false;
+      os << fmt::format( "\"{}\":{}", escape( c ), v );
+    }
+    os << '}';
+  }
+
+  static void write_json_scope( std::ostream& os, profile_scope_data const& data )
+  {
+    os << fmt::format( "{{\"name\":\"{}\",\"calls\":{},\"time\":{:.9f},\"allocations\":{},\"allocated_bytes\":{},\"peak_bytes\":{},\"counters\":", escape( data.name ), data.calls, data.time_ns / 1e9, data.allocations, data.allocated_bytes, data.peak_bytes );
+    write_json_counters( os, data.counters );
+    os << ",\"children\":[";
+    for ( auto i = 0u; i < data.children.size(); ++i )
+    {
+      if ( i )
+        os << ',';
+      write_json_scope( os, data.children[i] );
+    }
+    os << "]}";
+  }
+
+private:
+  clock::time_point _epoch;
+  std::atomic<bool> _enabled{false};
+  std::atomic<bool> _record_events{false};
+  std::string _exit_file;
+
+  mutable std::mutex _mutex;
+  std::vector<std::unique_ptr<thread_buffer>> _buffers;
+};
+
+/*! \brief Scoped timer of the profiler
+ *
+ * Records the time between construction and destruction as scope `name`,
+ * nested into the scope that is open in the same thread.  Does nothing if
+ * the profiler is disabled at construction.
+ */
+class profile_scope
+{
+public:
+  /*! \brief Opens a scope.
+   *
+   * \param name Name of the scope (with static storage duration)
+   */
+  explicit profile_scope( char const* name )
+      : _active( profiler::instance().is_enabled() )
+  {
+    if ( _active )
+    {
+      profiler::instance().begin( name );
+    }
+  }
+
+  /*! \brief Closes the scope. */
+  ~profile_scope()
+  {
+    if ( _active )
+    {
+      profiler::instance().end();
+    }
+  }
+
+  profile_scope( profile_scope const& ) = delete;
+  profile_scope& operator=( profile_scope const& ) = delete;
+
+private:
+  bool _active;
+};
+
+/*! \brief Increments a counter of the profiler.
+ *
+ * The counter is attributed to the scope that is open in the calling
+ * thread.  Does nothing if the profiler is disabled.
+ *
+ * \param name Name of the counter (with static storage duration)
+ * \param value Increment
+ */
+inline void profile_counter( char const* name, uint64_t value = 1u )
+{
+  auto& p = profiler::instance();
+  if ( p.is_enabled() )
+  {
+    p.count( name, value );
+  }
+}
+
+/*! \brief Reports a heap allocation to the profiler.
+ *
+ * The allocation is attributed to the scope that is open in the calling
+ * thread.  Does nothing if the profiler is disabled.  The function may be
+ * called from a replaced global `operator new`; allocations made by the
+ * profiler itself are ignored.
+ *
+ * \param bytes Number of allocated bytes
+ */
+inline void profile_allocation( uint64_t bytes )
+{
+  if ( profiler::is_recording() )
+  {
+    return;
+  }
+  profiler::is_recording() = true;
+  auto& p = profiler::instance();
+  profiler::is_recording() = false;
+  if ( p.is_enabled() )
+  {
+    p.allocate( bytes );
+  }
+}
+
+/*! \brief Reports a heap deallocation to the profiler.
+ *
+ * \param bytes Number of freed bytes
+ */
+inline void profile_deallocation( uint64_t bytes )
+{
+  if ( profiler::is_recording() )
+  {
+    return;
+  }
+  profiler::is_recording() = true;
+  auto& p = profiler::instance();
+  profiler::is_recording() = false;
+  if ( p.is_enabled() )
+  {
+    p.deallocate( bytes );
+  }
+}
+
+/*! \brief Allocator that reports to the profiler
+ *
+ * A standard allocator that reports all allocations and deallocations with
+ * `profile_allocation` and `profile_deallocation`.  It can be used for
+ * containers of algorithms, whose memory should be attributed to the scope
+ * of the algorithm.
+ *
+ * **Example**
+
+   \verbatim embed:rst
+
+   .. code-block:: c++
+
+      std::vector<uint32_t, tracking_allocator<uint32_t>> values;
+   \endverbatim
+ */
+template<typename T>
+struct tracking_allocator
+{
+  using value_type = T;
+
+  tracking_allocator() = default;
+
+  template<typename U>
+  tracking_allocator( tracking_allocator<U> const& ) noexcept
+  {
+  }
+
+  T* allocate( std::size_t n )
+  {
+    auto* p = std::allocator<T>().allocate( n );
+    profile_allocation( n * sizeof( T ) );
+    return p;
+  }
+
+  void deallocate( T* p, std::size_t n ) noexcept
+  {
+    profile_deallocation( n * sizeof( T ) );
+    std::allocator<T>().deallocate( p, n );
+  }
+
+  template<typename U>
+  bool operator==( tracking_allocator<U> const& ) const noexcept
+  {
+    return true;
+  }
+
+  template<typename U>
+  bool operator!=( tracking_allocator<U> const& ) const noexcept
+  {
+    return false;
+  }
+};
+
+} // namespace mockturtle
@@ -38,6 +38,8 @@
 
 #include <fmt/format.h>
 
+#include "profiler.hpp"
+
 namespace mockturtle
 {
 
@@ -84,6 +86,22 @@ public:
   {
   }
 
+  /*! \brief Constructor with profiler scope.
+   *
+   * Starts tracking time and, if the profiler is enabled, opens a profiler
+   * scope with the given name (see `profile_scope`).
+   */
+  stopwatch( duration& dur, char const* name )
+      : dur( dur ),
+        name( profiler::instance().is_enabled() ? name : nullptr )
+  {
+    if ( this->name )
+    {
+      profiler::instance().begin( this->name );
+    }
+    beg = clock::now();
+  }
+
   /*! \brief Default deconstructor.
    *
    * Stops tracking time and updates duration.
@@ -91,10 +109,15 @@ public:
   ~stopwatch()
   {
     dur += ( clock::now() - beg );
+    if ( name )
+    {
+      profiler::instance().end();
+    }
   }
 
 private:
   duration& dur;
+  char const* name{nullptr};
   time_point beg;
 };
 
@@ -125,6 +148,22 @@ std::invoke_result_t<Fn> call_with_stopwatch( typename Clock::duration& dur, Fn&
   return fn();
 }
 
+/*! \brief Calls a function and tracks time in a profiler scope.
+ *
+ * Same as `call_with_stopwatch( dur, fn )`, but also records the time in
+ * the profiler scope `name` if the profiler is enabled.
+ *
+ * \param dur Duration reference (time will be added to it)
+ * \param name Name of the profiler scope (with static storage duration)
+ * \param fn Callable object with no arguments
+ */
+template<class Fn, class Clock = std::chrono::steady_clock>
+std::invoke_result_t<Fn> call_with_stopwatch( typename Clock::duration& dur, char const* name, Fn&& fn )
+{
+  stopwatch<Clock> t( dur, name );
+  return fn();
+}
+
 /*! \brief Constructs an object and calls time.
  *
  * This function can track the time for the construction of an object and
@@ -0,0 +1,585 @@
+/* mockturtle: C++ logic network library
+ * Copyright (C) 2018-2020  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file thread_pool.hpp
+  \brief Thread pool with work-stealing parallel loops
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../traits.hpp"
+#include "../views/topo_view.hpp"
+#include "node_map.hpp"
+
+namespace mockturtle
+{
+
+namespace detail
+{
+
+inline std::atomic<uint32_t>& default_num_threads_value()
+{
+  static std::atomic<uint32_t> value{[]() {
+    if ( auto const* env = std::getenv( "MOCKTURTLE_NUM_THREADS" ) )
+    {
+      if ( auto const n = std::strtoul( env, nullptr, 10 ); n > 0u )
+      {
+        return static_cast<uint32_t>( n );
+      }
+    }
+    return std::max( 1u, std::thread::hardware_concurrency() );
+  }()};
+  return value;
+}
+
+/* set in threads while they execute a job, nested jobs run inline */
+inline thread_local bool inside_thread_pool = false;
+
+} // namespace detail
+
+/*! \brief Returns the default number of threads.
+ *
+ * This is the number of threads used by algorithms whose `num_threads`
+ * parameter is 0.  It is initialized from the environment variable
+ * `MOCKTURTLE_NUM_THREADS` if set, and to the number of hardware threads
+ * otherwise.
+ */
+inline uint32_t default_num_threads()
+{
+  return detail::default_num_threads_value().load( std::memory_order_relaxed );
+}
+
+/*! \brief Sets the default number of threads.
+ *
+ * \param num_threads Number of threads (0 uses all hardware threads)
+ */
+inline void set_default_num_threads( uint32_t num_threads )
+{
+  detail::default_num_threads_value().store( num_threads == 0u ? std::max( 1u, std::thread::hardware_concurrency() ) : num_threads, std::memory_order_relaxed );
+}
+
+/*! \brief Resolves a `num_threads` parameter.
+ *
+ * Returns `num_threads` if it is positive, and the default number of
+ * threads otherwise.
+ */
+inline uint32_t resolve_num_threads( uint32_t num_threads )
+{
+  return num_threads == 0u ? default_num_threads() : num_threads;
+}
+
+/*! \brief Thread pool
+ *
+ * The pool keeps worker threads alive between jobs, such that algorithms
+ * can parallelize short loops (e.g., over the nodes of a single level)
+ * without paying for thread creation each time.  The calling thread takes
+ * part in every job as thread 0; worker threads are created on demand when
+ * a job asks for more threads than the pool has.
+ *
+ * Every job is run by a number of participating threads, each of which is
+ * identified by its thread index between 0 and the number of participants.
+ * Algorithms use the index to access per-thread scratch data (see
+ * `per_thread`), such that no synchronization is needed inside the loop
+ * body.  Jobs of different callers are executed one after another.  Jobs
+ * that are started from within a job run sequentially in the calling
+ * thread.
+ *
+ * Exceptions thrown by a job are rethrown in the calling thread after all
+ * participants have finished.
+ *
+ * **Example**
+
+   \verbatim embed:rst
+
+   .. code-block:: c++
+
+      std::vector<uint64_t> values( 1000 );
+      default_thread_pool().parallel_for( 0u, values.size(), [&]( uint64_t i, uint32_t ) {
+        values[i] = i * i;
+      } );
+   \endverbatim
+ */
+class thread_pool
+{
+public:
+  /*! \brief Constructor.
+   *
+   * \param num_threads Number of worker threads created upfront, including
+   *                    the calling thread
+   */
+  explicit thread_pool( uint32_t num_threads = 1u )
+  {
+    std::lock_guard<std::mutex> job_lock( _job_mutex );
+    reserve( num_threads );
+  }
+
+  ~thread_pool()
+  {
+    {
+      std::lock_guard<std::mutex> lock( _mutex );
+      _stop = true;
+    }
+    _start.notify_all();
+    for ( auto& t : _threads )
+    {
+      t.join();
+    }
+  }
+
+  thread_pool( thread_pool const& ) = delete;
+  thread_pool& operator=( thread_pool const& ) = delete;
+
+  /*! \brief Returns the number of threads, including the calling thread. */
+  uint32_t num_threads() const
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    return static_cast<uint32_t>( _threads.size() ) + 1u;
+  }
+
+  /*! \brief Runs a function in several threads.
+   *
+   * Calls `fn( thread_index )` once in each of `num_threads` threads and
+   * returns after all calls have finished.
+   *
+   * \param num_threads Number of threads (0 uses the default number of threads)
+   * \param fn Function to call
+   */
+  template<class Fn>
+  void run( uint32_t num_threads, Fn&& fn )
+  {
+    num_threads = resolve_num_threads( num_threads );
+    if ( num_threads == 1u || detail::inside_thread_pool )
+    {
+      for ( auto t = 0u; t < num_threads; ++t )
+      {
+        fn( t );
+      }
+      return;
+    }
+
+    std::lock_guard<std::mutex> job_lock( _job_mutex );
+    reserve( num_threads );
+
+    {
+      std::lock_guard<std::mutex> lock( _mutex );
+      _job = std::ref( fn );
+      _participants = num_threads;
+      _pending = num_threads - 1u;
+      _exception = nullptr;
+      ++_generation;
+    }
+    _start.notify_all();
+
+    execute( 0u );
+
+    std::unique_lock<std::mutex> lock( _mutex );
+    _finished.wait( lock, [&]() { return _pending == 0u; } );
+    _job = nullptr;
+    if ( _exception )
+    {
+      std::rethrow_exception( std::exchange( _exception, nullptr ) );
+    }
+  }
+
+  /*! \brief Parallel loop over an index range.
+   *
+   * Calls `fn( i, thread_index )` for every `i` in `[begin, end)`.  The
+   * range is split evenly among the threads, each of which processes its
+   * part in chunks of `grain` indexes.  Threads that run out of work steal
+   * the upper half of the remaining range of another thread, such that
+   * uneven work per index is balanced.  The assignment of indexes to
+   * threads is not deterministic; algorithms that need deterministic
+   * results store them per index and combine them afterwards.
+   *
+   * \param begin First index
+   * \param end End index (exclusive)
+   * \param fn Loop body
+   * \param num_threads Number of threads (0 uses the default number of threads)
+   * \param grain Number of indexes that are processed in one chunk
+   */
+  template<class Fn>
+  void parallel_for( uint64_t begin, uint64_t end, Fn&& fn, uint32_t num_threads = 0u, uint64_t grain = 1u )
+  {
+    if ( begin >= end )
+    {
+      return;
+    }
+
+    grain = std::max<uint64_t>( grain, 1u );
+    num_threads = static_cast<uint32_t>( std::min<uint64_t>( resolve_num_threads( num_threads ), ( end - begin + grain - 1u ) / grain ) );
+    if ( num_threads <= 1u || detail::inside_thread_pool )
+    {
+      for ( auto i = begin; i < end; ++i )
+      {
+        fn( i, 0u );
+      }
+      return;
+    }
+
+    std::vector<range_slot> slots( num_threads );
+    uint64_t const size = end - begin;
+    for ( auto t = 0u; t < num_threads; ++t )
+    {
+      slots[t].lo = begin + size * t / num_threads;
+      slots[t].hi = begin + size * ( t + 1u ) / num_threads;
+    }
+
+    /* stops all threads once one of them throws */
+    std::atomic<bool> failed{false};
+    run( num_threads, [&]( uint32_t t ) {
+      auto& own = slots[t];
+      while ( !failed.load( std::memory_order_relaxed ) )
+      {
+        uint64_t lo, hi;
+        {
+          std::lock_guard<std::mutex> lock( own.mutex );
+          lo = own.lo;
+          hi = std::min( own.hi, lo + grain );
+          own.lo = hi;
+        }
+
+        if ( lo < hi )
+        {
+          try
+          {
+            for ( auto i = lo; i < hi; ++i )
+            {
+              fn( i, t );
+            }
+          }
+          catch ( ... )
+          {
+            failed = true;
+            throw;
+          }
+          continue;
+        }
+
+        if ( !steal( slots, t ) )
+        {
+          return;
+        }
+      }
+    } );
+  }
+
+  /*! \brief Parallel loop over a random access container.
+   *
+   * Calls `fn( element, index, thread_index )` for every element.
+   */
+  template<class Container, class Fn>
+  void parallel_foreach( Container&& elements, Fn&& fn, uint32_t num_threads = 0u, uint64_t grain = 1u )
+  {
+    auto const first = std::begin( elements );
+    parallel_for(
+        0u, std::size( elements ), [&]( uint64_t i, uint32_t t ) {
+          fn( *( first + i ), i, t );
+        },
+        num_threads, grain );
+  }
+
+private:
+  struct alignas( 64 ) range_slot
+  {
+    std::mutex mutex;
+    uint64_t lo{0u};
+    uint64_t hi{0u};
+  };
+
+  /* moves the upper half of the largest remaining range of another thread
+   * into the (empty) range of thread t, returns false if there is nothing
+   * left to steal */
+  static bool steal( std::vector<range_slot>& slots, uint32_t t )
+  {
+    uint32_t const n = static_cast<uint32_t>( slots.size() );
+    for ( auto k = 1u; k < n; ++k )
+    {
+      auto& victim = slots[( t + k ) % n];
+      uint64_t lo, hi;
+      {
+        std::lock_guard<std::mutex> lock( victim.mutex );
+        if ( victim.lo >= victim.hi )
+        {
+          continue;
+        }
+        hi = victim.hi;
+        lo = victim.lo + ( victim.hi - victim.lo ) / 2u;
+        victim.hi = lo;
+      }
+
+      std::lock_guard<std::mutex> lock( slots[t].mutex );
+      slots[t].lo = lo;
+      slots[t].hi = hi;
+      return true;
+    }
+    return false;
+  }
+
+  /* must hold _job_mutex */
+  void reserve( uint32_t num_threads )
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    while ( _threads.size() + 1u < num_threads )
+    {
+      auto const index = static_cast<uint32_t>( _threads.size() ) + 1u;
+      _threads.emplace_back( [this, index, generation = _generation]() { worker( index, generation ); } );
+    }
+  }
+
+  void execute( uint32_t index )
+  {
+    detail::inside_thread_pool = true;
+    try
+    {
+      _job( index );
+    }
+    catch ( ... )
+    {
+      std::lock_guard<std::mutex> lock( _mutex );
+      if ( !_exception )
+      {
+        _exception = std::current_exception();
+      }
+    }
+    detail::inside_thread_pool = false;
+  }
+
+  void worker( uint32_t index, uint64_t generation )
+  {
+    while ( true )
+    {
+      {
+        std::unique_lock<std::mutex> lock( _mutex );
+        _start.wait( lock, [&]() { return _stop || _generation != generation; } );
+        if ( _stop )
+        {
+          return;
+        }
+        generation = _generation;
+        if ( index >= _participants )
+        {
+          continue;
+        }
+      }
+
+      execute( index );
+
+      bool last{false};
+      {
+        std::lock_guard<std::mutex> lock( _mutex );
+        last = --_pending == 0u;
+      }
+      if ( last )
+      {
+        _finished.notify_one();
+      }
+    }
+  }
+
+private:
+  std::mutex _job_mutex;
+  mutable std::mutex _mutex;
+  std::condition_variable _start;
+  std::condition_variable _finished;
+  std::vector<std::thread> _threads;
+
+  std::function<void( uint32_t )> _job;
+  uint32_t _participants{0u};
+  uint32_t _pending{0u};
+  uint64_t _generation{0u};
+  std::exception_ptr _exception;
+  bool _stop{false};
+};
+
+/*! \brief Returns the process-wide thread pool.
+ *
+ * The pool is shared by all algorithms and grows to the largest number of
+ * threads that has been requested.
+ */
+inline thread_pool& default_thread_pool()
+{
+  static thread_pool pool;
+  return pool;
+}
+
+/*! \brief Per-thread scratch storage
+ *
+ * Holds one element for each thread of a parallel job, indexed by the
+ * thread index.  Elements are created on first access by calling the
+ * factory, in the thread that accesses them; since every thread only
+ * accesses its own element, this needs no synchronization.  Elements are
+ * stored in separate allocations to avoid false sharing.
+ *
+ * **Example**
+
+   \verbatim embed:rst
+
+   .. code-block:: c++
+
+      per_thread<std::vector<uint32_t>> buffers( num_threads );
+      default_thread_pool().parallel_for( 0u, n, [&]( uint64_t i, uint32_t t ) {
+        auto& buffer = buffers[t];
+        ...
+      }, num_threads );
+   \endverbatim
+ */
+template<class T>
+class per_thread
+{
+public:
+  /*! \brief Constructor.
+   *
+   * \param num_threads Number of threads
+   * \param factory Function that returns a new element
+   */
+  explicit per_thread( uint32_t num_threads, std::function<std::unique_ptr<T>()> factory = []() { return std::make_unique<T>(); } )
+      : _elements( num_threads ), _factory( std::move( factory ) )
+  {
+  }
+
+  /*! \brief Returns the element of a thread, creates it if needed. */
+  T& operator[]( uint32_t thread_index )
+  {
+    auto& e = _elements[thread_index];
+    if ( !e )
+    {
+      e = _factory();
+    }
+    return *e;
+  }
+
+  /*! \brief Returns whether the element of a thread has been created. */
+  bool has( uint32_t thread_index ) const
+  {
+    return static_cast<bool>( _elements[thread_index] );
+  }
+
+  /*! \brief Returns the number of threads. */
+  uint32_t size() const
+  {
+    return static_cast<uint32_t>( _elements.size() );
+  }
+
+  /*! \brief Calls `fn( element, thread_index )` for all created elements in order of thread index. */
+  template<class Fn>
+  void foreach_element( Fn&& fn )
+  {
+    for ( auto t = 0u; t < _elements.size(); ++t )
+    {
+      if ( _elements[t] )
+      {
+        fn( *_elements[t], t );
+      }
+    }
+  }
+
+  /*! \brief Destroys all elements, they are recreated on next access. */
+  void clear()
+  {
+    for ( auto& e : _elements )
+    {
+      e.reset();
+    }
+  }
+
+private:
+  std::vector<std::unique_ptr<T>> _elements;
+  std::function<std::unique_ptr<T>()> _factory;
+};
+
+/*! \brief Groups the gates of a network by level.
+ *
+ * Returns a vector whose entry `l` contains the gates whose longest path
+ * from a primary input has length `l + 1`, in topological order.  The
+ * gates of one level do not depend on each other and can be processed in
+ * parallel.
+ */
+template<class Ntk>
+std::vector<std::vector<node<Ntk>>> levelize( Ntk const& ntk )
+{
+  static_assert( is_network_type_v<Ntk>, "Ntk is not a network type" );
+  static_assert( has_foreach_fanin_v<Ntk>, "Ntk does not implement the foreach_fanin method" );
+
+  std::vector<std::vector<node<Ntk>>> levels;
+  node_map<uint32_t, Ntk> level( ntk, 0u );
+  topo_view<Ntk>{ntk}.foreach_node( [&]( auto const& n ) {
+    if ( ntk.is_constant( n ) || ntk.is_pi( n ) )
+    {
+      return;
+    }
+    uint32_t l{0u};
+    ntk.foreach_fanin( n, [&]( auto const& f ) {
+      l = std::max( l, level[f] );
+    } );
+    level[n] = l + 1u;
+    if ( levels.size() <= l )
+    {
+      levels.resize( l + 1u );
+    }
+    levels[l].push_back( n );
+  } );
+  return levels;
+}
+
+/*! \brief Level-synchronous traversal.
+ *
+ * Processes the levels of `levels` (see `levelize`) one after another.  The
+ * nodes of each level are processed in parallel by calling
+ * `fn( n, index, thread_index )`, where `index` is the position of `n` in
+ * its level.  After a level has been processed, `sync( level_index )` is
+ * called in the calling thread, e.g., to update the network with the
+ * results of the level before the next level is processed.
+ *
+ * \param levels Nodes grouped by level
+ * \param fn Function called for each node
+ * \param sync Function called after each level
+ * \param num_threads Number of threads (0 uses the default number of threads)
+ * \param pool Thread pool
+ */
+template<class Node, class Fn, class SyncFn>
+void wavefront( std::vector<std::vector<Node>> const& levels, Fn&& fn, SyncFn&& sync, uint32_t num_threads = 0u, thread_pool& pool = default_thread_pool() )
+{
+  for ( auto l = 0u; l < levels.size(); ++l )
+  {
+    pool.parallel_foreach( levels[l], fn, num_threads );
+    sync( l );
+  }
+}
+
+} // namespace mockturtle
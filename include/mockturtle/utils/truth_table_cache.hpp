@@ -39,6 +39,8 @@
 #include <kitty/operations.hpp>
 #include <kitty/operators.hpp>
 
+#include "memory.hpp"
+
 namespace mockturtle
 {
 
@@ -108,6 +110,12 @@ public:
   /*! \brief Returns number of normalized truth tables in the cache. */
   auto size() const { return _data.size(); }
 
+  /*! \brief Returns memory used by the cache (in bytes). */
+  uint64_t memory_usage() const
+  {
+    return sizeof( *this ) + heap_memory_usage( _indexes ) + heap_memory_usage( _data );
+  }
+
 private:
   std::unordered_map<TT, uint32_t, kitty::hash<TT>> _indexes;
   std::vector<TT> _data;
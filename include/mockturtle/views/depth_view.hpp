@@ -198,6 +198,12 @@ public:
     _depth = std::max( _depth, _levels[f] );
   }
 
+  /*! \brief Memory used by the network and the levels (in bytes). */
+  uint64_t memory_usage() const
+  {
+    return Ntk::memory_usage() + _levels.memory_usage() + _crit_path.memory_usage();
+  }
+
 private:
   uint32_t compute_levels( node const& n )
   {
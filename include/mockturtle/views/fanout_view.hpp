@@ -193,6 +193,12 @@ public:
     return _fanout[n];
   }
 
+  /*! \brief Memory used by the network and the fanout lists (in bytes). */
+  uint64_t memory_usage() const
+  {
+    return Ntk::memory_usage() + _fanout.memory_usage();
+  }
+
   void substitute_node( node const& old_node, signal const& new_signal )
   {
     std::stack<std::pair<node, signal>> to_substitute;
@@ -37,6 +37,7 @@
 
 #include "../networks/detail/foreach.hpp"
 #include "../traits.hpp"
+#include "../utils/memory.hpp"
 #include "../utils/truth_table_cache.hpp"
 #include "../views/immutable_view.hpp"
 
@@ -58,6 +59,11 @@ struct mapping_view_storage<true>
   uint32_t mapping_size{0};
   std::vector<uint32_t> functions;
   truth_table_cache<kitty::dynamic_truth_table> cache;
+
+  uint64_t memory_usage() const
+  {
+    return sizeof( *this ) + heap_memory_usage( mappings ) + heap_memory_usage( functions ) + heap_memory_usage( cache );
+  }
 };
 
 template<>
@@ -65,6 +71,11 @@ struct mapping_view_storage<false>
 {
   std::vector<uint32_t> mappings;
   uint32_t mapping_size{0};
+
+  uint64_t memory_usage() const
+  {
+    return sizeof( *this ) + heap_memory_usage( mappings );
+  }
 };
 
 } // namespace detail
@@ -233,6 +244,12 @@ public:
                                                                          [&]( auto i ) { return this->index_to_node( i ); }, fn );
   }
 
+  /*! \brief Memory used by the network and the mapping (in bytes). */
+  uint64_t memory_usage() const
+  {
+    return Ntk::memory_usage() + _mapping_storage->memory_usage();
+  }
+
 private:
   std::shared_ptr<detail::mapping_view_storage<StoreFunction>> _mapping_storage;
 };
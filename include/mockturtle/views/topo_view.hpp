@@ -38,6 +38,7 @@
 
 #include "../networks/detail/foreach.hpp"
 #include "../traits.hpp"
+#include "../utils/memory.hpp"
 #include "immutable_view.hpp"
 
 namespace mockturtle
@@ -211,6 +212,12 @@ public:
     }
   }
 
+  /*! \brief Memory used by the network and the topological order (in bytes). */
+  uint64_t memory_usage() const
+  {
+    return Ntk::memory_usage() + heap_memory_usage( topo_order );
+  }
+
 private:
   void create_topo_rec( node const& n )
   {
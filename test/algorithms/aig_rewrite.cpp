@@ -0,0 +1,66 @@
+#include <catch.hpp>
+
+#include <vector>
+
+#include <kitty/static_truth_table.hpp>
+#include <mockturtle/algorithms/aig_rewrite.hpp>
+#include <mockturtle/algorithms/cleanup.hpp>
+#include <mockturtle/algorithms/simulation.hpp>
+#include <mockturtle/generators/arithmetic.hpp>
+#include <mockturtle/networks/aig.hpp>
+
+using namespace mockturtle;
+
+TEST_CASE( "AIG rewriting of redundant majority", "[aig_rewrite]" )
+{
+  aig_network aig;
+  const auto a = aig.create_pi();
+  const auto b = aig.create_pi();
+  const auto c = aig.create_pi();
+
+  /* majority with 5 gates instead of 4 */
+  const auto f = aig.create_or( aig.create_or( aig.create_and( a, b ), aig.create_and( a, c ) ), aig.create_and( b, c ) );
+  aig.create_po( f );
+  CHECK( aig.num_gates() == 5u );
+  const auto tt = simulate<kitty::static_truth_table<3u>>( aig )[0];
+
+  aig_rewrite_stats st;
+  aig_rewrite( aig, {}, &st );
+  aig = cleanup_dangling( aig );
+
+  CHECK( st.num_rewrites == 1u );
+  CHECK( aig.num_gates() == 4u );
+  CHECK( simulate<kitty::static_truth_table<3u>>( aig )[0] == tt );
+}
+
+TEST_CASE( "AIG rewriting of a multiplier", "[aig_rewrite]" )
+{
+  aig_network aig;
+  std::vector<aig_network::signal> a( 4 ), b( 4 );
+  std::generate( a.begin(), a.end(), [&]() { return aig.create_pi(); } );
+  std::generate( b.begin(), b.end(), [&]() { return aig.create_pi(); } );
+  for ( auto const& f : carry_ripple_multiplier( aig, a, b ) )
+  {
+    aig.create_po( f );
+  }
+  const auto tts = simulate<kitty::static_truth_table<8u>>( aig );
+  const auto num_gates = aig.num_gates();
+
+  /* zero-gain rewriting restructures the network without growing it */
+  aig_rewrite_params ps;
+  ps.allow_zero_gain = true;
+  aig_rewrite_stats st;
+  aig_rewrite( aig, ps, &st );
+  CHECK( st.num_rewrites > 0u );
+  CHECK( aig.num_gates() + st.estimated_gain == num_gates );
+
+  /* rewriting again works on the same network */
+  const auto num_gates2 = aig.num_gates();
+  aig_rewrite( aig, {}, &st );
+  CHECK( aig.num_gates() + st.estimated_gain == num_gates2 );
+
+  /* substituted nodes are not in topological order anymore */
+  aig = cleanup_dangling( aig );
+  CHECK( aig.num_gates() == num_gates2 - st.estimated_gain );
+  CHECK( simulate<kitty::static_truth_table<8u>>( aig ) == tts );
+}
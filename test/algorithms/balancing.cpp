@@ -3,9 +3,17 @@
 #include <algorithm>
 #include <vector>
 
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+#include <kitty/esop.hpp>
+#include <kitty/isop.hpp>
+#include <kitty/operations.hpp>
+#include <kitty/static_truth_table.hpp>
+
 #include <mockturtle/algorithms/balancing.hpp>
 #include <mockturtle/algorithms/balancing/sop_balancing.hpp>
 #include <mockturtle/algorithms/balancing/esop_balancing.hpp>
+#include <mockturtle/algorithms/simulation.hpp>
 #include <mockturtle/generators/arithmetic.hpp>
 #include <mockturtle/networks/aig.hpp>
 #include <mockturtle/networks/xag.hpp>
@@ -44,3 +52,94 @@ TEST_CASE( "Rebalance XAG adder using ESOP balancing", "[balancing]" )
   xag = balancing( xag, {esop_rebalancing<xag_network>{}} );
   CHECK( depth_view{xag}.depth() == 22u );
 }
+
+TEST_CASE( "Cover cache maps covers of NPN representatives", "[balancing]" )
+{
+  cover_cache sop_cache, esop_cache;
+
+  kitty::dynamic_truth_table func( 5u );
+  for ( auto i = 0u; i < 200u; ++i )
+  {
+    kitty::create_random( func, i );
+
+    /* some transformations of the same function */
+    for ( auto const& f : {func, kitty::flip( func, 2u ), kitty::swap( func, 0u, 4u ), ~func} )
+    {
+      const auto sop = sop_cache.get( f, []( auto const& g ) { return kitty::isop( g ); } );
+      kitty::dynamic_truth_table from_sop( 5u );
+      kitty::create_from_cubes( from_sop, sop );
+      CHECK( from_sop == f );
+
+      const auto esop = esop_cache.get( f, []( auto const& g ) { return kitty::esop_from_pprm( g ); } );
+      kitty::dynamic_truth_table from_esop( 5u );
+      kitty::create_from_cubes( from_esop, esop, true );
+      CHECK( from_esop == f );
+    }
+  }
+
+  CHECK( sop_cache.hits() + sop_cache.class_hits() + sop_cache.misses() == 800u );
+  CHECK( sop_cache.class_hits() > 0u );
+  CHECK( sop_cache.num_classes() < sop_cache.size() );
+}
+
+TEST_CASE( "Share covers between balancing runs", "[balancing]" )
+{
+  aig_network aig;
+  std::vector<aig_network::signal> as( 4u ), bs( 4u );
+  std::generate( as.begin(), as.end(), [&]() { return aig.create_pi(); } );
+  std::generate( bs.begin(), bs.end(), [&]() { return aig.create_pi(); } );
+  for ( auto const& f : carry_ripple_multiplier( aig, as, bs ) )
+  {
+    aig.create_po( f );
+  }
+
+  sop_rebalancing<aig_network> sop_balancing;
+  balancing_params ps;
+  ps.cut_enumeration_ps.cut_size = 6u;
+
+  const auto aig1 = balancing( aig, {sop_balancing}, ps );
+  const auto misses = sop_balancing.covers->misses();
+  CHECK( misses > 0u );
+  CHECK( sop_balancing.covers->class_hits() > 0u );
+
+  const auto aig2 = balancing( aig, {sop_balancing}, ps );
+  CHECK( sop_balancing.covers->misses() == misses );
+  CHECK( depth_view{aig2}.depth() == depth_view{aig1}.depth() );
+  CHECK( aig2.num_gates() == aig1.num_gates() );
+  CHECK( simulate<kitty::static_truth_table<8u>>( aig1 ) == simulate<kitty::static_truth_table<8u>>( aig ) );
+  CHECK( simulate<kitty::static_truth_table<8u>>( aig2 ) == simulate<kitty::static_truth_table<8u>>( aig ) );
+}
+
+TEST_CASE( "Rebalance nodes of the same level in parallel", "[balancing]" )
+{
+  aig_network aig;
+  std::vector<aig_network::signal> as( 4u ), bs( 4u );
+  std::generate( as.begin(), as.end(), [&]() { return aig.create_pi(); } );
+  std::generate( bs.begin(), bs.end(), [&]() { return aig.create_pi(); } );
+  for ( auto const& f : carry_ripple_multiplier( aig, as, bs ) )
+  {
+    aig.create_po( f );
+  }
+
+  balancing_params ps;
+  ps.cut_enumeration_ps.cut_size = 4u;
+  const auto sequential = balancing( aig, {sop_rebalancing<aig_network>{}}, ps );
+
+  for ( auto num_threads : {2u, 3u} )
+  {
+    ps.num_threads = num_threads;
+    const auto parallel = balancing( aig, {sop_rebalancing<aig_network>{}}, ps );
+    CHECK( depth_view{parallel}.depth() == depth_view{sequential}.depth() );
+    CHECK( parallel.num_gates() == sequential.num_gates() );
+    CHECK( simulate<kitty::static_truth_table<8u>>( parallel ) == simulate<kitty::static_truth_table<8u>>( aig ) );
+  }
+
+  ps.only_on_critical_path = true;
+  ps.num_threads = 1u;
+  const auto critical = balancing( aig, {sop_rebalancing<aig_network>{}}, ps );
+  ps.num_threads = 2u;
+  const auto critical_parallel = balancing( aig, {sop_rebalancing<aig_network>{}}, ps );
+  CHECK( depth_view{critical_parallel}.depth() == depth_view{critical}.depth() );
+  CHECK( critical_parallel.num_gates() == critical.num_gates() );
+  CHECK( simulate<kitty::static_truth_table<8u>>( critical_parallel ) == simulate<kitty::static_truth_table<8u>>( aig ) );
+}
@@ -0,0 +1,160 @@
+#include <catch.hpp>
+
+#include <vector>
+
+#include <mockturtle/algorithms/bounded_model_checking.hpp>
+#include <mockturtle/algorithms/sequential_simulation.hpp>
+#include <mockturtle/networks/aig.hpp>
+#include <mockturtle/networks/xag.hpp>
+
+using namespace mockturtle;
+
+namespace
+{
+
+/* 3-bit counter with enable; the single output is 1 if the counter is 5 */
+template<class Ntk>
+Ntk counter_network()
+{
+  Ntk ntk;
+  auto const en = ntk.create_pi();
+  auto const q0 = ntk.create_ro();
+  auto const q1 = ntk.create_ro();
+  auto const q2 = ntk.create_ro();
+
+  auto const c1 = ntk.create_and( q0, en );
+  auto const c2 = ntk.create_and( q1, c1 );
+  ntk.create_po( ntk.create_and( ntk.create_and( q0, !q1 ), q2 ) );
+  ntk.create_ri( ntk.create_xor( q0, en ) );
+  ntk.create_ri( ntk.create_xor( q1, c1 ) );
+  ntk.create_ri( ntk.create_xor( q2, c2 ) );
+  return ntk;
+}
+
+/* replays a counter-example and returns the output in the last frame */
+template<class Ntk>
+bool replay( Ntk const& ntk, bmc_result const& r, uint32_t po )
+{
+  sequential_simulator<Ntk> sim( ntk );
+  std::vector<uint64_t> pi_words( ntk.num_pis() ), po_words;
+  for ( auto const& values : r.inputs )
+  {
+    for ( auto i = 0u; i < values.size(); ++i )
+    {
+      pi_words[i] = values[i] ? 1u : 0u;
+    }
+    sim.step( pi_words );
+  }
+  sim.output_values( po_words );
+  return ( po_words[po] & 1u ) != 0u;
+}
+
+} // namespace
+
+TEST_CASE( "BMC finds counter-example with SAT", "[bounded_model_checking]" )
+{
+  auto const aig = counter_network<aig_network>();
+
+  bounded_model_checking_params ps;
+  ps.num_frames = 8u;
+  ps.simulation_filter = false;
+  bounded_model_checking_stats st;
+  auto const results = bounded_model_checking( aig, ps, &st );
+
+  REQUIRE( results.size() == 1u );
+  CHECK( results[0].status == bmc_status::falsified );
+  CHECK( results[0].depth == 5u );
+  CHECK( results[0].inputs.size() == 6u );
+  CHECK( st.num_frames == 6u );
+  CHECK( st.num_sat_calls > 0u );
+  CHECK( replay( aig, results[0], 0u ) );
+
+  /* not reachable within 5 frames */
+  ps.num_frames = 5u;
+  auto const bounded = bounded_model_checking( aig, ps );
+  CHECK( bounded[0].status == bmc_status::holds );
+  CHECK( bounded[0].depth == 5u );
+}
+
+TEST_CASE( "BMC with simulation filter", "[bounded_model_checking]" )
+{
+  auto const xag = counter_network<xag_network>();
+
+  bounded_model_checking_params ps;
+  ps.num_frames = 8u;
+  bounded_model_checking_stats st;
+  auto const results = bounded_model_checking( xag, ps, &st );
+
+  REQUIRE( results.size() == 1u );
+  CHECK( results[0].status == bmc_status::falsified );
+  CHECK( results[0].depth == 5u );
+  CHECK( st.num_sim_falsified == 1u );
+  CHECK( st.num_sat_calls == 0u );
+  CHECK( replay( xag, results[0], 0u ) );
+}
+
+TEST_CASE( "BMC proves bounded safety and handles nondeterministic reset", "[bounded_model_checking]" )
+{
+  aig_network aig;
+  auto const a = aig.create_pi();
+  auto const q0 = aig.create_ro();
+  auto const q1 = aig.create_ro();
+  auto const q2 = aig.create_ro();
+
+  /* q0 and q1 hold the same value in every cycle; q2 starts with any value */
+  aig.create_po( aig.create_xor( q0, q1 ) );
+  aig.create_po( aig.create_and( q2, !a ) );
+  aig.create_ri( aig.create_xor( q0, a ), 1 );
+  aig.create_ri( !aig.create_xor( !q1, a ), 1 );
+  aig.create_ri( q2, -1 );
+
+  bounded_model_checking_params ps;
+  ps.num_frames = 6u;
+  ps.simulation_filter = false;
+  auto const results = bounded_model_checking( aig, ps );
+
+  REQUIRE( results.size() == 2u );
+  CHECK( results[0].status == bmc_status::holds );
+  CHECK( results[0].depth == 6u );
+
+  CHECK( results[1].status == bmc_status::falsified );
+  CHECK( results[1].depth == 0u );
+  REQUIRE( results[1].initial_state.size() == 3u );
+  CHECK( results[1].initial_state[0] );
+  CHECK( results[1].initial_state[1] );
+  CHECK( results[1].initial_state[2] );
+  CHECK( !results[1].inputs[0][0] );
+}
+
+TEST_CASE( "BMC falsifies constant outputs without SAT", "[bounded_model_checking]" )
+{
+  aig_network aig;
+  auto const a = aig.create_pi();
+  auto const q0 = aig.create_ro();
+  auto const q1 = aig.create_ro();
+
+  /* q0 is 1 in every cycle, q1 is 1 after the first cycle */
+  aig.create_po( q0 );
+  aig.create_po( aig.create_and( q1, a ) );
+  aig.create_ri( q0, 1 );
+  aig.create_ri( aig.get_constant( true ), 0 );
+
+  bounded_model_checking_params ps;
+  ps.num_frames = 4u;
+  ps.simulation_filter = false;
+  bounded_model_checking_stats st;
+  auto const results = bounded_model_checking( aig, ps, &st );
+
+  REQUIRE( results.size() == 2u );
+  CHECK( results[0].status == bmc_status::falsified );
+  CHECK( results[0].depth == 0u );
+  REQUIRE( results[0].inputs.size() == 1u );
+  REQUIRE( results[0].initial_state.size() == 2u );
+  CHECK( results[0].initial_state[0] );
+  CHECK( !results[0].initial_state[1] );
+  CHECK( replay( aig, results[0], 0u ) );
+
+  CHECK( results[1].status == bmc_status::falsified );
+  CHECK( results[1].depth == 1u );
+  CHECK( replay( aig, results[1], 1u ) );
+}
@@ -1,6 +1,7 @@
 #include <catch.hpp>
 
 #include <mockturtle/algorithms/circuit_validator.hpp>
+#include <mockturtle/generators/arithmetic.hpp>
 #include <mockturtle/networks/aig.hpp>
 #include <mockturtle/networks/xag.hpp>
 #include <mockturtle/networks/mig.hpp>
@@ -182,4 +183,123 @@ TEST_CASE( "Validating with ODC", "[validator]" )
   ps.odc_levels = 2;
   CHECK( *( v.validate( f1, false ) ) == true );
   CHECK( *( v.validate( aig.get_node( f1 ), aig.get_constant( false ) ) ) == true );
-}
\ No newline at end of file
+}
+
+TEST_CASE( "Validating circuits with ODC without push and pop", "[validator]" )
+{
+  aig_network aig;
+  auto const a = aig.create_pi();
+  auto const b = aig.create_pi();
+  auto const f1 = aig.create_and( !a, b );
+  auto const f2 = aig.create_and( a, !b );
+  auto const f3 = aig.create_or( f1, f2 ); // a ^ b
+  aig.create_po( f3 );
+
+  validator_params ps;
+  ps.odc_levels = 1;
+  fanout_view view{aig};
+  using validator_t = circuit_validator<fanout_view<aig_network>, bill::solvers::bsat2, false, false, true>;
+  validator_t v( view, ps );
+
+  using gate = validator_t::gate;
+  gate::fanin gi1{0, false};
+  gate::fanin gi2{1, false};
+  gate::fanin gi1_neg{0, true};
+  gate const g_and{{gi1_neg, gi2}, validator_t::gate_type::AND};
+  gate const g_xor{{gi1, gi2}, validator_t::gate_type::XOR};
+  gate const g_wrong{{gi1, gi2}, validator_t::gate_type::AND};
+
+  /* the gates of the circuit are constrained in the ODC window */
+  std::vector<node<aig_network>> const divs{aig.get_node( a ), aig.get_node( b )};
+  CHECK( *( v.validate( aig.get_node( f1 ), divs.begin(), divs.end(), {g_and} ) ) == true );
+  CHECK( *( v.validate( aig.get_node( f1 ), divs.begin(), divs.end(), {g_xor} ) ) == true );
+  CHECK( *( v.validate( aig.get_node( f1 ), divs.begin(), divs.end(), {g_wrong} ) ) == false );
+  CHECK( *( v.validate( aig.get_node( f1 ), divs.begin(), divs.end(), {g_and} ) ) == true );
+}
+
+TEST_CASE( "Reusing CNF encodings and validator pools", "[validator]" )
+{
+  aig_network aig;
+  auto const a = aig.create_pi();
+  auto const b = aig.create_pi();
+  auto const c = aig.create_pi();
+  auto const f1 = aig.create_and( a, b );
+  auto const f2 = aig.create_and( f1, c );
+  auto const f3 = aig.create_and( b, c );
+  auto const f4 = aig.create_and( a, f3 );
+  aig.create_po( f2 );
+  aig.create_po( f4 );
+
+  validator_params ps;
+  circuit_validator<aig_network, bill::solvers::bsat2, false, false, false> v( aig, ps );
+
+  CHECK( *( v.validate( f2, f4 ) ) == true );
+  CHECK( *( v.validate( f1, f3 ) ) == false );
+  CHECK( *( v.validate( f2, f4 ) ) == true ); /* retired miters do not constrain later calls */
+
+  auto const& st = v.stats();
+  CHECK( st.num_solve == 3u );
+  CHECK( st.num_unsat == 2u );
+  CHECK( st.num_sat == 1u );
+  CHECK( st.num_hits > 0u );
+  CHECK( st.num_retired_clauses == 6u );
+
+  validator_pool<circuit_validator<aig_network, bill::solvers::bsat2, false, false, false>> pool( aig, ps );
+  {
+    auto l1 = pool.acquire();
+    auto l2 = pool.acquire();
+    CHECK( *( l1->validate( f2, f4 ) ) == true );
+    CHECK( *( l2->validate( f1, f3 ) ) == false );
+  }
+  CHECK( pool.size() == 2u );
+  {
+    auto l = pool.acquire();
+    CHECK( *( l->validate( f4, f2 ) ) == true );
+  }
+  CHECK( pool.size() == 2u );
+  CHECK( pool.stats().num_solve == 3u );
+  CHECK( pool.stats().num_hits > 0u );
+}
+
+TEST_CASE( "Retired clauses do not cause restarts", "[validator]" )
+{
+  aig_network aig;
+  std::vector<aig_network::signal> a( 4u ), b( 4u );
+  std::generate( a.begin(), a.end(), [&]() { return aig.create_pi(); } );
+  std::generate( b.begin(), b.end(), [&]() { return aig.create_pi(); } );
+  for ( auto const& f : carry_ripple_multiplier( aig, a, b ) )
+  {
+    aig.create_po( f );
+  }
+
+  using validator_t = circuit_validator<aig_network>;
+  validator_t::gate g{{validator_t::gate::fanin{0, false}, validator_t::gate::fanin{1, true}}, validator_t::gate_type::AND};
+
+  std::vector<aig_network::node> gates;
+  aig.foreach_gate( [&]( auto const& n ) { gates.emplace_back( n ); } );
+
+  auto const validate_all = [&]( validator_t& v ) {
+    for ( auto i = 2u; i < gates.size(); ++i )
+    {
+      for ( auto j = 1u; j < i; ++j )
+      {
+        v.validate( gates[i], {gates[j - 1u], gates[j]}, {g}, false );
+      }
+    }
+  };
+
+  /* the clause limit is never reached, although Glucose drops the retired clauses */
+  validator_params ps;
+  ps.max_clauses = 1000000u;
+  validator_t v( aig, ps );
+  validate_all( v );
+  CHECK( v.stats().num_solve > 1000u );
+  CHECK( v.stats().num_retired_clauses > 1000u );
+  CHECK( v.stats().num_restarts == 0u );
+
+  /* the guarded clauses are retired, but the CNF of the network stays */
+  ps.max_clauses = 100u;
+  validator_t v_small( aig, ps );
+  validate_all( v_small );
+  CHECK( v_small.stats().num_restarts > 0u );
+}
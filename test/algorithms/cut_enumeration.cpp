@@ -4,7 +4,10 @@
 
 #include <kitty/constructors.hpp>
 #include <kitty/dynamic_truth_table.hpp>
+#include <kitty/operations.hpp>
+#include <kitty/static_truth_table.hpp>
 #include <mockturtle/algorithms/cut_enumeration.hpp>
+#include <mockturtle/generators/arithmetic.hpp>
 #include <mockturtle/networks/aig.hpp>
 #include <mockturtle/networks/klut.hpp>
 
@@ -176,6 +179,104 @@ TEST_CASE( "compute XOR network cuts in 2-LUT network", "[cut_enumeration]" )
   }
 }
 
+TEST_CASE( "compute static truth tables of AIG cuts", "[cut_enumeration]" )
+{
+  aig_network aig;
+
+  const auto a = aig.create_pi();
+  const auto b = aig.create_pi();
+  const auto f1 = aig.create_nand( a, b );
+  const auto f2 = aig.create_nand( f1, a );
+  const auto f3 = aig.create_nand( f1, b );
+  const auto f4 = aig.create_nand( f2, f3 );
+  aig.create_po( f4 );
+
+  const auto cuts = fast_cut_enumeration<aig_network, 4, true>( aig );
+
+  const auto i1 = aig.node_to_index( aig.get_node( f1 ) );
+  const auto i2 = aig.node_to_index( aig.get_node( f2 ) );
+  const auto i3 = aig.node_to_index( aig.get_node( f3 ) );
+  const auto i4 = aig.node_to_index( aig.get_node( f4 ) );
+
+  CHECK( cuts.cuts( i1 ).size() == 2 );
+  CHECK( cuts.cuts( i2 ).size() == 3 );
+  CHECK( cuts.cuts( i3 ).size() == 3 );
+  CHECK( cuts.cuts( i4 ).size() == 5 );
+
+  /* functions do not depend on the variables beyond the cut size */
+  CHECK( cuts.truth_table( cuts.cuts( i1 )[0] )._bits == 0x8888 );
+  CHECK( cuts.truth_table( cuts.cuts( i2 )[0] )._bits == 0x2222 );
+  CHECK( cuts.truth_table( cuts.cuts( i2 )[1] )._bits == 0x2222 );
+  CHECK( cuts.truth_table( cuts.cuts( i3 )[0] )._bits == 0x2222 );
+  CHECK( cuts.truth_table( cuts.cuts( i3 )[1] )._bits == 0x4444 );
+  CHECK( cuts.truth_table( cuts.cuts( i4 )[0] )._bits == 0x1111 );
+  CHECK( cuts.truth_table( cuts.cuts( i4 )[1] )._bits == 0x9999 );
+  CHECK( cuts.truth_table( cuts.cuts( i4 )[2] )._bits == 0x0d0d );
+  CHECK( cuts.truth_table( cuts.cuts( i4 )[3] )._bits == 0x0d0d );
+}
+
+TEST_CASE( "fast cut enumeration computes the same cuts", "[cut_enumeration]" )
+{
+  aig_network aig;
+  std::vector<aig_network::signal> a( 4 ), b( 4 );
+  std::generate( a.begin(), a.end(), [&]() { return aig.create_pi(); } );
+  std::generate( b.begin(), b.end(), [&]() { return aig.create_pi(); } );
+  for ( auto const& f : carry_ripple_multiplier( aig, a, b ) )
+  {
+    aig.create_po( f );
+  }
+
+  for ( auto cut_size : {4u, 6u} )
+  {
+    for ( auto minimize : {false, true} )
+    {
+      cut_enumeration_params ps;
+      ps.cut_size = cut_size;
+      ps.cut_limit = 8;
+      ps.minimize_truth_table = minimize;
+      const auto cuts = cut_enumeration<aig_network, true>( aig, ps );
+      const auto fast_cuts = fast_cut_enumeration<aig_network, 6, true>( aig, ps );
+
+      CHECK( fast_cuts.total_cuts() == cuts.total_cuts() );
+      aig.foreach_node( [&]( auto n ) {
+        auto const& set = cuts.cuts( aig.node_to_index( n ) );
+        auto const& fast_set = fast_cuts.cuts( aig.node_to_index( n ) );
+        CHECK( fast_set.size() == set.size() );
+        for ( auto i = 0u; i < std::min( set.size(), fast_set.size() ); ++i )
+        {
+          auto const& cut = set[i];
+          auto const& fast_cut = fast_set[i];
+          CHECK( std::vector<uint32_t>( fast_cut.begin(), fast_cut.end() ) == std::vector<uint32_t>( cut.begin(), cut.end() ) );
+
+          kitty::dynamic_truth_table tt( fast_cut.size() );
+          kitty::shrink_to_inplace( tt, fast_cuts.truth_table( fast_cut ) );
+          CHECK( tt == cuts.truth_table( cut ) );
+        }
+      } );
+    }
+  }
+}
+
+TEST_CASE( "merge fast cuts with leaves colliding modulo 64", "[cut_enumeration]" )
+{
+  using cut_t = fast_cut_type<6, true, empty_cut_data>;
+
+  cut_t c1, c2, c3, c4, res;
+  c1.set_leaves( std::vector<uint32_t>{1, 2, 3, 4, 5, 6} );
+  c2.set_leaves( std::vector<uint32_t>{65, 66, 67, 68, 69, 70} );
+  c3.set_leaves( std::vector<uint32_t>{3, 4, 65, 66} );
+  c4.set_leaves( std::vector<uint32_t>{5, 6} );
+
+  CHECK( c1.signature() == c2.signature() );
+  CHECK( !c1.merge( c2, res, 6 ) );
+  CHECK( !c1.merge( c2, res, 12 ) );
+  CHECK( !c1.merge( c3, res, 6 ) );
+
+  CHECK( c3.merge( c4, res, 6 ) );
+  CHECK( res.size() == 6u );
+  CHECK( std::vector<uint32_t>( res.begin(), res.end() ) == std::vector<uint32_t>{3, 4, 5, 6, 65, 66} );
+}
+
 TEST_CASE( "enumerate cuts for an AIG (small graph version)", "[fast_small_cut_enumeration]" )
 {
   aig_network aig;
@@ -1,6 +1,8 @@
 #include <catch.hpp>
 
 #include <mockturtle/algorithms/cut_rewriting.hpp>
+#include <mockturtle/algorithms/simulation.hpp>
+#include <mockturtle/generators/arithmetic.hpp>
 #include <mockturtle/algorithms/node_resynthesis/akers.hpp>
 #include <mockturtle/algorithms/node_resynthesis/exact.hpp>
 #include <mockturtle/algorithms/node_resynthesis/mig_npn.hpp>
@@ -209,6 +211,73 @@ TEST_CASE( "In-place cut rewriting with alternative costs", "[cut_rewriting]" )
   CHECK( *multiplicative_complexity( xag ) == 1 );
 }
 
+TEST_CASE( "In-place cut rewriting with parallel candidate synthesis", "[cut_rewriting]" )
+{
+  mig_network mig;
+  std::vector<mig_network::signal> a( 4 ), b( 4 );
+  std::generate( a.begin(), a.end(), [&]() { return mig.create_pi(); } );
+  std::generate( b.begin(), b.end(), [&]() { return mig.create_pi(); } );
+  for ( auto const& f : carry_ripple_multiplier( mig, a, b ) )
+  {
+    mig.create_po( f );
+  }
+
+  const auto tts = simulate<kitty::static_truth_table<8u>>( mig );
+
+  mig_npn_resynthesis resyn;
+  cut_rewriting_params ps;
+  ps.cut_enumeration_ps.cut_size = 4;
+
+  auto mig_seq = cleanup_dangling( mig );
+  cut_rewriting_with_compatibility_graph( mig_seq, resyn, ps );
+  mig_seq = cleanup_dangling( mig_seq );
+
+  for ( auto num_threads : {2u, 4u} )
+  {
+    auto mig_par = cleanup_dangling( mig );
+    ps.num_threads = num_threads;
+    cut_rewriting_with_compatibility_graph( mig_par, resyn, ps );
+    mig_par = cleanup_dangling( mig_par );
+
+    CHECK( mig_par.num_gates() == mig_seq.num_gates() );
+    CHECK( mig_par.num_gates() < mig.num_gates() );
+    CHECK( simulate<kitty::static_truth_table<8u>>( mig_par ) == tts );
+  }
+}
+
+TEST_CASE( "In-place cut rewriting with candidate cache", "[cut_rewriting]" )
+{
+  mig_network mig;
+  std::vector<mig_network::signal> a( 4 ), b( 4 );
+  std::generate( a.begin(), a.end(), [&]() { return mig.create_pi(); } );
+  std::generate( b.begin(), b.end(), [&]() { return mig.create_pi(); } );
+  for ( auto const& f : carry_ripple_multiplier( mig, a, b ) )
+  {
+    mig.create_po( f );
+  }
+
+  const auto tts = simulate<kitty::static_truth_table<8u>>( mig );
+
+  mig_npn_resynthesis resyn;
+  cut_rewriting_params ps;
+  ps.cut_enumeration_ps.cut_size = 4;
+
+  auto mig_ref = cleanup_dangling( mig );
+  cut_rewriting_with_compatibility_graph( mig_ref, resyn, ps );
+  mig_ref = cleanup_dangling( mig_ref );
+
+  auto mig_cache = cleanup_dangling( mig );
+  ps.use_candidate_cache = true;
+  cut_rewriting_stats st;
+  cut_rewriting_with_compatibility_graph( mig_cache, resyn, ps, &st );
+  mig_cache = cleanup_dangling( mig_cache );
+
+  CHECK( st.num_cache_misses > 0u );
+  CHECK( st.num_cache_hits > st.num_cache_misses );
+  CHECK( mig_cache.num_gates() == mig_ref.num_gates() );
+  CHECK( simulate<kitty::static_truth_table<8u>>( mig_cache ) == tts );
+}
+
 TEST_CASE( "Cut rewriting of bad MAJ", "[cut_rewriting]" )
 {
   mig_network mig;
@@ -461,3 +530,63 @@ TEST_CASE( "Cut rewriting with stacked depth-fanout views", "[cut_rewriting]" )
   CHECK( aig.num_pos() == 2 );
   CHECK( aig.num_gates() == 8 );
 }
+
+TEST_CASE( "Independent sets on the candidate conflict graph", "[cut_rewriting]" )
+{
+  /* path a - b - c with parallel edges and a self-loop, d isolated */
+  detail::graph g( {2, 3, 2, 1}, {{0, 1}, {1, 0}, {1, 2}, {2, 2}, {1, 2}} );
+  CHECK( g.num_vertices() == 4u );
+  CHECK( g.num_edges() == 2u );
+  CHECK( g.degree( 0 ) == 1u );
+  CHECK( g.degree( 1 ) == 2u );
+  CHECK( g.degree( 3 ) == 0u );
+
+  /* all of a, b, c have the same GWMIN value, b wins with the larger degree */
+  auto is = detail::maximum_weighted_independent_set_gwmin( g );
+  CHECK( is == std::vector<uint32_t>{1, 3} );
+
+  CHECK( detail::maximal_weighted_independent_set( g ) == std::vector<uint32_t>{0, 2, 3} );
+
+  /* local search swaps b for a and c */
+  detail::improve_independent_set( g, is, 1000u );
+  CHECK( is == std::vector<uint32_t>{3, 0, 2} );
+}
+
+TEST_CASE( "Cut rewriting with candidate cache", "[cut_rewriting]" )
+{
+  xag_network xag;
+  std::vector<xag_network::signal> a( 4 ), b( 4 );
+  std::generate( a.begin(), a.end(), [&]() { return xag.create_pi(); } );
+  std::generate( b.begin(), b.end(), [&]() { return xag.create_pi(); } );
+  for ( auto const& f : carry_ripple_multiplier( xag, a, b ) )
+  {
+    xag.create_po( f );
+  }
+
+  const auto tts = simulate<kitty::static_truth_table<8u>>( xag );
+
+  xag_npn_resynthesis<xag_network> resyn;
+  cut_rewriting_params ps;
+  ps.cut_enumeration_ps.cut_size = 4;
+
+  const auto xag_ref = cut_rewriting( xag, resyn, ps );
+
+  ps.use_candidate_cache = true;
+  cut_rewriting_stats st;
+  const auto xag_cache = cut_rewriting( xag, resyn, ps, &st );
+
+  CHECK( st.num_cache_hits > 0u );
+  CHECK( xag_cache.num_gates() == xag_ref.num_gates() );
+  CHECK( simulate<kitty::static_truth_table<8u>>( xag_cache ) == tts );
+
+  /* klut networks with exact synthesis */
+  const auto klut = cleanup_dangling<xag_network, klut_network>( xag );
+  exact_resynthesis<klut_network> exact( 3u );
+  cut_rewriting_params ps_klut;
+  ps_klut.cut_enumeration_ps.cut_size = 3;
+  const auto klut_ref = cut_rewriting( klut, exact, ps_klut );
+  ps_klut.use_candidate_cache = true;
+  const auto klut_cache = cut_rewriting( klut, exact, ps_klut );
+  CHECK( klut_cache.num_gates() == klut_ref.num_gates() );
+  CHECK( simulate<kitty::static_truth_table<8u>>( klut_cache ) == tts );
+}
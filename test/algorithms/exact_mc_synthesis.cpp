@@ -51,3 +51,40 @@ TEST_CASE( "Find multiple ITE with exact MC synthesis", "[exact_mc_synthesis]" )
     CHECK( simulate<kitty::dynamic_truth_table>( xag, {3u} )[0] == func );
   }
 }
+
+TEST_CASE( "Portfolio exact MC synthesis", "[exact_mc_synthesis]" )
+{
+  auto const test_one = [&]( uint32_t num_vars, const std::string& expression ) {
+    kitty::dynamic_truth_table func( num_vars );
+    kitty::create_from_expression( func, expression );
+    const auto xag = exact_mc_synthesis<xag_network>( func );
+
+    exact_mc_synthesis_params ps;
+    ps.num_threads = 4u;
+    ps.portfolio_conflict_slice = 100u;
+    exact_mc_synthesis_stats st;
+    const auto xag_portfolio = exact_mc_synthesis<xag_network>( func, ps, &st );
+    CHECK( simulate<kitty::dynamic_truth_table>( xag_portfolio, {num_vars} )[0] == func );
+    CHECK( xag_portfolio.num_gates() > 0u );
+    CHECK( st.num_jobs > 0u );
+
+    uint32_t ands{0u}, ands_portfolio{0u};
+    xag.foreach_gate( [&]( auto const& n ) { ands += xag.is_and( n ) ? 1u : 0u; } );
+    xag_portfolio.foreach_gate( [&]( auto const& n ) { ands_portfolio += xag_portfolio.is_and( n ) ? 1u : 0u; } );
+    CHECK( ands == ands_portfolio );
+  };
+
+  test_one( 3u, "<abc>" );
+  test_one( 4u, "(abcd)" );
+  test_one( 4u, "[(ab)(cd)]" );
+  test_one( 4u, "<a(bc)d>" );
+
+  /* multiple solutions are enumerated with the encoding that found the first one */
+  kitty::dynamic_truth_table func( 3 );
+  kitty::create_majority( func );
+  exact_mc_synthesis_params ps;
+  ps.num_threads = 2u;
+  ps.portfolio = {{}, {true}};
+  const auto xags = exact_mc_synthesis_multiple<xag_network>( func, 3u, ps );
+  CHECK( xags.size() == 2u );
+}
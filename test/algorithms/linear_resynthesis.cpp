@@ -1,5 +1,9 @@
 #include <catch.hpp>
 
+#include <algorithm>
+#include <random>
+#include <vector>
+
 #include <kitty/dynamic_truth_table.hpp>
 #include <mockturtle/algorithms/linear_resynthesis.hpp>
 #include <mockturtle/algorithms/simulation.hpp>
@@ -168,3 +172,33 @@ TEST_CASE( "Example from SEA'10 Boyar-Peralta paper; cancellation-free", "[linea
   CHECK( get_linear_matrix( xag ) == matrix );
   CHECK( xag.num_gates() == 5u );
 }
+
+TEST_CASE( "Linear resynthesis with Paar algorithm for many inputs", "[linear_resynthesis]" )
+{
+  std::default_random_engine gen( 42u );
+  std::bernoulli_distribution dist( 0.4 );
+
+  xag_network xag;
+  std::vector<xag_network::signal> xs( 100u );
+  std::generate( xs.begin(), xs.end(), [&]() { return xag.create_pi(); } );
+  for ( auto o = 0u; o < 80u; ++o )
+  {
+    std::vector<xag_network::signal> fanins;
+    for ( auto const& x : xs )
+    {
+      if ( dist( gen ) )
+      {
+        fanins.push_back( x );
+      }
+    }
+    xag.create_po( xag.create_nary_xor( fanins ) );
+  }
+  xag.create_po( xag.get_constant( false ) );
+
+  const auto xag2 = linear_resynthesis_paar( xag );
+
+  CHECK( xag2.num_pis() == xag.num_pis() );
+  CHECK( xag2.num_pos() == xag.num_pos() );
+  CHECK( xag2.num_gates() < xag.num_gates() );
+  CHECK( get_linear_matrix( xag2 ) == get_linear_matrix( xag ) );
+}
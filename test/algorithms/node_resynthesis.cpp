@@ -2,10 +2,12 @@
 
 #include <algorithm>
 
+#include <mockturtle/algorithms/detail/npn4_table.hpp>
 #include <mockturtle/algorithms/node_resynthesis.hpp>
 #include <mockturtle/algorithms/node_resynthesis/akers.hpp>
 #include <mockturtle/algorithms/node_resynthesis/direct.hpp>
 #include <mockturtle/algorithms/node_resynthesis/mig_npn.hpp>
+#include <mockturtle/algorithms/node_resynthesis/xag_npn.hpp>
 #include <mockturtle/algorithms/node_resynthesis/xmg_npn.hpp>
 #include <mockturtle/algorithms/simulation.hpp>
 #include <mockturtle/networks/aig.hpp>
@@ -16,6 +18,8 @@
 
 #include <kitty/constructors.hpp>
 #include <kitty/dynamic_truth_table.hpp>
+#include <kitty/npn.hpp>
+#include <kitty/static_truth_table.hpp>
 
 using namespace mockturtle;
 
@@ -360,3 +364,61 @@ TEST_CASE( "Node resynthesis with direct synthesis", "[node_resynthesis]" )
     CHECK( simulate<kitty::dynamic_truth_table>( xmg, {3u} )[0] == tt );
   }
 }
+
+TEST_CASE( "Shared 4-input NPN table agrees with exact NPN canonization", "[node_resynthesis]" )
+{
+  auto const& table = detail::npn4_table::instance();
+  CHECK( table.num_classes() == 222u );
+
+  for ( uint32_t f = 0u; f < ( 1u << 16u ); f += 7u )
+  {
+    kitty::static_truth_table<4u> tt;
+    kitty::create_from_words( tt, &f, &f + 1 );
+
+    const auto [repr, phase, perm] = kitty::exact_npn_canonization( tt );
+    const auto config = table.config( static_cast<uint16_t>( f ) );
+    CHECK( config.repr == repr );
+    CHECK( config.phase == phase );
+    for ( auto i = 0u; i < 4u; ++i )
+    {
+      CHECK( config.perm[i] == perm[i] );
+    }
+    CHECK( table.representative( static_cast<uint16_t>( f ) ) == *repr.cbegin() );
+  }
+}
+
+TEST_CASE( "NPN resynthesis databases are shared by all instances", "[node_resynthesis]" )
+{
+  xag_npn_resynthesis_stats st1, st2;
+  {
+    xag_npn_resynthesis<xag_network> resyn1( {}, &st1 );
+    xag_npn_resynthesis<xag_network> resyn2( {}, &st2 );
+  }
+  CHECK( st1.db_size > 0u );
+  CHECK( st1.db_size == st2.db_size );
+  CHECK( st1.covered_classes == st2.covered_classes );
+
+  mig_npn_resynthesis mig_resyn1, mig_resyn2, mig_resyn10( true );
+  xmg_npn_resynthesis xmg_resyn1, xmg_resyn2;
+  for ( uint32_t f = 0u; f < ( 1u << 16u ); f += 997u )
+  {
+    kitty::dynamic_truth_table tt( 4u );
+    kitty::create_from_words( tt, &f, &f + 1 );
+
+    const auto check = [&]( auto ntk, auto& resyn ) {
+      std::vector<typename decltype( ntk )::signal> pis( 4u );
+      std::generate( pis.begin(), pis.end(), [&]() { return ntk.create_pi(); } );
+      resyn( ntk, tt, pis.begin(), pis.end(), [&]( auto const& g ) {
+        ntk.create_po( g );
+        return false;
+      } );
+      REQUIRE( ntk.num_pos() == 1u );
+      CHECK( simulate<kitty::static_truth_table<4u>>( ntk )[0]._bits == f );
+    };
+    check( mig_network{}, mig_resyn1 );
+    check( mig_network{}, mig_resyn2 );
+    check( mig_network{}, mig_resyn10 );
+    check( xmg_network{}, xmg_resyn1 );
+    check( xmg_network{}, xmg_resyn2 );
+  }
+}
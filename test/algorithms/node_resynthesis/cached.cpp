@@ -1,10 +1,16 @@
 #include <catch.hpp>
 
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+
 #include <kitty/constructors.hpp>
 #include <kitty/dynamic_truth_table.hpp>
+#include <kitty/print.hpp>
 
 #include <mockturtle/algorithms/node_resynthesis/cached.hpp>
 #include <mockturtle/algorithms/node_resynthesis/exact.hpp>
+#include <mockturtle/algorithms/simulation.hpp>
 #include <mockturtle/networks/xag.hpp>
 
 using namespace mockturtle;
@@ -50,3 +56,67 @@ TEST_CASE( "Exact XAG for MAJ cached", "[cached]" )
   CHECK( !fs::exists( "mockturtle-test-cache.db.bak" ) );
   fs::remove( "mockturtle-test-cache.db" );
 }
+
+namespace
+{
+
+template<class ResynthesisFn>
+struct counting_resynthesis
+{
+  template<typename LeavesIterator, typename Fn>
+  void operator()( xag_network& ntk, kitty::dynamic_truth_table const& function, LeavesIterator begin, LeavesIterator end, Fn&& fn )
+  {
+    ++*calls;
+    if ( function.num_vars() == 3u )
+    {
+      resyn( ntk, function, begin, end, fn );
+    }
+  }
+
+  ResynthesisFn resyn;
+  std::shared_ptr<uint32_t> calls = std::make_shared<uint32_t>( 0u );
+};
+
+} // namespace
+
+TEST_CASE( "Reopen binary cache file of cached resynthesis", "[cached]" )
+{
+  const std::string filename = "mockturtle-test-cache.bin";
+  std::remove( filename.c_str() );
+
+  kitty::dynamic_truth_table maj( 3u ), and4( 4u );
+  kitty::create_majority( maj );
+  kitty::create_from_hex_string( and4, "8000" );
+
+  counting_resynthesis<exact_aig_resynthesis<xag_network>> counting;
+  for ( auto i = 0u; i < 2u; ++i )
+  {
+    xag_network xag;
+    std::vector<xag_network::signal> pis( 4u );
+    std::generate( pis.begin(), pis.end(), [&]() { return xag.create_pi(); } );
+
+    cached_resynthesis<xag_network, decltype( counting )> resyn( counting, 6u, filename );
+    resyn( xag, maj, pis.begin(), pis.begin() + 3, [&]( auto const& f ) {
+      xag.create_po( f );
+    } );
+    resyn( xag, maj, pis.rbegin(), pis.rbegin() + 3, [&]( auto const& f ) {
+      xag.create_po( f );
+    } );
+
+    /* and4 cannot be synthesized by counting_resynthesis and is blacklisted */
+    resyn( xag, and4, pis.begin(), pis.end(), [&]( auto const& f ) {
+      xag.create_po( f );
+    } );
+
+    /* the first run synthesizes both functions, the second run finds both in the cache file */
+    CHECK( *counting.calls == 2u );
+    CHECK( xag.num_pos() == 2u );
+
+    const auto tts = simulate<kitty::dynamic_truth_table>( xag, default_simulator<kitty::dynamic_truth_table>( 4u ) );
+    CHECK( kitty::to_hex( tts[0] ) == "e8e8" );
+    CHECK( kitty::to_hex( tts[1] ) == "fcc0" );
+  }
+
+  CHECK( binary_cache::is_binary_cache_file( filename ) );
+  std::remove( filename.c_str() );
+}
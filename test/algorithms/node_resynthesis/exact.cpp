@@ -1,5 +1,8 @@
 #include <catch.hpp>
 
+#include <algorithm>
+#include <cstdio>
+
 #include <kitty/constructors.hpp>
 #include <kitty/dynamic_truth_table.hpp>
 
@@ -170,3 +173,73 @@ TEST_CASE( "Exact XMG for XOR3", "[exact]" )
   CHECK( xmg.num_gates() == 1u );
   CHECK( simulate<kitty::dynamic_truth_table>( xmg, sim )[0] == _xor );
 }
+
+TEST_CASE( "Exact synthesis with a persistent cache", "[exact]" )
+{
+  const std::string filename = "mockturtle-test-exact-cache.bin";
+  std::remove( filename.c_str() );
+
+  kitty::dynamic_truth_table maj( 3u );
+  kitty::create_majority( maj );
+
+  for ( auto i = 0u; i < 2u; ++i )
+  {
+    exact_resynthesis_params ps;
+    ps.persistent_cache = std::make_shared<binary_cache>( filename );
+    CHECK( ps.persistent_cache->num_loaded() == i );
+
+    aig_network aig;
+    std::vector<aig_network::signal> pis( 3u );
+    std::generate( pis.begin(), pis.end(), [&]() { return aig.create_pi(); } );
+
+    exact_aig_resynthesis<aig_network> resyn( false, ps );
+    resyn( aig, maj, pis.begin(), pis.end(), [&]( auto const& f ) {
+      aig.create_po( f );
+    } );
+
+    default_simulator<kitty::dynamic_truth_table> sim( 3u );
+    CHECK( aig.num_gates() == 4u );
+    CHECK( simulate<kitty::dynamic_truth_table>( aig, sim )[0] == maj );
+
+    /* chains for k-LUT networks are kept apart */
+    CHECK( ps.persistent_cache->size() == 1u );
+    CHECK( !ps.persistent_cache->find( detail::exact_chain_record, detail::exact_cache_key( 2u, maj ) ) );
+  }
+
+  std::remove( filename.c_str() );
+}
+
+TEST_CASE( "Decode chains from corrupted cache records", "[exact]" )
+{
+  kitty::dynamic_truth_table op( 2u );
+  kitty::create_from_hex_string( op, "8" );
+
+  percy::chain c;
+  c.reset( 2, 1, 1, 2 );
+  c.set_step( 0, std::vector<int>{0, 1}, op );
+  c.set_output( 0, 6 );
+
+  auto const words = detail::encode_chain( c );
+  auto const decode = [&]( std::vector<binary_cache::word> const& record ) {
+    return detail::decode_chain( {record.data(), record.data() + record.size()} );
+  };
+
+  auto const decoded = decode( words );
+  REQUIRE( decoded );
+  CHECK( detail::encode_chain( *decoded ) == words );
+
+  /* counts that do not fit the record length */
+  CHECK( !decode( {} ) );
+  CHECK( !decode( std::vector<binary_cache::word>( words.begin(), words.end() - 1 ) ) );
+  auto steps = words;
+  steps[2] = 1000000u;
+  CHECK( !decode( steps ) );
+  auto outputs = words;
+  outputs[3] = 0xffffffffu;
+  CHECK( !decode( outputs ) );
+
+  /* references to later steps */
+  auto fanin = words;
+  fanin[4] = 2u;
+  CHECK( !decode( fanin ) );
+}
@@ -1,6 +1,7 @@
 #include <catch.hpp>
 
 #include <mockturtle/algorithms/cleanup.hpp>
+#include <mockturtle/generators/arithmetic.hpp>
 #include <mockturtle/algorithms/simulation.hpp>
 #include <mockturtle/algorithms/pattern_generation.hpp>
 #include <mockturtle/networks/aig.hpp>
@@ -119,3 +120,68 @@ TEST_CASE( "With observability awareness", "[pattern_generation]" )
   /* the generated pattern should be either 000, 010, or 101 */
   CHECK( ( ( !kitty::get_bit( sim.compute_pi( 0 ), 3 ) && !kitty::get_bit( sim.compute_pi( 2 ), 3 ) ) || ( kitty::get_bit( sim.compute_pi( 0 ), 3 ) && !kitty::get_bit( sim.compute_pi( 1 ), 3 ) && kitty::get_bit( sim.compute_pi( 2 ), 3 ) ) ) == true );
 }
+
+TEST_CASE( "Parallel stuck-at pattern generation", "[pattern_generation]" )
+{
+  aig_network aig;
+
+  std::vector<aig_network::signal> as( 6u );
+  std::vector<aig_network::signal> bs( 6u );
+  std::generate( as.begin(), as.end(), [&]() { return aig.create_pi(); } );
+  std::generate( bs.begin(), bs.end(), [&]() { return aig.create_pi(); } );
+  for ( auto const& f : carry_ripple_multiplier( aig, as, bs ) )
+  {
+    aig.create_po( f );
+  }
+
+  for ( auto num_threads : {2u, 4u} )
+  {
+    partial_simulator sim( aig.num_pis(), 0 );
+    pattern_generation_params ps;
+    ps.num_threads = num_threads;
+    ps.batch_size = 8u;
+    pattern_generation_stats st;
+    pattern_generation( aig, sim, ps, &st );
+
+    CHECK( st.num_constant == 0u );
+    CHECK( sim.num_bits() == st.num_generated_patterns );
+
+    /* every gate takes both values under the generated patterns */
+    auto const tts = simulate_nodes<kitty::partial_truth_table>( aig, sim );
+    auto const zero = sim.compute_constant( false );
+    aig.foreach_gate( [&]( auto const& n ) {
+      CHECK( tts[n] != zero );
+      CHECK( tts[n] != ~zero );
+    } );
+  }
+}
+
+TEST_CASE( "Parallel constant node removal", "[pattern_generation]" )
+{
+  aig_network aig;
+
+  const auto a = aig.create_pi();
+  const auto b = aig.create_pi();
+
+  const auto f1 = aig.create_and( !a, b );
+  const auto f2 = aig.create_and( a, !b );
+  const auto f3 = aig.create_or( f1, f2 );
+  aig.create_po( f3 );
+
+  const auto g1 = aig.create_and( a, b );
+  const auto g2 = aig.create_and( !a, !b );
+  const auto g3 = aig.create_or( g1, g2 );
+  aig.create_po( g3 );
+
+  const auto h = aig.create_and( f3, g3 );
+  aig.create_po( h );
+
+  partial_simulator sim( aig.num_pis(), 0 );
+  pattern_generation_params ps;
+  ps.substitute_const = true;
+  ps.num_threads = 2u;
+  ps.batch_size = 1u;
+  pattern_generation( aig, sim, ps );
+
+  CHECK( aig.num_gates() == 6 );
+}
@@ -5,6 +5,7 @@
 #include <vector>
 
 #include <mockturtle/algorithms/aig_resub.hpp>
+#include <mockturtle/algorithms/aig_rewrite.hpp>
 #include <mockturtle/algorithms/cleanup.hpp>
 #include <mockturtle/algorithms/collapse_mapped.hpp>
 #include <mockturtle/algorithms/cut_enumeration.hpp>
@@ -306,6 +307,18 @@ TEST_CASE( "Test quality improvement of cut rewriting with XAG NPN4 resynthesis"
   CHECK( v == std::vector<uint32_t>{{0, 31, 152, 50, 176, 79, 215, 134, 411, 869, 293}} );
 }
 
+TEST_CASE( "Test quality improvement of AIG rewriting", "[quality]" )
+{
+  const auto v = foreach_benchmark<aig_network>( []( auto& ntk, auto ) {
+    const auto before = ntk.num_gates();
+    aig_rewrite( ntk );
+    ntk = cleanup_dangling( ntk );
+    return before - ntk.num_gates();
+  } );
+
+  CHECK( v == std::vector<uint32_t>{{0, 30, 6, 13, 94, 21, 140, 121, 281, 241, 37}} );
+}
+
 TEST_CASE( "Test quality improvement for XMG3 rewriting with 4-input NPN database", "[quality]" )
 {
   xmg3_npn_resynthesis<xmg_network> resyn;
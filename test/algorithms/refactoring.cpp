@@ -4,6 +4,9 @@
 #include <mockturtle/algorithms/node_resynthesis/akers.hpp>
 #include <mockturtle/algorithms/node_resynthesis/bidecomposition.hpp>
 #include <mockturtle/algorithms/node_resynthesis/mig_npn.hpp>
+#include <mockturtle/algorithms/simulation.hpp>
+#include <mockturtle/generators/arithmetic.hpp>
+#include <mockturtle/networks/aig.hpp>
 #include <mockturtle/networks/mig.hpp>
 #include <mockturtle/networks/xag.hpp>
 #include <mockturtle/traits.hpp>
@@ -185,3 +188,34 @@ TEST_CASE( "Refactoring from inverted projection", "[refactoring]" )
     CHECK( mig.is_complemented( f ) );
   } );
 }
+
+TEST_CASE( "Refactoring with candidate cache", "[refactoring]" )
+{
+  aig_network aig;
+  std::vector<aig_network::signal> a( 4 ), b( 4 );
+  std::generate( a.begin(), a.end(), [&]() { return aig.create_pi(); } );
+  std::generate( b.begin(), b.end(), [&]() { return aig.create_pi(); } );
+  for ( auto const& f : carry_ripple_multiplier( aig, a, b ) )
+  {
+    aig.create_po( f );
+  }
+  const auto tts = simulate<kitty::static_truth_table<8u>>( aig );
+
+  bidecomposition_resynthesis<aig_network> resyn;
+  refactoring_params ps;
+  ps.allow_zero_gain = true;
+
+  auto aig_ref = cleanup_dangling( aig );
+  refactoring( aig_ref, resyn, ps );
+
+  /* rejected candidates are not created in the network */
+  auto aig_cache = cleanup_dangling( aig );
+  ps.use_candidate_cache = true;
+  refactoring( aig_cache, resyn, ps );
+  CHECK( aig_cache.size() < aig_ref.size() );
+
+  aig_ref = cleanup_dangling( aig_ref );
+  aig_cache = cleanup_dangling( aig_cache );
+  CHECK( aig_cache.num_gates() == aig_ref.num_gates() );
+  CHECK( simulate<kitty::static_truth_table<8u>>( aig_cache ) == tts );
+}
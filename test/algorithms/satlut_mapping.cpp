@@ -1,8 +1,15 @@
 #include <catch.hpp>
 
+#include <vector>
+
+#include <kitty/static_truth_table.hpp>
 #include <mockturtle/traits.hpp>
+#include <mockturtle/algorithms/collapse_mapped.hpp>
+#include <mockturtle/algorithms/lut_mapping.hpp>
 #include <mockturtle/algorithms/satlut_mapping.hpp>
+#include <mockturtle/algorithms/simulation.hpp>
 #include <mockturtle/networks/aig.hpp>
+#include <mockturtle/networks/klut.hpp>
 #include <mockturtle/views/mapping_view.hpp>
 
 using namespace mockturtle;
@@ -33,3 +40,62 @@ TEST_CASE( "SAT-LUT mapping of AIG", "[satlut_mapping]" )
 
   satlut_mapping( mapped_aig );
 }
+
+TEST_CASE( "parallel windowed SAT-LUT mapping of AIG", "[satlut_mapping]" )
+{
+  aig_network aig;
+  std::vector<aig_network::signal> pis;
+  for ( auto i = 0u; i < 16u; ++i )
+  {
+    pis.push_back( aig.create_pi() );
+  }
+
+  /* chains of XORs, which are mapped into many small windows */
+  for ( auto i = 0u; i < 16u; ++i )
+  {
+    auto f = pis[i];
+    for ( auto j = 1u; j < 8u; ++j )
+    {
+      f = aig.create_xor( f, pis[( i + j ) % 16u] );
+    }
+    aig.create_po( f );
+  }
+
+  auto const map_with_threads = [&]( uint32_t num_threads ) {
+    mapping_view<aig_network, true> mapped_aig{aig};
+    lut_mapping_params lps;
+    lps.cut_enumeration_ps.cut_size = 4u;
+    lut_mapping<mapping_view<aig_network, true>, true>( mapped_aig, lps );
+    auto const initial = mapped_aig.num_cells();
+
+    satlut_mapping_params ps;
+    ps.cut_enumeration_ps.cut_size = 4u;
+    ps.num_threads = num_threads;
+    ps.batch_size = 4u;
+    satlut_mapping_stats st;
+    satlut_mapping<mapping_view<aig_network, true>, true>( mapped_aig, 16u, ps, &st );
+    CHECK( mapped_aig.num_cells() <= initial );
+    if ( num_threads != 1u )
+    {
+      CHECK( st.num_batches > 0u );
+    }
+
+    auto const klut = *collapse_mapped_network<klut_network>( mapped_aig );
+    CHECK( simulate<kitty::static_truth_table<16u>>( klut ) == simulate<kitty::static_truth_table<16u>>( aig ) );
+
+    std::vector<std::vector<aig_network::node>> cells;
+    mapped_aig.foreach_gate( [&]( auto const& n ) {
+      if ( mapped_aig.is_cell_root( n ) )
+      {
+        cells.emplace_back();
+        mapped_aig.foreach_cell_fanin( n, [&]( auto const& l ) { cells.back().push_back( l ); } );
+      }
+    } );
+    return cells;
+  };
+
+  map_with_threads( 1u );
+  auto const cells2 = map_with_threads( 2u );
+  auto const cells4 = map_with_threads( 4u );
+  CHECK( cells2 == cells4 );
+}
@@ -0,0 +1,152 @@
+#include <catch.hpp>
+
+#include <sstream>
+#include <vector>
+
+#include <mockturtle/algorithms/sequential_simulation.hpp>
+#include <mockturtle/networks/aig.hpp>
+#include <mockturtle/networks/klut.hpp>
+#include <mockturtle/networks/xag.hpp>
+
+using namespace mockturtle;
+
+TEST_CASE( "Sequential simulation of a 2-bit counter", "[sequential_simulation]" )
+{
+  aig_network aig;
+  auto const en = aig.create_pi();
+  auto const q0 = aig.create_ro();
+  auto const q1 = aig.create_ro();
+
+  auto const d0 = aig.create_xor( q0, en );
+  auto const d1 = aig.create_xor( q1, aig.create_and( q0, en ) );
+  aig.create_po( q0 );
+  aig.create_po( q1 );
+  aig.create_ri( d0, 0 );
+  aig.create_ri( d1, 1 );
+
+  /* trace 0 counts in every cycle, trace 1 never, trace 2 every other cycle */
+  std::istringstream in( "# en\n"
+                         "5\n"
+                         "1\n"
+                         "\n"
+                         "5\n"
+                         "1\n" );
+
+  sequential_simulation_params ps;
+  ps.num_cycles = 10u;
+  sequential_simulation_stats st;
+  auto const result = simulate_sequential( aig, stimuli_reader( in ), ps, &st );
+
+  CHECK( st.num_cycles == 4u );
+  CHECK( result.num_cycles == 4u );
+  REQUIRE( result.outputs.size() == 4u );
+
+  /* outputs are the register values before the clock edge, starting at 2 */
+  std::vector<uint32_t> const trace0{2u, 3u, 0u, 1u};
+  std::vector<uint32_t> const trace2{2u, 3u, 3u, 0u};
+  for ( auto c = 0u; c < 4u; ++c )
+  {
+    REQUIRE( result.outputs[c].size() == 2u );
+    auto const value = [&]( uint32_t t ) {
+      return static_cast<uint32_t>( ( result.outputs[c][0] >> t ) & 1u ) | static_cast<uint32_t>( ( ( result.outputs[c][1] >> t ) & 1u ) << 1u );
+    };
+    CHECK( value( 0u ) == trace0[c] );
+    CHECK( value( 1u ) == 2u );
+    CHECK( value( 2u ) == trace2[c] );
+  }
+}
+
+TEST_CASE( "Sequential simulation with several words per signal", "[sequential_simulation]" )
+{
+  xag_network xag;
+  auto const a = xag.create_pi();
+  auto const b = xag.create_pi();
+  auto const q = xag.create_ro();
+  auto const f = xag.create_and( a, b );
+  xag.create_po( !q );
+  xag.create_ri( f );
+
+  sequential_simulation_params ps;
+  ps.num_cycles = 3u;
+  ps.num_words = 2u;
+
+  std::istringstream in( "1ffffffffffffffff 10000000000000000\n"
+                         "0 0\n"
+                         "0 0\n" );
+  auto const result = simulate_sequential( xag, stimuli_reader( in ), ps );
+  REQUIRE( result.num_cycles == 3u );
+  REQUIRE( result.outputs[0].size() == 2u );
+
+  /* register is 0 in the first cycle, a & b in the second one */
+  CHECK( result.outputs[0][0] == ~UINT64_C( 0 ) );
+  CHECK( result.outputs[0][1] == ~UINT64_C( 0 ) );
+  CHECK( result.outputs[1][0] == ~UINT64_C( 0 ) );
+  CHECK( result.outputs[1][1] == ~UINT64_C( 1 ) );
+  CHECK( result.outputs[2][1] == ~UINT64_C( 0 ) );
+}
+
+TEST_CASE( "Malformed stimuli end sequential simulation", "[sequential_simulation]" )
+{
+  aig_network aig;
+  auto const a = aig.create_pi();
+  auto const b = aig.create_pi();
+  aig.create_po( aig.create_and( a, b ) );
+
+  std::istringstream in( "1 1\n"
+                         "1 x\n"
+                         "1 1\n" );
+  auto const result = simulate_sequential( aig, stimuli_reader( in ) );
+  CHECK( result.num_cycles == 1u );
+  CHECK( result.outputs[0][0] == 1u );
+}
+
+TEST_CASE( "Switching activity of sequential k-LUT network", "[sequential_simulation]" )
+{
+  klut_network klut;
+  auto const a = klut.create_pi();
+  auto const q = klut.create_ro();
+  auto const t = klut.create_not( q );
+  auto const f = klut.create_and( a, q );
+  klut.create_po( f );
+  klut.create_ri( t );
+
+  sequential_simulation_params ps;
+  ps.num_cycles = 200u;
+  ps.num_words = 4u;
+  ps.record_outputs = false;
+  ps.compute_activity = true;
+  auto const result = simulate_sequential( klut, random_stimuli( 5u ), ps );
+
+  CHECK( result.outputs.empty() );
+  CHECK( result.switching[klut.get_node( q )] == 1.0 );
+  CHECK( result.probability[klut.get_node( q )] == 0.5 );
+  CHECK( result.probability[klut.get_node( a )] > 0.45 );
+  CHECK( result.probability[klut.get_node( a )] < 0.55 );
+  CHECK( result.probability[klut.get_node( f )] > 0.2 );
+  CHECK( result.probability[klut.get_node( f )] < 0.3 );
+  CHECK( result.probability[klut.get_constant( true )] == 1.0 );
+}
+
+TEST_CASE( "Nondeterministic register reset values", "[sequential_simulation]" )
+{
+  aig_network aig;
+  auto const q = aig.create_ro();
+  aig.create_po( q );
+  aig.create_ri( q, -1 );
+
+  sequential_simulation_params ps;
+  ps.num_cycles = 2u;
+  ps.num_words = 8u;
+  auto const result = simulate_sequential( aig, random_stimuli(), ps );
+  REQUIRE( result.num_cycles == 2u );
+
+  /* random initial values are kept */
+  CHECK( result.outputs[0] == result.outputs[1] );
+  uint32_t ones{0u};
+  for ( auto w : result.outputs[0] )
+  {
+    ones += __builtin_popcountll( w );
+  }
+  CHECK( ones > 128u );
+  CHECK( ones < 384u );
+}
@@ -0,0 +1,77 @@
+#include <catch.hpp>
+
+#include <sstream>
+
+#include <mockturtle/io/write_blif.hpp>
+#include <mockturtle/networks/klut.hpp>
+
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+
+using namespace mockturtle;
+
+TEST_CASE( "write k-LUT network into BLIF file", "[write_blif]" )
+{
+  klut_network klut;
+
+  const auto a = klut.create_pi();
+  const auto b = klut.create_pi();
+  const auto c = klut.create_pi();
+
+  const auto f1 = klut.create_and( a, b );
+  const auto f2 = klut.create_maj( f1, b, c );
+  klut.create_po( f2 );
+  klut.create_po( klut.create_not( f1 ) );
+
+  std::ostringstream out;
+  write_blif( klut, out );
+
+  CHECK( out.str() == ".model top\n"
+                      ".inputs pi2 pi3 pi4 \n"
+                      ".outputs po0 po1 \n"
+                      ".names new_n0\n"
+                      "0\n"
+                      ".names new_n1\n"
+                      "1\n"
+                      ".names pi2 pi3 new_n5\n"
+                      "11 1\n"
+                      ".names new_n5 pi3 pi4 new_n6\n"
+                      "-11 1\n"
+                      "1-1 1\n"
+                      "11- 1\n"
+                      ".names new_n5 new_n7\n"
+                      "0 1\n"
+                      ".names new_n6 po0\n"
+                      "1 1\n"
+                      ".names new_n7 po1\n"
+                      "1 1\n"
+                      ".end\n" );
+}
+
+TEST_CASE( "write BLIF in parallel chunks", "[write_blif]" )
+{
+  klut_network klut;
+
+  std::vector<klut_network::signal> fs;
+  for ( auto i = 0u; i < 8u; ++i )
+  {
+    fs.push_back( klut.create_pi() );
+  }
+  for ( auto i = 0u; i < 5000u; ++i )
+  {
+    kitty::dynamic_truth_table tt( 3u );
+    kitty::create_from_hex_string( tt, i % 3 ? "e8" : "96" );
+    fs.push_back( klut.create_node( {fs[i], fs[i + 3], fs[i + 7]}, tt ) );
+  }
+  klut.create_po( fs.back() );
+
+  std::ostringstream out1, out3;
+  write_blif( klut, out1 );
+
+  write_blif_params ps;
+  ps.num_threads = 3u;
+  ps.buffer_size = 32u;
+  write_blif( klut, out3, ps );
+
+  CHECK( out1.str() == out3.str() );
+}
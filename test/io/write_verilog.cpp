@@ -9,6 +9,7 @@
 #include <mockturtle/networks/aig.hpp>
 #include <mockturtle/networks/klut.hpp>
 #include <mockturtle/networks/mig.hpp>
+#include <mockturtle/networks/xag.hpp>
 
 using namespace mockturtle;
 
@@ -131,3 +132,28 @@ TEST_CASE( "write Verilog with register names", "[write_verilog]" )
                       "  assign y[3] = n15 ;\n"
                       "endmodule\n" );
 }
+
+TEST_CASE( "write Verilog in parallel chunks", "[write_verilog]" )
+{
+  xag_network xag;
+
+  std::vector<xag_network::signal> as( 32u );
+  std::vector<xag_network::signal> bs( 32u );
+  std::generate( as.begin(), as.end(), [&]() { return xag.create_pi(); } );
+  std::generate( bs.begin(), bs.end(), [&]() { return xag.create_pi(); } );
+  for ( auto const& f : carry_ripple_multiplier( xag, as, bs ) )
+  {
+    xag.create_po( f );
+  }
+  CHECK( xag.num_gates() > 4096u );
+
+  std::ostringstream out1, out4;
+  write_verilog( xag, out1 );
+
+  write_verilog_params ps;
+  ps.num_threads = 4u;
+  ps.buffer_size = 64u;
+  write_verilog( xag, out4, ps );
+
+  CHECK( out1.str() == out4.str() );
+}
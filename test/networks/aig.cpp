@@ -260,6 +260,24 @@ TEST_CASE( "hash nodes in AIG network", "[aig]" )
   CHECK( aig.get_node( f ) == aig.get_node( g ) );
 }
 
+TEST_CASE( "look up nodes in AIG network", "[aig]" )
+{
+  aig_network aig;
+
+  auto a = aig.create_pi();
+  auto b = aig.create_pi();
+
+  CHECK( !aig.has_and( a, b ) );
+  auto f = aig.create_and( a, b );
+  CHECK( aig.has_and( b, a ) == f );
+  CHECK( !aig.has_and( !a, b ) );
+
+  CHECK( aig.has_and( a, a ) == a );
+  CHECK( aig.has_and( a, !a ) == aig.get_constant( false ) );
+  CHECK( aig.has_and( aig.get_constant( true ), b ) == b );
+  CHECK( aig.size() == 4u );
+}
+
 TEST_CASE( "clone a node in AIG network", "[aig]" )
 {
   aig_network aig1, aig2;
@@ -362,6 +362,28 @@ TEST_CASE( "hash nodes in xag network", "[xag]" )
   CHECK( xag.get_node( f ) == xag.get_node( g ) );
 }
 
+TEST_CASE( "look up nodes in xag network", "[xag]" )
+{
+  xag_network xag;
+
+  auto a = xag.create_pi();
+  auto b = xag.create_pi();
+
+  CHECK( !xag.has_and( a, b ) );
+  CHECK( !xag.has_xor( a, b ) );
+  auto f = xag.create_and( a, b );
+  auto g = xag.create_xor( a, b );
+  CHECK( xag.has_and( b, a ) == f );
+  CHECK( xag.has_xor( b, a ) == g );
+  CHECK( xag.has_xor( !a, b ) == !g );
+  CHECK( !xag.has_and( !a, b ) );
+
+  CHECK( xag.has_and( a, !a ) == xag.get_constant( false ) );
+  CHECK( xag.has_xor( a, !a ) == xag.get_constant( true ) );
+  CHECK( xag.has_xor( xag.get_constant( true ), b ) == !b );
+  CHECK( xag.size() == 5u );
+}
+
 TEST_CASE( "clone a node in xag network", "[xag]" )
 {
   xag_network xag1, xag2;
@@ -0,0 +1,188 @@
+#include <catch.hpp>
+
+#include <cmath>
+
+#include <mockturtle/algorithms/cut_rewriting.hpp>
+#include <mockturtle/algorithms/lut_mapping.hpp>
+#include <mockturtle/algorithms/node_resynthesis/mig_npn.hpp>
+#include <mockturtle/algorithms/node_resynthesis/xag_npn.hpp>
+#include <mockturtle/algorithms/refactoring.hpp>
+#include <mockturtle/generators/arithmetic.hpp>
+#include <mockturtle/networks/aig.hpp>
+#include <mockturtle/networks/mig.hpp>
+#include <mockturtle/properties/switching_activity.hpp>
+#include <mockturtle/utils/cost_functions.hpp>
+#include <mockturtle/views/depth_view.hpp>
+#include <mockturtle/views/mapping_view.hpp>
+
+using namespace mockturtle;
+
+TEST_CASE( "Signal probabilities by propagation on cuts", "[switching_activity]" )
+{
+  aig_network aig;
+  auto const a = aig.create_pi();
+  auto const b = aig.create_pi();
+  auto const c = aig.create_pi();
+  auto const f1 = aig.create_and( a, b );
+  auto const f2 = aig.create_and( a, !b );
+  auto const f3 = aig.create_or( f1, f2 ); /* reconvergent, equals a */
+  auto const f4 = aig.create_and( f1, c );
+  aig.create_po( f3 );
+  aig.create_po( f4 );
+
+  switching_activity_params ps;
+  ps.method = switching_activity_params::propagation;
+  auto const result = switching_activity( aig, ps );
+
+  CHECK( result.probability[a] == Approx( 0.5 ) );
+  CHECK( result.probability[f1] == Approx( 0.25 ) );
+  CHECK( result.switching[f1] == Approx( 0.375 ) );
+  CHECK( result.probability[f3] == Approx( 0.5 ) );
+  CHECK( result.probability[f4] == Approx( 0.125 ) );
+  CHECK( result.probability[aig.get_constant( false )] == 0.0 );
+
+  ps.input_probability = 0.9;
+  auto const biased = switching_activity( aig, ps );
+  CHECK( biased.probability[f1] == Approx( 0.81 ) );
+  CHECK( biased.switching[f3] == Approx( 0.18 ) );
+
+  /* only trivial cuts, probabilities are propagated from the fanins */
+  ps.input_probability = 0.5;
+  ps.cut_limit = 1u;
+  auto const trivial = switching_activity( aig, ps );
+  CHECK( trivial.probability[f1] == Approx( 0.25 ) );
+  CHECK( trivial.probability[f3] == Approx( 0.5625 ) ); /* node of f3 is the AND of !f1 and !f2 */
+  CHECK( trivial.probability[f4] == Approx( 0.125 ) );
+}
+
+TEST_CASE( "Signal probabilities by random simulation", "[switching_activity]" )
+{
+  aig_network aig;
+  auto const a = aig.create_pi();
+  auto const b = aig.create_pi();
+  auto const f1 = aig.create_and( a, b );
+  auto const f2 = aig.create_xor( a, b );
+  aig.create_po( f1 );
+  aig.create_po( f2 );
+
+  switching_activity_params ps;
+  ps.num_patterns = 10000u;
+  auto const result = switching_activity( aig, ps );
+
+  CHECK( std::abs( result.probability[a] - 0.5 ) < 0.03 );
+  CHECK( std::abs( result.probability[f1] - 0.25 ) < 0.03 );
+  CHECK( std::abs( result.switching[f1] - 0.375 ) < 0.03 );
+  CHECK( std::abs( result.switching[f2] - 0.5 ) < 0.03 );
+  CHECK( result.switching[aig.get_constant( false )] == 0.0 );
+}
+
+TEST_CASE( "Power cost function for new nodes", "[switching_activity]" )
+{
+  aig_network aig;
+  auto const a = aig.create_pi();
+  auto const b = aig.create_pi();
+  auto const c = aig.create_pi();
+  auto const f = aig.create_and( a, b );
+  aig.create_po( f );
+
+  switching_activity_params ps;
+  ps.method = switching_activity_params::propagation;
+  switching_activity_cost<aig_network> cost( aig, ps );
+  CHECK( cost( aig, aig.get_node( f ) ) == 38u );
+  CHECK( cost( aig, aig.get_node( a ) ) == 50u );
+
+  /* nodes created after the analysis */
+  auto const g = aig.create_and( f, !c );
+  CHECK( cost.probability( aig, aig.get_node( g ) ) == Approx( 0.125 ) );
+  CHECK( cost( aig, aig.get_node( g ) ) == 22u );
+
+  /* copies share the cache, other networks are propagated */
+  auto const copy = cost;
+  aig_network other;
+  other.create_po( other.create_and( other.create_pi(), other.create_pi() ) );
+  CHECK( copy.switching( other, other.size() - 1u ) == Approx( 0.375 ) );
+
+  CHECK( costs( aig, cost ) == 60u );
+
+  /* views share the storage of the bound network */
+  depth_view depth_aig{aig};
+  CHECK( cost.probability( depth_aig, aig.get_node( g ) ) == Approx( 0.125 ) );
+
+  /* default costs are bound on first use, the last other network is cached */
+  switching_activity_cost<aig_network> lazy;
+  for ( auto i = 0u; i < 2u; ++i )
+  {
+    CHECK( lazy.probability( aig, aig.get_node( g ) ) == Approx( 0.125 ) );
+    CHECK( lazy.switching( other, other.size() - 1u ) == Approx( 0.375 ) );
+    CHECK( lazy.probability( depth_aig, aig.get_node( f ) ) == Approx( 0.25 ) );
+  }
+  CHECK( costs( other, lazy ) == 38u );
+
+  /* gates with (almost) no activity still have a positive cost */
+  switching_activity_cost<aig_network> quiet( 100.0, 0.01 );
+  CHECK( quiet.switching( aig, aig.get_node( g ) ) < 0.001 );
+  CHECK( quiet( aig, aig.get_node( g ) ) == 1u );
+}
+
+TEST_CASE( "Power-aware rewriting and mapping", "[switching_activity]" )
+{
+  mig_network mig;
+  auto const a = mig.create_pi();
+  auto const b = mig.create_pi();
+  auto const c = mig.create_pi();
+  mig.create_po( mig.create_maj( a, mig.create_maj( a, b, c ), c ) );
+
+  mig_npn_resynthesis resyn;
+  {
+    switching_activity_cost<mig_network> cost( mig );
+    auto const res = cut_rewriting( mig, resyn, {}, nullptr, cost );
+    CHECK( res.num_gates() == 1u );
+  }
+  {
+    auto copy = mig;
+    switching_activity_cost<mig_network> cost( copy );
+    cut_rewriting_with_compatibility_graph( copy, resyn, {}, nullptr, cost );
+    copy = cleanup_dangling( copy );
+    CHECK( copy.num_gates() == 1u );
+  }
+  {
+    auto copy = mig;
+    switching_activity_cost<mig_network> cost( copy );
+    refactoring( copy, resyn, {}, nullptr, cost );
+    copy = cleanup_dangling( copy );
+    CHECK( copy.num_gates() == 1u );
+  }
+
+  /* candidates from the cache are created in the network, not costed on an overlay */
+  CHECK( is_structural_cost_v<unit_cost<aig_network>> );
+  CHECK( !is_structural_cost_v<switching_activity_cost<aig_network>> );
+  {
+    aig_network aig;
+    auto const a = aig.create_pi();
+    auto const b = aig.create_pi();
+    auto const c = aig.create_pi();
+    aig.create_po( aig.create_or( aig.create_and( a, b ), aig.create_and( a, c ) ) );
+
+    cut_rewriting_params ps;
+    ps.use_candidate_cache = true;
+    switching_activity_cost<aig_network> cost( aig );
+    xag_npn_resynthesis<aig_network> aig_resyn;
+    auto const res = cut_rewriting( aig, aig_resyn, ps, nullptr, cost );
+    CHECK( res.num_gates() == 2u );
+  }
+
+  aig_network aig;
+  std::vector<aig_network::signal> xs( 4u ), ys( 4u );
+  std::generate( xs.begin(), xs.end(), [&]() { return aig.create_pi(); } );
+  std::generate( ys.begin(), ys.end(), [&]() { return aig.create_pi(); } );
+  auto carry = aig.get_constant( false );
+  carry_ripple_adder_inplace( aig, xs, ys, carry );
+  std::for_each( xs.begin(), xs.end(), [&]( auto const& f ) { aig.create_po( f ); } );
+  aig.create_po( carry );
+
+  mapping_view<aig_network, true> mapped{aig};
+  switching_activity_cost<aig_network> cost( aig );
+  lut_mapping<mapping_view<aig_network, true>, true, cut_enumeration_mf_cut, switching_activity_cost<aig_network>>( mapped, {}, nullptr, cost );
+  CHECK( mapped.has_mapping() );
+  CHECK( mapped.num_cells() > 0u );
+}
@@ -0,0 +1,164 @@
+#include <catch.hpp>
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <kitty/static_truth_table.hpp>
+
+#include <mockturtle/algorithms/cleanup.hpp>
+#include <mockturtle/algorithms/simulation.hpp>
+#include <mockturtle/networks/aig.hpp>
+#include <mockturtle/networks/storage.hpp>
+#include <mockturtle/utils/allocators.hpp>
+#include <mockturtle/utils/node_map.hpp>
+
+using namespace mockturtle;
+
+TEST_CASE( "arena reuses its chunks after reset", "[allocators]" )
+{
+  arena mem( 1024u );
+
+  auto* a = mem.allocate( 100u );
+  auto* b = mem.allocate( 8u, 64u );
+  CHECK( reinterpret_cast<uintptr_t>( b ) % 64u == 0u );
+  CHECK( b != a );
+  CHECK( mem.used() == 108u );
+  CHECK( mem.capacity() == 1024u );
+
+  /* larger than a chunk */
+  auto* c = mem.allocate( 4000u );
+  CHECK( c != nullptr );
+  CHECK( mem.capacity() >= 5024u );
+
+  auto const capacity = mem.capacity();
+  mem.reset();
+  CHECK( mem.used() == 0u );
+  CHECK( mem.allocate( 100u ) == a );
+  mem.allocate( 4000u );
+  CHECK( mem.capacity() == capacity );
+
+  mem.release();
+  CHECK( mem.capacity() == 0u );
+}
+
+TEST_CASE( "containers with arena allocator", "[allocators]" )
+{
+  arena mem;
+
+  for ( auto window = 0u; window < 3u; ++window )
+  {
+    {
+      std::vector<uint32_t, arena_allocator<uint32_t>> values( arena_allocator<uint32_t>{mem} );
+      for ( auto i = 0u; i < 1000u; ++i )
+      {
+        values.push_back( i );
+      }
+      CHECK( values[999u] == 999u );
+    }
+    CHECK( mem.used() > 4000u );
+    mem.reset();
+  }
+  CHECK( mem.capacity() == 1u << 16u );
+}
+
+TEST_CASE( "pool allocator recycles blocks", "[allocators]" )
+{
+  pool_allocator<uint64_t> alloc;
+  auto* p = alloc.allocate( 10u );
+  alloc.deallocate( p, 10u );
+
+  /* same size class */
+  auto* q = alloc.allocate( 9u );
+  CHECK( q == p );
+  alloc.deallocate( q, 9u );
+
+  /* large blocks are not cached */
+  auto* r = alloc.allocate( 100000u );
+  r[99999u] = 1u;
+  alloc.deallocate( r, 100000u );
+
+  /* blocks may be freed in another thread */
+  auto* s = alloc.allocate( 100u );
+  std::thread t( [&]() { alloc.deallocate( s, 100u ); } );
+  t.join();
+
+  std::vector<uint32_t, pool_allocator<uint32_t>> values( 100u, 7u );
+  CHECK( values.back() == 7u );
+}
+
+TEST_CASE( "node maps with custom allocators", "[allocators]" )
+{
+  aig_network aig;
+  auto const a = aig.create_pi();
+  auto const b = aig.create_pi();
+  auto const f = aig.create_and( a, b );
+  aig.create_po( f );
+
+  arena mem;
+  {
+    node_map<uint32_t, aig_network, std::vector<uint32_t, arena_allocator<uint32_t>>> map( aig, 5u, arena_allocator<uint32_t>{mem} );
+    CHECK( mem.used() >= aig.size() * sizeof( uint32_t ) );
+    CHECK( map[f] == 5u );
+    map[f] = 3u;
+    CHECK( map[aig.get_node( f )] == 3u );
+
+    aig.create_po( aig.create_and( a, !b ) );
+    map.resize( 1u );
+    CHECK( map[aig.size() - 1u] == 1u );
+  }
+  mem.reset();
+
+  unordered_node_map<uint32_t, aig_network, pool_allocator<uint32_t>> umap( aig );
+  CHECK( !umap.has( f ) );
+  umap[f] = 4u;
+  CHECK( umap.has( f ) );
+  auto const copy = umap.copy();
+  CHECK( copy[f] == 4u );
+}
+
+TEST_CASE( "network storage with custom allocator", "[allocators]" )
+{
+  using node_type = regular_node<2, 2, 1>;
+
+  arena mem;
+  storage<node_type, empty_storage_data, node_hash<node_type>, arena_allocator<node_type>> s( arena_allocator<node_type>{mem} );
+  CHECK( s.nodes.size() == 1u );
+  CHECK( mem.used() >= 10000u * sizeof( node_type ) );
+
+  s.inputs.push_back( 1u );
+  s.nodes.emplace_back();
+  CHECK( s.nodes.size() == 2u );
+  CHECK( s.inputs.size() == 1u );
+}
+
+TEST_CASE( "AIG with custom allocator", "[allocators]" )
+{
+  using arena_aig = basic_aig_network<arena_allocator<aig_node>>;
+
+  arena mem;
+  arena_aig aig( arena_allocator<aig_node>{mem} );
+  CHECK( mem.used() >= 10000u * sizeof( aig_node ) );
+
+  auto const a = aig.create_pi();
+  auto const b = aig.create_pi();
+  auto const c = aig.create_pi();
+  aig.create_po( aig.create_maj( a, b, c ) );
+  aig.create_po( aig.create_xor( a, b ) );
+  CHECK( aig.num_pis() == 3u );
+  CHECK( aig.num_gates() == 7u );
+
+  default_simulator<kitty::static_truth_table<3u>> sim;
+  auto const tts = simulate<kitty::static_truth_table<3u>>( aig, sim );
+  CHECK( tts[0]._bits == 0xe8 );
+  CHECK( tts[1]._bits == 0x66 );
+
+  /* copy into an AIG with the default allocator */
+  auto const copy = cleanup_dangling<arena_aig, aig_network>( aig );
+  CHECK( copy.num_gates() == 7u );
+  CHECK( simulate<kitty::static_truth_table<3u>>( copy, sim ) == tts );
+
+  basic_aig_network<pool_allocator<aig_node>> pooled;
+  pooled.create_po( pooled.create_and( pooled.create_pi(), pooled.create_pi() ) );
+  CHECK( pooled.num_gates() == 1u );
+}
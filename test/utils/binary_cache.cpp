@@ -0,0 +1,116 @@
+#include <catch.hpp>
+
+#include <cstdio>
+#include <fstream>
+
+#include <mockturtle/utils/binary_cache.hpp>
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+
+using namespace mockturtle;
+
+TEST_CASE( "insert and find records in a binary cache", "[binary_cache]" )
+{
+  binary_cache cache;
+  CHECK( !cache.is_persistent() );
+
+  for ( auto i = 0u; i < 1000u; ++i )
+  {
+    cache.insert( i % 2u, {i, i + 1u}, {i * i} );
+  }
+  CHECK( cache.size() == 1000u );
+
+  for ( auto i = 0u; i < 1000u; ++i )
+  {
+    const auto value = cache.find( i % 2u, {i, i + 1u} );
+    REQUIRE( value );
+    CHECK( value->second - value->first == 1 );
+    CHECK( *value->first == i * i );
+    CHECK( !cache.find( 1u - i % 2u, {i, i + 1u} ) );
+  }
+
+  /* replace a value */
+  cache.insert( 0u, {2u, 3u}, {7u, 8u} );
+  CHECK( cache.size() == 1000u );
+  const auto value = cache.find( 0u, {2u, 3u} );
+  REQUIRE( value );
+  CHECK( std::vector<binary_cache::word>( value->first, value->second ) == std::vector<binary_cache::word>{7u, 8u} );
+}
+
+TEST_CASE( "reopen a binary cache file", "[binary_cache]" )
+{
+  const std::string filename = "mockturtle-test-binary-cache.bin";
+  std::remove( filename.c_str() );
+
+  {
+    binary_cache cache( filename );
+    CHECK( cache.is_persistent() );
+    CHECK( cache.num_loaded() == 0u );
+    cache.insert( 1u, {1u}, {10u, 11u} );
+    cache.insert( 1u, {2u}, {} );
+    cache.insert( 1u, {1u}, {12u} );
+  }
+  CHECK( binary_cache::is_binary_cache_file( filename ) );
+
+  {
+    binary_cache cache( filename );
+    CHECK( cache.is_persistent() );
+    CHECK( cache.num_loaded() == 3u );
+    CHECK( cache.size() == 2u );
+    const auto v1 = cache.find( 1u, {1u} );
+    REQUIRE( v1 );
+    CHECK( std::vector<binary_cache::word>( v1->first, v1->second ) == std::vector<binary_cache::word>{12u} );
+    const auto v2 = cache.find( 1u, {2u} );
+    REQUIRE( v2 );
+    CHECK( v2->first == v2->second );
+  }
+
+  /* an incomplete record at the end is discarded */
+  {
+    std::ofstream os( filename, std::ofstream::binary | std::ofstream::app );
+    const binary_cache::word partial[2] = {10u, 1u};
+    os.write( reinterpret_cast<char const*>( partial ), sizeof( partial ) );
+  }
+
+  {
+    binary_cache cache( filename );
+    CHECK( cache.num_loaded() == 3u );
+    cache.insert( 1u, {3u}, {13u} );
+  }
+
+  {
+    binary_cache cache( filename );
+    CHECK( cache.num_loaded() == 4u );
+    CHECK( cache.size() == 3u );
+    CHECK( cache.find( 1u, {3u} ) );
+  }
+
+  std::remove( filename.c_str() );
+}
+
+TEST_CASE( "truth tables in binary cache keys", "[binary_cache]" )
+{
+  kitty::dynamic_truth_table maj( 3u ), tt( 7u );
+  kitty::create_majority( maj );
+  kitty::create_majority( tt );
+
+  for ( auto const& f : {maj, tt} )
+  {
+    std::vector<binary_cache::word> words;
+    append_truth_table( words, f );
+    CHECK( words.size() == 1u + 2u * f.num_blocks() );
+
+    auto it = static_cast<binary_cache::word const*>( words.data() );
+    CHECK( read_truth_table( it, words.data() + words.size() ) == f );
+    CHECK( it == words.data() + words.size() );
+
+    /* truncated records */
+    it = words.data();
+    CHECK( !read_truth_table( it, words.data() + words.size() - 1u ) );
+    CHECK( !read_truth_table( it, words.data() ) );
+  }
+
+  std::vector<binary_cache::word> words{32u, 0u, 0u};
+  auto it = static_cast<binary_cache::word const*>( words.data() );
+  CHECK( !read_truth_table( it, words.data() + words.size() ) );
+}
@@ -0,0 +1,119 @@
+#include <catch.hpp>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <kitty/dynamic_truth_table.hpp>
+#include <mockturtle/networks/abstract_xag.hpp>
+#include <mockturtle/networks/aig.hpp>
+#include <mockturtle/networks/klut.hpp>
+#include <mockturtle/utils/memory.hpp>
+#include <mockturtle/utils/node_map.hpp>
+#include <mockturtle/views/depth_view.hpp>
+#include <mockturtle/views/fanout_view.hpp>
+#include <mockturtle/views/mapping_view.hpp>
+#include <mockturtle/views/topo_view.hpp>
+
+using namespace mockturtle;
+
+TEST_CASE( "heap memory of containers", "[memory]" )
+{
+  CHECK( heap_memory_usage( 42u ) == 0u );
+
+  std::vector<uint64_t> v;
+  v.reserve( 100u );
+  CHECK( heap_memory_usage( v ) == 800u );
+
+  std::string const small = "abc";
+  std::string const large( 1000u, 'x' );
+  CHECK( heap_memory_usage( small ) == 0u );
+  CHECK( heap_memory_usage( large ) > 1000u );
+
+  /* nested containers */
+  std::vector<std::string> strings( 2u, large );
+  CHECK( heap_memory_usage( strings ) >= 2u * sizeof( std::string ) + 2000u );
+
+  std::unordered_map<uint32_t, uint32_t> map;
+  auto const empty_map = heap_memory_usage( map );
+  for ( auto i = 0u; i < 100u; ++i )
+  {
+    map[i] = i;
+  }
+  CHECK( heap_memory_usage( map ) >= empty_map + 100u * sizeof( std::pair<uint32_t const, uint32_t> ) );
+
+  kitty::dynamic_truth_table tt( 10u );
+  CHECK( heap_memory_usage( tt ) == 128u );
+}
+
+TEST_CASE( "memory usage of networks", "[memory]" )
+{
+  aig_network aig;
+  auto const empty = aig.memory_usage();
+  CHECK( empty >= sizeof( aig_storage ) + 10000u * sizeof( aig_storage::node_type ) );
+
+  std::vector<aig_network::signal> pis;
+  for ( auto i = 0u; i < 100u; ++i )
+  {
+    pis.push_back( aig.create_pi() );
+  }
+  auto f = pis[0];
+  for ( auto i = 1u; i < 100u; ++i )
+  {
+    f = aig.create_and( f, pis[i] );
+  }
+  aig.create_po( f );
+  CHECK( aig.memory_usage() > empty );
+
+  /* copies share the storage */
+  auto const copy = aig;
+  CHECK( copy.memory_usage() == aig.memory_usage() );
+
+  klut_network klut;
+  auto const a = klut.create_pi();
+  auto const b = klut.create_pi();
+  auto const empty_klut = klut.memory_usage();
+  klut.create_po( klut.create_and( a, b ) );
+  klut.create_po( klut.create_xor( a, b ) );
+  CHECK( klut.memory_usage() > empty_klut );
+
+  abstract_xag_network xag;
+  auto const empty_xag = xag.memory_usage();
+  xag.create_po( xag.create_nary_xor( {xag.create_pi(), xag.create_pi(), xag.create_pi()} ) );
+  CHECK( xag.memory_usage() >= empty_xag + 3u * sizeof( uint32_t ) );
+}
+
+TEST_CASE( "memory usage of views", "[memory]" )
+{
+  aig_network aig;
+  auto const a = aig.create_pi();
+  auto const b = aig.create_pi();
+  auto const c = aig.create_pi();
+  aig.create_po( aig.create_and( aig.create_and( a, b ), c ) );
+
+  auto const base = aig.memory_usage();
+
+  node_map<uint32_t, aig_network> map( aig );
+  CHECK( map.memory_usage() >= aig.size() * sizeof( uint32_t ) );
+
+  fanout_view fanout_aig{aig};
+  CHECK( fanout_aig.memory_usage() > base );
+
+  depth_view depth_aig{aig};
+  CHECK( depth_aig.memory_usage() >= base + 2u * aig.size() * sizeof( uint32_t ) );
+
+  mapping_view<aig_network, true> mapped_aig{aig};
+  CHECK( mapped_aig.memory_usage() >= base + aig.size() * sizeof( uint32_t ) );
+
+  topo_view topo_aig{aig};
+  CHECK( topo_aig.memory_usage() >= base + aig.size() * sizeof( aig_network::node ) );
+
+  /* stacked views */
+  depth_view depth_fanout_aig{fanout_aig};
+  CHECK( depth_fanout_aig.memory_usage() > fanout_aig.memory_usage() );
+}
+
+TEST_CASE( "resident set size", "[memory]" )
+{
+  CHECK( peak_rss() >= current_rss() );
+}
@@ -1,6 +1,8 @@
 #include <catch.hpp>
 
 #include <cstdint>
+#include <stdexcept>
+#include <unordered_map>
 #include <vector>
 
 #include <mockturtle/generators/arithmetic.hpp>
@@ -94,3 +96,77 @@ TEST_CASE( "create unordered node map for full adder", "[node_map]" )
 
   CHECK( total == mig.size() );
 }
+
+TEST_CASE( "flat node table", "[node_map]" )
+{
+  flat_node_table<uint32_t> table;
+  CHECK( table.find( 5u ) == nullptr );
+
+  /* looking up existing keys does not grow the table */
+  for ( auto i = 0u; i < 8u; ++i )
+  {
+    table[i] = i;
+  }
+  auto const memory_full = table.memory_usage();
+  CHECK( table[7u] == 7u );
+  CHECK( table.memory_usage() == memory_full );
+  CHECK( table.at( 3u ) == 3u );
+  CHECK_THROWS_AS( table.at( 8u ), std::out_of_range );
+  CHECK( table.size() == 8u );
+  table.clear();
+
+  for ( auto i = 0u; i < 1000u; ++i )
+  {
+    table[i * 7u] = i;
+  }
+  CHECK( table.size() == 1000u );
+
+  /* references remain valid while the table grows */
+  auto& first = table[0u];
+  for ( auto i = 1000u; i < 2000u; ++i )
+  {
+    table[i * 7u] = i;
+  }
+  CHECK( &first == &table[0u] );
+
+  for ( auto i = 0u; i < 2000u; i += 2u )
+  {
+    CHECK( table.erase( i * 7u ) );
+  }
+  CHECK( !table.erase( 0u ) );
+  CHECK( table.size() == 1000u );
+  for ( auto i = 0u; i < 2000u; ++i )
+  {
+    auto const* v = table.find( i * 7u );
+    CHECK( ( v != nullptr ) == ( i % 2u == 1u ) );
+    if ( v )
+    {
+      CHECK( *v == i );
+    }
+  }
+
+  /* values of previous epochs are reset when reused */
+  auto const memory = table.memory_usage();
+  table.clear();
+  CHECK( table.size() == 0u );
+  CHECK( table.find( 7u ) == nullptr );
+  CHECK( table[7u] == 0u );
+  CHECK( table.memory_usage() == memory );
+}
+
+TEST_CASE( "node map based on std::unordered_map", "[node_map]" )
+{
+  aig_network aig;
+  auto const a = aig.create_pi();
+  auto const b = aig.create_pi();
+  auto const f = aig.create_and( a, b );
+  aig.create_po( f );
+
+  node_map<uint32_t, aig_network, std::unordered_map<aig_network::node, uint32_t>> map( aig );
+  CHECK( !map.has( f ) );
+  map[f] = 3u;
+  CHECK( map.has( aig.get_node( f ) ) );
+  CHECK( map[aig.get_node( f )] == 3u );
+  map.reset();
+  CHECK( !map.has( f ) );
+}
@@ -0,0 +1,216 @@
+#include <catch.hpp>
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <mockturtle/algorithms/cleanup.hpp>
+#include <mockturtle/algorithms/cut_rewriting.hpp>
+#include <mockturtle/algorithms/node_resynthesis/mig_npn.hpp>
+#include <mockturtle/networks/mig.hpp>
+#include <mockturtle/utils/profiler.hpp>
+#include <mockturtle/utils/stopwatch.hpp>
+
+using namespace mockturtle;
+
+namespace
+{
+
+profile_scope_data const* find_scope( profile_scope_data const& data, std::string const& name )
+{
+  for ( auto const& c : data.children )
+  {
+    if ( c.name == name )
+    {
+      return &c;
+    }
+  }
+  return nullptr;
+}
+
+} // namespace
+
+TEST_CASE( "nested scopes and counters", "[profiler]" )
+{
+  auto& p = profiler::instance();
+  p.enable();
+  p.reset();
+
+  {
+    profile_scope outer( "outer" );
+    for ( auto i = 0u; i < 3u; ++i )
+    {
+      profile_scope inner( "inner" );
+      profile_counter( "items", 2u );
+    }
+    profile_counter( "items" );
+
+    stopwatch<>::duration time{0};
+    {
+      stopwatch t( time, "timed" );
+    }
+    call_with_stopwatch( time, "timed", [&]() { profile_counter( "calls" ); } );
+  }
+
+  /* disabled profiler does not record */
+  p.disable();
+  {
+    profile_scope ignored( "ignored" );
+    profile_counter( "items", 100u );
+  }
+
+  auto const root = p.aggregate();
+  auto const* outer = find_scope( root, "outer" );
+  REQUIRE( outer );
+  CHECK( outer->calls == 1u );
+  CHECK( outer->counters.at( "items" ) == 1u );
+  CHECK( find_scope( root, "ignored" ) == nullptr );
+
+  auto const* inner = find_scope( *outer, "inner" );
+  REQUIRE( inner );
+  CHECK( inner->calls == 3u );
+  CHECK( inner->counters.at( "items" ) == 6u );
+  CHECK( inner->time_ns <= outer->time_ns );
+
+  auto const* timed = find_scope( *outer, "timed" );
+  REQUIRE( timed );
+  CHECK( timed->calls == 2u );
+
+  CHECK( p.counter( "items" ) == 7u );
+  CHECK( p.counter( "calls" ) == 1u );
+
+  p.reset();
+  CHECK( p.counter( "items" ) == 0u );
+  CHECK( p.aggregate().children.empty() );
+}
+
+TEST_CASE( "scopes of several threads are merged", "[profiler]" )
+{
+  auto& p = profiler::instance();
+  p.enable();
+  p.reset();
+
+  std::vector<std::thread> threads;
+  for ( auto t = 0u; t < 4u; ++t )
+  {
+    threads.emplace_back( []() {
+      profile_scope scope( "work" );
+      profile_counter( "items", 10u );
+    } );
+  }
+  for ( auto& t : threads )
+  {
+    t.join();
+  }
+  p.disable();
+
+  auto const root = p.aggregate();
+  auto const* work = find_scope( root, "work" );
+  REQUIRE( work );
+  CHECK( work->calls == 4u );
+  CHECK( work->counters.at( "items" ) == 40u );
+}
+
+TEST_CASE( "export profile as report, JSON, and Chrome trace", "[profiler]" )
+{
+  auto& p = profiler::instance();
+  p.enable( true );
+  p.reset();
+
+  {
+    profile_scope scope( "flow \"quoted\"" );
+    profile_counter( "sat_calls", 5u );
+  }
+  p.disable();
+
+  std::ostringstream report;
+  p.report( report );
+  CHECK( report.str().find( "flow \"quoted\"" ) != std::string::npos );
+  CHECK( report.str().find( "sat_calls" ) != std::string::npos );
+
+  std::ostringstream json;
+  p.write_json( json );
+  CHECK( json.str().find( "{\"scopes\":[{\"name\":\"flow \\\"quoted\\\"\",\"calls\":1," ) == 0u );
+  CHECK( json.str().find( "\"counters\":{\"sat_calls\":5}}" ) != std::string::npos );
+
+  std::ostringstream trace;
+  p.write_chrome_trace( trace );
+  CHECK( trace.str().find( "{\"traceEvents\":[{\"name\":\"flow \\\"quoted\\\"\",\"ph\":\"X\"" ) == 0u );
+  CHECK( trace.str().find( "\"otherData\":{\"sat_calls\":5}" ) != std::string::npos );
+
+  p.reset();
+}
+
+TEST_CASE( "algorithms report to the profiler", "[profiler]" )
+{
+  auto& p = profiler::instance();
+  p.enable();
+  p.reset();
+
+  mig_network mig;
+  auto const a = mig.create_pi();
+  auto const b = mig.create_pi();
+  auto const c = mig.create_pi();
+  auto const f = mig.create_maj( a, mig.create_maj( a, b, c ), c );
+  mig.create_po( f );
+
+  mig_npn_resynthesis resyn;
+  {
+    profile_scope flow( "flow" );
+    for ( auto i = 0u; i < 2u; ++i )
+    {
+      cut_rewriting( mig, resyn );
+      mig = cleanup_dangling( mig );
+    }
+  }
+  p.disable();
+
+  auto const root = p.aggregate();
+  auto const* flow = find_scope( root, "flow" );
+  REQUIRE( flow );
+  auto const* rw = find_scope( *flow, "cut_rewriting" );
+  REQUIRE( rw );
+  CHECK( rw->calls == 2u );
+  CHECK( find_scope( *rw, "cut_enumeration" ) );
+
+  p.reset();
+}
+
+TEST_CASE( "heap memory is attributed to scopes", "[profiler]" )
+{
+  auto& p = profiler::instance();
+  p.enable();
+  p.reset();
+
+  {
+    profile_scope outer( "outer" );
+    std::vector<uint64_t, tracking_allocator<uint64_t>> values;
+    values.reserve( 1000u );
+    {
+      profile_scope inner( "inner" );
+      std::vector<uint64_t, tracking_allocator<uint64_t>> temporary( 4000u );
+    }
+    std::vector<uint64_t, tracking_allocator<uint64_t>> more( 1000u );
+  }
+  p.disable();
+
+  auto const root = p.aggregate();
+  auto const* outer = find_scope( root, "outer" );
+  REQUIRE( outer );
+  CHECK( outer->allocations == 2u );
+  CHECK( outer->allocated_bytes == 16000u );
+  CHECK( outer->peak_bytes == 40000u );
+
+  auto const* inner = find_scope( *outer, "inner" );
+  REQUIRE( inner );
+  CHECK( inner->allocations == 1u );
+  CHECK( inner->allocated_bytes == 32000u );
+  CHECK( inner->peak_bytes == 32000u );
+
+  std::ostringstream json;
+  p.write_json( json );
+  CHECK( json.str().find( "\"allocated_bytes\":16000,\"peak_bytes\":40000" ) != std::string::npos );
+
+  p.reset();
+}
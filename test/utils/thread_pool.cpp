@@ -0,0 +1,194 @@
+#include <catch.hpp>
+
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include <mockturtle/networks/aig.hpp>
+#include <mockturtle/utils/thread_pool.hpp>
+#include <mockturtle/views/depth_view.hpp>
+
+using namespace mockturtle;
+
+TEST_CASE( "parallel loop visits every index once", "[thread_pool]" )
+{
+  thread_pool pool( 4u );
+  CHECK( pool.num_threads() == 4u );
+
+  for ( auto grain : {1u, 7u, 1000u} )
+  {
+    std::vector<std::atomic<uint32_t>> visits( 10000u );
+    std::atomic<uint32_t> max_thread{0u};
+    pool.parallel_for(
+        0u, visits.size(), [&]( uint64_t i, uint32_t t ) {
+          ++visits[i];
+          if ( t > max_thread )
+            max_thread = t;
+        },
+        4u, grain );
+    CHECK( max_thread < 4u );
+
+    for ( auto const& v : visits )
+    {
+      CHECK( v == 1u );
+    }
+  }
+
+  /* empty range and more threads than the pool has */
+  std::atomic<uint32_t> count{0u};
+  pool.parallel_for( 5u, 5u, [&]( uint64_t, uint32_t ) { ++count; } );
+  CHECK( count == 0u );
+  pool.parallel_for(
+      0u, 100u, [&]( uint64_t, uint32_t ) { ++count; }, 8u );
+  CHECK( count == 100u );
+  CHECK( pool.num_threads() == 8u );
+}
+
+TEST_CASE( "uneven work is balanced by stealing", "[thread_pool]" )
+{
+  thread_pool pool( 4u );
+
+  /* all expensive indexes are at the beginning of the range */
+  std::vector<uint64_t> results( 256u );
+  per_thread<uint64_t> work( 4u );
+  pool.parallel_for(
+      0u, results.size(), [&]( uint64_t i, uint32_t t ) {
+        uint64_t x = i;
+        for ( auto k = 0u; k < ( i < 64u ? 20000u : 10u ); ++k )
+        {
+          x = x * 6364136223846793005ull + 1442695040888963407ull;
+        }
+        results[i] = x;
+        ++work[t];
+      },
+      4u );
+
+  uint64_t total{0u};
+  work.foreach_element( [&]( auto const& w, auto ) { total += w; } );
+  CHECK( total == results.size() );
+
+  for ( auto i = 0u; i < results.size(); ++i )
+  {
+    uint64_t x = i;
+    for ( auto k = 0u; k < ( i < 64u ? 20000u : 10u ); ++k )
+    {
+      x = x * 6364136223846793005ull + 1442695040888963407ull;
+    }
+    CHECK( results[i] == x );
+  }
+}
+
+TEST_CASE( "run jobs, nested jobs, and exceptions in a thread pool", "[thread_pool]" )
+{
+  thread_pool pool( 3u );
+
+  std::vector<uint32_t> ids( 3u, 0u );
+  pool.run( 3u, [&]( uint32_t t ) { ids[t] = t + 1u; } );
+  CHECK( ids == std::vector<uint32_t>{1u, 2u, 3u} );
+
+  /* nested loops run in the calling thread */
+  std::vector<uint64_t> sums( 3u, 0u );
+  std::vector<uint32_t> inner_threads( 3u, 0u );
+  pool.run( 3u, [&]( uint32_t t ) {
+    pool.parallel_for(
+        0u, 100u, [&]( uint64_t i, uint32_t inner ) {
+          inner_threads[t] |= inner;
+          sums[t] += i;
+        },
+        3u );
+  } );
+  CHECK( sums == std::vector<uint64_t>{4950u, 4950u, 4950u} );
+  CHECK( inner_threads == std::vector<uint32_t>{0u, 0u, 0u} );
+
+  CHECK_THROWS_AS( pool.parallel_for(
+                       0u, 100u, [&]( uint64_t i, uint32_t ) {
+                         if ( i == 42u )
+                           throw std::runtime_error( "42" );
+                       },
+                       3u ),
+                   std::runtime_error );
+
+  /* the pool is still usable */
+  std::atomic<uint32_t> count{0u};
+  pool.parallel_for(
+      0u, 100u, [&]( uint64_t, uint32_t ) { ++count; }, 3u );
+  CHECK( count == 100u );
+}
+
+TEST_CASE( "default number of threads", "[thread_pool]" )
+{
+  auto const n = default_num_threads();
+  CHECK( n >= 1u );
+
+  set_default_num_threads( 3u );
+  CHECK( default_num_threads() == 3u );
+  CHECK( resolve_num_threads( 0u ) == 3u );
+  CHECK( resolve_num_threads( 2u ) == 2u );
+
+  std::vector<uint32_t> ids( 3u, 0u );
+  default_thread_pool().run( 0u, [&]( uint32_t t ) { ids[t] = t + 1u; } );
+  CHECK( ids == std::vector<uint32_t>{1u, 2u, 3u} );
+
+  set_default_num_threads( n );
+}
+
+TEST_CASE( "per-thread storage creates elements on demand", "[thread_pool]" )
+{
+  uint32_t created{0u};
+  per_thread<std::vector<uint32_t>> buffers( 4u, [&]() { ++created; return std::make_unique<std::vector<uint32_t>>( 2u, 7u ); } );
+  CHECK( buffers.size() == 4u );
+  CHECK( !buffers.has( 2u ) );
+
+  buffers[2u].push_back( 3u );
+  CHECK( buffers.has( 2u ) );
+  CHECK( buffers[2u] == std::vector<uint32_t>{7u, 7u, 3u} );
+  CHECK( created == 1u );
+
+  uint32_t visited{0u};
+  buffers.foreach_element( [&]( auto const&, uint32_t t ) { CHECK( t == 2u ); ++visited; } );
+  CHECK( visited == 1u );
+
+  buffers.clear();
+  CHECK( !buffers.has( 2u ) );
+  CHECK( buffers[2u].size() == 2u );
+  CHECK( created == 2u );
+}
+
+TEST_CASE( "level-synchronous traversal of an AIG", "[thread_pool]" )
+{
+  aig_network aig;
+  auto const a = aig.create_pi();
+  auto const b = aig.create_pi();
+  auto const c = aig.create_pi();
+  auto const f1 = aig.create_and( a, b );
+  auto const f2 = aig.create_and( b, c );
+  auto const f3 = aig.create_and( f1, c );
+  auto const f4 = aig.create_and( f1, f2 );
+  auto const f5 = aig.create_and( f3, f4 );
+  aig.create_po( f5 );
+
+  auto const levels = levelize( aig );
+  REQUIRE( levels.size() == 3u );
+  CHECK( levels[0] == std::vector<aig_network::node>{aig.get_node( f1 ), aig.get_node( f2 )} );
+  CHECK( levels[1] == std::vector<aig_network::node>{aig.get_node( f3 ), aig.get_node( f4 )} );
+  CHECK( levels[2] == std::vector<aig_network::node>{aig.get_node( f5 )} );
+
+  /* each node sees the levels of its fanins computed in earlier waves */
+  thread_pool pool( 2u );
+  depth_view depth_aig{aig};
+  std::vector<uint32_t> level( aig.size(), 0u );
+  std::vector<uint32_t> synced;
+  wavefront(
+      levels, [&]( auto const& n, uint64_t, uint32_t ) {
+        uint32_t l{0u};
+        aig.foreach_fanin( n, [&]( auto const& f ) { l = std::max( l, level[aig.get_node( f )] ); } );
+        level[n] = l + 1u;
+      },
+      [&]( uint32_t l ) { synced.push_back( l ); }, 2u, pool );
+
+  CHECK( synced == std::vector<uint32_t>{0u, 1u, 2u} );
+  aig.foreach_gate( [&]( auto const& n ) {
+    CHECK( level[n] == depth_aig.level( n ) );
+  } );
+}